@@ -0,0 +1,88 @@
+/** @file
+
+    Benchmark harness.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+/// The result of running one benchmark.
+struct Result {
+  std::string _name;         ///< Benchmark name.
+  size_t _iterations   = 0;  ///< Operations per sample.
+  double _ns           = 0;  ///< Median nanoseconds per operation.
+  double _ns_min       = 0;  ///< Minimum nanoseconds per operation.
+  double _allocs       = 0;  ///< Heap allocations per operation.
+  double _alloc_bytes  = 0;  ///< Heap bytes allocated per operation.
+  double _cache_misses = -1; ///< Cache misses per operation, negative if not available.
+};
+
+/** Measurement for a benchmark.
+ *
+ * A benchmark function does any set up and then calls @c measure with the operation to time. The
+ * operation is called with the iteration index, and the benchmark must make sure the work is not
+ * optimized away, e.g. with @c keep.
+ */
+class Run {
+public:
+  /** Time @a op.
+   *
+   * @param op The operation, called with the iteration index.
+   *
+   * The number of iterations is calibrated to run for the minimum time, and then several samples are
+   * taken. This can be called only once per benchmark.
+   */
+  void measure(std::function<void(size_t)> const &op);
+
+  /// Minimum time per sample, in seconds.
+  double _min_time = 0.1;
+  /// Number of samples.
+  int _samples = 5;
+  /// Result of the measurement.
+  Result _result;
+};
+
+/// Signature for a benchmark function.
+using Function = void (*)(Run &);
+
+/// Register a benchmark. This is normally done with @c BENCHMARK.
+bool add(char const *name, Function f);
+
+/// Prevent the compiler from optimizing away @a value.
+template <typename T>
+inline void
+keep(T const &value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Deterministic data for reproducible runs.
+uint64_t next_random(uint64_t &state);
+
+} // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+/// Define a benchmark named @a name.
+#define BENCHMARK(name, fn) static bool BENCH_CONCAT(Bench_Reg_, __LINE__) = bench::add(name, fn)
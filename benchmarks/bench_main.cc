@@ -0,0 +1,320 @@
+/** @file
+
+    Benchmark harness and driver.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "swoc/TextView.h"
+#include "swoc/BufferWriter.h"
+#include "swoc/bwf_base.h"
+#include "swoc/swoc_version.h"
+
+#include "bench.h"
+
+using swoc::TextView;
+using namespace std::literals;
+
+namespace
+{
+// Heap use, counted by the replacement global allocation functions.
+std::atomic<size_t> Alloc_Count{0};
+std::atomic<size_t> Alloc_Bytes{0};
+
+struct Entry {
+  char const *_name;
+  bench::Function _f;
+};
+
+std::vector<Entry> &
+Benchmarks()
+{
+  static std::vector<Entry> benchmarks;
+  return benchmarks;
+}
+
+/// Hardware cache miss counter for the process, if available.
+class CacheMisses
+{
+public:
+  CacheMisses()
+  {
+#if defined(__linux__)
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    _fd                 = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~CacheMisses()
+  {
+#if defined(__linux__)
+    if (_fd >= 0) {
+      close(_fd);
+    }
+#endif
+  }
+
+  /// @return @c true if the counter is available.
+  bool
+  is_valid() const
+  {
+    return _fd >= 0;
+  }
+
+  void
+  start()
+  {
+#if defined(__linux__)
+    if (_fd >= 0) {
+      ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  /// @return The count since @c start.
+  uint64_t
+  stop()
+  {
+    uint64_t count = 0;
+#if defined(__linux__)
+    if (_fd >= 0) {
+      ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(_fd, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+protected:
+  int _fd = -1;
+};
+
+CacheMisses &
+Cache_Misses()
+{
+  static CacheMisses counter;
+  return counter;
+}
+
+} // namespace
+
+// Count the C allocation functions as well, because MemArena allocates blocks with @c malloc.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+extern "C" {
+void *__libc_malloc(size_t);
+void *__libc_calloc(size_t, size_t);
+void *__libc_realloc(void *, size_t);
+
+void *
+malloc(size_t n)
+{
+  ++Alloc_Count;
+  Alloc_Bytes += n;
+  return __libc_malloc(n);
+}
+
+void *
+calloc(size_t n, size_t size)
+{
+  ++Alloc_Count;
+  Alloc_Bytes += n * size;
+  return __libc_calloc(n, size);
+}
+
+void *
+realloc(void *p, size_t n)
+{
+  ++Alloc_Count;
+  Alloc_Bytes += n;
+  return __libc_realloc(p, n);
+}
+}
+#define BENCH_COUNTED_MALLOC 1
+#endif
+
+void *
+operator new(size_t n)
+{
+#if !defined(BENCH_COUNTED_MALLOC)
+  ++Alloc_Count;
+  Alloc_Bytes += n;
+#endif
+  if (void *p = std::malloc(n ? n : 1)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void
+operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace bench
+{
+bool
+add(char const *name, Function f)
+{
+  Benchmarks().push_back({name, f});
+  return true;
+}
+
+uint64_t
+next_random(uint64_t &state)
+{
+  // splitmix64, which is good enough and identical everywhere.
+  uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+void
+Run::measure(std::function<void(size_t)> const &op)
+{
+  using clock = std::chrono::steady_clock;
+  auto sample = [&](size_t n) -> double {
+    auto t0 = clock::now();
+    for (size_t i = 0; i < n; ++i) {
+      op(i);
+    }
+    return std::chrono::duration<double>(clock::now() - t0).count();
+  };
+
+  // Calibrate, with a warm up as a side effect.
+  size_t n = 1;
+  for (double t; (t = sample(n)) < _min_time;) {
+    n = t < _min_time / 100 ? n * 10 : std::max<size_t>(n + 1, n * 1.2 * _min_time / t);
+  }
+
+  std::vector<double> times;
+  auto &misses        = Cache_Misses();
+  uint64_t miss_count = 0;
+  size_t allocs       = Alloc_Count;
+  size_t alloc_bytes  = Alloc_Bytes;
+  for (int i = 0; i < _samples; ++i) {
+    misses.start();
+    times.push_back(sample(n) * 1e9 / n);
+    miss_count += misses.stop();
+  }
+  double ops = double(n) * _samples;
+  std::sort(times.begin(), times.end());
+  _result._iterations   = n;
+  _result._ns           = times[times.size() / 2];
+  _result._ns_min       = times[0];
+  _result._allocs       = (Alloc_Count - allocs) / ops;
+  _result._alloc_bytes  = (Alloc_Bytes - alloc_bytes) / ops;
+  _result._cache_misses = misses.is_valid() ? miss_count / ops : -1;
+}
+
+} // namespace bench
+
+int
+main(int argc, char *argv[])
+{
+  bool json_p     = false;
+  double min_time = 0.1;
+  TextView filter;
+  for (int i = 1; i < argc; ++i) {
+    TextView arg{argv[i], strlen(argv[i])};
+    if (arg == "--json"sv) {
+      json_p = true;
+    } else if (arg == "--filter"sv && i + 1 < argc) {
+      filter.assign(argv[i + 1], strlen(argv[i + 1]));
+      ++i;
+    } else if (arg == "--min-time"sv && i + 1 < argc) {
+      min_time = std::max(0.001, atof(argv[++i]));
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--json] [--filter text] [--min-time seconds]" << std::endl;
+      return 1;
+    }
+  }
+
+  auto &benchmarks = Benchmarks();
+  std::sort(benchmarks.begin(), benchmarks.end(), [](Entry const &lhs, Entry const &rhs) { return strcmp(lhs._name, rhs._name) < 0; });
+
+  std::vector<bench::Result> results;
+  for (auto const &[name, f] : benchmarks) {
+    if (filter.empty() || TextView{name, strlen(name)}.find(filter) != TextView::npos) {
+      bench::Run run;
+      run._min_time     = min_time;
+      run._result._name = name;
+      f(run);
+      results.push_back(run._result);
+      if (!json_p) {
+        swoc::LocalBufferWriter<256> w;
+        auto const &r = run._result;
+        w.print("{:<40} {:>10.2} ns/op {:>8.2} allocs/op {:>10.2} B/op", r._name, r._ns, r._allocs, r._alloc_bytes);
+        if (r._cache_misses >= 0) {
+          w.print(" {:>8.2} misses/op", r._cache_misses);
+        }
+        std::cout << w.view() << std::endl;
+      }
+    }
+  }
+
+  if (json_p) {
+    swoc::LocalBufferWriter<256> w;
+    w.print(R"({{"library":"libswoc","version":"{}.{}.{}","benchmarks":[)", swoc::MAJOR_VERSION, swoc::MINOR_VERSION, swoc::POINT_VERSION);
+    std::cout << w.view();
+    char const *sep = "";
+    for (auto const &r : results) {
+      w.clear().print(R"({}{{"name":"{}","iterations":{},"ns_per_op":{:.3},"ns_per_op_min":{:.3},"allocs_per_op":{:.3},)"
+                      R"("alloc_bytes_per_op":{:.3},"cache_misses_per_op":)",
+                      sep, r._name, r._iterations, r._ns, r._ns_min, r._allocs, r._alloc_bytes);
+      if (r._cache_misses >= 0) {
+        w.print("{:.3}}}", r._cache_misses);
+      } else {
+        w.write("null}");
+      }
+      std::cout << w.view();
+      sep = ",";
+    }
+    std::cout << "]}" << std::endl;
+  }
+  return 0;
+}
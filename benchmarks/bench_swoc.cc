@@ -0,0 +1,1077 @@
+/** @file
+
+    Benchmarks of core library operations.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "swoc/AtomTable.h"
+#include "swoc/BufferWriter.h"
+#include "swoc/IntrusiveHashMap.h"
+#include "swoc/IntrusiveQueue.h"
+#include "swoc/IntrusiveRBMap.h"
+#include "swoc/Lexicon.h"
+#include "swoc/MemArena.h"
+#include "swoc/OffsetPtr.h"
+#include "swoc/RecordTokenizer.h"
+#include "swoc/ShardedScalar.h"
+#include "swoc/TextView.h"
+#include "swoc/bwf_base.h"
+#include "swoc/bwf_ip.h"
+#include "swoc/bwf_std.h"
+#include "swoc/ext/HashFNV.h"
+#include "swoc/swoc_file.h"
+#include "swoc/swoc_ip.h"
+
+#include "bench.h"
+
+using swoc::IP4Addr;
+using swoc::IP4Range;
+using swoc::IPAddr;
+using swoc::MemArena;
+using swoc::RecordTokenizer;
+using swoc::TextView;
+using namespace std::literals;
+
+namespace
+{
+// --- Data sets. These are generated from a fixed seed so every run uses the same data.
+
+/// Synthetic CIDR list, in the style of a geo IP or ACL list - mostly /16 to /28 networks.
+std::vector<std::string> const &
+Cidr_Texts()
+{
+  static std::vector<std::string> texts = [] {
+    std::vector<std::string> zret;
+    uint64_t state = 1;
+    for (int i = 0; i < 10000; ++i) {
+      auto r    = bench::next_random(state);
+      auto bits = 16 + r % 13;
+      auto addr = uint32_t(r >> 32) & ~((uint32_t(1) << (32 - bits)) - 1);
+      std::string text;
+      swoc::bwprint(text, "{}/{}", IP4Addr(addr), bits);
+      zret.push_back(std::move(text));
+    }
+    return zret;
+  }();
+  return texts;
+}
+
+/// Header fields in a typical request or response.
+std::vector<std::string> const &
+Header_Corpus()
+{
+  static std::vector<std::string> lines = [] {
+    static constexpr std::string_view NAMES[] = {
+      "Host"sv, "User-Agent"sv, "Accept"sv, "Accept-Encoding"sv, "Accept-Language"sv, "Cache-Control"sv,
+      "Connection"sv, "Content-Length"sv, "Content-Type"sv, "Cookie"sv, "Date"sv, "ETag"sv,
+      "If-None-Match"sv, "Last-Modified"sv, "Referer"sv, "Server"sv, "Set-Cookie"sv, "Via"sv,
+      "X-Forwarded-For"sv, "X-Request-Id"sv, "Age"sv, "Expires"sv, "Vary"sv, "Transfer-Encoding"sv};
+    static constexpr std::string_view VALUES[] = {
+      "www.example.com"sv, "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)"sv,
+      "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"sv, "gzip, deflate, br"sv, "en-US,en;q=0.5"sv,
+      "max-age=0, no-cache"sv, "keep-alive"sv, "1234"sv, "application/json; charset=utf-8"sv,
+      "session=5f2b8c1a9e7d4f3b; theme=dark; lang=en"sv, "Tue, 13 Oct 2026 10:12:31 GMT"sv, "\"33a64df551425fcc55e4d42a148795d9f25f89d4\""sv};
+    std::vector<std::string> zret;
+    uint64_t state = 2;
+    for (int i = 0; i < 4096; ++i) {
+      auto r = bench::next_random(state);
+      std::string line{NAMES[r % std::size(NAMES)]};
+      line += ": "sv;
+      line += VALUES[(r >> 32) % std::size(VALUES)];
+      zret.push_back(std::move(line));
+    }
+    return zret;
+  }();
+  return lines;
+}
+
+/// Chunks of CSV records, in the style of an access log export - 64 records of 8 fields per chunk.
+std::vector<std::string> const &
+Csv_Corpus()
+{
+  static std::vector<std::string> chunks = [] {
+    std::vector<std::string> zret;
+    uint64_t state = 3;
+    for (int i = 0; i < 64; ++i) {
+      std::string chunk, line;
+      for (int k = 0; k < 64; ++k) {
+        auto r = bench::next_random(state);
+        swoc::bwprint(line, "{},{},GET,/path/{:x}/index.html,{},{},{},Mozilla/5.0 (X11; Linux x86_64)\n", 1700000000 + k,
+                      IP4Addr(uint32_t(r >> 32)), r & 0xFFFFFF, 200 + r % 5, r % 100000, (r >> 16) % 1000);
+        chunk += line;
+      }
+      zret.push_back(std::move(chunk));
+    }
+    return zret;
+  }();
+  return chunks;
+}
+
+// --- AtomTable
+
+namespace
+{
+std::vector<std::string> const &
+Header_Names()
+{
+  static std::vector<std::string> names{"Accept",        "Accept-Encoding", "Accept-Language", "Authorization",
+                                        "Cache-Control", "Connection",      "Content-Length",  "Content-Type",
+                                        "Cookie",        "Date",            "Host",            "If-Modified-Since",
+                                        "If-None-Match", "Origin",          "Pragma",          "Referer",
+                                        "User-Agent",    "Via",             "X-Forwarded-For", "X-Request-Id"};
+  return names;
+}
+} // namespace
+
+void
+Header_Match_Strcasecmp(bench::Run &run)
+{
+  // Incoming names in mixed case, matched against the known names ignoring case.
+  auto const &names = Header_Names();
+  std::vector<std::string> incoming;
+  for (auto const &name : names) {
+    std::string text{name};
+    for (auto &c : text) {
+      c = tolower(c);
+    }
+    incoming.push_back(text);
+  }
+  run.measure([&](size_t i) {
+    auto const &text = incoming[i % incoming.size()];
+    size_t idx       = 0;
+    while (idx < names.size() && 0 != strcasecmp(std::string_view{text}, std::string_view{names[idx]})) {
+      ++idx;
+    }
+    bench::keep(idx);
+  });
+}
+BENCHMARK("header match strcasecmp", Header_Match_Strcasecmp);
+
+void
+Header_Match_Atom(bench::Run &run)
+{
+  // The incoming names are interned once, when parsed, and then matched by the folded atoms.
+  swoc::AtomTable table;
+  auto const &names = Header_Names();
+  std::vector<swoc::Atom> known, incoming;
+  for (auto const &name : names) {
+    known.push_back(table.intern(name).folded());
+    std::string text{name};
+    for (auto &c : text) {
+      c = tolower(c);
+    }
+    incoming.push_back(table.intern(text));
+  }
+  run.measure([&](size_t i) {
+    auto atom  = incoming[i % incoming.size()].folded();
+    size_t idx = 0;
+    while (idx < known.size() && atom != known[idx]) {
+      ++idx;
+    }
+    bench::keep(idx);
+  });
+}
+BENCHMARK("header match Atom", Header_Match_Atom);
+
+void
+Header_Intern(bench::Run &run)
+{
+  swoc::AtomTable table;
+  auto const &names = Header_Names();
+  for (auto const &name : names) {
+    table.intern(name);
+  }
+  run.measure([&](size_t i) { bench::keep(table.intern(names[i % names.size()]).hash()); });
+}
+BENCHMARK("AtomTable::intern hit", Header_Intern);
+
+void
+Header_Intern_Shared(bench::Run &run)
+{
+  swoc::AtomTable table{swoc::AtomTable::SHARED};
+  auto const &names = Header_Names();
+  for (auto const &name : names) {
+    table.intern(name);
+  }
+  run.measure([&](size_t i) { bench::keep(table.intern(names[i % names.size()]).hash()); });
+}
+BENCHMARK("AtomTable::intern hit shared", Header_Intern_Shared);
+
+// --- Lexicon
+
+namespace
+{
+/// Header lines, with the header names in mixed case.
+std::vector<std::string>
+Header_Lines()
+{
+  std::vector<std::string> lines;
+  unsigned idx = 0;
+  for (auto const &name : Header_Names()) {
+    std::string text{name};
+    for (auto &c : text) {
+      c = (idx++ & 1) ? toupper(c) : tolower(c);
+    }
+    lines.push_back(text + ": value");
+  }
+  lines.push_back("X-Unknown-Header: value");
+  return lines;
+}
+
+void
+Header_Lexicon(swoc::Lexicon<int> &lex)
+{
+  lex.set_default(-1);
+  int value = 0;
+  for (auto const &name : Header_Names()) {
+    lex.define(value++, name);
+  }
+  lex.compile();
+}
+} // namespace
+
+void
+Header_Lookup_Tokenize(bench::Run &run)
+{
+  // Find the end of the name, then look it up.
+  swoc::Lexicon<int> lex;
+  Header_Lexicon(lex);
+  auto lines = Header_Lines();
+  run.measure([&](size_t i) {
+    swoc::TextView line{lines[i % lines.size()]};
+    auto name = line.take_prefix_at(':');
+    bench::keep(lex[name]);
+  });
+}
+BENCHMARK("header lookup tokenize+Lexicon", Header_Lookup_Tokenize);
+
+void
+Header_Lookup_Matcher(bench::Run &run)
+{
+  // Match the name while scanning for its end.
+  static constexpr swoc::CharSet DELIMITERS{":"};
+  swoc::Lexicon<int> lex;
+  Header_Lexicon(lex);
+  auto m     = lex.matcher();
+  auto lines = Header_Lines();
+  run.measure([&](size_t i) {
+    auto match = m.token(lines[i % lines.size()], DELIMITERS);
+    bench::keep(match ? match._value : -1);
+  });
+}
+BENCHMARK("header lookup Lexicon::Matcher", Header_Lookup_Matcher);
+
+// --- MemArena
+
+void
+Arena_Alloc(bench::Run &run)
+{
+  MemArena arena;
+  uint64_t state = 3;
+  std::vector<size_t> sizes;
+  for (int i = 0; i < 1024; ++i) {
+    sizes.push_back(8 + bench::next_random(state) % 120);
+  }
+  run.measure([&](size_t i) {
+    if ((i & 0xFFFF) == 0) {
+      arena.clear();
+    }
+    bench::keep(arena.alloc(sizes[i & 1023]).data());
+  });
+}
+BENCHMARK("MemArena::alloc", Arena_Alloc);
+
+namespace
+{
+/// A configuration graph built from the CIDR data.
+struct ConfigNode {
+  swoc::OffsetPtr<ConfigNode> _next;
+  swoc::OffsetPtr<char> _text;
+  IP4Range _range;
+};
+
+ConfigNode *
+Config_Build(MemArena &arena)
+{
+  ConfigNode *head = nullptr;
+  for (auto const &text : Cidr_Texts()) {
+    auto node    = arena.make<ConfigNode>();
+    node->_range = IP4Range{text};
+    auto span    = arena.alloc(text.size() + 1).rebind<char>();
+    std::memcpy(span.data(), text.c_str(), span.size());
+    node->_text = span.data();
+    node->_next  = head;
+    head         = node;
+  }
+  return head;
+}
+
+size_t
+Config_Walk(ConfigNode const *head)
+{
+  size_t zret = 0;
+  for (auto node = head; node; node = node->_next) {
+    zret += node->_range.min().host_order() + node->_text.get()[0];
+  }
+  return zret;
+}
+} // namespace
+
+void
+Arena_Config_Rebuild(bench::Run &run)
+{
+  run.measure([&](size_t) {
+    MemArena arena;
+    bench::keep(Config_Walk(Config_Build(arena)));
+  });
+}
+BENCHMARK("MemArena config rebuild", Arena_Config_Rebuild);
+
+void
+Arena_Config_Image(bench::Run &run)
+{
+  char name[] = "/tmp/swoc_bench_image.XXXXXX";
+  ::close(::mkstemp(name));
+  swoc::file::path path{name};
+  std::error_code ec;
+  {
+    MemArena::RegionSource source{1 << 26};
+    MemArena arena{&source};
+    auto head = Config_Build(arena);
+    arena.freeze();
+    MemArena::Image::write(path, arena, source, head, ec);
+  }
+  run.measure([&](size_t) {
+    auto image = MemArena::Image::load(path, ec);
+    bench::keep(Config_Walk(image.root<ConfigNode const>()));
+  });
+  ::unlink(name);
+}
+BENCHMARK("MemArena::Image config load", Arena_Config_Image);
+
+// --- IntrusiveHashMap
+
+struct Field {
+  std::string _name;
+  int _n;
+  Field *_next{nullptr};
+  Field *_prev{nullptr};
+};
+
+struct FieldDescriptor {
+  static Field *&
+  next_ptr(Field *f)
+  {
+    return f->_next;
+  }
+  static Field *&
+  prev_ptr(Field *f)
+  {
+    return f->_prev;
+  }
+  static std::string_view
+  key_of(Field *f)
+  {
+    return f->_name;
+  }
+  static uint64_t
+  hash_of(std::string_view s)
+  {
+    return swoc::Hash64FNV1a().hash_immediate(s);
+  }
+  static bool
+  equal(std::string_view lhs, std::string_view rhs)
+  {
+    return lhs == rhs;
+  }
+};
+
+void
+Hash_Map_Find(bench::Run &run)
+{
+  std::vector<Field> fields;
+  fields.reserve(10000);
+  for (int i = 0; i < 10000; ++i) {
+    std::string name;
+    swoc::bwprint(name, "proxy.config.field.{}.name", i);
+    fields.push_back({std::move(name), i});
+  }
+  swoc::IntrusiveHashMap<FieldDescriptor> map;
+  for (auto &f : fields) {
+    map.insert(&f);
+  }
+  std::vector<std::string_view> keys;
+  uint64_t state = 4;
+  for (int i = 0; i < 4096; ++i) {
+    keys.push_back(fields[bench::next_random(state) % fields.size()]._name);
+  }
+  run.measure([&](size_t i) { bench::keep(map.find(keys[i & 4095])); });
+}
+BENCHMARK("IntrusiveHashMap::find", Hash_Map_Find);
+
+// --- IntrusiveRBMap, as a timer queue - insert at a later time and remove the earliest.
+
+struct Timer : public swoc::RBMapNode {
+  uint64_t _when = 0;
+};
+
+struct TimerDescriptor {
+  static uint64_t
+  key_of(Timer *t)
+  {
+    return t->_when;
+  }
+  static bool
+  less(uint64_t lhs, uint64_t rhs)
+  {
+    return lhs < rhs;
+  }
+};
+
+void
+RB_Map_Timers(bench::Run &run)
+{
+  std::vector<Timer> timers(4096);
+  swoc::IntrusiveRBMap<TimerDescriptor> map;
+  uint64_t state = 5;
+  for (auto &t : timers) {
+    t._when = bench::next_random(state) % 100000;
+    map.insert(&t);
+  }
+  run.measure([&](size_t i) {
+    auto t = &*map.begin();
+    map.erase(t);
+    t->_when += 1 + bench::next_random(state) % 100000;
+    map.insert(t);
+  });
+}
+BENCHMARK("IntrusiveRBMap timers", RB_Map_Timers);
+
+void
+Std_Multimap_Timers(bench::Run &run)
+{
+  std::multimap<uint64_t, int> map;
+  uint64_t state = 5;
+  for (int i = 0; i < 4096; ++i) {
+    map.emplace(bench::next_random(state) % 100000, i);
+  }
+  run.measure([&](size_t i) {
+    auto spot = map.begin();
+    auto when = spot->first + 1 + bench::next_random(state) % 100000;
+    auto id   = spot->second;
+    map.erase(spot);
+    map.emplace(when, id);
+  });
+}
+BENCHMARK("std::multimap timers", Std_Multimap_Timers);
+
+// --- Handoff queues, uncontended. Each iteration is a push and a pop, or a push with a batch pop
+// every 64 pushes.
+
+struct Task {
+  Task *_next = nullptr;
+  Task *_prev = nullptr;
+
+  using Linkage = swoc::IntrusiveLinkage<Task>;
+};
+
+void
+MPSC_Queue_Handoff(bench::Run &run)
+{
+  std::vector<Task> tasks(64);
+  swoc::IntrusiveMPSCQueue<Task::Linkage> q;
+  run.measure([&](size_t i) {
+    q.push(&tasks[i % tasks.size()]);
+    bench::keep(q.pop());
+  });
+}
+BENCHMARK("IntrusiveMPSCQueue handoff", MPSC_Queue_Handoff);
+
+void
+MPSC_Queue_Batch(bench::Run &run)
+{
+  std::vector<Task> tasks(64);
+  swoc::IntrusiveMPSCQueue<Task::Linkage> q;
+  run.measure([&](size_t i) {
+    q.push(&tasks[i % tasks.size()]);
+    if (i % tasks.size() == tasks.size() - 1) {
+      bench::keep(q.pop_all().count());
+    }
+  });
+}
+BENCHMARK("IntrusiveMPSCQueue handoff batch", MPSC_Queue_Batch);
+
+void
+SPSC_Ring_Handoff(bench::Run &run)
+{
+  std::vector<Task> tasks(64);
+  swoc::IntrusiveSPSCRing<Task::Linkage> ring{64};
+  run.measure([&](size_t i) {
+    ring.push(&tasks[i % tasks.size()]);
+    bench::keep(ring.pop());
+  });
+}
+BENCHMARK("IntrusiveSPSCRing handoff", SPSC_Ring_Handoff);
+
+void
+Mutex_List_Handoff(bench::Run &run)
+{
+  std::vector<Task> tasks(64);
+  std::mutex mutex;
+  swoc::IntrusiveDList<Task::Linkage> list;
+  run.measure([&](size_t i) {
+    {
+      std::lock_guard lock(mutex);
+      list.append(&tasks[i % tasks.size()]);
+    }
+    std::lock_guard lock(mutex);
+    bench::keep(list.take_head());
+  });
+}
+BENCHMARK("mutex IntrusiveDList handoff", Mutex_List_Handoff);
+
+void
+Mutex_List_Batch(bench::Run &run)
+{
+  std::vector<Task> tasks(64);
+  std::mutex mutex;
+  swoc::IntrusiveDList<Task::Linkage> list;
+  run.measure([&](size_t i) {
+    std::lock_guard lock(mutex);
+    list.append(&tasks[i % tasks.size()]);
+    if (i % tasks.size() == tasks.size() - 1) {
+      swoc::IntrusiveDList<Task::Linkage> batch{std::move(list)};
+      bench::keep(batch.count());
+    }
+  });
+}
+BENCHMARK("mutex IntrusiveDList handoff batch", Mutex_List_Batch);
+
+// --- DiscreteSpace, via IPSpace.
+
+void
+Space_Mark(bench::Run &run)
+{
+  std::vector<IP4Range> ranges;
+  for (auto const &text : Cidr_Texts()) {
+    ranges.emplace_back(text);
+  }
+  swoc::IPSpace<unsigned> space;
+  run.measure([&](size_t i) {
+    if (i % ranges.size() == 0) {
+      space.clear();
+    }
+    space.mark(ranges[i % ranges.size()], unsigned(i & 7));
+  });
+}
+BENCHMARK("DiscreteSpace::mark", Space_Mark);
+
+void
+Space_Find(bench::Run &run)
+{
+  swoc::IPSpace<unsigned> space;
+  unsigned n = 0;
+  for (auto const &text : Cidr_Texts()) {
+    space.mark(IP4Range{text}, n++ & 7);
+  }
+  std::vector<IP4Addr> addrs;
+  uint64_t state = 5;
+  for (int i = 0; i < 4096; ++i) {
+    addrs.emplace_back(uint32_t(bench::next_random(state)));
+  }
+  run.measure([&](size_t i) { bench::keep(space.find(addrs[i & 4095])); });
+}
+BENCHMARK("DiscreteSpace::find", Space_Find);
+
+void
+Space_Find_IP6(bench::Run &run)
+{
+  // The IPv4 data set, mapped in to an IPv6 prefix.
+  auto to_ip6 = [](uint32_t addr) {
+    in6_addr a6{};
+    a6.s6_addr[0] = 0x20;
+    a6.s6_addr[1] = 0x01;
+    a6.s6_addr[2] = 0x0d;
+    a6.s6_addr[3] = 0xb8;
+    for (int k = 0; k < 4; ++k) {
+      a6.s6_addr[12 + k] = addr >> (24 - 8 * k);
+    }
+    return swoc::IP6Addr{a6};
+  };
+  swoc::DiscreteSpace<swoc::IP6Addr, unsigned> space;
+  unsigned n = 0;
+  for (auto const &text : Cidr_Texts()) {
+    IP4Range r{text};
+    space.mark(swoc::DiscreteRange<swoc::IP6Addr>{to_ip6(r.min().host_order()), to_ip6(r.max().host_order())}, n++ & 7);
+  }
+  std::vector<swoc::IP6Addr> addrs;
+  uint64_t state = 5;
+  for (int i = 0; i < 4096; ++i) {
+    addrs.push_back(to_ip6(uint32_t(bench::next_random(state))));
+  }
+  run.measure([&](size_t i) { bench::keep(space.find(addrs[i & 4095])); });
+}
+BENCHMARK("DiscreteSpace::find IPv6", Space_Find_IP6);
+
+void
+Space_Merge(bench::Run &run)
+{
+  swoc::IPSpace<unsigned> lhs, rhs, result;
+  unsigned n = 0;
+  for (auto const &text : Cidr_Texts()) {
+    (n & 1 ? lhs : rhs).mark(IP4Range{text}, n & 7);
+    ++n;
+  }
+  run.measure([&](size_t) {
+    result.merge(lhs, rhs, [](unsigned &r, unsigned const *a, unsigned const *b) {
+      r = a ? *a : *b;
+      return true;
+    }, 1);
+    bench::keep(result.count());
+  });
+}
+BENCHMARK("DiscreteSpace::merge", Space_Merge);
+
+void
+Space_Startup_Text(bench::Run &run)
+{
+  auto const &texts = Cidr_Texts();
+  run.measure([&](size_t) {
+    swoc::IPSpace<unsigned> space;
+    unsigned n = 0;
+    for (auto const &text : texts) {
+      space.mark(IP4Range{text}, n++ & 7);
+    }
+    bench::keep(space.freeze().count());
+  });
+}
+BENCHMARK("IPSpace::Frozen startup from text", Space_Startup_Text);
+
+void
+Space_Startup_Image(bench::Run &run)
+{
+  swoc::IPSpace<unsigned> space;
+  unsigned n = 0;
+  for (auto const &text : Cidr_Texts()) {
+    space.mark(IP4Range{text}, n++ & 7);
+  }
+  auto frozen = space.freeze();
+  // Page aligned, as from a memory map.
+  auto size = (frozen.image_size() + 4095) & ~size_t(4095);
+  std::unique_ptr<char, decltype(&::free)> buff{static_cast<char *>(::aligned_alloc(4096, size)), &::free};
+  auto image = frozen.write_image(swoc::MemSpan<char>{buff.get(), frozen.image_size()});
+  run.measure([&](size_t) {
+    swoc::IPSpace<unsigned>::Frozen loaded;
+    loaded.attach(swoc::MemSpan<char const>{image.data(), image.size()});
+    bench::keep(loaded.count());
+  });
+}
+BENCHMARK("IPSpace::Frozen startup from image", Space_Startup_Image);
+
+// --- IP address parsing.
+
+void
+IP_Load(bench::Run &run)
+{
+  std::vector<TextView> texts;
+  for (auto const &text : Cidr_Texts()) {
+    texts.push_back(TextView{text}.prefix_at('/'));
+  }
+  IPAddr addr;
+  run.measure([&](size_t i) {
+    addr.load(texts[i % texts.size()]);
+    bench::keep(addr);
+  });
+}
+BENCHMARK("IPAddr::load", IP_Load);
+
+// --- Connection table lookup by the socket address of a packet, half IPv4 and half IPv6.
+
+struct Connection {
+  swoc::IPEndpoint _ep;
+  swoc::IPKey _key;
+  Connection *_next = nullptr;
+  Connection *_prev = nullptr;
+
+  struct Linkage : public swoc::IntrusiveLinkage<Connection> {};
+
+  /// Key by the endpoint, hashing the address and port bytes.
+  struct EndpointDescriptor : public Linkage {
+    static sockaddr const *
+    key_of(Connection *c)
+    {
+      return &c->_ep.sa;
+    }
+    static uint64_t
+    hash_of(sockaddr const *sa)
+    {
+      swoc::Hash64FNV1a h;
+      auto port = swoc::IPEndpoint::port(sa);
+      h.update({reinterpret_cast<char const *>(&port), sizeof(port)});
+      if (sa->sa_family == AF_INET) {
+        auto sin = reinterpret_cast<sockaddr_in const *>(sa);
+        h.update({reinterpret_cast<char const *>(&sin->sin_addr), sizeof(sin->sin_addr)});
+      } else {
+        auto sin6 = reinterpret_cast<sockaddr_in6 const *>(sa);
+        h.update({reinterpret_cast<char const *>(&sin6->sin6_addr), sizeof(sin6->sin6_addr)});
+      }
+      return h.final().get();
+    }
+    static bool
+    equal(sockaddr const *lhs, sockaddr const *rhs)
+    {
+      return swoc::IPEndpoint::port(lhs) == swoc::IPEndpoint::port(rhs) && swoc::IPAddr{lhs} == swoc::IPAddr{rhs};
+    }
+  };
+
+  struct KeyDescriptor : public Linkage, public swoc::IPKey::HashDescriptor {
+    static swoc::IPKey const &
+    key_of(Connection *c)
+    {
+      return c->_key;
+    }
+  };
+};
+
+std::vector<Connection> &
+Connections()
+{
+  static std::vector<Connection> conns;
+  if (conns.empty()) {
+    conns.resize(10000);
+    uint64_t state = 11;
+    for (size_t i = 0; i < conns.size(); ++i) {
+      auto port = htons(1024 + bench::next_random(state) % 60000);
+      if (i & 1) {
+        in6_addr a;
+        auto r0 = bench::next_random(state), r1 = bench::next_random(state);
+        memcpy(a.s6_addr, &r0, 8);
+        memcpy(a.s6_addr + 8, &r1, 8);
+        conns[i]._ep.assign(IPAddr{a}, port);
+      } else {
+        conns[i]._ep.assign(IPAddr{in_addr_t(bench::next_random(state))}, port);
+      }
+      conns[i]._key.assign(&conns[i]._ep.sa);
+    }
+  }
+  return conns;
+}
+
+std::vector<swoc::IPEndpoint>
+Packet_Sources()
+{
+  std::vector<swoc::IPEndpoint> zret;
+  uint64_t state = 12;
+  auto &conns    = Connections();
+  for (int i = 0; i < 4096; ++i) {
+    zret.push_back(conns[bench::next_random(state) % conns.size()]._ep);
+  }
+  return zret;
+}
+
+void
+Conn_Find_Endpoint(bench::Run &run)
+{
+  swoc::IntrusiveHashMap<Connection::EndpointDescriptor> map;
+  for (auto &c : Connections()) {
+    map.insert(&c);
+  }
+  auto srcs = Packet_Sources();
+  run.measure([&](size_t i) { bench::keep(map.find(&srcs[i & 4095].sa)); });
+}
+BENCHMARK("connection find IPEndpoint FNV", Conn_Find_Endpoint);
+
+void
+Conn_Find_Key(bench::Run &run)
+{
+  swoc::IntrusiveHashMap<Connection::KeyDescriptor> map;
+  for (auto &c : Connections()) {
+    map.insert(&c);
+  }
+  auto srcs = Packet_Sources();
+  run.measure([&](size_t i) { bench::keep(map.find(swoc::IPKey{srcs[i & 4095]})); });
+}
+BENCHMARK("connection find IPKey", Conn_Find_Key);
+
+// --- TextView
+
+void
+TextView_Tokenize(bench::Run &run)
+{
+  auto const &lines = Header_Corpus();
+  run.measure([&](size_t i) {
+    TextView line{lines[i & 4095]};
+    auto name = line.take_prefix_at(':');
+    line.ltrim_if(&isspace);
+    size_t n = 0;
+    while (line) {
+      auto token = line.take_prefix_at(',').trim_if(&isspace);
+      n += token.size();
+    }
+    bench::keep(name);
+    bench::keep(n);
+  });
+}
+BENCHMARK("TextView tokenize", TextView_Tokenize);
+
+void
+TextView_Split_Records(bench::Run &run)
+{
+  auto const &chunks = Csv_Corpus();
+  std::vector<TextView> fields;
+  run.measure([&](size_t i) {
+    TextView text{chunks[i & 63]};
+    size_t n = 0;
+    while (text) {
+      auto line = text.take_prefix_at('\n');
+      fields.clear();
+      while (line) {
+        fields.push_back(line.take_prefix_at(','));
+      }
+      n += fields.size();
+    }
+    bench::keep(n);
+  });
+}
+BENCHMARK("TextView split records", TextView_Split_Records);
+
+void
+Record_Tokenizer(bench::Run &run)
+{
+  auto const &chunks = Csv_Corpus();
+  std::vector<TextView> fields;
+  run.measure([&](size_t i) {
+    RecordTokenizer tokens{chunks[i & 63]};
+    size_t n = 0;
+    while (tokens.next(fields)) {
+      n += fields.size();
+    }
+    bench::keep(n);
+  });
+}
+BENCHMARK("RecordTokenizer", Record_Tokenizer);
+
+void
+Record_Tokenizer_Project(bench::Run &run)
+{
+  auto const &chunks = Csv_Corpus();
+  std::vector<TextView> fields;
+  run.measure([&](size_t i) {
+    RecordTokenizer tokens{chunks[i & 63]};
+    tokens.project({1, 4});
+    size_t n = 0;
+    while (tokens.next(fields)) {
+      n += fields[1].size();
+    }
+    bench::keep(n);
+  });
+}
+BENCHMARK("RecordTokenizer projected", Record_Tokenizer_Project);
+
+// --- Loading a set of small configuration fragments.
+
+std::vector<swoc::file::path> const &
+Fragment_Paths()
+{
+  static std::vector<swoc::file::path> paths;
+  if (paths.empty()) {
+    char tmpl[] = "/tmp/swoc_bench_XXXXXX";
+    swoc::file::path dir{::mkdtemp(tmpl)};
+    std::string text;
+    for (int i = 0; i < 32; ++i) {
+      swoc::bwprint(text, "fragment.{} = {}\n", i, std::string(100 + i * 20, 'x'));
+      paths.push_back(dir / swoc::bwprint(text, "{}.config", i));
+      int fd = ::open(paths.back().c_str(), O_WRONLY | O_CREAT, 0600);
+      bench::keep(::write(fd, text.data(), text.size()));
+      ::close(fd);
+    }
+  }
+  return paths;
+}
+
+void
+File_Load_Fragments(bench::Run &run)
+{
+  auto &paths = Fragment_Paths();
+  run.measure([&](size_t) {
+    std::error_code ec;
+    for (auto const &p : paths) {
+      bench::keep(swoc::file::load(p, ec).size());
+    }
+  });
+}
+BENCHMARK("file::load 32 fragments", File_Load_Fragments);
+
+void
+Async_Load_Fragments(bench::Run &run)
+{
+  auto &paths = Fragment_Paths();
+  swoc::MemArena arena;
+  swoc::file::async_loader loader{arena};
+  run.measure([&](size_t) {
+    size_t n = 0;
+    for (auto const &p : paths) {
+      loader.load(p, [&](swoc::file::path const &, swoc::TextView content, std::error_code) { n += content.size(); });
+    }
+    loader.wait();
+    bench::keep(n);
+    arena.clear();
+  });
+}
+BENCHMARK("file::async_loader 32 fragments", Async_Load_Fragments);
+
+// --- BufferWriter
+
+void
+BW_Print_Log(bench::Run &run)
+{
+  // A typical access log line.
+  static const swoc::bwf::Format fmt{"{} - - [{}] \"{} {} HTTP/1.1\" {} {} \"{}\" \"{}\" {}"};
+  auto const &lines = Header_Corpus();
+  std::vector<IP4Addr> addrs;
+  uint64_t state = 6;
+  for (int i = 0; i < 4096; ++i) {
+    addrs.emplace_back(uint32_t(bench::next_random(state)));
+  }
+  swoc::LocalBufferWriter<1024> w;
+  run.measure([&](size_t i) {
+    w.clear().print(fmt, addrs[i & 4095], "13/Oct/2026:10:12:31 +0000"sv, "GET"sv, "/index.html?id=12345"sv, 200, i & 0xFFFF,
+                    TextView{lines[i & 4095]}.prefix(24), "Mozilla/5.0"sv, 0.125 * (i & 31));
+    bench::keep(w.size());
+  });
+}
+BENCHMARK("BufferWriter::print log", BW_Print_Log);
+
+void
+BW_Print_IP(bench::Run &run)
+{
+  std::vector<IPAddr> addrs;
+  uint64_t state = 7;
+  for (int i = 0; i < 4096; ++i) {
+    auto r = bench::next_random(state);
+    if (i & 1) {
+      addrs.emplace_back(IP4Addr(uint32_t(r)));
+    } else {
+      // Typical IPv6 addresses have a zero run.
+      in6_addr a6{};
+      a6.s6_addr[0] = 0x20;
+      a6.s6_addr[1] = 0x01;
+      for (int k = 10; k < 16; ++k) {
+        a6.s6_addr[k] = r >> (8 * k - 80);
+      }
+      addrs.emplace_back(a6);
+    }
+  }
+  swoc::LocalBufferWriter<256> w;
+  run.measure([&](size_t i) {
+    w.clear().print("{}", addrs[i & 4095]);
+    bench::keep(w.size());
+  });
+}
+BENCHMARK("BufferWriter::print IPAddr", BW_Print_IP);
+
+/// Names for a log format, each of which writes a short fixed value.
+swoc::bwf::ExternalNames &
+Log_Names()
+{
+  static swoc::bwf::ExternalNames names = [] {
+    swoc::bwf::ExternalNames zret;
+    for (auto name : {"chi", "caun", "cqtx", "pssc", "psql", "cquc", "cqhv", "cqh", "phr", "pqsn", "crc", "sssc", "ttms",
+                      "cqtd", "cqtt", "pitag", "cluc", "cqlm", "cqhl", "cqbl"}) {
+      zret.assign(name, [](swoc::BufferWriter &w, swoc::bwf::Spec const &spec) -> swoc::BufferWriter & {
+        return bwformat(w, spec, "value"sv);
+      });
+    }
+    return zret;
+  }();
+  return names;
+}
+
+constexpr std::string_view LOG_FORMAT{"{chi} - {caun} [{cqtx}] {pssc} {psql} {cquc} {cqhv} {cqh} {phr} {pqsn} {crc} {sssc} "
+                                      "{ttms} {cqtd} {cqtt} {pitag} {cluc} {cqlm} {cqhl} {cqbl}"};
+
+void
+BW_Print_Names(bench::Run &run)
+{
+  static const swoc::bwf::Format fmt{LOG_FORMAT};
+  auto &names = Log_Names();
+  swoc::LocalBufferWriter<1024> w;
+  run.measure([&](size_t) {
+    w.clear().print_nfv(names.bind(), fmt.bind());
+    bench::keep(w.size());
+  });
+}
+BENCHMARK("BufferWriter::print names", BW_Print_Names);
+
+void
+BW_Print_Bound_Names(bench::Run &run)
+{
+  static const swoc::bwf::BoundFormat<swoc::bwf::ExternalGeneratorSignature> fmt{LOG_FORMAT, Log_Names()};
+  swoc::LocalBufferWriter<1024> w;
+  run.measure([&](size_t) {
+    w.clear().print(fmt);
+    bench::keep(w.size());
+  });
+}
+BENCHMARK("BufferWriter::print bound names", BW_Print_Bound_Names);
+
+// --- Statistics counters, the cost of an increment on the hot path.
+
+using Bytes = swoc::Scalar<1, uint64_t>;
+
+void
+Counter_Local(bench::Run &run)
+{
+  Bytes bytes;
+  run.measure([&](size_t i) {
+    bytes += Bytes(i & 0xFF);
+    bench::keep(bytes.count());
+  });
+}
+BENCHMARK("counter Scalar local", Counter_Local);
+
+void
+Counter_Atomic(bench::Run &run)
+{
+  std::atomic<uint64_t> bytes{0};
+  run.measure([&](size_t i) { bytes.fetch_add(i & 0xFF, std::memory_order_relaxed); });
+  bench::keep(bytes.load());
+}
+BENCHMARK("counter std::atomic", Counter_Atomic);
+
+void
+Counter_Sharded(bench::Run &run)
+{
+  swoc::ShardedScalar<Bytes> bytes;
+  run.measure([&](size_t i) { bytes.inc(i & 0xFF); });
+  bench::keep(bytes.fold().count());
+}
+BENCHMARK("counter ShardedScalar", Counter_Sharded);
+
+} // namespace
@@ -6,6 +6,9 @@
  */
 #pragma once
 
+#include <vector>
+#include <sys/uio.h>
+
 #include "swoc/MemSpan.h"
 #include "swoc/bwf_base.h"
 #include "swoc/MemArena.h"
@@ -59,6 +62,149 @@ protected:
   void realloc(size_t n);
 };
 
+/** Buffer writer for a @c MemArena that does not copy on growth.
+ *
+ * Output is written to a chain of segments allocated from the arena. When a segment is full a new
+ * one is allocated and writing continues there, previous output is never copied. The output is
+ * available as a list of @c iovec for use with @c writev or @c sendmsg. If contiguous output is
+ * required, @c view copies the segments to a single arena allocation.
+ *
+ * There is no capacity limit, and so this never has an error and @c restrict and @c restore have
+ * no effect. Segments are allocated in the arena as they are needed, and are not released until
+ * the arena is cleared.
+ */
+class SegmentedArenaWriter : public BufferWriter {
+  using self_type  = SegmentedArenaWriter; ///< Self reference type.
+  using super_type = BufferWriter;         ///< Parent type.
+public:
+  /// Default initial segment size.
+  static constexpr size_t DEFAULT_SEGMENT_SIZE = 1024;
+  /// Maximum segment size, unless a single write requires more.
+  static constexpr size_t MAX_SEGMENT_SIZE = 1 << 16;
+
+  /** Constructor.
+   *
+   * @param arena Arena to use for storage.
+   * @param segment_size Size of the first segment. Later segments double in size up to @c MAX_SEGMENT_SIZE.
+   */
+  explicit SegmentedArenaWriter(MemArena &arena, size_t segment_size = DEFAULT_SEGMENT_SIZE);
+
+  /// Write a single character @a c to the buffer.
+  self_type &write(char c) override;
+
+  /// Write @a n bytes from @a data to the buffer.
+  self_type &write(void const *data, size_t n) override;
+
+  using super_type::write; // import super class write.
+
+  /// @return The start of the current segment.
+  const char *data() const override;
+
+  /// @return @c false - output is never discarded.
+  bool error() const override;
+
+  /// @return The first unused byte in the current segment.
+  char *aux_data() override;
+
+  /// @return The size of all segments.
+  size_t capacity() const override;
+
+  /// @return The total output.
+  size_t extent() const override;
+
+  /** Mark bytes in the current segment as in use.
+   *
+   * @param n Number of bytes to include in the used buffer.
+   * @return @c true if successful, @c false if a new segment was allocated and the write should be retried.
+   */
+  bool commit(size_t n) override;
+
+  /// Drop @a n characters from the end of the output.
+  self_type &discard(size_t n) override;
+
+  /// No effect, there is no capacity limit.
+  self_type &restrict(size_t n) override;
+
+  /// No effect, there is no capacity limit.
+  self_type &restore(size_t n) override;
+
+  /// Copy data in the output. The regions may span segments.
+  self_type &copy(size_t dst, size_t src, size_t n) override;
+
+  /** The output as a list of segments.
+   *
+   * @return A span of @c iovec, one for each segment.
+   *
+   * The span is invalidated by any further output.
+   */
+  MemSpan<iovec> segments();
+
+  /** The output as contiguous memory.
+   *
+   * @return A view of the output.
+   *
+   * If the output is in more than one segment it is copied to a new arena allocation, which then
+   * becomes the only segment.
+   */
+  std::string_view view();
+
+  /// Output the segments to the @a stream.
+  std::ostream &operator>>(std::ostream &stream) const override;
+
+protected:
+  MemArena &_arena;            ///< Arena for the segments.
+  size_t _segment_size;        ///< Size of the next segment.
+  size_t _prior = 0;           ///< Size of output in previous segments.
+  std::vector<iovec> _segments; ///< Segments, the last is the current segment.
+
+  /** Start a new segment.
+   *
+   * @param n Minimum size of the segment.
+   */
+  void extend(size_t n);
+
+  /// @return Address of output byte at @a offset.
+  char *at(size_t offset);
+};
+
 inline swoc::ArenaWriter::ArenaWriter(swoc::MemArena &arena) : _arena(arena), super_type(arena.remnant()) {}
 
+inline SegmentedArenaWriter::SegmentedArenaWriter(MemArena &arena, size_t segment_size)
+  : _arena(arena), _segment_size(std::max<size_t>(segment_size, 1)) {}
+
+inline const char *
+SegmentedArenaWriter::data() const {
+  return _buffer;
+}
+
+inline bool
+SegmentedArenaWriter::error() const {
+  return false;
+}
+
+inline char *
+SegmentedArenaWriter::aux_data() {
+  return _buffer + _attempted;
+}
+
+inline size_t
+SegmentedArenaWriter::capacity() const {
+  return _prior + _capacity;
+}
+
+inline size_t
+SegmentedArenaWriter::extent() const {
+  return _prior + _attempted;
+}
+
+inline auto
+SegmentedArenaWriter::restrict(size_t) -> self_type & {
+  return *this;
+}
+
+inline auto
+SegmentedArenaWriter::restore(size_t) -> self_type & {
+  return *this;
+}
+
 } // namespace swoc
@@ -0,0 +1,138 @@
+/** @file
+
+    Asynchronous sink for Errata.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "swoc/Errata.h"
+
+namespace swoc
+{
+/** An @c Errata sink that writes to a file descriptor from a background thread.
+
+    Each abandoned @c Errata is formatted in to a ring buffer for the calling thread. Each thread
+    has its own ring, which has a single producer and single consumer, and so this never locks or
+    blocks the calling thread. A background thread drains the rings in batches, writing them to the
+    file descriptor with @c writev.
+
+    If a ring is full the @c Errata is dropped and counted. If a ring is more than half full the
+    background thread is woken immediately rather than waiting for the next interval.
+ */
+class AsyncErrataSink : public Errata::Sink
+{
+  using self_type  = AsyncErrataSink;
+  using super_type = Errata::Sink;
+
+public:
+  /// Default size of the ring for each thread.
+  static constexpr size_t DEFAULT_RING_SIZE = 1 << 16;
+  /// Default maximum time between writes.
+  static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{10};
+
+  /** Construct.
+   *
+   * @param fd File descriptor for output. This is not closed by the sink.
+   * @param ring_size Size of the ring for each thread, rounded up to a power of 2.
+   * @param interval Maximum time between writes.
+   */
+  explicit AsyncErrataSink(int fd, size_t ring_size = DEFAULT_RING_SIZE, std::chrono::milliseconds interval = DEFAULT_INTERVAL);
+
+  AsyncErrataSink(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /// Stop the background thread, after writing anything pending.
+  ~AsyncErrataSink() override;
+
+  /// Format @a erratum in to the ring for this thread.
+  void operator()(Errata const &erratum) const override;
+
+  /// Write everything pending, from the calling thread.
+  void flush() const;
+
+  /// @return The number of @c Errata written.
+  size_t written() const;
+
+  /// @return The number of @c Errata dropped because a ring was full.
+  size_t dropped() const;
+
+  /// @return The number of write failures.
+  size_t errors() const;
+
+protected:
+  struct Ring;
+  /// Thread local access to the rings.
+  struct ThreadRings;
+
+  /// @return The ring for the calling thread, creating it if needed.
+  Ring &local_ring() const;
+
+  /// Write pending data from all rings.
+  /// @return @c true if anything was written.
+  bool drain() const;
+
+  /// Background thread body.
+  void run();
+
+  int _fd;                 ///< Output file descriptor.
+  size_t _ring_size;       ///< Ring size for new rings.
+  uint64_t _id;            ///< Unique identifier, for thread local lookup.
+  std::chrono::milliseconds _interval; ///< Maximum time between writes.
+
+  mutable std::mutex _rings_mutex;                  ///< Protects @a _rings.
+  mutable std::vector<std::shared_ptr<Ring>> _rings; ///< All rings.
+  mutable std::mutex _drain_mutex;                  ///< Serializes draining.
+
+  mutable std::mutex _wake_mutex;          ///< Mutex for @a _wake.
+  mutable std::condition_variable _wake;   ///< Wakes the background thread.
+  std::atomic<bool> _stop_p{false};        ///< Stop the background thread.
+
+  mutable std::atomic<size_t> _written{0}; ///< # of Errata written.
+  mutable std::atomic<size_t> _dropped{0}; ///< # of Errata dropped.
+  mutable std::atomic<size_t> _errors{0};  ///< # of write failures.
+
+  std::thread _thread; ///< Background thread.
+};
+
+inline size_t
+AsyncErrataSink::written() const
+{
+  return _written.load(std::memory_order_relaxed);
+}
+
+inline size_t
+AsyncErrataSink::dropped() const
+{
+  return _dropped.load(std::memory_order_relaxed);
+}
+
+inline size_t
+AsyncErrataSink::errors() const
+{
+  return _errors.load(std::memory_order_relaxed);
+}
+
+} // namespace swoc
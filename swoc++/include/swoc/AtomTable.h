@@ -0,0 +1,328 @@
+/** @file
+
+  Interned strings.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string_view>
+
+#include "swoc/IntrusiveHashMap.h"
+#include "swoc/MemArena.h"
+
+namespace swoc
+{
+class AtomTable;
+
+/** An interned string.
+
+    An atom is a handle for a string in an @c AtomTable. The table has a single atom for each
+    distinct string, so two atoms from the same table are equal exactly when the handles are equal,
+    which is a pointer compare. Each atom also refers to its case folded (lower case) form, which is
+    an atom in the same table, so comparing ignoring case is also a pointer compare.
+
+    The hash of an atom is computed once when it is interned. It is case insensitive, so atoms that
+    differ only in case have the same hash and it can be used for both kinds of comparison.
+
+    Atoms are valid until the table is cleared or destroyed.
+ */
+class Atom
+{
+  using self_type = Atom; ///< Self reference type.
+  friend AtomTable;
+
+public:
+  /// Construct the null atom, which is the empty string.
+  Atom() = default;
+
+  /// @return The text, which is nul terminated.
+  std::string_view view() const;
+
+  /// @return The text.
+  operator std::string_view() const;
+
+  /// @return A pointer to the text, which is nul terminated.
+  char const *c_str() const;
+
+  /// @return The length of the text.
+  size_t size() const;
+
+  /// @return @c true if not the null atom.
+  explicit operator bool() const;
+
+  /// @return The case insensitive hash of the text.
+  uint64_t hash() const;
+
+  /// @return The atom for the lower case form of the text.
+  self_type folded() const;
+
+  /// @return @c true if @a this and @a that are the same ignoring case.
+  bool equal_nocase(self_type const &that) const;
+
+  bool operator==(self_type const &that) const;
+  bool operator!=(self_type const &that) const;
+
+  /// Hash functor for containers keyed by atoms.
+  struct Hash {
+    size_t operator()(self_type const &atom) const;
+  };
+
+  /// Case insensitive equality functor, for use with @c Hash.
+  struct EqualNoCase {
+    bool operator()(self_type const &lhs, self_type const &rhs) const;
+  };
+
+protected:
+  /// Storage for an atom.
+  struct Data {
+    Data *_next{nullptr};    ///< Forward link for the index.
+    Data *_prev{nullptr};    ///< Backward link for the index.
+    uint64_t _hash;          ///< Case insensitive hash of @a _text.
+    Data const *_folded;     ///< Case folded form, which may be @a this.
+    std::string_view _text;  ///< Text, nul terminated.
+  };
+
+  Data const *_data = nullptr; ///< Storage, or @c nullptr for the null atom.
+
+  /// Construct from storage.
+  explicit Atom(Data const *data);
+};
+
+/** A table of interned strings.
+
+    Strings are copied in to a @c MemArena which is owned by the table, and indexed by an
+    @c IntrusiveHashMap with the atom storage as the elements, so that interning a string allocates
+    only on the first use of the string. Lookup uses the case insensitive hash of the string, so the
+    exact and case folded forms are in the same bucket.
+
+    By default the table is for use on a single thread. If it is constructed as @c SHARED then it
+    can be used from any number of threads. Lookup of a string that is already interned takes a
+    shared lock, and so lookups don't block each other, and only adding a string takes the lock
+    exclusively. This suits tables that are filled when configuration is loaded and used afterwards.
+
+    The table can be @c clear ed to release all of the atoms at once, for instance a table of the
+    atoms for a configuration can be cleared on each reload. Clearing increments the generation of
+    the table, which can be used to check that atoms held elsewhere are from the current generation.
+ */
+class AtomTable
+{
+  using self_type = AtomTable; ///< Self reference type.
+
+public:
+  /// Threading mode.
+  enum Mode {
+    LOCAL, ///< Used by a single thread.
+    SHARED ///< Used concurrently by any number of threads.
+  };
+
+  /** Constructor.
+   *
+   * @param mode Threading mode.
+   */
+  explicit AtomTable(Mode mode = LOCAL);
+
+  AtomTable(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Get the atom for a string.
+   *
+   * @param text The string.
+   * @return The atom for @a text, which is added if needed.
+   */
+  Atom intern(std::string_view text);
+
+  /** Get the atom for a string, if there is one.
+   *
+   * @param text The string.
+   * @return The atom for @a text, or the null atom if @a text has not been interned.
+   *
+   * This never changes the table.
+   */
+  Atom find(std::string_view text) const;
+
+  /// @return The number of atoms, including the case folded forms.
+  size_t count() const;
+
+  /// @return The generation, which is incremented by @c clear.
+  unsigned generation() const;
+
+  /** Release all of the atoms.
+   *
+   * Atoms from the table are invalid after this. In @c SHARED mode this must not be called while
+   * another thread could be using an atom from the table.
+   */
+  self_type &clear();
+
+  /// @return The case insensitive hash for @a text, which is the same as @c Atom::hash.
+  static uint64_t hash_of(std::string_view text);
+
+protected:
+  using Data = Atom::Data;
+
+  /// Key for the index, the text with its hash.
+  struct Key {
+    std::string_view _text; ///< Text.
+    uint64_t _hash;         ///< Case insensitive hash of @a _text.
+  };
+
+  /// Index descriptor.
+  struct Linkage {
+    static Data *&next_ptr(Data *data);
+    static Data *&prev_ptr(Data *data);
+    static Key key_of(Data *data);
+    static uint64_t hash_of(Key const &key);
+    static bool equal(Key const &lhs, Key const &rhs);
+  };
+
+  using Index = IntrusiveHashMap<Linkage>;
+
+  Mode _mode;                        ///< Threading mode.
+  MemArena _arena;                   ///< Storage for the atoms.
+  Index _index;                      ///< Atoms by text.
+  std::atomic<unsigned> _generation{0}; ///< Incremented by @c clear.
+  mutable std::shared_mutex _mutex;  ///< Lock for @c SHARED mode.
+
+  /// Find @a key, without locking.
+  Data const *lookup(Key const &key) const;
+
+  /// Add @a key, without locking. @a key must not already be in the table.
+  Data const *insert(Key const &key);
+
+  /// Add a new atom for @a text with hash @a hash and folded form @a folded.
+  Data const *make(std::string_view text, uint64_t hash, Data const *folded);
+};
+
+// ---- Atom
+
+inline Atom::Atom(Data const *data) : _data(data) {}
+
+inline std::string_view
+Atom::view() const {
+  return _data ? _data->_text : std::string_view{""};
+}
+
+inline Atom::operator std::string_view() const {
+  return this->view();
+}
+
+inline char const *
+Atom::c_str() const {
+  return this->view().data();
+}
+
+inline size_t
+Atom::size() const {
+  return _data ? _data->_text.size() : 0;
+}
+
+inline Atom::operator bool() const {
+  return _data != nullptr;
+}
+
+inline uint64_t
+Atom::hash() const {
+  return _data ? _data->_hash : 0;
+}
+
+inline Atom
+Atom::folded() const {
+  return self_type{_data ? _data->_folded : nullptr};
+}
+
+inline bool
+Atom::equal_nocase(self_type const &that) const {
+  return this->folded() == that.folded();
+}
+
+inline bool
+Atom::operator==(self_type const &that) const {
+  return _data == that._data;
+}
+
+inline bool
+Atom::operator!=(self_type const &that) const {
+  return _data != that._data;
+}
+
+inline size_t
+Atom::Hash::operator()(self_type const &atom) const {
+  return atom.hash();
+}
+
+inline bool
+Atom::EqualNoCase::operator()(self_type const &lhs, self_type const &rhs) const {
+  return lhs.equal_nocase(rhs);
+}
+
+// ---- AtomTable
+
+inline auto
+AtomTable::Linkage::next_ptr(Data *data) -> Data *& {
+  return data->_next;
+}
+
+inline auto
+AtomTable::Linkage::prev_ptr(Data *data) -> Data *& {
+  return data->_prev;
+}
+
+inline auto
+AtomTable::Linkage::key_of(Data *data) -> Key {
+  return {data->_text, data->_hash};
+}
+
+inline uint64_t
+AtomTable::Linkage::hash_of(Key const &key) {
+  return key._hash;
+}
+
+inline bool
+AtomTable::Linkage::equal(Key const &lhs, Key const &rhs) {
+  return lhs._hash == rhs._hash && lhs._text == rhs._text;
+}
+
+inline size_t
+AtomTable::count() const {
+  std::shared_lock lock(_mutex, std::defer_lock);
+  if (_mode == SHARED) {
+    lock.lock();
+  }
+  return _index.count();
+}
+
+inline unsigned
+AtomTable::generation() const {
+  return _generation.load(std::memory_order_acquire);
+}
+
+} // namespace swoc
+
+namespace std
+{
+/// Hash for atoms in standard containers.
+template <> struct hash<swoc::Atom> {
+  size_t
+  operator()(swoc::Atom const &atom) const {
+    return atom.hash();
+  }
+};
+} // namespace std
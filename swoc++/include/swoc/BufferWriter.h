@@ -37,6 +37,9 @@ namespace bwf
 {
   struct Spec;
   class Format;
+  template <size_t N> class LocalFormat;
+  template <typename F> class BoundFormat;
+  template <typename S> class StaticFormat;
   class NameBinding;
   class ArgPack;
 } // namespace bwf
@@ -50,6 +53,10 @@ namespace bwf
  * needed can be determined by the method @c extent.
  *
  * @note This is a protocol class, concrete subclasses implement the functionality.
+ *
+ * A subclass with a memory buffer can provide it to this class, which enables @c put and the
+ * @c std::string_view overload of @c write to write directly to the buffer without virtual dispatch
+ * if there is room. The virtual methods are used only when the buffer is full.
  */
 class BufferWriter {
 public:
@@ -60,6 +67,15 @@ public:
    */
   virtual BufferWriter &write(char c) = 0;
 
+  /** Write @a c to the buffer.
+   *
+   * @param c Character to write.
+   * @return @a this.
+   *
+   * This is identical to @c write but does not use virtual dispatch if there is room in the buffer.
+   */
+  BufferWriter &put(char c);
+
   /** Write @a length bytes starting at @a data to the buffer.
    *
    * @param data Source data.
@@ -231,6 +247,73 @@ public:
    */
   template <typename... Args> BufferWriter &print_v(const bwf::Format &fmt, const std::tuple<Args...> &args);
 
+  /** Formatted output to the buffer.
+   *
+   * @tparam N Format storage size.
+   * @tparam Args Types of the format input parameters.
+   * @param fmt Pre-condensed compact format.
+   * @param args Arguments for the format string.
+   * @return @a this.
+   */
+  template <size_t N, typename... Args> BufferWriter &print(const bwf::LocalFormat<N> &fmt, Args &&... args);
+
+  /** Formatted output to the buffer.
+   *
+   * @tparam N Format storage size.
+   * @tparam Args Types of the parameter for formatting.
+   * @param fmt Pre-condensed compact format.
+   * @param args The format parameters in a tuple.
+   * @return @a this
+   */
+  template <size_t N, typename... Args>
+  BufferWriter &print_v(const bwf::LocalFormat<N> &fmt, const std::tuple<Args...> &args);
+
+  /** Formatted output to the buffer.
+   *
+   * @tparam F Generator signature of the names.
+   * @tparam Args Types of the format input parameters.
+   * @param fmt Format with pre-resolved names.
+   * @param args Arguments for the format string.
+   * @return @a this.
+   *
+   * The names in @a fmt must not require a context, e.g. the names are from @c bwf::ExternalNames.
+   */
+  template <typename F, typename... Args> BufferWriter &print(const bwf::BoundFormat<F> &fmt, Args &&... args);
+
+  /** Formatted output to the buffer.
+   *
+   * @tparam F Generator signature of the names.
+   * @tparam Args Types of the parameter for formatting.
+   * @param fmt Format with pre-resolved names.
+   * @param args The format parameters in a tuple.
+   * @return @a this
+   */
+  template <typename F, typename... Args>
+  BufferWriter &print_v(const bwf::BoundFormat<F> &fmt, const std::tuple<Args...> &args);
+
+  /** Formatted output to the buffer.
+   *
+   * @tparam S Format string source.
+   * @tparam Args Types of the format input parameters.
+   * @param fmt Format parsed at compile time.
+   * @param args Arguments for the format string.
+   * @return @a this.
+   *
+   * The number of arguments must match @a fmt, which is checked at compile time.
+   */
+  template <typename S, typename... Args> BufferWriter &print(const bwf::StaticFormat<S> &fmt, Args &&... args);
+
+  /** Formatted output to the buffer.
+   *
+   * @tparam S Format string source.
+   * @tparam Args Types of the parameter for formatting.
+   * @param fmt Format parsed at compile time.
+   * @param args The format parameters in a tuple.
+   * @return @a this
+   */
+  template <typename S, typename... Args>
+  BufferWriter &print_v(const bwf::StaticFormat<S> &fmt, const std::tuple<Args...> &args);
+
   /** Write formatted output of @a args to @a this buffer.
    *
    * @tparam Binding Type for the name binding instance.
@@ -289,6 +372,24 @@ public:
    * Write the buffer contents to @a stream.
    */
   virtual std::ostream &operator>>(std::ostream &stream) const = 0;
+
+protected:
+  /// Construct without a buffer, all output uses virtual dispatch.
+  BufferWriter() = default;
+
+  /** Construct with a buffer for direct output.
+   *
+   * @param buffer Output buffer.
+   * @param capacity Size of @a buffer.
+   *
+   * While @a _attempted is less than @a _capacity, storing a character at @a _attempted in
+   * @a _buffer and incrementing @a _attempted must be equivalent to @c write.
+   */
+  BufferWriter(char *buffer, size_t capacity);
+
+  char *const _buffer = nullptr; ///< Output buffer.
+  size_t _capacity    = 0;       ///< Size of output buffer.
+  size_t _attempted   = 0;       ///< Number of characters written, including those discarded due error condition.
 };
 
 /** A concrete @c BufferWriter class for a fixed buffer.
@@ -394,12 +495,20 @@ public:
   template <typename... Args> self_type &print(bwf::Format const &fmt, Args &&... args);
 
   template <typename... Args> self_type &print_v(bwf::Format const &fmt, std::tuple<Args...> const &args);
+
+  template <size_t N, typename... Args> self_type &print(bwf::LocalFormat<N> const &fmt, Args &&... args);
+
+  template <size_t N, typename... Args> self_type &print_v(bwf::LocalFormat<N> const &fmt, std::tuple<Args...> const &args);
+
+  template <typename F, typename... Args> self_type &print(bwf::BoundFormat<F> const &fmt, Args &&... args);
+
+  template <typename F, typename... Args> self_type &print_v(bwf::BoundFormat<F> const &fmt, std::tuple<Args...> const &args);
+
+  template <typename S, typename... Args> self_type &print(bwf::StaticFormat<S> const &fmt, Args &&... args);
+
+  template <typename S, typename... Args> self_type &print_v(bwf::StaticFormat<S> const &fmt, std::tuple<Args...> const &args);
   /// @endcond
 
-protected:
-  char *const _buffer;   ///< Output buffer.
-  size_t _capacity;      ///< Size of output buffer.
-  size_t _attempted = 0; ///< Number of characters written, including those discarded due error condition.
 };
 
 /** A @c BufferWriter that has an internal buffer.
@@ -441,8 +550,20 @@ protected:
 
 // --------------- Implementation --------------------
 
+inline BufferWriter::BufferWriter(char *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
 inline BufferWriter::~BufferWriter() {}
 
+inline BufferWriter &
+BufferWriter::put(char c) {
+  if (_attempted < _capacity)
+  {
+    _buffer[_attempted++] = c;
+    return *this;
+  }
+  return this->write(c);
+}
+
 inline BufferWriter &
 BufferWriter::write(const void *data, size_t length) {
   const char *d = static_cast<const char *>(data);
@@ -456,6 +577,12 @@ BufferWriter::write(const void *data, size_t length) {
 
 inline BufferWriter &
 BufferWriter::write(const std::string_view &sv) {
+  if (sv.size() && _attempted + sv.size() <= _capacity)
+  {
+    std::memcpy(_buffer + _attempted, sv.data(), sv.size());
+    _attempted += sv.size();
+    return *this;
+  }
   return this->write(sv.data(), sv.size());
 }
 
@@ -475,7 +602,7 @@ BufferWriter::remaining() const {
 }
 
 // --- FixedBufferWriter ---
-inline FixedBufferWriter::FixedBufferWriter(char *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {
+inline FixedBufferWriter::FixedBufferWriter(char *buffer, size_t capacity) : super_type(buffer, capacity) {
   if (_capacity != 0 && buffer == nullptr)
   {
     throw(std::invalid_argument{"FixedBufferWriter created with null buffer and non-zero size."});
@@ -483,11 +610,11 @@ inline FixedBufferWriter::FixedBufferWriter(char *buffer, size_t capacity) : _bu
 }
 
 inline FixedBufferWriter::FixedBufferWriter(MemSpan<void> const &span)
-  : _buffer{static_cast<char *>(span.data())}, _capacity{span.size()} {}
+  : super_type{static_cast<char *>(span.data()), span.size()} {}
 
-inline FixedBufferWriter::FixedBufferWriter(MemSpan<char> const &span) : _buffer{span.begin()}, _capacity{span.size()} {}
+inline FixedBufferWriter::FixedBufferWriter(MemSpan<char> const &span) : super_type{span.begin(), span.size()} {}
 
-inline FixedBufferWriter::FixedBufferWriter(std::nullptr_t) : _buffer(nullptr), _capacity(0) {}
+inline FixedBufferWriter::FixedBufferWriter(std::nullptr_t) : super_type(nullptr, 0) {}
 
 inline FixedBufferWriter::self_type &
 FixedBufferWriter::detach() {
@@ -497,8 +624,8 @@ FixedBufferWriter::detach() {
   return *this;
 }
 
-inline FixedBufferWriter::FixedBufferWriter(FixedBufferWriter &&that)
-  : _buffer(that._buffer), _capacity(that._capacity), _attempted(that._attempted) {
+inline FixedBufferWriter::FixedBufferWriter(FixedBufferWriter &&that) : super_type(that._buffer, that._capacity) {
+  _attempted = that._attempted;
   that.detach();
 }
 
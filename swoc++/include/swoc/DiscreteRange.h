@@ -11,10 +11,21 @@
 
 #include <limits>
 #include <functional>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstring>
+#include <type_traits>
 
 #include <swoc/swoc_meta.h>
 #include <swoc/RBTree.h>
 #include <swoc/MemArena.h>
+#include <swoc/swoc_trace.h>
 
 namespace swoc
 {
@@ -61,6 +72,69 @@ namespace detail
     return minimum<M>(meta::CaseArg);
   }
   /// @}
+
+  /// Hint that the memory at @a ptr will be read soon.
+  inline void
+  prefetch(void const *ptr) {
+#if defined(__GNUC__)
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+  }
+
+  /// Number of searches interleaved by batch lookup.
+  static constexpr size_t FIND_BATCH_WIDTH = 8;
+
+  /// @return The number of trailing 1 bits in @a n.
+  inline unsigned
+  trailing_ones(size_t n) {
+#if defined(__GNUC__)
+    return ~n ? __builtin_ctzll(~static_cast<unsigned long long>(n)) : std::numeric_limits<size_t>::digits;
+#else
+    unsigned zret = 0;
+    for (; n & 1; n >>= 1) {
+      ++zret;
+    }
+    return zret;
+#endif
+  }
+
+  /** Header of a @c FrozenDiscreteSpace image.
+   *
+   * The sections follow the header at the offsets given, each aligned to @c ALIGN bytes relative to
+   * the start of the image. All values are in host byte order and the image is valid only for the
+   * same types on the same architecture, which is checked using the type sizes and @a _byte_order.
+   */
+  struct FrozenImageHeader {
+    static constexpr char MAGIC[8]        = {'s', 'w', 'o', 'c', 'D', 'S', 'P', 'C'}; ///< File identifier.
+    static constexpr uint32_t VERSION     = 1;          ///< Current format version.
+    static constexpr uint32_t ORDER_MARK  = 0x01020304; ///< Byte order mark.
+    static constexpr size_t ALIGN         = 64;         ///< Section alignment.
+    static constexpr unsigned N_SECTIONS  = 5;          ///< Number of sections.
+
+    /// Section indices.
+    enum Section { TREE, RANK, MIN, MAX, PAYLOAD };
+
+    char _magic[8];                  ///< Must be @c MAGIC.
+    uint32_t _version;               ///< Format version.
+    uint32_t _byte_order;            ///< @c ORDER_MARK as written.
+    uint16_t _metric_size;           ///< @c sizeof the metric.
+    uint16_t _metric_align;          ///< @c alignof the metric.
+    uint16_t _payload_size;          ///< @c sizeof the payload.
+    uint16_t _payload_align;         ///< @c alignof the payload.
+    uint32_t _rank_size;             ///< @c sizeof a rank.
+    uint32_t _reserved;              ///< Zero.
+    uint64_t _count;                 ///< Number of ranges.
+    uint64_t _size;                  ///< Size of the image in bytes, including this header.
+    uint64_t _offset[N_SECTIONS];    ///< Offset of each section from the start of the image.
+
+    /// @return @a n rounded up to a multiple of @c ALIGN.
+    static constexpr size_t
+    round_up(size_t n) {
+      return (n + ALIGN - 1) & ~(ALIGN - 1);
+    }
+  };
 } // namespace detail
 
 /// Relationship between two intervals.
@@ -520,6 +594,8 @@ operator>=(DiscreteRange<T> const &lhs, DiscreteRange<T> const &rhs) {
   return lhs.is_superset_of(rhs);
 }
 
+template <typename METRIC, typename PAYLOAD> class FrozenDiscreteSpace;
+
 /** A space for a discrete @c METRIC.
  *
  * @tparam METRIC Value type for the space.
@@ -563,6 +639,8 @@ protected:
 
     /// @return The payload in the node.
     PAYLOAD & payload();
+    /// @return The payload in the node.
+    PAYLOAD const & payload() const;
 
     /** Set the @a range of a node.
      *
@@ -625,7 +703,7 @@ protected:
 
   Node *_root = nullptr;                        ///< Root node.
   IntrusiveDList<typename Node::Linkage> _list; ///< In order list of nodes.
-  swoc::MemArena _arena{4000}; ///< Memory Storage.
+  swoc::MemArena _arena{4000}; ///< Memory Storage, if not provided by the client.
   swoc::FixedArena<Node> _fa{_arena}; ///< Node allocator and free list.
 
   // Utility methods to avoid having casts scattered all over.
@@ -647,9 +725,21 @@ protected:
   }
 
 public:
-  using iterator = typename decltype(_list)::iterator;
+  using iterator       = typename decltype(_list)::iterator;
+  using const_iterator = typename decltype(_list)::const_iterator;
 
   DiscreteSpace() = default;
+
+  /** Construct with an external arena for node storage.
+   *
+   * @param arena The arena for nodes.
+   *
+   * Nodes are allocated from @a arena instead of an internal arena. This allows multiple spaces to
+   * share an arena, and the memory for all of them to be released at once by clearing the arena.
+   * @a arena must outlive the space.
+   */
+  explicit DiscreteSpace(MemArena &arena) : _fa{arena} {}
+
   ~DiscreteSpace();
 
   /** Set the @a payload for a @a range
@@ -662,6 +752,58 @@ public:
    */
   self_type &mark(range_type const &range, PAYLOAD const &payload);
 
+  /** Load a batch of ranges.
+   *
+   * @tparam I Random access iterator type.
+   * @param first First element of the batch.
+   * @param last Past the last element of the batch.
+   * @return @a this
+   *
+   * Each element must be a pair-like of a range and a payload, such as a
+   * <tt>std::tuple<DiscreteRange<METRIC>, PAYLOAD></tt>. The effect is the same as calling @c mark
+   * for each element in order of the range minimums. If the batch isn't already in that order it is
+   * sorted in place, stably, so that of ranges with the same minimum the later one has priority.
+   *
+   * If the space is empty the leading disjoint ranges are coalesced and built in to a balanced tree
+   * directly in linear time, and any ranges after the first overlapping one are marked. If the space is
+   * not empty all of the ranges are marked.
+   */
+  template <typename I> self_type &load(I first, I last);
+
+  /** Set this space to a combination of two spaces.
+   *
+   * @tparam F Functor to combine payloads.
+   * @param lhs First space.
+   * @param rhs Second space.
+   * @param combiner Payload combiner.
+   * @param n_threads Maximum number of threads, 0 to use the hardware concurrency.
+   * @return @a this
+   *
+   * The current contents are replaced, and so this must be neither @a lhs nor @a rhs. The ranges of
+   * the spaces are walked together, in time linear in the total number of ranges, while the result
+   * is built in to a balanced tree directly. The combiner is called for every maximal range of values
+   * that have a payload in at least one of the spaces and for which those payloads don't change. It
+   * has the signature
+   *
+   * @code
+   *   bool combiner(PAYLOAD &result, PAYLOAD const *lhs, PAYLOAD const *rhs);
+   * @endcode
+   *
+   * where @a lhs and @a rhs point at the payloads from the corresponding spaces, or are @c nullptr
+   * if that space has no payload for the range. The combiner must set @a result, which is initially
+   * default constructed, and return @c true to put the range in the space, or @c false to leave it
+   * out. For instance, to intersect the spaces the combiner returns @c false if either payload is
+   * missing.
+   *
+   * If the spaces are large, the values are split in to contiguous parts which are combined on
+   * separate threads, and therefore the combiner may be called concurrently.
+   */
+  template <typename F>
+  self_type &merge(self_type const &lhs, self_type const &rhs, F &&combiner, unsigned n_threads = 0);
+
+  /// Minimum number of ranges per thread for @c merge.
+  static constexpr size_t MERGE_THREAD_MIN = 1 << 14;
+
   /** Erase a @a range.
    *
    * @param range Range to erase.
@@ -708,22 +850,40 @@ public:
    */
   PAYLOAD * find(METRIC const &metric);
 
+  /** Find the payloads for a batch of metrics.
+   *
+   * @param metrics Metrics for which to search.
+   * @param results Payload for each metric, or @c nullptr if not found.
+   *
+   * This is equivalent to calling @c find for each metric but the searches are interleaved so that
+   * the memory accesses for different searches overlap. Only as many metrics as there are elements in
+   * @a results are searched.
+   */
+  void find(MemSpan<METRIC const> metrics, MemSpan<PAYLOAD *> results);
+
   /// @return The number of distinct ranges.
   size_t count() const;
 
   iterator begin() { return _list.begin(); }
   iterator end() { return _list.end(); }
+  const_iterator begin() const { return _list.begin(); }
+  const_iterator end() const { return _list.end(); }
 
-  /// Remove all ranges.
-  void clear() {
-    for (auto &node : _list) {
-      std::destroy_at(&node.payload());
-    }
-    _list.clear();
-    _root = nullptr;
-    _arena.clear();
-    _fa.clear();
-  }
+  /** Create a read only, compact copy of the space.
+   *
+   * @return The frozen space.
+   *
+   * The frozen copy is independent of this space, which can be changed or destroyed without
+   * affecting it.
+   */
+  FrozenDiscreteSpace<METRIC, PAYLOAD> freeze() const;
+
+  /** Remove all ranges.
+   *
+   * If the nodes are in the internal arena, that is cleared. Otherwise the nodes are kept on the
+   * free list for re-use as the external arena may be shared.
+   */
+  void clear();
 
 protected:
   /** Find the lower bound range for @a target.
@@ -734,6 +894,47 @@ protected:
    */
   Node *lower_bound(METRIC const &target);
 
+  /// @return The rightmost range that starts at or before @a target, or @c nullptr.
+  Node const *
+  lower_bound(METRIC const &target) const {
+    return const_cast<self_type *>(this)->lower_bound(target);
+  }
+
+  /// @return The first range that contains or is after @a target.
+  const_iterator
+  first_at(METRIC const &target) const {
+    auto n    = this->lower_bound(target);
+    auto spot = n ? _list.iterator_for(n) : _list.begin();
+    if (spot != _list.end() && spot->max() < target) {
+      ++spot;
+    }
+    return spot;
+  }
+
+  /** Collect the range minimums of the nodes at a depth in the tree.
+   *
+   * @param n Subtree root.
+   * @param depth Depth of interest in the subtree.
+   * @param points [out] The range minimums, in order.
+   *
+   * The tree is balanced, and so these split the ranges in to roughly equal parts.
+   */
+  static void split_points(Node const *n, unsigned depth, std::vector<METRIC> &points);
+
+  /** Combine part of two spaces.
+   *
+   * @param lhs First space.
+   * @param rhs Second space.
+   * @param range Values to combine.
+   * @param combiner Payload combiner.
+   * @param items [out] Combined ranges, in order.
+   *
+   * @see merge
+   */
+  template <typename F>
+  static void merge_part(self_type const &lhs, self_type const &rhs, range_type const &range, F &combiner,
+                         std::vector<std::tuple<range_type, PAYLOAD>> &items);
+
   /// @return The first node in the tree.
   Node * head();
 
@@ -755,6 +956,20 @@ protected:
 
   void append(Node *node);
 
+  /** Build a balanced subtree.
+   *
+   * @param nodes Nodes in order.
+   * @param n Number of nodes.
+   * @param depth Depth of the subtree root.
+   * @param red_depth Depth of the red nodes.
+   * @param parent Parent of the subtree root.
+   * @return The subtree root.
+   *
+   * Each subtree root is the middle node, therefore all levels above @a red_depth are complete and
+   * coloring only the nodes at @a red_depth red satisfies the red black invariants.
+   */
+  Node *build(Node **nodes, size_t n, unsigned depth, unsigned red_depth, Node *parent);
+
   void
   remove(Node *node) {
     _root = static_cast<Node *>(node->remove());
@@ -771,6 +986,12 @@ DiscreteSpace<METRIC, PAYLOAD>::Node::payload() {
   return _payload;
 }
 
+template <typename METRIC, typename PAYLOAD>
+PAYLOAD const &
+DiscreteSpace<METRIC, PAYLOAD>::Node::payload() const {
+  return _payload;
+}
+
 template <typename METRIC, typename PAYLOAD>
 auto
 DiscreteSpace<METRIC, PAYLOAD>::Node::assign(DiscreteSpace::range_type const &range) -> self_type &{
@@ -803,9 +1024,32 @@ void DiscreteSpace<METRIC, PAYLOAD>::Node::structure_fixup() {
 template <typename METRIC, typename PAYLOAD>
 DiscreteSpace<METRIC, PAYLOAD>::~DiscreteSpace() {
   // Destruct all the payloads - the nodes themselves are in the arena and disappear with it.
-  for (auto &node : _list) {
-    std::destroy_at(&node.payload());
+  if constexpr (!std::is_trivially_destructible_v<PAYLOAD>) {
+    for (auto &node : _list) {
+      std::destroy_at(&node.payload());
+    }
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+DiscreteSpace<METRIC, PAYLOAD>::clear() {
+  if (&_fa.arena() == &_arena) {
+    if constexpr (!std::is_trivially_destructible_v<PAYLOAD>) {
+      for (auto &node : _list) {
+        std::destroy_at(&node.payload());
+      }
+    }
+    _arena.clear();
+    _fa.clear();
+  } else {
+    for (Node *n = this->head(), *x; n; n = x) {
+      x = next(n);
+      _fa.destroy(n);
+    }
   }
+  _list.clear();
+  _root = nullptr;
 }
 
 template <typename METRIC, typename PAYLOAD>
@@ -823,17 +1067,9 @@ DiscreteSpace<METRIC, PAYLOAD>::find(METRIC const &metric) {
   auto n = _root; // current node to test.
   while (n) {
     if (metric < n->min()) {
-      if (n->_hull.contains(metric)) {
-        n = n->left();
-      } else {
-        return nullptr;
-      }
+      n = n->left();
     } else if (n->max() < metric) {
-      if (n->_hull.contains(metric)) {
-        n = n->right();
-      } else {
-        return nullptr;
-      }
+      n = n->right();
     } else {
       return &n->payload();
     }
@@ -841,6 +1077,43 @@ DiscreteSpace<METRIC, PAYLOAD>::find(METRIC const &metric) {
   return nullptr;
 }
 
+template <typename METRIC, typename PAYLOAD>
+void
+DiscreteSpace<METRIC, PAYLOAD>::find(MemSpan<METRIC const> metrics, MemSpan<PAYLOAD *> results) {
+  static constexpr size_t WIDTH = detail::FIND_BATCH_WIDTH;
+  auto n = std::min(metrics.count(), results.count());
+  for (size_t base = 0; base < n; base += WIDTH) {
+    size_t width = std::min(WIDTH, n - base);
+    Node *nodes[WIDTH];
+    for (size_t j = 0; j < width; ++j) {
+      nodes[j]          = _root;
+      results[base + j] = nullptr;
+    }
+    // Advance each search one level per pass, so the node loads for different searches overlap.
+    for (bool active_p = true; active_p;) {
+      active_p = false;
+      for (size_t j = 0; j < width; ++j) {
+        if (Node *x = nodes[j]; x) {
+          auto const &metric = metrics[base + j];
+          if (metric < x->min()) {
+            x = x->left();
+          } else if (x->max() < metric) {
+            x = x->right();
+          } else {
+            results[base + j] = &x->payload();
+            x                 = nullptr;
+          }
+          if (x) {
+            detail::prefetch(x);
+            active_p = true;
+          }
+          nodes[j] = x;
+        }
+      }
+    }
+  }
+}
+
 template <typename METRIC, typename PAYLOAD>
 auto DiscreteSpace<METRIC, PAYLOAD>::lower_bound(METRIC const &target) -> Node * {
   Node *n    = _root;   // current node to test.
@@ -937,6 +1210,7 @@ DiscreteSpace<METRIC, PAYLOAD>::mark(DiscreteSpace::range_type const &range, PAY
       // if there is a previous range, min is not zero.
       Node *p = prev(n);
       if (p && p->payload() == payload && p->max() == min_minus_1) {
+        SWOC_TRACE(space_coalesce, this, _list.count());
         x = p;
         n = x; // need to back up n because frame of reference moved.
         x->assign_max(range.max());
@@ -948,7 +1222,7 @@ DiscreteSpace<METRIC, PAYLOAD>::mark(DiscreteSpace::range_type const &range, PAY
         return *this; // request is covered by existing span with the same data
       } else {
         // request span is covered by existing span.
-        x = new Node{range, payload}; //
+        x = _fa.make(range, payload);
         n->assign_min(max_plus_1);    // clip existing.
         this->insert_before(n, x);
         return *this;
@@ -979,6 +1253,7 @@ DiscreteSpace<METRIC, PAYLOAD>::mark(DiscreteSpace::range_type const &range, PAY
       // We split it, put the new span in between and we're done.
       // max_plus_1 is valid because n->_max > max.
       Node *r;
+      SWOC_TRACE(space_split, this, _list.count());
       x = _fa.make(range, payload);
       r = _fa.make(range_type{max_plus_1, n->max()}, n->payload());
       n->assign_max(min_minus_1);
@@ -1021,12 +1296,15 @@ DiscreteSpace<METRIC, PAYLOAD>::mark(DiscreteSpace::range_type const &range, PAY
     } else if (max_plus_1 < n->min()) { // no overlap, done.
       break;
     } else if (n->payload() == payload) { // skew overlap or adj., same payload
+      SWOC_TRACE(space_coalesce, this, _list.count());
       x->assign_max(n->max());
       y = n;
       n = next(n);
       this->remove(y);
-    } else if (n->min() <= range.max()) { // skew overlap different payload
-      n->assign_min(max_plus_1);
+    } else { // skew overlap or adj., different payload
+      if (n->min() <= range.max()) {
+        n->assign_min(max_plus_1);
+      }
       break;
     }
   }
@@ -1034,6 +1312,205 @@ DiscreteSpace<METRIC, PAYLOAD>::mark(DiscreteSpace::range_type const &range, PAY
   return *this;
 }
 
+template <typename METRIC, typename PAYLOAD>
+auto
+DiscreteSpace<METRIC, PAYLOAD>::build(Node **nodes, size_t n, unsigned depth, unsigned red_depth, Node *parent) -> Node * {
+  if (n == 0) {
+    return nullptr;
+  }
+  auto mid   = n / 2;
+  Node *x    = nodes[mid];
+  x->_parent = parent;
+  x->_color  = depth == red_depth ? Node::Color::RED : Node::Color::BLACK;
+  x->_left   = this->build(nodes, mid, depth + 1, red_depth, x);
+  x->_right  = this->build(nodes + mid + 1, n - mid - 1, depth + 1, red_depth, x);
+  x->structure_fixup();
+  return x;
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename I>
+auto
+DiscreteSpace<METRIC, PAYLOAD>::load(I first, I last) -> self_type & {
+  auto by_min = [](auto const &lhs, auto const &rhs) -> bool { return std::get<0>(lhs).min() < std::get<0>(rhs).min(); };
+  if (!std::is_sorted(first, last, by_min)) {
+    std::stable_sort(first, last, by_min);
+  }
+
+  if (nullptr == _root) {
+    std::vector<Node *> nodes;
+    nodes.reserve(std::distance(first, last));
+    for (; first != last; ++first) {
+      auto const &range   = std::get<0>(*first);
+      auto const &payload = std::get<1>(*first);
+      if (!nodes.empty()) {
+        Node *prev = nodes.back();
+        if (!(prev->max() < range.min())) {
+          break; // overlap, mark from here on.
+        }
+        // Can't overflow because there is a larger value, @a range.min().
+        auto max_plus_1 = prev->max();
+        ++max_plus_1;
+        if (max_plus_1 == range.min() && prev->payload() == payload) {
+          prev->_range.assign_max(range.max());
+          continue;
+        }
+      }
+      nodes.push_back(_fa.make(range, payload));
+    }
+
+    for (auto n : nodes) {
+      _list.append(n);
+    }
+    unsigned red_depth = 0;
+    while ((size_t(1) << (red_depth + 1)) <= nodes.size() + 1) {
+      ++red_depth;
+    }
+    _root = this->build(nodes.data(), nodes.size(), 0, red_depth, nullptr);
+  }
+
+  for (; first != last; ++first) {
+    this->mark(std::get<0>(*first), std::get<1>(*first));
+  }
+  return *this;
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+DiscreteSpace<METRIC, PAYLOAD>::split_points(Node const *n, unsigned depth, std::vector<METRIC> &points) {
+  if (n) {
+    if (depth == 0) {
+      points.push_back(n->min());
+    } else {
+      split_points(static_cast<Node const *>(n->_left), depth - 1, points);
+      split_points(static_cast<Node const *>(n->_right), depth - 1, points);
+    }
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename F>
+void
+DiscreteSpace<METRIC, PAYLOAD>::merge_part(self_type const &lhs, self_type const &rhs, range_type const &range, F &combiner,
+                                           std::vector<std::tuple<range_type, PAYLOAD>> &items) {
+  auto const &max = range.max();
+  auto a          = lhs.first_at(range.min());
+  auto b          = rhs.first_at(range.min());
+  auto min        = range.min(); // Start of the next piece.
+
+  while (true) {
+    bool a_live_p = a != lhs.end() && !(max < a->min());
+    bool b_live_p = b != rhs.end() && !(max < b->min());
+    if (!a_live_p && !b_live_p) {
+      break;
+    }
+    bool in_a_p = a_live_p && !(min < a->min());
+    bool in_b_p = b_live_p && !(min < b->min());
+    if (!in_a_p && !in_b_p) { // skip the gap.
+      min = (a_live_p && (!b_live_p || a->min() < b->min())) ? a->min() : b->min();
+      continue;
+    }
+
+    // The piece ends at the first range end or start after @a min.
+    auto piece_max = max;
+    auto clip      = [&](METRIC const &m) {
+      if (m < piece_max) {
+        piece_max = m;
+      }
+    };
+    for (auto [live_p, in_p, spot] : {std::make_tuple(a_live_p, in_a_p, a), std::make_tuple(b_live_p, in_b_p, b)}) {
+      if (in_p) {
+        clip(spot->max());
+      } else if (live_p) {
+        auto m = spot->min();
+        --m; // OK because it's larger than @a min.
+        clip(m);
+      }
+    }
+
+    PAYLOAD payload{};
+    if (combiner(payload, in_a_p ? &a->payload() : nullptr, in_b_p ? &b->payload() : nullptr)) {
+      items.emplace_back(range_type{min, piece_max}, std::move(payload));
+    }
+
+    if (in_a_p && a->max() == piece_max) {
+      ++a;
+    }
+    if (in_b_p && b->max() == piece_max) {
+      ++b;
+    }
+    if (piece_max == max) {
+      break;
+    }
+    min = piece_max;
+    ++min;
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename F>
+auto
+DiscreteSpace<METRIC, PAYLOAD>::merge(self_type const &lhs, self_type const &rhs, F &&combiner, unsigned n_threads)
+  -> self_type & {
+  using Item = std::tuple<range_type, PAYLOAD>;
+
+  if (n_threads == 0) {
+    n_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  n_threads = std::max<size_t>(1, std::min<size_t>(n_threads, (lhs.count() + rhs.count()) / MERGE_THREAD_MIN));
+
+  // Split the values in to parts, at range minimums from the larger space.
+  std::vector<range_type> parts;
+  std::vector<METRIC> points;
+  if (n_threads > 1) {
+    unsigned depth = 0;
+    while ((1U << depth) < n_threads) {
+      ++depth;
+    }
+    split_points(lhs.count() < rhs.count() ? rhs._root : lhs._root, depth, points);
+  }
+  auto part_min = detail::minimum<METRIC>();
+  for (auto const &m : points) {
+    if (part_min < m) {
+      auto part_max = m;
+      --part_max;
+      parts.emplace_back(part_min, part_max);
+      part_min = m;
+    }
+  }
+  parts.emplace_back(part_min, detail::maximum<METRIC>());
+
+  std::vector<std::vector<Item>> runs(parts.size());
+  auto worker = [&](size_t idx) { merge_part(lhs, rhs, parts[idx], combiner, runs[idx]); };
+  std::vector<std::thread> threads;
+  for (size_t idx = 1; idx < parts.size(); ++idx) {
+    threads.emplace_back(worker, idx);
+  }
+  worker(0);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  std::vector<Item> items;
+  if (runs.size() == 1) {
+    items = std::move(runs[0]);
+  } else {
+    size_t n = 0;
+    for (auto const &run : runs) {
+      n += run.size();
+    }
+    items.reserve(n);
+    for (auto &run : runs) {
+      std::move(run.begin(), run.end(), std::back_inserter(items));
+    }
+  }
+  runs.clear();
+
+  // The parts are disjoint and in order, so this builds the tree directly and coalesces.
+  this->clear();
+  return this->load(items.begin(), items.end());
+}
+
 template <typename METRIC, typename PAYLOAD>
 DiscreteSpace<METRIC, PAYLOAD> &
 DiscreteSpace<METRIC, PAYLOAD>::fill(DiscreteSpace::range_type const &range, PAYLOAD const &payload) {
@@ -1126,7 +1603,7 @@ DiscreteSpace<METRIC, PAYLOAD>::fill(DiscreteSpace::range_type const &range, PAY
         }
       } else {               // no carry node.
         if (max < n->_min) { // entirely before next span.
-          this->insert_before(n, new Node(min, max, payload));
+          this->insert_before(n, _fa.make(min, max, payload));
           return *this;
         } else {
           if (min < n->_min) { // leading section, need node.
@@ -1310,4 +1787,1059 @@ DiscreteSpace<METRIC, PAYLOAD>::blend(DiscreteSpace::range_type const&range, U c
   return *this;
 }
 
+/** A read only, compact form of a @c DiscreteSpace.
+ *
+ * @tparam METRIC Value type for the space.
+ * @tparam PAYLOAD Data stored with values in the space.
+ *
+ * This is created by @c DiscreteSpace::freeze when the space is fully populated. The range minimums
+ * are stored contiguously in Eytzinger (breadth first) order, so that the first levels of the search
+ * share cache lines and the search is a fixed sequence of compares without data dependent branches.
+ * The range maximums and payloads are stored in parallel arrays in range order.
+ *
+ * If @c METRIC and @c PAYLOAD are trivially copyable the arrays can be written as a binary image
+ * with @c write_image, and an instance can be attached to an image with @c attach and used with no
+ * copying or parsing. The image has no pointers, so it can be written to a file by a build step and
+ * used directly from a read only memory map of that file, shared by any number of processes.
+ */
+template <typename METRIC, typename PAYLOAD> class FrozenDiscreteSpace {
+  using self_type = FrozenDiscreteSpace;
+
+public:
+  using metric_type  = METRIC;  ///< Export.
+  using payload_type = PAYLOAD; ///< Export.
+  using range_type   = DiscreteRange<METRIC>;
+
+  /// Construct an empty space.
+  FrozenDiscreteSpace() = default;
+
+  /// Construct from the current contents of @a space.
+  explicit FrozenDiscreteSpace(DiscreteSpace<METRIC, PAYLOAD> const &space);
+
+  FrozenDiscreteSpace(self_type const &that);
+  FrozenDiscreteSpace(self_type &&that) = default;
+  self_type &operator=(self_type const &that);
+  self_type &operator=(self_type &&that) = default;
+
+  /** Find the payload at @a metric.
+   *
+   * @param metric The metric for which to search.
+   * @return The payload for @a metric if found, @c nullptr if not found.
+   */
+  PAYLOAD const *find(METRIC const &metric) const;
+
+  /** Find the payloads for a batch of metrics.
+   *
+   * @param metrics Metrics for which to search.
+   * @param results Payload for each metric, or @c nullptr if not found.
+   *
+   * @see DiscreteSpace::find(MemSpan<METRIC const>, MemSpan<PAYLOAD *>)
+   */
+  void find(MemSpan<METRIC const> metrics, MemSpan<PAYLOAD const *> results) const;
+
+  /// @return The number of distinct ranges.
+  size_t count() const;
+
+  /// @return The range at index @a idx, in range order.
+  range_type range_at(size_t idx) const;
+
+  /// @return The payload at index @a idx, in range order.
+  PAYLOAD const &payload_at(size_t idx) const;
+
+  /// @return The size in bytes of the image of this space.
+  size_t image_size() const;
+
+  /** Write the image of this space.
+   *
+   * @param dst Memory for the image.
+   * @return The part of @a dst that was used, which is empty if @a dst is smaller than @c image_size.
+   *
+   * The start of @a dst should be aligned to @c detail::FrozenImageHeader::ALIGN bytes if the image
+   * is to be used in place, otherwise it can be copied to aligned memory such as a file.
+   */
+  MemSpan<char> write_image(MemSpan<char> dst) const;
+
+  /** Use the space in an image.
+   *
+   * @param image An image written by @c write_image.
+   * @return @c true if the image was valid and attached, @c false if not, in which case the space is
+   * unchanged.
+   *
+   * The image is used in place and must remain valid and unchanged for as long as it is attached.
+   * The header and section bounds are checked, but not the contents of the sections, and so the
+   * image must come from a trusted source. The start of the image must be aligned to at least the
+   * alignment of @c METRIC and @c PAYLOAD, which is always true for memory returned by @c mmap.
+   */
+  bool attach(MemSpan<char const> image);
+
+protected:
+  using header_type = detail::FrozenImageHeader;
+
+  // Storage for a space created from a @c DiscreteSpace. These are empty if attached to an image.
+  std::vector<METRIC> _tree_store;     ///< Range minimums in Eytzinger order, 1 based.
+  std::vector<size_t> _rank_store;     ///< Index in range order of the corresponding element of @a _tree.
+  std::vector<METRIC> _min_store;      ///< Range minimums in range order.
+  std::vector<METRIC> _max_store;      ///< Range maximums in range order.
+  std::vector<PAYLOAD> _payload_store; ///< Payloads in range order.
+
+  // Views of either the local storage or an attached image, used for lookup.
+  MemSpan<METRIC const> _tree;     ///< Range minimums in Eytzinger order, 1 based.
+  MemSpan<size_t const> _rank;     ///< Index in range order of the corresponding element of @a _tree.
+  MemSpan<METRIC const> _min;      ///< Range minimums in range order.
+  MemSpan<METRIC const> _max;      ///< Range maximums in range order.
+  MemSpan<PAYLOAD const> _payload; ///< Payloads in range order.
+
+  /// Set the views to the local storage.
+  void bind();
+
+  /// @return @c true if the views are of the local storage.
+  bool is_local() const;
+
+  /** Fill in the image header.
+   *
+   * @param hdr Header to fill.
+   * @param n Number of ranges.
+   *
+   * The sections are laid out in order after the header.
+   */
+  static void layout_image(header_type &hdr, size_t n);
+
+  /** Fill in the Eytzinger layout.
+   *
+   * @param idx Next index in range order to place.
+   * @param k Eytzinger index of the subtree.
+   */
+  void layout(size_t &idx, size_t k);
+
+  /** Convert a search leaf to a payload.
+   *
+   * @param metric The search metric.
+   * @param k The Eytzinger index at the end of the descent for @a metric.
+   * @return The payload for @a metric, or @c nullptr if not found.
+   */
+  PAYLOAD const *resolve(METRIC const &metric, size_t k) const;
+};
+
+template <typename METRIC, typename PAYLOAD>
+FrozenDiscreteSpace<METRIC, PAYLOAD>::FrozenDiscreteSpace(DiscreteSpace<METRIC, PAYLOAD> const &space) {
+  auto n = space.count();
+  _min_store.reserve(n);
+  _max_store.reserve(n);
+  _payload_store.reserve(n);
+  for (auto const &node : space) {
+    _min_store.push_back(node.min());
+    _max_store.push_back(node.max());
+    _payload_store.push_back(node.payload());
+  }
+  _tree_store.resize(n + 1);
+  _rank_store.resize(n + 1);
+  size_t idx = 0;
+  this->layout(idx, 1);
+  this->bind();
+}
+
+template <typename METRIC, typename PAYLOAD>
+FrozenDiscreteSpace<METRIC, PAYLOAD>::FrozenDiscreteSpace(self_type const &that)
+  : _tree_store(that._tree_store),
+    _rank_store(that._rank_store),
+    _min_store(that._min_store),
+    _max_store(that._max_store),
+    _payload_store(that._payload_store) {
+  if (that.is_local()) {
+    this->bind();
+  } else {
+    _tree    = that._tree;
+    _rank    = that._rank;
+    _min     = that._min;
+    _max     = that._max;
+    _payload = that._payload;
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+FrozenDiscreteSpace<METRIC, PAYLOAD>::operator=(self_type const &that) -> self_type & {
+  if (this != &that) {
+    *this = self_type(that);
+  }
+  return *this;
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+FrozenDiscreteSpace<METRIC, PAYLOAD>::bind() {
+  _tree    = {_tree_store.data(), _tree_store.size()};
+  _rank    = {_rank_store.data(), _rank_store.size()};
+  _min     = {_min_store.data(), _min_store.size()};
+  _max     = {_max_store.data(), _max_store.size()};
+  _payload = {_payload_store.data(), _payload_store.size()};
+}
+
+template <typename METRIC, typename PAYLOAD>
+bool
+FrozenDiscreteSpace<METRIC, PAYLOAD>::is_local() const {
+  return _tree.data() == _tree_store.data();
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+FrozenDiscreteSpace<METRIC, PAYLOAD>::layout(size_t &idx, size_t k) {
+  if (k < _tree_store.size()) {
+    this->layout(idx, 2 * k);
+    _tree_store[k] = _min_store[idx];
+    _rank_store[k] = idx++;
+    this->layout(idx, 2 * k + 1);
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+PAYLOAD const *
+FrozenDiscreteSpace<METRIC, PAYLOAD>::find(METRIC const &metric) const {
+  size_t k     = 1;
+  size_t limit = _tree.count();
+  // Descend to a leaf, going right if the minimum is not larger than @a metric.
+  while (k < limit) {
+    k = 2 * k + !(metric < _tree[k]);
+  }
+  return this->resolve(metric, k);
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+FrozenDiscreteSpace<METRIC, PAYLOAD>::find(MemSpan<METRIC const> metrics, MemSpan<PAYLOAD const *> results) const {
+  static constexpr size_t WIDTH = detail::FIND_BATCH_WIDTH;
+  auto n     = std::min(metrics.count(), results.count());
+  auto limit = _tree.count();
+  for (size_t base = 0; base < n; base += WIDTH) {
+    size_t width = std::min(WIDTH, n - base);
+    size_t ks[WIDTH];
+    std::fill(ks, ks + width, 1);
+    // All searches step together, each one until it passes the bottom of the tree.
+    for (bool active_p = limit > 1; active_p;) {
+      active_p = false;
+      for (size_t j = 0; j < width; ++j) {
+        if (size_t k = ks[j]; k < limit) {
+          k     = 2 * k + !(metrics[base + j] < _tree[k]);
+          ks[j] = k;
+          if (k < limit) {
+            detail::prefetch(_tree.data() + k);
+            active_p = true;
+          }
+        }
+      }
+    }
+    for (size_t j = 0; j < width; ++j) {
+      results[base + j] = this->resolve(metrics[base + j], ks[j]);
+    }
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+PAYLOAD const *
+FrozenDiscreteSpace<METRIC, PAYLOAD>::resolve(METRIC const &metric, size_t k) const {
+  // Back up to the last left turn, which is the first range with a larger minimum, or 0 if none.
+  k >>= detail::trailing_ones(k) + 1;
+  size_t idx = k ? _rank[k] : _payload.count();
+  // The candidate is the previous range, the last one with a minimum not larger than @a metric.
+  if (idx == 0 || _max[--idx] < metric) {
+    return nullptr;
+  }
+  return &_payload[idx];
+}
+
+template <typename METRIC, typename PAYLOAD>
+size_t
+FrozenDiscreteSpace<METRIC, PAYLOAD>::count() const {
+  return _payload.count();
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+FrozenDiscreteSpace<METRIC, PAYLOAD>::range_at(size_t idx) const -> range_type {
+  return {_min[idx], _max[idx]};
+}
+
+template <typename METRIC, typename PAYLOAD>
+PAYLOAD const &
+FrozenDiscreteSpace<METRIC, PAYLOAD>::payload_at(size_t idx) const {
+  return _payload[idx];
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+FrozenDiscreteSpace<METRIC, PAYLOAD>::layout_image(header_type &hdr, size_t n) {
+  size_t const sizes[header_type::N_SECTIONS] = {(n + 1) * sizeof(METRIC), (n + 1) * sizeof(size_t), n * sizeof(METRIC),
+                                                 n * sizeof(METRIC), n * sizeof(PAYLOAD)};
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr._magic, header_type::MAGIC, sizeof(hdr._magic));
+  hdr._version       = header_type::VERSION;
+  hdr._byte_order    = header_type::ORDER_MARK;
+  hdr._metric_size   = sizeof(METRIC);
+  hdr._metric_align  = alignof(METRIC);
+  hdr._payload_size  = sizeof(PAYLOAD);
+  hdr._payload_align = alignof(PAYLOAD);
+  hdr._rank_size     = sizeof(size_t);
+  hdr._count         = n;
+  size_t offset      = header_type::round_up(sizeof(header_type));
+  for (unsigned i = 0; i < header_type::N_SECTIONS; ++i) {
+    hdr._offset[i] = offset;
+    offset         = header_type::round_up(offset + sizes[i]);
+  }
+  hdr._size = offset;
+}
+
+template <typename METRIC, typename PAYLOAD>
+size_t
+FrozenDiscreteSpace<METRIC, PAYLOAD>::image_size() const {
+  header_type hdr;
+  layout_image(hdr, this->count());
+  return hdr._size;
+}
+
+template <typename METRIC, typename PAYLOAD>
+MemSpan<char>
+FrozenDiscreteSpace<METRIC, PAYLOAD>::write_image(MemSpan<char> dst) const {
+  static_assert(std::is_trivially_copyable_v<METRIC> && std::is_trivially_copyable_v<PAYLOAD>,
+                "FrozenDiscreteSpace images require trivially copyable metric and payload types.");
+  header_type hdr;
+  layout_image(hdr, this->count());
+  if (dst.size() < hdr._size) {
+    return {};
+  }
+  // Clear first so that the padding, including the unused first tree element, is always zero.
+  std::memset(dst.data(), 0, hdr._size);
+  std::memcpy(dst.data(), &hdr, sizeof(hdr));
+  auto write = [&](unsigned section, auto const &span) {
+    if (span.size()) {
+      std::memcpy(dst.data() + hdr._offset[section], span.data(), span.size());
+    }
+  };
+  write(header_type::TREE, _tree);
+  write(header_type::RANK, _rank);
+  write(header_type::MIN, _min);
+  write(header_type::MAX, _max);
+  write(header_type::PAYLOAD, _payload);
+  return dst.prefix(hdr._size);
+}
+
+template <typename METRIC, typename PAYLOAD>
+bool
+FrozenDiscreteSpace<METRIC, PAYLOAD>::attach(MemSpan<char const> image) {
+  static_assert(std::is_trivially_copyable_v<METRIC> && std::is_trivially_copyable_v<PAYLOAD>,
+                "FrozenDiscreteSpace images require trivially copyable metric and payload types.");
+  header_type hdr;
+  if (image.size() < sizeof(hdr)) {
+    return false;
+  }
+  std::memcpy(&hdr, image.data(), sizeof(hdr));
+  if (0 != std::memcmp(hdr._magic, header_type::MAGIC, sizeof(hdr._magic)) || hdr._version != header_type::VERSION ||
+      hdr._byte_order != header_type::ORDER_MARK || hdr._size > image.size() ||
+      hdr._count >= std::numeric_limits<size_t>::max() / 2 / std::max(sizeof(METRIC), sizeof(PAYLOAD))) {
+    return false;
+  }
+  // The layout is fully determined by the types and count, so a mismatch in any of the type sizes or
+  // offsets means the image is not for this type.
+  header_type expected;
+  layout_image(expected, hdr._count);
+  if (0 != std::memcmp(&hdr, &expected, sizeof(hdr))) {
+    return false;
+  }
+  auto base = image.data();
+  if (reinterpret_cast<uintptr_t>(base) % std::max(alignof(METRIC), alignof(PAYLOAD))) {
+    return false;
+  }
+  size_t n = hdr._count;
+  _tree    = {reinterpret_cast<METRIC const *>(base + hdr._offset[header_type::TREE]), n + 1};
+  _rank    = {reinterpret_cast<size_t const *>(base + hdr._offset[header_type::RANK]), n + 1};
+  _min     = {reinterpret_cast<METRIC const *>(base + hdr._offset[header_type::MIN]), n};
+  _max     = {reinterpret_cast<METRIC const *>(base + hdr._offset[header_type::MAX]), n};
+  _payload = {reinterpret_cast<PAYLOAD const *>(base + hdr._offset[header_type::PAYLOAD]), n};
+  _tree_store.clear();
+  _rank_store.clear();
+  _min_store.clear();
+  _max_store.clear();
+  _payload_store.clear();
+  return true;
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+DiscreteSpace<METRIC, PAYLOAD>::freeze() const -> FrozenDiscreteSpace<METRIC, PAYLOAD> {
+  return FrozenDiscreteSpace<METRIC, PAYLOAD>{*this};
+}
+
+/** A persistent (copy on write) form of a @c DiscreteSpace.
+ *
+ * @tparam METRIC Value type for the space.
+ * @tparam PAYLOAD Data stored with values in the space.
+ *
+ * Each change creates a new @c Version of the space which shares all of the unchanged nodes with
+ * the previous version, so that a change touching a few ranges takes time and memory logarithmic in
+ * the number of ranges. Versions are immutable and the nodes are reference counted, so a reader can
+ * use a version from @c snapshot for as long as it likes, from any thread, without locking, and the
+ * nodes are released when the last version using them is destroyed.
+ *
+ * The tree is a treap, rather than a red black tree, because it can be split and joined without
+ * parent pointers and rebalancing touches only the nodes on the search path.
+ *
+ * Readers can run concurrently with a writer, but changes must be serialized by the caller.
+ */
+template <typename METRIC, typename PAYLOAD> class PersistentDiscreteSpace {
+  using self_type = PersistentDiscreteSpace;
+
+public:
+  using metric_type  = METRIC;  ///< Export.
+  using payload_type = PAYLOAD; ///< Export.
+  using range_type   = DiscreteRange<METRIC>;
+
+protected:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  /// A node in the tree. Nodes are never changed after construction.
+  struct Node {
+    range_type _range;   ///< Range covered by this node.
+    PAYLOAD _payload;    ///< Payload for the range.
+    NodePtr _left;       ///< Subtree with smaller ranges.
+    NodePtr _right;      ///< Subtree with larger ranges.
+    uint32_t _priority;  ///< Heap priority, larger is closer to the root.
+    size_t _count;       ///< Number of nodes in the subtree rooted at this node.
+
+    Node(range_type const &range, PAYLOAD const &payload, uint32_t priority, NodePtr left, NodePtr right)
+      : _range(range), _payload(payload), _left(std::move(left)), _right(std::move(right)), _priority(priority),
+        _count(1 + (_left ? _left->_count : 0) + (_right ? _right->_count : 0)) {}
+  };
+
+  /// A range and payload, used while building the nodes for a change.
+  struct Item {
+    range_type _range;
+    PAYLOAD _payload;
+  };
+  using Items = std::vector<Item>;
+
+public:
+  /** An immutable version of the space.
+   *
+   * This is a cheap handle which can be copied freely. Changes return a new version and do not
+   * affect this one.
+   */
+  class Version {
+    friend class PersistentDiscreteSpace;
+
+  public:
+    /// Construct an empty version.
+    Version() = default;
+
+    /** Find the payload at @a metric.
+     *
+     * @param metric The metric for which to search.
+     * @return The payload for @a metric if found, @c nullptr if not found.
+     */
+    PAYLOAD const *find(METRIC const &metric) const;
+
+    /// @return The number of distinct ranges.
+    size_t count() const { return _root ? _root->_count : 0; }
+
+    /** Invoke @a f for each range in order.
+     *
+     * @tparam F Functor type, with the signature <tt>void (range_type const&, PAYLOAD const&)</tt>.
+     * @param f The functor.
+     */
+    template <typename F> void apply(F &&f) const { apply_subtree(_root.get(), f); }
+
+    /// @return A version with @a range set to @a payload.
+    /// @see DiscreteSpace::mark
+    Version mark(range_type const &range, PAYLOAD const &payload) const;
+
+    /// @return A version with the values in @a range that have no payload set to @a payload.
+    /// @see DiscreteSpace::fill
+    Version fill(range_type const &range, PAYLOAD const &payload) const;
+
+    /// @return A version with @a color blended in to @a range.
+    /// @see DiscreteSpace::blend
+    template <typename F, typename U = PAYLOAD> Version blend(range_type const &range, U const &color, F &&blender) const;
+
+    /// @return A version with @a range removed.
+    /// @see DiscreteSpace::erase
+    Version erase(range_type const &range) const;
+
+  protected:
+    NodePtr _root; ///< Root of the tree, @c nullptr if empty.
+
+    explicit Version(NodePtr root) : _root(std::move(root)) {}
+
+    template <typename F>
+    static void
+    apply_subtree(Node const *n, F &&f) {
+      for (; n; n = n->_right.get()) {
+        apply_subtree(n->_left.get(), f);
+        f(n->_range, n->_payload);
+      }
+    }
+
+    /** Replace the values in @a range.
+     *
+     * @param range Range to change.
+     * @param f Functor which computes the new items for @a range from the existing ones.
+     * @return The new version.
+     *
+     * @a f is passed the existing items in @a range, clipped to @a range, and must replace them with
+     * the new items for @a range, in order.
+     */
+    template <typename F> Version update(range_type const &range, F &&f) const;
+
+    /** Find the gaps in @a range.
+     *
+     * @param range Range of interest.
+     * @param items Existing items in @a range.
+     * @param existing Functor called for each existing item.
+     * @param gap Functor called for each gap, that is each maximal range in @a range which is not in
+     * @a items.
+     *
+     * The functors are passed the replacement items and an existing item or a gap, in order, and
+     * add to the replacement items as needed. @a items is then set to the replacement items.
+     */
+    template <typename E, typename G> static void weave(range_type const &range, Items &items, E &&existing, G &&gap);
+  };
+
+  /** Get the current version.
+   *
+   * @return The current version.
+   *
+   * This is safe to call at the same time as a change to the space. The version remains valid
+   * regardless of any later changes.
+   */
+  Version snapshot() const;
+
+  /** Make @a version the current version.
+   *
+   * @param version The new version.
+   * @return @a this
+   *
+   * This can be used to publish several changes at once.
+   */
+  self_type &publish(Version const &version);
+
+  /// Set the @a payload for a @a range. @see DiscreteSpace::mark
+  self_type &mark(range_type const &range, PAYLOAD const &payload);
+
+  /// Fill @a range with @a payload. @see DiscreteSpace::fill
+  self_type &fill(range_type const &range, PAYLOAD const &payload);
+
+  /// Blend a @a color to a @a range. @see DiscreteSpace::blend
+  template <typename F, typename U = PAYLOAD> self_type &blend(range_type const &range, U const &color, F &&blender);
+
+  /// Erase a @a range. @see DiscreteSpace::erase
+  self_type &erase(range_type const &range);
+
+  /// Remove all ranges.
+  self_type &clear();
+
+  /// @return The number of distinct ranges in the current version.
+  size_t count() const { return this->snapshot().count(); }
+
+  /// Find the payload at @a metric in the current version.
+  /// @note The payload is valid only as long as the version, prefer @c snapshot if there are concurrent changes.
+  PAYLOAD const *find(METRIC const &metric) const { return this->snapshot().find(metric); }
+
+protected:
+  NodePtr _root; ///< Root of the current version, accessed only atomically.
+
+  /// @return A pseudo random node priority.
+  static uint32_t next_priority();
+
+  /// @return A new node.
+  static NodePtr make(range_type const &range, PAYLOAD const &payload, uint32_t priority, NodePtr left, NodePtr right) {
+    return std::make_shared<const Node>(range, payload, priority, std::move(left), std::move(right));
+  }
+
+  /// @return A tree with the nodes in @a lhs followed by the nodes in @a rhs.
+  static NodePtr join(NodePtr const &lhs, NodePtr const &rhs);
+
+  /** Split a tree.
+   *
+   * @param n Root of the tree.
+   * @param metric Split value.
+   * @param lhs [out] Nodes with a minimum less than @a metric.
+   * @param rhs [out] Nodes with a minimum at least @a metric.
+   */
+  static void split(NodePtr const &n, METRIC const &metric, NodePtr &lhs, NodePtr &rhs);
+
+  /// @return The first node in the non-empty tree @a n.
+  static Node const *
+  first(NodePtr const &n) {
+    auto p = n.get();
+    while (p->_left) {
+      p = p->_left.get();
+    }
+    return p;
+  }
+
+  /// @return The last node in the non-empty tree @a n.
+  static Node const *
+  last(NodePtr const &n) {
+    auto p = n.get();
+    while (p->_right) {
+      p = p->_right.get();
+    }
+    return p;
+  }
+
+  /// @return The tree @a n without its last node, which is stored in @a last.
+  static NodePtr remove_last(NodePtr const &n, NodePtr &last);
+
+  /// @return The tree @a n without its first node, which is stored in @a first.
+  static NodePtr remove_first(NodePtr const &n, NodePtr &first);
+
+  /// @return @c true if @a lhs is immediately followed by @a rhs with the same payload.
+  static bool
+  is_mergeable(Item const &lhs, Item const &rhs) {
+    auto max_plus_1 = lhs._range.max();
+    ++max_plus_1; // not used if it wraps, as there is no larger @a rhs.
+    return max_plus_1 == rhs._range.min() && lhs._payload == rhs._payload;
+  }
+};
+
+template <typename METRIC, typename PAYLOAD>
+uint32_t
+PersistentDiscreteSpace<METRIC, PAYLOAD>::next_priority() {
+  // xorshift, seeded differently per thread. The quality needed is only enough to balance the tree.
+  static std::atomic<uint32_t> seed{0x9e3779b9};
+  thread_local uint32_t state = seed.fetch_add(0x6d2b79f5) | 1;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::join(NodePtr const &lhs, NodePtr const &rhs) -> NodePtr {
+  if (!lhs) {
+    return rhs;
+  }
+  if (!rhs) {
+    return lhs;
+  }
+  if (lhs->_priority > rhs->_priority) {
+    return make(lhs->_range, lhs->_payload, lhs->_priority, lhs->_left, join(lhs->_right, rhs));
+  }
+  return make(rhs->_range, rhs->_payload, rhs->_priority, join(lhs, rhs->_left), rhs->_right);
+}
+
+template <typename METRIC, typename PAYLOAD>
+void
+PersistentDiscreteSpace<METRIC, PAYLOAD>::split(NodePtr const &n, METRIC const &metric, NodePtr &lhs, NodePtr &rhs) {
+  if (!n) {
+    lhs = rhs = nullptr;
+  } else if (n->_range.min() < metric) {
+    NodePtr tmp;
+    split(n->_right, metric, tmp, rhs);
+    lhs = make(n->_range, n->_payload, n->_priority, n->_left, std::move(tmp));
+  } else {
+    NodePtr tmp;
+    split(n->_left, metric, lhs, tmp);
+    rhs = make(n->_range, n->_payload, n->_priority, std::move(tmp), n->_right);
+  }
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::remove_last(NodePtr const &n, NodePtr &last) -> NodePtr {
+  if (!n->_right) {
+    last = n;
+    return n->_left;
+  }
+  return make(n->_range, n->_payload, n->_priority, n->_left, remove_last(n->_right, last));
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::remove_first(NodePtr const &n, NodePtr &first) -> NodePtr {
+  if (!n->_left) {
+    first = n;
+    return n->_right;
+  }
+  return make(n->_range, n->_payload, n->_priority, remove_first(n->_left, first), n->_right);
+}
+
+template <typename METRIC, typename PAYLOAD>
+PAYLOAD const *
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::find(METRIC const &metric) const {
+  for (auto n = _root.get(); n;) {
+    if (metric < n->_range.min()) {
+      n = n->_left.get();
+    } else if (n->_range.max() < metric) {
+      n = n->_right.get();
+    } else {
+      return &n->_payload;
+    }
+  }
+  return nullptr;
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename F>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::update(range_type const &range, F &&f) const -> Version {
+  auto const &min = range.min();
+  auto const &max = range.max();
+  Items items;    // Existing items in @a range, then their replacements.
+  Items edges[2]; // Parts of nodes that straddle the ends of @a range.
+  NodePtr lhs, mid, rhs, n;
+
+  // Split in to nodes before @a range, in @a range, and after @a range. There may be a node in the left
+  // part that straddles the start of @a range, and a node in the middle that straddles the end.
+  PersistentDiscreteSpace::split(_root, min, lhs, mid);
+  if (lhs && !(PersistentDiscreteSpace::last(lhs)->_range.max() < min)) {
+    lhs        = PersistentDiscreteSpace::remove_last(lhs, n);
+    auto min_1 = min;
+    --min_1; // OK because @a n starts before @a min.
+    edges[0].push_back({{n->_range.min(), min_1}, n->_payload});
+    if (max < n->_range.max()) {
+      auto max_plus_1 = max;
+      ++max_plus_1; // OK because @a n ends after @a max.
+      items.push_back({range, n->_payload});
+      edges[1].push_back({{max_plus_1, n->_range.max()}, n->_payload});
+    } else {
+      items.push_back({{min, n->_range.max()}, n->_payload});
+    }
+  }
+  if (!(max == detail::maximum<METRIC>())) {
+    auto max_plus_1 = max;
+    ++max_plus_1;
+    NodePtr tmp;
+    PersistentDiscreteSpace::split(mid, max_plus_1, tmp, rhs);
+    mid = std::move(tmp);
+  }
+  Version::apply_subtree(mid.get(), [&](range_type const &r, PAYLOAD const &payload) {
+    if (max < r.max()) {
+      auto max_plus_1 = max;
+      ++max_plus_1;
+      items.push_back({{r.min(), max}, payload});
+      edges[1].push_back({{max_plus_1, r.max()}, payload});
+    } else {
+      items.push_back({r, payload});
+    }
+  });
+
+  f(items);
+
+  // Assemble the new items with the edges, coalescing.
+  Items merged;
+  merged.reserve(items.size() + 2);
+  for (auto *part : {&edges[0], &items, &edges[1]}) {
+    for (auto &item : *part) {
+      if (!merged.empty() && PersistentDiscreteSpace::is_mergeable(merged.back(), item)) {
+        merged.back()._range.assign_max(item._range.max());
+      } else {
+        merged.push_back(std::move(item));
+      }
+    }
+  }
+  // Check the neighbors outside of @a range.
+  if (!merged.empty()) {
+    if (lhs) {
+      auto last = PersistentDiscreteSpace::last(lhs);
+      if (PersistentDiscreteSpace::is_mergeable({last->_range, last->_payload}, merged.front())) {
+        merged.front()._range.assign_min(last->_range.min());
+        lhs = PersistentDiscreteSpace::remove_last(lhs, n);
+      }
+    }
+    if (rhs) {
+      auto first = PersistentDiscreteSpace::first(rhs);
+      if (PersistentDiscreteSpace::is_mergeable(merged.back(), {first->_range, first->_payload})) {
+        merged.back()._range.assign_max(first->_range.max());
+        rhs = PersistentDiscreteSpace::remove_first(rhs, n);
+      }
+    }
+  }
+
+  for (auto const &item : merged) {
+    lhs = PersistentDiscreteSpace::join(lhs, PersistentDiscreteSpace::make(item._range, item._payload, PersistentDiscreteSpace::next_priority(), nullptr, nullptr));
+  }
+  return Version{PersistentDiscreteSpace::join(lhs, rhs)};
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::mark(range_type const &range, PAYLOAD const &payload) const -> Version {
+  return this->update(range, [&](Items &items) {
+    items.clear();
+    items.push_back({range, payload});
+  });
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::erase(range_type const &range) const -> Version {
+  return this->update(range, [&](Items &items) { items.clear(); });
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::fill(range_type const &range, PAYLOAD const &payload) const -> Version {
+  return this->update(range, [&](Items &items) {
+    Version::weave(
+      range, items, [](Items &zret, Item &item) { zret.push_back(std::move(item)); },
+      [&](Items &zret, range_type const &gap) { zret.push_back({gap, payload}); });
+  });
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename F, typename U>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::blend(range_type const &range, U const &color, F &&blender) const -> Version {
+  // As for @c DiscreteSpace, check once whether unmapped values get a color.
+  auto plain_color   = PAYLOAD();
+  bool plain_color_p = blender(plain_color, color);
+  return this->update(range, [&](Items &items) {
+    Version::weave(
+      range, items,
+      [&](Items &zret, Item &item) {
+        if (blender(item._payload, color)) {
+          zret.push_back(std::move(item));
+        }
+      },
+      [&](Items &zret, range_type const &gap) {
+        if (plain_color_p) {
+          zret.push_back({gap, plain_color});
+        }
+      });
+  });
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename E, typename G>
+void
+PersistentDiscreteSpace<METRIC, PAYLOAD>::Version::weave(range_type const &range, Items &items, E &&existing, G &&gap) {
+  Items zret;
+  auto cursor = range.min(); // Start of the next gap.
+  bool done_p = false;       // Set if the last item ends at the end of @a range, when @a cursor can't be incremented.
+  for (auto &item : items) {
+    if (cursor < item._range.min()) {
+      auto gap_max = item._range.min();
+      --gap_max;
+      gap(zret, range_type{cursor, gap_max});
+    }
+    existing(zret, item);
+    if (item._range.max() == range.max()) {
+      done_p = true;
+    } else {
+      cursor = item._range.max();
+      ++cursor;
+    }
+  }
+  if (!done_p) {
+    gap(zret, range_type{cursor, range.max()});
+  }
+  items = std::move(zret);
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::snapshot() const -> Version {
+  return Version{std::atomic_load(&_root)};
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::publish(Version const &version) -> self_type & {
+  std::atomic_store(&_root, version._root);
+  return *this;
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::mark(range_type const &range, PAYLOAD const &payload) -> self_type & {
+  return this->publish(this->snapshot().mark(range, payload));
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::fill(range_type const &range, PAYLOAD const &payload) -> self_type & {
+  return this->publish(this->snapshot().fill(range, payload));
+}
+
+template <typename METRIC, typename PAYLOAD>
+template <typename F, typename U>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::blend(range_type const &range, U const &color, F &&blender) -> self_type & {
+  return this->publish(this->snapshot().blend(range, color, std::forward<F>(blender)));
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::erase(range_type const &range) -> self_type & {
+  return this->publish(this->snapshot().erase(range));
+}
+
+template <typename METRIC, typename PAYLOAD>
+auto
+PersistentDiscreteSpace<METRIC, PAYLOAD>::clear() -> self_type & {
+  return this->publish(Version{});
+}
+
+/** A @c DiscreteSpace with interned payloads.
+ *
+ * @tparam METRIC Value type for the space.
+ * @tparam PAYLOAD Data stored with values in the space.
+ * @tparam INDEX Integral type for payload indices.
+ * @tparam HASH Hash functor for @c PAYLOAD.
+ *
+ * This is for spaces with many ranges but few distinct payloads. Each distinct payload is stored
+ * once in a table and the ranges store only an index in to the table, so a range costs the size of
+ * @a INDEX instead of the size of @c PAYLOAD and comparing payloads while coalescing is an integer
+ * compare. Payloads are never removed from the table, which is expected to stay small.
+ *
+ * Index 0 is always a default constructed @c PAYLOAD, which is used as the plain color for blending.
+ */
+template <typename METRIC, typename PAYLOAD, typename INDEX = uint32_t, typename HASH = std::hash<PAYLOAD>>
+class InternedDiscreteSpace {
+  using self_type = InternedDiscreteSpace;
+
+public:
+  using metric_type  = METRIC;  ///< Export.
+  using payload_type = PAYLOAD; ///< Export.
+  using index_type   = INDEX;   ///< Export.
+  using range_type   = DiscreteRange<METRIC>;
+  using space_type   = DiscreteSpace<METRIC, INDEX>; ///< Space of payload indices.
+
+  static_assert(std::is_integral_v<INDEX> && std::is_unsigned_v<INDEX>, "INDEX must be an unsigned integral type");
+
+  /// Construct an empty space.
+  InternedDiscreteSpace() { this->intern(PAYLOAD{}); }
+
+  /** Construct with an external arena for node storage.
+   *
+   * @param arena The arena for nodes.
+   *
+   * @see DiscreteSpace::DiscreteSpace(MemArena &)
+   */
+  explicit InternedDiscreteSpace(MemArena &arena) : _space(arena) { this->intern(PAYLOAD{}); }
+
+  /** Set the @a payload for a @a range
+   *
+   * @param range Range to mark.
+   * @param payload Payload to set.
+   * @return @a this
+   *
+   * @see DiscreteSpace::mark
+   */
+  self_type &mark(range_type const &range, PAYLOAD const &payload);
+
+  /** Blend a @a color to a @a range.
+   *
+   * @tparam F Functor to blend payloads.
+   * @tparam U type to blend in to payloads.
+   * @param range Range for blending.
+   * @param color Payload to blend.
+   * @return @a this
+   *
+   * @see DiscreteSpace::blend
+   */
+  template <typename F, typename U = PAYLOAD> self_type &blend(range_type const &range, U const &color, F &&blender);
+
+  /** Find the payload at @a metric.
+   *
+   * @param metric The metric for which to search.
+   * @return The payload for @a metric if found, @c nullptr if not found.
+   *
+   * The payload is valid until the next change to the space.
+   */
+  PAYLOAD const *find(METRIC const &metric);
+
+  /// @return The number of distinct ranges.
+  size_t count() const { return _space.count(); }
+
+  /// @return The number of distinct payloads, including the default payload.
+  size_t payload_count() const { return _payloads.size(); }
+
+  /** Get the index for a payload.
+   *
+   * @param payload The payload.
+   * @return The index of @a payload in the table, which is updated if needed.
+   */
+  INDEX intern(PAYLOAD const &payload);
+
+  /// @return The payload for @a idx.
+  PAYLOAD const &payload_at(INDEX idx) const { return _payloads[idx]; }
+
+  /// @return The space of payload indices, e.g. to iterate over the ranges.
+  space_type const &space() const { return _space; }
+
+  /// Remove all ranges and payloads.
+  void clear();
+
+protected:
+  space_type _space;                             ///< Ranges, with payload indices.
+  std::vector<PAYLOAD> _payloads;                ///< Distinct payloads.
+  std::unordered_multimap<size_t, INDEX> _index; ///< Payload hash to index.
+};
+
+template <typename METRIC, typename PAYLOAD, typename INDEX, typename HASH>
+INDEX
+InternedDiscreteSpace<METRIC, PAYLOAD, INDEX, HASH>::intern(PAYLOAD const &payload) {
+  auto hash     = HASH{}(payload);
+  auto [lo, hi] = _index.equal_range(hash);
+  for (; lo != hi; ++lo) {
+    if (_payloads[lo->second] == payload) {
+      return lo->second;
+    }
+  }
+  if (_payloads.size() > std::numeric_limits<INDEX>::max()) {
+    throw std::length_error("InternedDiscreteSpace: too many distinct payloads for the index type");
+  }
+  auto idx = static_cast<INDEX>(_payloads.size());
+  _payloads.push_back(payload);
+  _index.emplace(hash, idx);
+  return idx;
+}
+
+template <typename METRIC, typename PAYLOAD, typename INDEX, typename HASH>
+auto
+InternedDiscreteSpace<METRIC, PAYLOAD, INDEX, HASH>::mark(range_type const &range, PAYLOAD const &payload) -> self_type & {
+  _space.mark(range, this->intern(payload));
+  return *this;
+}
+
+template <typename METRIC, typename PAYLOAD, typename INDEX, typename HASH>
+template <typename F, typename U>
+auto
+InternedDiscreteSpace<METRIC, PAYLOAD, INDEX, HASH>::blend(range_type const &range, U const &color, F &&blender) -> self_type & {
+  // Ranges with the same payload almost always blend to the same result, so remember the last one.
+  INDEX last_src    = 0;
+  INDEX last_dst    = 0;
+  bool last_p       = false;
+  bool last_valid_p = false;
+  _space.blend(range, color, [&](INDEX &idx, U const &c) -> bool {
+    if (!last_valid_p || idx != last_src) {
+      PAYLOAD payload{_payloads[idx]};
+      last_src     = idx;
+      last_p       = blender(payload, c);
+      last_dst     = last_p ? this->intern(payload) : 0;
+      last_valid_p = true;
+    }
+    idx = last_dst;
+    return last_p;
+  });
+  return *this;
+}
+
+template <typename METRIC, typename PAYLOAD, typename INDEX, typename HASH>
+PAYLOAD const *
+InternedDiscreteSpace<METRIC, PAYLOAD, INDEX, HASH>::find(METRIC const &metric) {
+  auto idx = _space.find(metric);
+  return idx ? &_payloads[*idx] : nullptr;
+}
+
+template <typename METRIC, typename PAYLOAD, typename INDEX, typename HASH>
+void
+InternedDiscreteSpace<METRIC, PAYLOAD, INDEX, HASH>::clear() {
+  _space.clear();
+  _payloads.clear();
+  _index.clear();
+  this->intern(PAYLOAD{});
+}
+
 } // namespace swoc
@@ -55,6 +55,8 @@
 #include <string_view>
 #include <functional>
 #include <atomic>
+#include <algorithm>
+#include <type_traits>
 #include "swoc/MemArena.h"
 #include "swoc/bwf_base.h"
 #include "swoc/IntrusiveDList.h"
@@ -139,6 +141,65 @@ protected:
   /// Internally the vector is accessed backwards, in order to make it LIFO.
   using Container = IntrusiveDList<Annotation::Linkage>;
 
+  /** Render a deferred annotation.
+   *
+   * @param w Output.
+   * @param capture The captured format and arguments.
+   * @param base The base address for captured strings.
+   */
+  using Render = void (*)(BufferWriter &w, void const *capture, char const *base);
+
+  /** Copy a deferred annotation capture.
+   *
+   * @param dst Uninitialized storage for the copy.
+   * @param src The captured format and arguments.
+   */
+  using Copy = void (*)(void *dst, void const *src);
+
+  /// A deferred annotation in the arena.
+  struct Pending {
+    Pending *_next;        ///< Next pending annotation.
+    Annotation *_note;     ///< Annotation to receive the text.
+    Render _render;        ///< Rendering function.
+    void const *_capture;  ///< Captured format and arguments.
+    char const *_base;     ///< Base for captured strings.
+  };
+
+  /** A captured string argument.
+   *
+   * This is stored as an offset from a base address so that inline captures can be copied as raw
+   * memory when the instance is moved. For captures in the arena the base is @c nullptr.
+   */
+  struct CapturedString {
+    uintptr_t _offset; ///< Offset from base.
+    size_t _size;      ///< Length.
+
+    /// @return A view of the string relative to @a base.
+    std::string_view
+    view(char const *base) const {
+      return {reinterpret_cast<char const *>(reinterpret_cast<uintptr_t>(base) + _offset), _size};
+    }
+  };
+
+  /// Arguments that convert to strings are captured as a copy of the string.
+  template <typename T>
+  static constexpr bool is_string_arg_v = std::is_convertible_v<std::decay_t<T> const &, std::string_view>;
+
+  /// The captured type for an argument.
+  template <typename T> using capture_t = std::conditional_t<is_string_arg_v<T>, CapturedString, std::decay_t<T>>;
+
+  /// Captured format and arguments for a deferred annotation.
+  template <typename... Args> struct Deferred {
+    bwf::Format const *_fmt;               ///< Format, which must outlive the annotation.
+    std::tuple<capture_t<Args>...> _args; ///< Captured arguments.
+
+    /// Implementation of @c Render for this capture.
+    static void render(BufferWriter &w, void const *capture, char const *base);
+
+    /// Implementation of @c Copy for this capture.
+    static void copy(void *dst, void const *src);
+  };
+
   /// Implementation class.
   struct Data {
     using self_type = Data; ///< Self reference type.
@@ -162,6 +223,18 @@ protected:
     /// Allocate from the arena.
     swoc::MemSpan<char> alloc(size_t n);
 
+    /// Construct an instance of @a T in the arena. Text is unaligned, so this aligns for @a T.
+    template <typename T, typename... Args> T *make(Args &&... args);
+
+    /** Render a deferred annotation in to the arena.
+     *
+     * @param render Rendering function.
+     * @param capture Captured format and arguments.
+     * @param base Base for captured strings.
+     * @return The rendered text.
+     */
+    std::string_view render(Render render, void const *capture, char const *base);
+
     /// Reference count.
     std::atomic<int> _ref_count{0};
 
@@ -173,12 +246,87 @@ protected:
     unsigned _level{0};
     /// The effective severity of the message stack.
     Severity _severity{Errata::DEFAULT_SEVERITY};
+    /// Deferred annotations not yet rendered.
+    Pending *_pending{nullptr};
+  };
+
+  /** Inline storage for the first few annotations.
+   *
+   * Most instances that are not empty have only one or two short annotations. These are kept in
+   * the instance until there are too many or a copy is made, at which point they are moved to a
+   * @c Data instance. This avoids the arena and reference counting in the common case, at the cost
+   * of the size of an @c Errata, which is 224 bytes rather than a pointer.
+   */
+  struct Inline {
+    using self_type = Inline; ///< Self reference type.
+
+    static constexpr size_t N_NOTES   = 2;   ///< Maximum number of inline annotations.
+    static constexpr size_t TEXT_SIZE = 72;  ///< Inline text storage size.
+
+    /// Annotation @a idx, in insertion order.
+    Annotation &operator[](unsigned idx);
+    /// Annotation @a idx, in insertion order.
+    Annotation const &operator[](unsigned idx) const;
+
+    /// Space available for the text of another annotation, empty if no more annotations fit.
+    MemSpan<char> remnant();
+
+    /** Add an annotation.
+     *
+     * @param severity Severity of the annotation.
+     * @param n Size of the text, which must already be in @c remnant.
+     */
+    void commit(Severity severity, size_t n);
+
+    /** Allocate inline storage for a deferred annotation.
+     *
+     * @param n Number of bytes.
+     * @param align Alignment.
+     * @return The storage, or @c nullptr if there is not enough space or no more annotations fit.
+     */
+    char *alloc(size_t n, size_t align);
+
+    /** Add a deferred annotation.
+     *
+     * @param severity Severity of the annotation.
+     * @param render Rendering function.
+     * @param copy Copy function for the capture.
+     * @param capture Captured format and arguments, which must be from @c alloc.
+     */
+    void commit(Severity severity, Render render, Copy copy, char const *capture);
+
+    /** Copy the text to @a dst.
+     *
+     * @param dst Destination, at least @a _used bytes.
+     *
+     * Text is copied as characters, and the captures of deferred annotations are copied as
+     * objects in the same place.
+     */
+    void copy_text(char *dst) const;
+
+    /// Copy the annotations from @a that, which must be empty.
+    void copy(self_type const &that);
+
+    /// Remove all annotations.
+    void clear();
+
+    /// Storage for the annotations, constructed on demand.
+    std::aligned_storage_t<sizeof(Annotation), alignof(Annotation)> _slots[N_NOTES];
+    Container _notes;                             ///< The message stack.
+    Render _render[N_NOTES];                      ///< Rendering function, if deferred.
+    Copy _copy[N_NOTES];                          ///< Capture copy function, if deferred.
+    uint8_t _capture[N_NOTES];                    ///< Offset of the capture in @a _text, if deferred.
+    uint8_t _count{0};                            ///< Number of annotations.
+    uint8_t _n_pending{0};                        ///< Number of deferred annotations.
+    uint8_t _used{0};                             ///< Bytes used in @a _text.
+    Severity _severity{Errata::DEFAULT_SEVERITY}; ///< Effective severity.
+    alignas(8) char _text[TEXT_SIZE];             ///< Annotation text and capture storage.
   };
 
 public:
   /// Default constructor - empty errata, very fast.
   Errata();
-  Errata(self_type const &that);                                   ///< Reference counting copy constructor.
+  Errata(self_type const &that);                                   ///< Copy, sharing out of line data.
   Errata(self_type &&that);                                        ///< Move constructor.
   self_type &operator=(self_type const &that) = delete;            // no copy assignemnt.
   self_type &operator                         =(self_type &&that); ///< Move assignment.
@@ -205,6 +353,22 @@ public:
   */
   template <typename... Args> self_type &note_v(Severity severity, std::string_view fmt, std::tuple<Args...> const &args);
 
+  /** Add a deferred annotation.
+   *
+   * @tparam Args Format argument types.
+   * @param severity Severity of the annotation.
+   * @param fmt Pre-parsed format.
+   * @param args Arguments for @a fmt.
+   * @return @a *this
+   *
+   * The text is not rendered until it is used - an annotation is accessed, the instance is written
+   * or formatted, or passed to a sink. If the instance is cleared or discarded without any sinks,
+   * the text is never rendered. Arguments that convert to @c std::string_view are captured as
+   * copies of the string, other arguments are copied and must be trivially copyable. @a fmt is not
+   * copied and must outlive the instance, which generally means it is a static or global.
+   */
+  template <typename... Args> self_type &note_deferred(Severity severity, bwf::Format const &fmt, Args &&... args);
+
   /** Copy messages from @a that to @a this.
    *
    * @param that Source object from which to copy.
@@ -347,11 +511,17 @@ protected:
   // case. The problem is code that wants to work with an instance, which is common. In such cases
   // the instance is constructed just as it is returned (e.g. std::string). Code would therefore
   // have to call std::move for every return, which is not going to be done reliably.
-  Data *_data{nullptr};
+  // These are mutable because moving inline annotations to the data, as is done to share them,
+  // doesn't change the annotations.
+  mutable Data *_data{nullptr};
+
+  /// Annotations, if @a _data is @c nullptr.
+  mutable Inline _inline;
 
   /// Force data existence.
+  /// If there are inline annotations these are moved to the data.
   /// @return A pointer to the data.
-  const Data *data();
+  const Data *data() const;
 
   /// Get a writeable data pointer.
   /// @internal It is a fatal error to ask for writeable data if there are shared references.
@@ -367,6 +537,25 @@ protected:
   /// Add a note which is already localized.
   self_type &note_localized(Severity, std::string_view const &text);
 
+  /// @return @c true if there are deferred annotations that are not rendered.
+  bool is_pending() const;
+
+  /// Render all deferred annotations.
+  void render_pending();
+
+  /// Copy the string content of @a arg to @a chars and return the capture, or just return @a arg.
+  template <typename T> static capture_t<T> capture(T &&arg, char const *base, char *&chars);
+
+  /// Render all deferred annotations, if any.
+  /// This is logically @c const because deferred annotations have no visible text.
+  void
+  render_if_pending() const {
+    if (this->is_pending())
+    {
+      const_cast<self_type *>(this)->render_pending();
+    }
+  }
+
   /// Used for returns when no data is present.
   static Annotation const NIL_NOTE;
 
@@ -638,11 +827,64 @@ Errata::Data::alloc(size_t n) {
   return _arena.alloc(n).rebind<char>();
 }
 
+template <typename T, typename... Args>
+T *
+Errata::Data::make(Args &&... args) {
+  return new (_arena.alloc(sizeof(T), alignof(T)).data()) T(std::forward<Args>(args)...);
+}
+
 inline bool
 Errata::Data::empty() const {
   return _notes.empty();
 }
 
+/* ----------------------------------------------------------------------- */
+// Inline methods for Errata::Inline
+
+inline Errata::Annotation &Errata::Inline::operator[](unsigned idx) {
+  return *reinterpret_cast<Annotation *>(&_slots[idx]);
+}
+
+inline Errata::Annotation const &Errata::Inline::operator[](unsigned idx) const {
+  return *reinterpret_cast<Annotation const *>(&_slots[idx]);
+}
+
+inline swoc::MemSpan<char>
+Errata::Inline::remnant() {
+  return _count < N_NOTES ? swoc::MemSpan<char>{_text + _used, TEXT_SIZE - _used} : swoc::MemSpan<char>{};
+}
+
+inline void
+Errata::Inline::commit(Severity severity, size_t n) {
+  _render[_count] = nullptr;
+  auto note       = new (&_slots[_count++]) Annotation(severity, {_text + _used, n});
+  _notes.prepend(note);
+  _used += n;
+  _severity = std::max(_severity, severity);
+}
+
+inline char *
+Errata::Inline::alloc(size_t n, size_t align) {
+  size_t offset = (_used + align - 1) & ~(align - 1);
+  if (_count >= N_NOTES || offset + n > TEXT_SIZE)
+  {
+    return nullptr;
+  }
+  _used = offset + n;
+  return _text + offset;
+}
+
+inline void
+Errata::Inline::commit(Severity severity, Render render, Copy copy, char const *capture) {
+  _render[_count]  = render;
+  _copy[_count]    = copy;
+  _capture[_count] = capture - _text;
+  auto note        = new (&_slots[_count++]) Annotation(severity, {});
+  _notes.prepend(note);
+  ++_n_pending;
+  _severity = std::max(_severity, severity);
+}
+
 /* ----------------------------------------------------------------------- */
 // Inline methods for Errata
 
@@ -650,11 +892,23 @@ inline Errata::Errata() {}
 
 inline Errata::Errata(self_type &&that) {
   std::swap(_data, that._data);
+  if (that._inline._count)
+  {
+    _inline.copy(that._inline);
+    that._inline.clear();
+  }
 }
 
 inline Errata::Errata(self_type const &that) {
+  // Sharing is done with the data, so inline annotations are moved there first, and rendered so the
+  // shared data is never changed. Neither changes the annotations in @a that.
+  if (that._inline._count)
+  {
+    that.data();
+  }
   if (nullptr != (_data = that._data))
   {
+    that.render_if_pending();
     ++(_data->_ref_count);
   }
 }
@@ -665,6 +919,11 @@ Errata::operator=(self_type &&that) -> self_type & {
   {
     this->release();
     std::swap(_data, that._data);
+    if (that._inline._count)
+    {
+      _inline.copy(that._inline);
+      that._inline.clear();
+    }
   }
   return *this;
 }
@@ -679,22 +938,29 @@ inline bool Errata::operator!() const {
 
 inline bool
 Errata::empty() const {
-  return _data == nullptr || _data->_notes.count() == 0;
+  return _data ? _data->_notes.count() == 0 : _inline._count == 0;
 }
 
 inline size_t
 Errata::count() const {
-  return _data ? _data->_notes.count() : 0;
+  return _data ? _data->_notes.count() : _inline._count;
 }
 
 inline bool
 Errata::is_ok() const {
-  return 0 == _data || 0 == _data->_notes.count() || _data->_severity < FAILURE_SEVERITY;
+  return _data ? (0 == _data->_notes.count() || _data->_severity < FAILURE_SEVERITY)
+               : (0 == _inline._count || _inline._severity < FAILURE_SEVERITY);
+}
+
+inline bool
+Errata::is_pending() const {
+  return _data ? _data->_pending != nullptr : _inline._n_pending != 0;
 }
 
 inline const Errata::Annotation &
 Errata::front() const {
-  return *(_data->_notes.head());
+  this->render_if_pending();
+  return *(_data ? _data->_notes.head() : _inline._notes.head());
 }
 
 template <typename... Args>
@@ -737,6 +1003,18 @@ Errata::note(self_type &&that) {
 template <typename... Args>
 Errata &
 Errata::note_v(Severity severity, std::string_view fmt, std::tuple<Args...> const &args) {
+  if (!_data)
+  {
+    if (auto span = _inline.remnant(); !span.empty())
+    {
+      FixedBufferWriter bw{span};
+      if (!bw.print_v(fmt, args).error())
+      {
+        _inline.commit(severity, bw.extent());
+        return *this;
+      }
+    }
+  }
   Data *data = this->writeable_data();
   auto span  = data->remnant();
   FixedBufferWriter bw{span};
@@ -754,6 +1032,82 @@ Errata::note_v(Severity severity, std::string_view fmt, std::tuple<Args...> cons
   return *this;
 }
 
+template <typename... Args>
+void
+Errata::Deferred<Args...>::render(BufferWriter &w, void const *capture, char const *base) {
+  auto self    = static_cast<Deferred const *>(capture);
+  auto resolve = [=](auto const &arg) -> decltype(auto) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, CapturedString>)
+    {
+      return arg.view(base);
+    } else
+    {
+      return arg;
+    }
+  };
+  std::apply([&](auto const &... args) { w.print_v(*self->_fmt, std::forward_as_tuple(resolve(args)...)); }, self->_args);
+}
+
+template <typename... Args>
+void
+Errata::Deferred<Args...>::copy(void *dst, void const *src) {
+  new (dst) Deferred(*static_cast<Deferred const *>(src));
+}
+
+template <typename T>
+auto
+Errata::capture(T &&arg, char const *base, char *&chars) -> capture_t<T> {
+  if constexpr (is_string_arg_v<T>)
+  {
+    std::string_view s{arg};
+    memcpy(chars, s.data(), s.size());
+    CapturedString zret{reinterpret_cast<uintptr_t>(chars) - reinterpret_cast<uintptr_t>(base), s.size()};
+    chars += s.size();
+    return zret;
+  } else
+  {
+    static_assert(std::is_trivially_copyable_v<capture_t<T>>, "Deferred annotation arguments must be trivially copyable");
+    return arg;
+  }
+}
+
+template <typename... Args>
+Errata &
+Errata::note_deferred(Severity severity, bwf::Format const &fmt, Args &&... args) {
+  using D        = Deferred<Args...>;
+  size_t n_chars = (size_t(0) + ... + [](auto const &arg) -> size_t {
+    if constexpr (is_string_arg_v<decltype(arg)>)
+    {
+      return std::string_view{arg}.size();
+    } else
+    {
+      return 0;
+    }
+  }(args));
+
+  if constexpr (alignof(D) <= 8)
+  {
+    if (char *mem = _data ? nullptr : _inline.alloc(sizeof(D) + n_chars, alignof(D)); mem)
+    {
+      char *chars = mem + sizeof(D);
+      new (mem) D{&fmt, {capture(std::forward<Args>(args), _inline._text, chars)...}};
+      _inline.commit(severity, &D::render, &D::copy, mem);
+      return *this;
+    }
+  }
+
+  Data *data  = this->writeable_data();
+  auto mem    = data->_arena.alloc(sizeof(D) + n_chars, alignof(D)).template rebind<char>().data();
+  char *chars = mem + sizeof(D);
+  new (mem) D{&fmt, {capture(std::forward<Args>(args), nullptr, chars)...}};
+  auto note    = data->make<Annotation>(severity, std::string_view{});
+  note->_level = data->_level;
+  data->_notes.prepend(note);
+  data->_severity = std::max(data->_severity, severity);
+  data->_pending  = data->make<Pending>(Pending{data->_pending, note, &D::render, mem, nullptr});
+  return *this;
+}
+
 inline void
 Errata::SinkWrapper::operator()(Errata const &e) const {
   _f(e);
@@ -0,0 +1,220 @@
+/** @file
+
+    @c BufferWriter for a file descriptor.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+
+#include "swoc/BufferWriter.h"
+
+namespace swoc
+{
+/** Buffer writer for a file descriptor.
+ *
+ * Output is formatted directly in to an internal buffer, which is written to the file descriptor
+ * when it is full or on @c flush. There are two buffers, and if the writer is asynchronous a full
+ * buffer is written by a background thread while output continues in the other buffer, so that
+ * formatting and I/O overlap.
+ *
+ * Large data which will remain valid can be added with @c reference, which puts it in the output
+ * without copying. The output is written with @c writev, gathering the buffered text and the
+ * referenced data.
+ *
+ * Output that has been written can't be changed, so @c discard and @c copy apply only to the
+ * current buffer and @c restrict and @c restore have no effect. Formatting with @c print is not
+ * affected by this, as each argument is formatted in the unused part of the buffer before it is
+ * committed. If an argument doesn't fit, the buffer is written and the argument is formatted again.
+ *
+ * The file descriptor is not closed by the writer.
+ */
+class FdWriter : public BufferWriter {
+  using self_type  = FdWriter;     ///< Self reference type.
+  using super_type = BufferWriter; ///< Parent type.
+public:
+  /// Default buffer size.
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+  /// Minimum buffer size.
+  static constexpr size_t MIN_BUFFER_SIZE = 64;
+  /// Maximum number of @c iovec in a buffer, after which it is written.
+  static constexpr size_t MAX_IOV = 256;
+
+  /** Constructor.
+   *
+   * @param fd File descriptor for output.
+   * @param buffer_size Size of each buffer.
+   * @param async_p Write full buffers from a background thread.
+   */
+  explicit FdWriter(int fd, size_t buffer_size = DEFAULT_BUFFER_SIZE, bool async_p = false);
+
+  FdWriter(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /// Flush and release resources.
+  ~FdWriter() override;
+
+  /// Write a single character @a c to the buffer.
+  self_type &write(char c) override;
+
+  /// Write @a n bytes from @a data to the buffer.
+  self_type &write(void const *data, size_t n) override;
+
+  using super_type::write; // import super class write.
+
+  /** Add @a view to the output without copying it.
+   *
+   * @param view Data to add.
+   * @return @a this
+   *
+   * The memory for @a view must remain valid until the next @c flush returns, or the writer is
+   * destroyed.
+   */
+  self_type &reference(std::string_view view);
+
+  /** Write all output to the file descriptor.
+   *
+   * @return @a this
+   *
+   * This waits for any background write to finish.
+   */
+  self_type &flush();
+
+  /// @return The start of the current buffer.
+  const char *data() const override;
+
+  /// @return @c true if a write to the file descriptor failed.
+  bool error() const override;
+
+  /// @return The @c errno of the first failed write, or 0 if there were no failures.
+  int error_code() const;
+
+  /// @return The first unused byte in the current buffer.
+  char *aux_data() override;
+
+  /// @return The output so far plus the unused part of the current buffer.
+  size_t capacity() const override;
+
+  /// @return The total output.
+  size_t extent() const override;
+
+  /** Mark bytes in the current buffer as in use.
+   *
+   * @param n Number of bytes to include in the used buffer.
+   * @return @c true if successful, @c false if the buffer was written and the write should be retried.
+   */
+  bool commit(size_t n) override;
+
+  /// Drop @a n characters from the end of the output in the current buffer.
+  self_type &discard(size_t n) override;
+
+  /// No effect, there is no capacity limit.
+  self_type &restrict(size_t n) override;
+
+  /// No effect, there is no capacity limit.
+  self_type &restore(size_t n) override;
+
+  /// Copy data in the current buffer. Offsets before the current buffer are ignored.
+  self_type &copy(size_t dst, size_t src, size_t n) override;
+
+  /// Output the unwritten data to the @a stream.
+  std::ostream &operator>>(std::ostream &stream) const override;
+
+protected:
+  /// Output to be written.
+  struct Batch {
+    std::unique_ptr<char[]> _buffer; ///< Text storage.
+    size_t _size = 0;                ///< Size of @a _buffer.
+    std::vector<iovec> _iov;         ///< Text and referenced data, in order.
+  };
+
+  int _fd;               ///< Output file descriptor.
+  Batch _batch[2];       ///< Batches, one is current.
+  unsigned _current = 0; ///< Index of the current batch.
+  size_t _prior     = 0; ///< Output written or referenced before the current buffer text.
+  size_t _mark      = 0; ///< Start of text in the current buffer that is not yet in an @c iovec.
+
+  std::atomic<int> _errno{0}; ///< First write error.
+
+  // Background writing.
+  std::mutex _mutex;           ///< Lock for @a _pending.
+  std::condition_variable _cv; ///< Signal changes to @a _pending or @a _stop_p.
+  Batch *_pending = nullptr;   ///< Batch to be written by the background thread.
+  bool _stop_p    = false;     ///< Stop the background thread.
+  std::thread _thread;         ///< Background thread, if asynchronous.
+
+  /// Write the current batch and switch to the other batch.
+  void submit();
+
+  /// Make the current buffer at least @a n bytes.
+  void reserve(size_t n);
+
+  /// Write @a batch to the file descriptor.
+  void write_batch(Batch &batch);
+
+  /// Background thread.
+  void run();
+};
+
+inline const char *
+FdWriter::data() const {
+  return _buffer;
+}
+
+inline bool
+FdWriter::error() const {
+  return _errno != 0;
+}
+
+inline int
+FdWriter::error_code() const {
+  return _errno;
+}
+
+inline char *
+FdWriter::aux_data() {
+  return _buffer + _attempted;
+}
+
+inline size_t
+FdWriter::capacity() const {
+  return _prior + _capacity;
+}
+
+inline size_t
+FdWriter::extent() const {
+  return _prior + _attempted;
+}
+
+inline auto
+FdWriter::restrict(size_t) -> self_type & {
+  return *this;
+}
+
+inline auto
+FdWriter::restore(size_t) -> self_type & {
+  return *this;
+}
+
+} // namespace swoc
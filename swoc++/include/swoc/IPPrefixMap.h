@@ -0,0 +1,534 @@
+#pragma once
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2014 Network Geographics
+
+/** @file
+
+    Longest prefix match of IP addresses.
+ */
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+
+#include <swoc/MemArena.h>
+#include <swoc/swoc_ip.h>
+
+namespace swoc
+{
+namespace detail
+{
+  /// @return The number of 1 bits in @a n.
+  inline unsigned
+  popcount(uint64_t n) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(n);
+#else
+    unsigned zret = 0;
+    for (; n; n &= n - 1) {
+      ++zret;
+    }
+    return zret;
+#endif
+  }
+
+  /// Prefix key support for IPv4.
+  struct IP4PrefixKey {
+    using key_type                  = uint32_t; ///< Address in host order.
+    static constexpr unsigned WIDTH = 32;       ///< Number of bits in a key.
+
+    static key_type
+    key_of(IP4Addr const &addr) {
+      return addr.host_order();
+    }
+
+    /// @return Bit @a idx of @a k, counting from the most significant bit.
+    static unsigned
+    bit(key_type k, unsigned idx) {
+      return (k >> (WIDTH - 1 - idx)) & 1;
+    }
+
+    /// @return 6 bits of @a k starting at bit @a offset, padded with 0 past the end of the key.
+    static unsigned
+    chunk(key_type k, unsigned offset) {
+      return offset < WIDTH ? static_cast<unsigned>(((uint64_t(k) << 32) << offset) >> 58) : 0;
+    }
+  };
+
+  /// Prefix key support for IPv6.
+  struct IP6PrefixKey {
+    using key_type                  = std::array<uint64_t, 2>; ///< Most significant word first.
+    static constexpr unsigned WIDTH = 128;                     ///< Number of bits in a key.
+
+    static key_type
+    key_of(IP6Addr const &addr) {
+      auto raw     = addr.network_order();
+      key_type zret{0, 0};
+      for (unsigned i = 0; i < 16; ++i) {
+        zret[i / 8] = (zret[i / 8] << 8) | raw.s6_addr[i];
+      }
+      return zret;
+    }
+
+    /// @return Bit @a idx of @a k, counting from the most significant bit.
+    static unsigned
+    bit(key_type const &k, unsigned idx) {
+      return (k[idx / 64] >> (63 - idx % 64)) & 1;
+    }
+
+    /// @return 6 bits of @a k starting at bit @a offset, padded with 0 past the end of the key.
+    static unsigned
+    chunk(key_type const &k, unsigned offset) {
+      if (offset >= WIDTH) {
+        return 0;
+      }
+      uint64_t w = offset < 64 ? (k[0] << offset) | (offset ? k[1] >> (64 - offset) : 0) : k[1] << (offset - 64);
+      return static_cast<unsigned>(w >> 58);
+    }
+  };
+
+  template <typename K, typename PAYLOAD> class IPPrefixCompiled;
+
+  /** Binary trie of prefixes.
+   *
+   * @tparam K Key support class.
+   * @tparam PAYLOAD Data for each prefix.
+   *
+   * This is the modifiable form, with one node per bit of each prefix.
+   */
+  template <typename K, typename PAYLOAD> class IPPrefixTrie
+  {
+    using self_type = IPPrefixTrie;
+    friend IPPrefixCompiled<K, PAYLOAD>;
+
+  public:
+    using key_type = typename K::key_type;
+
+    IPPrefixTrie() = default;
+    IPPrefixTrie(self_type const &) = delete;
+    self_type &operator=(self_type const &) = delete;
+    ~IPPrefixTrie();
+
+    /** Set the payload for a prefix.
+     *
+     * @param k Key.
+     * @param width Number of significant bits in @a k.
+     * @param payload Payload for the prefix.
+     * @return @c true if the prefix was added, @c false if it was already present and the payload replaced.
+     */
+    bool insert(key_type const &k, unsigned width, PAYLOAD const &payload);
+
+    /** Remove a prefix.
+     *
+     * @param k Key.
+     * @param width Number of significant bits in @a k.
+     * @return @c true if the prefix was present, @c false if not.
+     */
+    bool erase(key_type const &k, unsigned width);
+
+    /// @return The payload of the longest prefix that matches @a k, or @c nullptr if none does.
+    PAYLOAD *find(key_type const &k) const;
+
+    /// @return The number of prefixes.
+    size_t count() const;
+
+    /// Remove all prefixes.
+    void clear();
+
+  protected:
+    /// A node for one bit of a prefix.
+    struct Node {
+      Node *_child[2] = {nullptr, nullptr}; ///< Child nodes by next bit.
+      PAYLOAD _payload{};                     ///< Payload if this node ends a prefix.
+      bool _payload_p = false;                ///< Set if this node ends a prefix.
+    };
+
+    Node *_root  = nullptr; ///< Root node, for the zero width prefix.
+    size_t _count = 0;      ///< Number of prefixes.
+    MemArena _arena{4000};  ///< Node storage.
+
+    /// Destroy the payloads.
+    void destroy();
+  };
+
+  /** Compiled form of an @c IPPrefixTrie.
+   *
+   * This is a multi-bit trie in the style of Poptrie. Each node covers 6 bits of the key with a 64 bit
+   * vector that marks which of the 64 values has a child node, and another 64 bit vector that marks
+   * the start of each run of identical leaves. The children and the leaves of a node are contiguous
+   * and are indexed by counting the bits in the vectors below the value. A lookup therefore reads one
+   * node for every 6 key bits up to the depth of the longest matching prefix, and then one leaf.
+   */
+  template <typename K, typename PAYLOAD> class IPPrefixCompiled
+  {
+    using self_type = IPPrefixCompiled;
+    using trie_type = IPPrefixTrie<K, PAYLOAD>;
+
+  public:
+    using key_type = typename K::key_type;
+
+    /// Number of key bits for each node.
+    static constexpr unsigned STRIDE = 6;
+
+    /// Construct an empty instance.
+    IPPrefixCompiled();
+
+    /// Construct from the current content of @a trie.
+    explicit IPPrefixCompiled(trie_type const &trie);
+
+    /// @return The payload of the longest prefix that matches @a k, or @c nullptr if none does.
+    PAYLOAD const *find(key_type const &k) const;
+
+    /// @return The number of prefixes.
+    size_t count() const;
+
+  protected:
+    /// Node in the multi-bit trie.
+    struct Node {
+      uint64_t _vector  = 0; ///< Bit set for values with a child node.
+      uint64_t _leafvec = 0; ///< Bit set for values which start a run of leaves.
+      uint32_t _base0   = 0; ///< Index of the first leaf.
+      uint32_t _base1   = 0; ///< Index of the first child node.
+    };
+
+    std::vector<Node> _nodes;       ///< Nodes, the root is first.
+    std::vector<uint32_t> _leaves;  ///< Leaves, index in to @a _payloads plus one or 0 for no match.
+    std::vector<PAYLOAD> _payloads; ///< Payloads.
+
+    /// Payload index for each trie node, used during compilation.
+    using index_map = std::unordered_map<typename trie_type::Node const *, uint32_t>;
+
+    /** Compile the subtrie at @a n.
+     *
+     * @param n Trie node.
+     * @param depth Depth of @a n in the trie.
+     * @param best Leaf for the longest prefix at or above @a n.
+     * @param idx Index of the compiled node.
+     * @param indices Payload indices.
+     */
+    void compile(typename trie_type::Node const *n, unsigned depth, uint32_t best, size_t idx, index_map &indices);
+  };
+
+  // --- Implementation ---
+
+  template <typename K, typename PAYLOAD> IPPrefixTrie<K, PAYLOAD>::~IPPrefixTrie() { this->destroy(); }
+
+  template <typename K, typename PAYLOAD>
+  void
+  IPPrefixTrie<K, PAYLOAD>::destroy() {
+    // Nodes are in the arena, only the payloads need to be destroyed.
+    if constexpr (!std::is_trivially_destructible_v<PAYLOAD>) {
+      std::vector<Node *> todo;
+      if (_root) {
+        todo.push_back(_root);
+      }
+      while (!todo.empty()) {
+        Node *n = todo.back();
+        todo.pop_back();
+        for (auto c : n->_child) {
+          if (c) {
+            todo.push_back(c);
+          }
+        }
+        std::destroy_at(n);
+      }
+    }
+  }
+
+  template <typename K, typename PAYLOAD>
+  bool
+  IPPrefixTrie<K, PAYLOAD>::insert(key_type const &k, unsigned width, PAYLOAD const &payload) {
+    if (!_root) {
+      _root = _arena.make<Node>();
+    }
+    Node *n = _root;
+    for (unsigned i = 0; i < width; ++i) {
+      auto &c = n->_child[K::bit(k, i)];
+      if (!c) {
+        c = _arena.make<Node>();
+      }
+      n = c;
+    }
+    n->_payload = payload;
+    if (n->_payload_p) {
+      return false;
+    }
+    n->_payload_p = true;
+    ++_count;
+    return true;
+  }
+
+  template <typename K, typename PAYLOAD>
+  bool
+  IPPrefixTrie<K, PAYLOAD>::erase(key_type const &k, unsigned width) {
+    Node *n = _root;
+    for (unsigned i = 0; n && i < width; ++i) {
+      n = n->_child[K::bit(k, i)];
+    }
+    if (n && n->_payload_p) {
+      n->_payload_p = false;
+      n->_payload   = PAYLOAD{};
+      --_count;
+      return true;
+    }
+    return false;
+  }
+
+  template <typename K, typename PAYLOAD>
+  PAYLOAD *
+  IPPrefixTrie<K, PAYLOAD>::find(key_type const &k) const {
+    PAYLOAD *zret = nullptr;
+    Node *n       = _root;
+    for (unsigned i = 0; n; ++i) {
+      if (n->_payload_p) {
+        zret = &n->_payload;
+      }
+      n = i < K::WIDTH ? n->_child[K::bit(k, i)] : nullptr;
+    }
+    return zret;
+  }
+
+  template <typename K, typename PAYLOAD>
+  size_t
+  IPPrefixTrie<K, PAYLOAD>::count() const {
+    return _count;
+  }
+
+  template <typename K, typename PAYLOAD>
+  void
+  IPPrefixTrie<K, PAYLOAD>::clear() {
+    this->destroy();
+    _root  = nullptr;
+    _count = 0;
+    _arena.clear();
+  }
+
+  template <typename K, typename PAYLOAD> IPPrefixCompiled<K, PAYLOAD>::IPPrefixCompiled() : _nodes(1), _leaves(1, 0) {
+    _nodes[0]._leafvec = 1;
+  }
+
+  template <typename K, typename PAYLOAD> IPPrefixCompiled<K, PAYLOAD>::IPPrefixCompiled(trie_type const &trie) {
+    index_map indices;
+    _payloads.reserve(trie.count());
+    _nodes.resize(1);
+    uint32_t best = 0;
+    if (trie._root && trie._root->_payload_p) {
+      _payloads.push_back(trie._root->_payload);
+      best = indices[trie._root] = _payloads.size();
+    }
+    this->compile(trie._root, 0, best, 0, indices);
+  }
+
+  template <typename K, typename PAYLOAD>
+  void
+  IPPrefixCompiled<K, PAYLOAD>::compile(typename trie_type::Node const *n, unsigned depth, uint32_t best, size_t idx,
+                                        index_map &indices) {
+    using TrieNode = typename trie_type::Node;
+    Node node;
+    std::vector<std::tuple<TrieNode const *, uint32_t>> kids;
+    uint32_t prev_leaf = 0;
+    bool leaf_p        = false; // Set if there has been a leaf in this node.
+
+    node._base0 = _leaves.size();
+    for (unsigned v = 0; v < (1U << STRIDE); ++v) {
+      // Walk down the trie along the bits of @a v, tracking the longest prefix.
+      TrieNode const *x = n;
+      uint32_t leaf     = best;
+      for (unsigned i = 0; x && i < STRIDE; ++i) {
+        x = depth + i < K::WIDTH ? x->_child[(v >> (STRIDE - 1 - i)) & 1] : nullptr;
+        if (x && x->_payload_p) {
+          if (auto spot = indices.find(x); spot != indices.end()) {
+            leaf = spot->second;
+          } else {
+            _payloads.push_back(x->_payload);
+            leaf = indices[x] = _payloads.size();
+          }
+        }
+      }
+      if (x && (x->_child[0] || x->_child[1])) {
+        node._vector |= uint64_t(1) << v;
+        kids.emplace_back(x, leaf);
+      } else if (!leaf_p || leaf != prev_leaf) {
+        node._leafvec |= uint64_t(1) << v;
+        _leaves.push_back(leaf);
+        prev_leaf = leaf;
+        leaf_p    = true;
+      }
+    }
+
+    node._base1 = _nodes.size();
+    _nodes.resize(_nodes.size() + kids.size());
+    _nodes[idx] = node;
+    for (size_t i = 0; i < kids.size(); ++i) {
+      auto [kid, leaf] = kids[i];
+      this->compile(kid, depth + STRIDE, leaf, node._base1 + i, indices);
+    }
+  }
+
+  template <typename K, typename PAYLOAD>
+  PAYLOAD const *
+  IPPrefixCompiled<K, PAYLOAD>::find(key_type const &k) const {
+    Node const *n   = _nodes.data();
+    unsigned offset = 0;
+    unsigned v      = K::chunk(k, offset);
+    while ((n->_vector >> v) & 1) {
+      n = _nodes.data() + n->_base1 + popcount(n->_vector & ((uint64_t(2) << v) - 1)) - 1;
+      offset += STRIDE;
+      v = K::chunk(k, offset);
+    }
+    auto leaf = _leaves[n->_base0 + popcount(n->_leafvec & ((uint64_t(2) << v) - 1)) - 1];
+    return leaf ? &_payloads[leaf - 1] : nullptr;
+  }
+
+  template <typename K, typename PAYLOAD>
+  size_t
+  IPPrefixCompiled<K, PAYLOAD>::count() const {
+    return _payloads.size();
+  }
+
+} // namespace detail
+
+/** Longest prefix match of IP addresses.
+ *
+ * @tparam PAYLOAD Data for each network.
+ *
+ * Unlike @c IPSpace, networks can overlap and a lookup finds the payload for the most specific
+ * network that contains the address. Networks are added and removed in a binary trie. For fast
+ * lookup this can be compiled to a read only multi-bit trie with @c compile.
+ */
+template <typename PAYLOAD> class IPPrefixMap
+{
+  using self_type = IPPrefixMap;
+
+public:
+  using payload_t = PAYLOAD; ///< Export payload type.
+
+  /// Construct an empty map.
+  IPPrefixMap() = default;
+
+  /** Set the @a payload for @a net.
+   *
+   * @param net Network.
+   * @param payload Payload.
+   * @return @c true if @a net was added, @c false if already present and the payload replaced.
+   *
+   * Only the leading bits of the address of @a net, as specified by the mask width, are used.
+   */
+  bool insert(IpNet const &net, PAYLOAD const &payload);
+
+  /** Remove @a net.
+   *
+   * @param net Network.
+   * @return @c true if the network was present, @c false if not.
+   */
+  bool erase(IpNet const &net);
+
+  /** Find the payload for @a addr.
+   *
+   * @param addr Address.
+   * @return The payload of the most specific network containing @a addr, or @c nullptr if none does.
+   */
+  PAYLOAD *find(IPAddr const &addr);
+
+  /// @return The number of networks.
+  size_t count() const { return _ip4.count() + _ip6.count(); }
+
+  /// Remove all networks.
+  void clear();
+
+  /** A read only, compiled copy of an @c IPPrefixMap.
+   *
+   * This is independent of the source map, which can be changed or destroyed afterwards.
+   */
+  class Compiled
+  {
+  public:
+    /// Construct an empty map.
+    Compiled() = default;
+
+    /// Construct from the current content of @a map.
+    explicit Compiled(IPPrefixMap const &map) : _ip4(map._ip4), _ip6(map._ip6) {}
+
+    /// @return The payload of the most specific network containing @a addr, or @c nullptr if none does.
+    PAYLOAD const *find(IPAddr const &addr) const;
+
+    /// @return The payload of the most specific network containing @a addr, or @c nullptr if none does.
+    PAYLOAD const *find(IP4Addr const &addr) const { return _ip4.find(detail::IP4PrefixKey::key_of(addr)); }
+
+    /// @return The payload of the most specific network containing @a addr, or @c nullptr if none does.
+    PAYLOAD const *find(IP6Addr const &addr) const { return _ip6.find(detail::IP6PrefixKey::key_of(addr)); }
+
+    /// @return The number of networks.
+    size_t count() const { return _ip4.count() + _ip6.count(); }
+
+  protected:
+    detail::IPPrefixCompiled<detail::IP4PrefixKey, PAYLOAD> _ip4;
+    detail::IPPrefixCompiled<detail::IP6PrefixKey, PAYLOAD> _ip6;
+  };
+
+  /// @return A compiled copy of this map.
+  Compiled compile() const { return Compiled{*this}; }
+
+protected:
+  detail::IPPrefixTrie<detail::IP4PrefixKey, PAYLOAD> _ip4;
+  detail::IPPrefixTrie<detail::IP6PrefixKey, PAYLOAD> _ip6;
+};
+
+template <typename PAYLOAD>
+bool
+IPPrefixMap<PAYLOAD>::insert(IpNet const &net, PAYLOAD const &payload) {
+  auto const &addr = net.addr();
+  auto width       = net.mask().width();
+  if (addr.is_ip4()) {
+    return _ip4.insert(ntohl(addr.network_ip4()), std::min<unsigned>(width, 32), payload);
+  } else if (addr.is_ip6()) {
+    return _ip6.insert(detail::IP6PrefixKey::key_of(IP6Addr{addr.network_ip6()}), std::min<unsigned>(width, 128), payload);
+  }
+  return false;
+}
+
+template <typename PAYLOAD>
+bool
+IPPrefixMap<PAYLOAD>::erase(IpNet const &net) {
+  auto const &addr = net.addr();
+  auto width       = net.mask().width();
+  if (addr.is_ip4()) {
+    return _ip4.erase(ntohl(addr.network_ip4()), std::min<unsigned>(width, 32));
+  } else if (addr.is_ip6()) {
+    return _ip6.erase(detail::IP6PrefixKey::key_of(IP6Addr{addr.network_ip6()}), std::min<unsigned>(width, 128));
+  }
+  return false;
+}
+
+template <typename PAYLOAD>
+PAYLOAD *
+IPPrefixMap<PAYLOAD>::find(IPAddr const &addr) {
+  if (addr.is_ip4()) {
+    return _ip4.find(ntohl(addr.network_ip4()));
+  } else if (addr.is_ip6()) {
+    return _ip6.find(detail::IP6PrefixKey::key_of(IP6Addr{addr.network_ip6()}));
+  }
+  return nullptr;
+}
+
+template <typename PAYLOAD>
+void
+IPPrefixMap<PAYLOAD>::clear() {
+  _ip4.clear();
+  _ip6.clear();
+}
+
+template <typename PAYLOAD>
+PAYLOAD const *
+IPPrefixMap<PAYLOAD>::Compiled::find(IPAddr const &addr) const {
+  if (addr.is_ip4()) {
+    return _ip4.find(ntohl(addr.network_ip4()));
+  } else if (addr.is_ip6()) {
+    return _ip6.find(detail::IP6PrefixKey::key_of(IP6Addr{addr.network_ip6()}));
+  }
+  return nullptr;
+}
+
+} // namespace swoc
@@ -0,0 +1,646 @@
+/** @file
+
+  Intrusive flat (open addressing) hash map.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace swoc
+{
+namespace detail
+{
+  /// Deduce the argument type of a descriptor @c key_of.
+  template <typename R, typename A> A flat_hash_arg_of(R (*)(A));
+
+  /** A group of control bytes that are checked together.
+   *
+   * Each control byte is either @c EMPTY, @c DELETED, or the 7 bit hash fragment of the element in
+   * the corresponding slot. With SSE2 a group is 16 bytes wide and matched with vector compares,
+   * otherwise it is 8 bytes wide and matched with word arithmetic. Match results are bit masks with one
+   * bit per control byte, at a stride of @c SHIFT bits.
+   */
+  struct FlatHashGroup {
+    using ctrl_t = int8_t;
+
+    static constexpr ctrl_t EMPTY   = -128; ///< Slot has never been used.
+    static constexpr ctrl_t DELETED = -2;   ///< Slot held an element that was removed.
+
+#if defined(__SSE2__)
+    static constexpr size_t WIDTH = 16; ///< Number of control bytes in a group.
+    static constexpr unsigned SHIFT = 0; ///< log2 of bits per control byte in a match mask.
+    using mask_t = uint32_t;
+
+    explicit FlatHashGroup(ctrl_t const *ctrl) : _ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const *>(ctrl))) {}
+
+    /// @return Mask of bytes that match @a h2.
+    mask_t
+    match(ctrl_t h2) const {
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+    }
+
+    /// @return Mask of bytes that are @c EMPTY.
+    mask_t
+    match_empty() const {
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(EMPTY), _ctrl));
+    }
+
+    /// @return Mask of bytes that are @c EMPTY or @c DELETED.
+    mask_t
+    match_available() const {
+      return _mm_movemask_epi8(_ctrl); // only the non-full values have the sign bit set.
+    }
+
+    __m128i _ctrl;
+#else
+    static constexpr size_t WIDTH = 8;
+    static constexpr unsigned SHIFT = 3;
+    using mask_t = uint64_t;
+
+    static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+    static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+    explicit FlatHashGroup(ctrl_t const *ctrl) { std::memcpy(&_ctrl, ctrl, sizeof(_ctrl)); }
+
+    // This can have false positives, but not false negatives. That's fine because the slot element
+    // is always checked for a match.
+    mask_t
+    match(ctrl_t h2) const {
+      auto x = _ctrl ^ (LSBS * static_cast<uint8_t>(h2));
+      return (x - LSBS) & ~x & MSBS;
+    }
+
+    mask_t
+    match_empty() const {
+      return _ctrl & (~_ctrl << 6) & MSBS;
+    }
+
+    mask_t
+    match_available() const {
+      return _ctrl & (~_ctrl << 7) & MSBS;
+    }
+
+    uint64_t _ctrl;
+#endif
+
+    /// @return The index in the group of the lowest bit set in @a mask.
+    static unsigned
+    lowest(mask_t mask) {
+      return static_cast<unsigned>(__builtin_ctzll(mask)) >> SHIFT;
+    }
+
+    /// @return @a mask with the lowest set bit cleared.
+    static mask_t
+    next(mask_t mask) {
+      return mask & (mask - 1);
+    }
+  };
+} // namespace detail
+
+/** Intrusive flat hash table.
+
+    This is an open addressing alternative to @c IntrusiveHashMap for tables that are dominated by
+    lookups. Elements are not copied - the table stores pointers to the elements, which are not
+    destroyed when the table is destroyed or an element is removed.
+
+    The table uses the same descriptor as @c IntrusiveHashMap except that the link accessors are
+    not used, and therefore not required. The descriptor must provide
+
+    - The static method <tt>key_type key_of(value_type *)</tt> which returns the key for an instance
+      of @c value_type. This must not be overloaded as it is used to deduce @c value_type.
+
+    - The static method <tt>bool equal(key_type lhs, key_type rhs)</tt> which checks if two keys are
+      the same.
+
+    - The static method <tt>hash_id hash_of(key_type)</tt> which computes the hash value of the key.
+
+    Unlike @c IntrusiveHashMap keys are unique - an element is not inserted if an element with an
+    equal key is already in the table.
+
+    Internally the table is a contiguous array of control bytes in parallel with an array of element
+    pointers. Each control byte of an occupied slot holds 7 bits of the hash, and the control bytes are
+    probed a group at a time (16 bytes with SSE2) so that a lookup usually touches one control group and
+    one slot before comparing the key. The table expands when it is 7/8 full.
+
+    Iterators are invalidated by any insertion that expands the table, and by @c clear.
+ */
+template <typename H> class IntrusiveFlatHashMap
+{
+  using self_type = IntrusiveFlatHashMap;
+  using Group     = detail::FlatHashGroup;
+  using ctrl_t    = Group::ctrl_t;
+
+public:
+  /// Type of elements in the map.
+  using value_type = std::remove_const_t<std::remove_pointer_t<decltype(detail::flat_hash_arg_of(&H::key_of))>>;
+  /// Key type for the elements.
+  using key_type = decltype(H::key_of(static_cast<value_type *>(nullptr)));
+  /// The numeric hash ID computed from a key.
+  using hash_id = decltype(H::hash_of(H::key_of(static_cast<value_type *>(nullptr))));
+
+  /// The minimum number of slots in a table that is not empty.
+  static constexpr size_t MIN_CAPACITY = Group::WIDTH;
+
+  /// Iterator over elements in the table. The order is unspecified.
+  template <typename V> class base_iterator
+  {
+    using self_type = base_iterator;
+    friend IntrusiveFlatHashMap;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = V;
+    using difference_type   = ptrdiff_t;
+    using pointer           = V *;
+    using reference         = V &;
+
+    base_iterator() = default;
+
+    /// Allow conversion from @c iterator to @c const_iterator.
+    template <typename U, typename = std::enable_if_t<std::is_const_v<V> && !std::is_const_v<U>>>
+    base_iterator(base_iterator<U> const &that) : _map(that._map), _idx(that._idx) {}
+
+    reference operator*() const;
+    pointer operator->() const;
+    /// Convenience conversion to pointer type.
+    operator pointer() const;
+
+    self_type &operator++();
+    self_type operator++(int);
+
+    bool operator==(self_type const &that) const;
+    bool operator!=(self_type const &that) const;
+
+  protected:
+    template <typename U> friend class base_iterator;
+
+    base_iterator(IntrusiveFlatHashMap const *map, size_t idx) : _map(map), _idx(idx) {}
+
+    /// Move forward to the next occupied slot, starting at the current slot.
+    self_type &skip();
+
+    IntrusiveFlatHashMap const *_map = nullptr; ///< Containing map.
+    size_t _idx                      = 0;       ///< Slot index.
+  };
+
+  using iterator       = base_iterator<value_type>;
+  using const_iterator = base_iterator<value_type const>;
+
+  /** Construct with capacity for @a n elements without expanding.
+   *
+   * This doubles as the default constructor, in which case no memory is allocated until the
+   * first insert.
+   */
+  explicit IntrusiveFlatHashMap(size_t n = 0);
+
+  /// Move the contents of @a that in to @a this.
+  IntrusiveFlatHashMap(self_type &&that) = default;
+  self_type &operator=(self_type &&that) = default;
+
+  // noncopyable
+  IntrusiveFlatHashMap(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Remove all values from the table.
+   *
+   * The values are not touched.
+   */
+  self_type &clear();
+
+  iterator begin();             ///< First element.
+  const_iterator begin() const; ///< First element.
+  iterator end();               ///< Past last element.
+  const_iterator end() const;   ///< Past last element.
+
+  /** Insert a value in to the table.
+   *
+   * @param v Value to insert.
+   * @return @c true if @a v was inserted, @c false if there is already an element with an equal key.
+   *
+   * @note The value itself is put in the table, @b not a copy.
+   */
+  bool insert(value_type *v);
+
+  /** Find an element with a key equal to @a key.
+   *
+   * @return A element with a matching key, or the end iterator if not found.
+   */
+  iterator find(key_type key);
+  const_iterator find(key_type key) const;
+
+  /** Get an iterator for an existing value @a v.
+   *
+   * @return An iterator that references @a v, or the end iterator if @a v is not in the table.
+   */
+  iterator find(value_type const *v);
+  const_iterator find(value_type const *v) const;
+
+  /// @return @c true if an element with a key equal to @a key is in the table.
+  bool contains(key_type key) const;
+
+  /** Remove the value at @a loc from the table.
+   *
+   * @return An iterator to the next value past @a loc.
+   */
+  iterator erase(iterator const &loc);
+
+  /// Remove a @a value from the container.
+  /// @return @c true if @a value was in the container and removed, @c false if it was not in the container.
+  bool erase(value_type *value);
+
+  /** Apply @a f to every element in the table.
+   *
+   * @tparam F A functional object of the form <tt>void F(value_type *)</tt>
+   * @param f The function to apply.
+   * @return @a this
+   *
+   * Iteration is not affected by @a f destroying the element. This is primarily useful for deleting
+   * the elements before clearing the table.
+   */
+  template <typename F> self_type &apply(F &&f);
+
+  /** Make the table large enough to contain @a n elements without expanding.
+   *
+   * @param n Number of elements.
+   * @return @a this
+   */
+  self_type &reserve(size_t n);
+
+  /// Number of elements in the map.
+  size_t count() const;
+
+  /// Number of slots in the table.
+  size_t capacity() const;
+
+protected:
+  /// Position in the table for a hash.
+  struct Probe {
+    size_t _group; ///< Group index.
+    size_t _step;  ///< Current step in the probe sequence.
+    ctrl_t _h2;    ///< Control byte value for the hash.
+  };
+
+  /// @return The initial probe position for @a key.
+  Probe probe_for(key_type key) const;
+
+  /// Advance @a p to the next group.
+  void next(Probe &p) const;
+
+  /// Set the control byte and pointer for slot @a idx.
+  void set_slot(size_t idx, ctrl_t ctrl, value_type *v);
+
+  /// @return Index of an available slot for an element with @a key.
+  size_t find_available(key_type key, ctrl_t &h2) const;
+
+  /// @return Index of the slot containing an element with @a key, or @c capacity() if not found.
+  size_t find_index(key_type key) const;
+
+  /// Rebuild the table with @a n slots.
+  void rehash(size_t n);
+
+  /// @return The number of slots needed for @a n elements.
+  static size_t capacity_for(size_t n);
+
+  std::vector<ctrl_t> _ctrl;       ///< Control bytes, one per slot, a multiple of the group width.
+  std::vector<value_type *> _slot; ///< Element pointers, parallel to @a _ctrl.
+  size_t _count   = 0;             ///< Number of elements.
+  size_t _growth  = 0;             ///< Number of inserts in to @c EMPTY slots before expanding.
+  size_t _n_group = 0;             ///< Number of control groups, always a power of 2.
+};
+
+// ---------------------
+// Iterator.
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator*() const -> reference {
+  return *_map->_slot[_idx];
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator->() const -> pointer {
+  return _map->_slot[_idx];
+}
+
+template <typename H> template <typename V> IntrusiveFlatHashMap<H>::base_iterator<V>::operator pointer() const {
+  return _map->_slot[_idx];
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveFlatHashMap<H>::base_iterator<V>::skip() -> self_type & {
+  auto limit = _map->_ctrl.size();
+  while (_idx < limit && _map->_ctrl[_idx] < 0) {
+    ++_idx;
+  }
+  return *this;
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator++() -> self_type & {
+  ++_idx;
+  return this->skip();
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator++(int) -> self_type {
+  self_type zret{*this};
+  ++*this;
+  return zret;
+}
+
+template <typename H>
+template <typename V>
+bool
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator==(self_type const &that) const {
+  return _idx == that._idx && _map == that._map;
+}
+
+template <typename H>
+template <typename V>
+bool
+IntrusiveFlatHashMap<H>::base_iterator<V>::operator!=(self_type const &that) const {
+  return !(*this == that);
+}
+
+// ---------------------
+
+template <typename H> IntrusiveFlatHashMap<H>::IntrusiveFlatHashMap(size_t n) {
+  if (n) {
+    this->rehash(capacity_for(n));
+  }
+}
+
+template <typename H>
+size_t
+IntrusiveFlatHashMap<H>::capacity_for(size_t n) {
+  // Round up to make the load factor at most 7/8.
+  n          = n + (n + 6) / 7;
+  size_t cap = MIN_CAPACITY;
+  while (cap < n) {
+    cap <<= 1;
+  }
+  return cap;
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::probe_for(key_type key) const -> Probe {
+  // Mix the hash to spread the bits - the descriptor hash may be weak in the low bits, or the
+  // identity for integral keys.
+  uint64_t h = static_cast<uint64_t>(H::hash_of(key)) * 0x9E3779B97F4A7C15ULL;
+  h ^= h >> 32;
+  return {static_cast<size_t>(h >> 7) & (_n_group - 1), 0, static_cast<ctrl_t>(h & 0x7F)};
+}
+
+template <typename H>
+void
+IntrusiveFlatHashMap<H>::next(Probe &p) const {
+  // Triangular probing visits every group if the group count is a power of 2.
+  p._group = (p._group + ++p._step) & (_n_group - 1);
+}
+
+template <typename H>
+void
+IntrusiveFlatHashMap<H>::set_slot(size_t idx, ctrl_t ctrl, value_type *v) {
+  _ctrl[idx] = ctrl;
+  _slot[idx] = v;
+}
+
+template <typename H>
+size_t
+IntrusiveFlatHashMap<H>::find_index(key_type key) const {
+  if (_count == 0) {
+    return _ctrl.size();
+  }
+  for (Probe p = this->probe_for(key);; this->next(p)) {
+    auto base = p._group * Group::WIDTH;
+    Group g{_ctrl.data() + base};
+    for (auto mask = g.match(p._h2); mask; mask = Group::next(mask)) {
+      auto idx = base + Group::lowest(mask);
+      if (H::equal(key, H::key_of(_slot[idx]))) {
+        return idx;
+      }
+    }
+    if (g.match_empty()) {
+      return _ctrl.size();
+    }
+  }
+}
+
+template <typename H>
+size_t
+IntrusiveFlatHashMap<H>::find_available(key_type key, ctrl_t &h2) const {
+  for (Probe p = this->probe_for(key);; this->next(p)) {
+    auto base = p._group * Group::WIDTH;
+    if (auto mask = Group{_ctrl.data() + base}.match_available(); mask) {
+      h2 = p._h2;
+      return base + Group::lowest(mask);
+    }
+  }
+}
+
+template <typename H>
+void
+IntrusiveFlatHashMap<H>::rehash(size_t n) {
+  std::vector<ctrl_t> ctrl(n, Group::EMPTY);
+  std::vector<value_type *> slot(n, nullptr);
+  std::swap(ctrl, _ctrl);
+  std::swap(slot, _slot);
+  _n_group = n / Group::WIDTH;
+  _growth  = n - n / 8 - _count;
+
+  for (size_t idx = 0, limit = ctrl.size(); idx < limit; ++idx) {
+    if (ctrl[idx] >= 0) {
+      ctrl_t h2;
+      auto spot = this->find_available(H::key_of(slot[idx]), h2);
+      this->set_slot(spot, h2, slot[idx]);
+    }
+  }
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::reserve(size_t n) -> self_type & {
+  if (auto cap = capacity_for(n); cap > _ctrl.size()) {
+    this->rehash(cap);
+  }
+  return *this;
+}
+
+template <typename H>
+bool
+IntrusiveFlatHashMap<H>::insert(value_type *v) {
+  auto key = H::key_of(v);
+  if (this->find_index(key) != _ctrl.size()) {
+    return false;
+  }
+
+  ctrl_t h2 = 0;
+  size_t idx;
+  if (_ctrl.empty()) {
+    this->rehash(MIN_CAPACITY);
+    idx = this->find_available(key, h2);
+  } else if (idx = this->find_available(key, h2); _growth == 0 && _ctrl[idx] == Group::EMPTY) {
+    // Out of room - if it's mostly tombstones, clean up in place, otherwise double.
+    this->rehash(_count * 2 < this->capacity() ? this->capacity() : this->capacity() * 2);
+    idx = this->find_available(key, h2);
+  }
+  if (_ctrl[idx] == Group::EMPTY) {
+    --_growth;
+  }
+  this->set_slot(idx, h2, v);
+  ++_count;
+  return true;
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::find(key_type key) -> iterator {
+  return {this, this->find_index(key)};
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::find(key_type key) const -> const_iterator {
+  return {this, this->find_index(key)};
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::find(value_type const *v) -> iterator {
+  auto idx = this->find_index(H::key_of(const_cast<value_type *>(v)));
+  return {this, (idx < _slot.size() && _slot[idx] == v) ? idx : _ctrl.size()};
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::find(value_type const *v) const -> const_iterator {
+  return const_cast<self_type *>(this)->find(v);
+}
+
+template <typename H>
+bool
+IntrusiveFlatHashMap<H>::contains(key_type key) const {
+  return this->find_index(key) != _ctrl.size();
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::erase(iterator const &loc) -> iterator {
+  auto idx  = loc._idx;
+  auto base = idx & ~(Group::WIDTH - 1);
+  // If the group has never been full, no probe sequence passed through it and the slot can be
+  // made empty instead of a tombstone.
+  if (Group{_ctrl.data() + base}.match_empty()) {
+    this->set_slot(idx, Group::EMPTY, nullptr);
+    ++_growth;
+  } else {
+    this->set_slot(idx, Group::DELETED, nullptr);
+  }
+  --_count;
+  return iterator{this, idx}.skip();
+}
+
+template <typename H>
+bool
+IntrusiveFlatHashMap<H>::erase(value_type *value) {
+  auto loc = this->find(value);
+  if (loc != this->end()) {
+    this->erase(loc);
+    return true;
+  }
+  return false;
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::clear() -> self_type & {
+  std::fill(_ctrl.begin(), _ctrl.end(), Group::EMPTY);
+  std::fill(_slot.begin(), _slot.end(), nullptr);
+  _count  = 0;
+  _growth = _ctrl.size() - _ctrl.size() / 8;
+  return *this;
+}
+
+template <typename H>
+template <typename F>
+auto
+IntrusiveFlatHashMap<H>::apply(F &&f) -> self_type & {
+  for (size_t idx = 0, limit = _ctrl.size(); idx < limit; ++idx) {
+    if (_ctrl[idx] >= 0) {
+      f(_slot[idx]);
+    }
+  }
+  return *this;
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::begin() -> iterator {
+  return iterator{this, 0}.skip();
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::begin() const -> const_iterator {
+  return const_iterator{this, 0}.skip();
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::end() -> iterator {
+  return {this, _ctrl.size()};
+}
+
+template <typename H>
+auto
+IntrusiveFlatHashMap<H>::end() const -> const_iterator {
+  return {this, _ctrl.size()};
+}
+
+template <typename H>
+size_t
+IntrusiveFlatHashMap<H>::count() const {
+  return _count;
+}
+
+template <typename H>
+size_t
+IntrusiveFlatHashMap<H>::capacity() const {
+  return _ctrl.size();
+}
+
+} // namespace swoc
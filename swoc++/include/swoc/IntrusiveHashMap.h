@@ -24,6 +24,7 @@
 #include <array>
 #include <algorithm>
 #include "swoc/IntrusiveDList.h"
+#include "swoc/swoc_trace.h"
 
 namespace swoc
 {
@@ -42,6 +43,12 @@ namespace swoc
     @see @c setExpansionLimit()
     @see @c expand()
 
+    Expansion is normally done all at once, which is linear in the number of elements. If incremental
+    expansion is enabled the table instead moves a few buckets to the expanded table on each insert,
+    so that no single insert is expensive. Lookups and iteration are correct during this migration,
+    although the order of iteration changes as elements are moved.
+    @see @c set_incremental_expansion()
+
     The hash table is configured by a descriptor class. This must contain the following members
 
     - The static method <tt>key_type key_of(value_type *)</tt> which returns the key for an instance of @c value_type.
@@ -125,12 +132,8 @@ protected:
      */
     bool _mixed_p{false};
 
-    /// Compute the limit value for iteration in this bucket.
-    /// This is the value of the next bucket, or @c nullptr if no next bucket.
-    value_type *limit() const;
-
-    /// Verify @a v is in this bucket.
-    bool contains(value_type *v) const;
+    /// Verify @a v is in this bucket, where @a limit is the first element past the bucket.
+    bool contains(value_type *v, value_type *limit) const;
 
     void clear(); ///< Reset to initial state.
   };
@@ -142,6 +145,8 @@ public:
   static size_t constexpr DEFAULT_EXPANSION_LIMIT = 4; ///< Value from previous version.
   /// Expansion policy if not specified in constructor.
   static ExpansionPolicy constexpr DEFAULT_EXPANSION_POLICY = AVERAGE;
+  /// Number of buckets moved per insert during an incremental expansion.
+  static size_t constexpr EXPANSION_STEP = 2;
 
   using iterator       = typename List::iterator;
   using const_iterator = typename List::const_iterator;
@@ -262,10 +267,40 @@ public:
 
   /** Expand the hash if needed.
 
-      Useful primarily when the expansion policy is set to @c MANUAL.
+      Useful primarily when the expansion policy is set to @c MANUAL. If incremental expansion is
+      enabled this starts the expansion, otherwise it is done immediately. In either case any
+      incremental expansion in progress is finished first.
    */
   void expand();
 
+  /** Move buckets to the expanded table.
+   *
+   * @param n Maximum number of buckets to move.
+   * @return @c true if the expansion is still in progress, @c false if it has completed.
+   *
+   * This is done automatically on insert. It can be called to make progress with an incremental
+   * expansion without inserting, such as when the event loop is idle.
+   */
+  bool expand_step(size_t n = EXPANSION_STEP);
+
+  /// @return @c true if an incremental expansion is in progress.
+  bool is_expanding() const;
+
+  /** Set whether expansion is incremental.
+   *
+   * @param flag @c true for incremental expansion, @c false to expand all at once.
+   * @return @a this
+   *
+   * If incremental, expansion creates the larger table and then moves @c EXPANSION_STEP buckets on
+   * each subsequent insert until all elements have been moved. This bounds the cost of any insert.
+   * Lookups during the migration check the old bucket if it has not been moved, otherwise the new
+   * bucket. Elements with equal keys are always moved together.
+   */
+  self_type &set_incremental_expansion(bool flag);
+
+  /// @return @c true if expansion is incremental.
+  bool is_incremental_expansion() const;
+
   /// Number of elements in the map.
   size_t count() const;
 
@@ -294,8 +329,27 @@ protected:
   /// List of non-empty buckets.
   IntrusiveDList<typename Bucket::Linkage> _active_buckets;
 
+  /// Previous buckets during an incremental expansion, empty otherwise.
+  Table _old_table;
+  /// Non-empty buckets in @a _old_table. The elements for these are after those in @a _table.
+  IntrusiveDList<typename Bucket::Linkage> _old_active;
+  bool _incremental_p{false}; ///< Expand incrementally.
+
+  /// @return The bucket that contains, or would contain, elements with @a key.
   Bucket *bucket_for(key_type key);
 
+  /// @return The first element past the elements in bucket @a b.
+  value_type *limit_of(Bucket const *b) const;
+
+  /// @return @c true if @a b is in the old table.
+  bool is_old(Bucket const *b) const;
+
+  /// Insert @a v in to @a bucket.
+  void insert_into(Bucket *bucket, value_type *v);
+
+  /// Move the elements in old bucket @a b to the current table.
+  void migrate(Bucket *b);
+
   ExpansionPolicy _expansion_policy{DEFAULT_EXPANSION_POLICY}; ///< When to exand the table.
   size_t _expansion_limit{DEFAULT_EXPANSION_LIMIT};            ///< Limit value for expansion.
 
@@ -322,15 +376,24 @@ IntrusiveHashMap<H>::Bucket::Linkage::prev_ptr(Bucket *b) -> Bucket *& {
   return b->_link._prev;
 }
 
-// This is designed so that if the bucket is empty, then @c nullptr is returned, which will immediately terminate
-// a search loop on an empty bucket because that will start with a nullptr candidate, matching the limit.
+// The limit is the start of the next bucket. For the last bucket in the table, this is the start of
+// the old table elements, if any. If the bucket is empty then @c nullptr is returned, which will immediately
+// terminate a search loop on an empty bucket because that will start with a nullptr candidate, matching the limit.
 template <typename H>
 auto
-IntrusiveHashMap<H>::Bucket::limit() const -> value_type * {
-  Bucket *n{_link._next};
-  return n ? n->_v : nullptr;
+IntrusiveHashMap<H>::limit_of(Bucket const *b) const -> value_type * {
+  if (Bucket *n{b->_link._next}; n) {
+    return n->_v;
+  }
+  return (b->_v && !_old_active.empty() && !this->is_old(b)) ? _old_active.head()->_v : nullptr;
 };
 
+template <typename H>
+bool
+IntrusiveHashMap<H>::is_old(Bucket const *b) const {
+  return !_old_table.empty() && _old_table.data() <= b && b < _old_table.data() + _old_table.size();
+}
+
 template <typename H>
 void
 IntrusiveHashMap<H>::Bucket::clear() {
@@ -343,9 +406,8 @@ IntrusiveHashMap<H>::Bucket::clear() {
 
 template <typename H>
 bool
-IntrusiveHashMap<H>::Bucket::contains(value_type *v) const {
-  value_type *x     = _v;
-  value_type *limit = this->limit();
+IntrusiveHashMap<H>::Bucket::contains(value_type *v, value_type *limit) const {
+  value_type *x = _v;
   while (x != limit && x != v)
   {
     x = H::next_ptr(x);
@@ -389,7 +451,14 @@ template <typename H> IntrusiveHashMap<H>::IntrusiveHashMap(size_t n) {
 template <typename H>
 auto
 IntrusiveHashMap<H>::bucket_for(key_type key) -> Bucket * {
-  return &_table[H::hash_of(key) % _table.size()];
+  auto h = H::hash_of(key);
+  // If the old bucket hasn't been moved, all of the elements for @a key are still there.
+  if (!_old_table.empty()) {
+    if (Bucket *b = &_old_table[h % _old_table.size()]; b->_v) {
+      return b;
+    }
+  }
+  return &_table[h % _table.size()];
 }
 
 template <typename H>
@@ -426,6 +495,8 @@ IntrusiveHashMap<H>::clear() -> self_type & {
   // Clear container data.
   _list.clear();
   _active_buckets.clear();
+  _old_active.clear();
+  Table{}.swap(_old_table);
   return *this;
 }
 
@@ -434,7 +505,7 @@ auto
 IntrusiveHashMap<H>::find(key_type key) -> iterator {
   Bucket *b         = this->bucket_for(key);
   value_type *v     = b->_v;
-  value_type *limit = b->limit();
+  value_type *limit = this->limit_of(b);
   while (v != limit && !H::equal(key, H::key_of(v)))
   {
     v = H::next_ptr(v);
@@ -485,7 +556,7 @@ template <typename H>
 auto
 IntrusiveHashMap<H>::find(value_type *v) -> iterator {
   Bucket *b = this->bucket_for(H::key_of(v));
-  return b->contains(v) ? _list.iterator_for(v) : this->end();
+  return b->contains(v, this->limit_of(b)) ? _list.iterator_for(v) : this->end();
 }
 
 template <typename H>
@@ -497,19 +568,42 @@ IntrusiveHashMap<H>::find(value_type const *v) const -> const_iterator {
 template <typename H>
 void
 IntrusiveHashMap<H>::insert(value_type *v) {
+  auto key       = H::key_of(v);
+  Bucket *bucket = this->bucket_for(key);
+
+  // Always insert in to the current table, which means moving the old bucket first so that equal
+  // keys are not split between the tables.
+  if (this->is_old(bucket)) {
+    this->migrate(bucket);
+    bucket = this->bucket_for(key);
+  }
+  this->insert_into(bucket, v);
+
+  if (this->is_expanding()) {
+    this->expand_step();
+  } else if ((AVERAGE == _expansion_policy && (_list.count() / _table.size()) > _expansion_limit) ||
+             (MAXIMUM == _expansion_policy && bucket->_count > _expansion_limit && bucket->_mixed_p))
+  { // auto expand if appropriate.
+    this->expand();
+  }
+}
+
+template <typename H>
+void
+IntrusiveHashMap<H>::insert_into(Bucket *bucket, value_type *v) {
   auto key         = H::key_of(v);
-  Bucket *bucket   = this->bucket_for(key);
   value_type *spot = bucket->_v;
   bool mixed_p     = false; // Found a different key in the bucket.
 
   if (nullptr == spot)
   { // currently empty bucket, set it and add to active list.
-    _list.append(v);
+    // Put it after the current table elements, which is before any old table elements.
+    _list.insert_before(_old_active.empty() ? nullptr : _old_active.head()->_v, v);
     bucket->_v = v;
     _active_buckets.append(bucket);
   } else
   {
-    value_type *limit = bucket->limit();
+    value_type *limit = this->limit_of(bucket);
 
     // First search the bucket to see if the key is already in it.
     while (spot != limit && !H::equal(key, H::key_of(spot)))
@@ -539,12 +633,29 @@ IntrusiveHashMap<H>::insert(value_type *v) {
     bucket->_mixed_p = mixed_p;
   }
   ++bucket->_count;
+}
+
+template <typename H>
+void
+IntrusiveHashMap<H>::migrate(Bucket *b) {
+  // Pull the elements out first so they are never in the span of a current table bucket.
+  List tmp;
+  value_type *v     = b->_v;
+  value_type *limit = this->limit_of(b);
+  while (v != limit)
+  {
+    value_type *next = H::next_ptr(v);
+    _list.erase(v);
+    tmp.append(v);
+    v = next;
+  }
+  _old_active.erase(b);
+  b->clear();
 
-  // auto expand if appropriate.
-  if ((AVERAGE == _expansion_policy && (_list.count() / _table.size()) > _expansion_limit) ||
-      (MAXIMUM == _expansion_policy && bucket->_count > _expansion_limit && bucket->_mixed_p))
+  auto &table = _table;
+  while (nullptr != (v = tmp.take_head()))
   {
-    this->expand();
+    this->insert_into(&table[H::hash_of(H::key_of(v)) % table.size()], v);
   }
 }
 
@@ -555,18 +666,18 @@ IntrusiveHashMap<H>::erase(iterator const &loc) -> iterator {
   iterator zret     = ++(this->iterator_for(v)); // get around no const_iterator -> iterator.
   Bucket *b         = this->bucket_for(H::key_of(v));
   value_type *nv    = H::next_ptr(v);
-  value_type *limit = b->limit();
-  if (b->_v == v)
-  { // removed first element in bucket, update bucket
-    if (limit == nv)
-    { // that was also the only element, deactivate bucket
-      _active_buckets.erase(b);
-      b->clear();
-    } else
-    {
+  value_type *limit = this->limit_of(b);
+  if (b->_v == v && limit == nv)
+  { // that was the only element, deactivate bucket
+    (this->is_old(b) ? _old_active : _active_buckets).erase(b);
+    b->clear();
+  } else
+  {
+    if (b->_v == v)
+    { // removed first element in bucket, update bucket
       b->_v = nv;
-      --b->_count;
     }
+    --b->_count;
   }
   _list.erase(loc);
   return zret;
@@ -588,24 +699,11 @@ template <typename H>
 auto
 IntrusiveHashMap<H>::erase(iterator const &start, iterator const &limit) -> iterator {
   auto spot{start};
-  Bucket *bucket{this->bucket_for(spot)};
   while (spot != limit)
   {
-    auto target         = bucket;
-    bucket              = bucket->_link._next; // bump now to avoid forward iteration problems in case of bucket removal.
-    value_type *v_limit = bucket ? bucket->_v : nullptr;
-    while (spot != v_limit && spot != limit)
-    {
-      --(target->_count);
-      ++spot;
-    }
-    if (target->_count == 0)
-    {
-      _active_buckets.erase(target);
-    }
+    spot = this->erase(spot);
   }
-  _list.erase(start, limit);
-  return _list.iterator_for(limit); // convert from const_iterator back to iterator
+  return spot;
 };
 
 template <typename H>
@@ -653,6 +751,19 @@ IntrusiveHashMap<H>::apply(F &&f) -> self_type & {
 template <typename H>
 void
 IntrusiveHashMap<H>::expand() {
+  while (this->expand_step(_table.size()))
+    ;
+
+  SWOC_TRACE(hashmap_expand, this, _list.count(), _table.size(), _incremental_p);
+
+  if (_incremental_p)
+  { // Set up the new table, the elements are moved later.
+    _old_table.swap(_table);
+    _old_active = std::move(_active_buckets);
+    _table.resize(*std::lower_bound(PRIME.begin(), PRIME.end(), _old_table.size() + 1));
+    return;
+  }
+
   ExpansionPolicy org_expansion_policy = _expansion_policy; // save for restore.
   value_type *old                      = _list.head();      // save for repopulating.
   auto old_size                        = _table.size();
@@ -672,6 +783,39 @@ IntrusiveHashMap<H>::expand() {
   _expansion_policy = org_expansion_policy; // reset to original value.
 }
 
+template <typename H>
+bool
+IntrusiveHashMap<H>::expand_step(size_t n) {
+  while (n-- > 0 && !_old_active.empty())
+  {
+    this->migrate(_old_active.head());
+  }
+  if (_old_active.empty() && !_old_table.empty())
+  {
+    Table{}.swap(_old_table);
+  }
+  return this->is_expanding();
+}
+
+template <typename H>
+bool
+IntrusiveHashMap<H>::is_expanding() const {
+  return !_old_table.empty();
+}
+
+template <typename H>
+auto
+IntrusiveHashMap<H>::set_incremental_expansion(bool flag) -> self_type & {
+  _incremental_p = flag;
+  return *this;
+}
+
+template <typename H>
+bool
+IntrusiveHashMap<H>::is_incremental_expansion() const {
+  return _incremental_p;
+}
+
 template <typename H>
 size_t
 IntrusiveHashMap<H>::count() const {
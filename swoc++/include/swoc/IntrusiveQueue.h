@@ -0,0 +1,315 @@
+/** @file
+
+  Intrusive queues for handing items between threads.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "swoc/IntrusiveDList.h"
+
+namespace swoc
+{
+/** Intrusive multiple producer, single consumer queue.
+
+    Any thread can @c push an item, and a single consumer thread can @c pop items one at a time or
+    take every queued item at once with @c pop_all. No locks are used and nothing is allocated.
+
+    The linkage @a L is the same as for @c IntrusiveDList, and the items are returned by @c pop_all
+    as an @c IntrusiveDList<L>. Only the next link is used while an item is queued.
+
+    As with the Vyukov queue, @c push is a single atomic exchange and so is wait free. The exchange
+    makes an item the top of a stack of pushed items, after which the producer sets the next link of
+    the item to the previous top. The consumer takes the whole stack with another exchange and
+    reverses it in to a list to restore the push order, waiting if a producer has done the exchange
+    but not yet set the link. That wait is bounded by the producer's next two instructions, unless
+    the producer is preempted between them.
+
+    @tparam L The linkage descriptor.
+ */
+template <typename L> class IntrusiveMPSCQueue
+{
+  using self_type = IntrusiveMPSCQueue; ///< Self reference type.
+
+public:
+  /// List type for items taken from the queue.
+  using list_type = IntrusiveDList<L>;
+  /// Type of items in the queue.
+  using value_type = typename list_type::value_type;
+
+  IntrusiveMPSCQueue() = default;
+  IntrusiveMPSCQueue(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Add @a v to the end of the queue.
+   *
+   * @param v Item to add, which must not be in the queue.
+   *
+   * This can be called from any thread.
+   */
+  void push(value_type *v);
+
+  /** Remove the item at the front of the queue.
+   *
+   * @return The item, or @c nullptr if the queue is empty.
+   *
+   * This must be called only from the consumer thread.
+   */
+  value_type *pop();
+
+  /** Remove all items.
+   *
+   * @return The items, in the order they were pushed.
+   *
+   * This must be called only from the consumer thread.
+   */
+  list_type pop_all();
+
+  /** Check if the queue is empty.
+   *
+   * @return @c true if there are no items.
+   *
+   * This must be called only from the consumer thread, and other threads may push items at any time.
+   */
+  bool empty() const;
+
+protected:
+  /// Number of spins waiting for a link before yielding.
+  static constexpr unsigned SPIN_LIMIT = 64;
+
+  /// @return The marker for a link not yet set by the producer.
+  static value_type *busy();
+
+  /// Move all of the pushed items to @a _local.
+  void take();
+
+  alignas(64) std::atomic<value_type *> _top{nullptr}; ///< Last pushed item.
+  alignas(64) list_type _local;                        ///< Items taken by the consumer but not popped.
+};
+
+/** Intrusive single producer, single consumer ring.
+
+    One thread can @c push items and one other thread can @c pop items. The ring holds pointers to
+    the items and so has a fixed capacity, set when it is constructed, but the links in the items
+    are not used and items can be in another container while in the ring. Nothing is allocated
+    after construction and there are no locks. Each side keeps a copy of the ring index of the other
+    side, which is reloaded only when the ring looks full or empty, to minimize the cache line
+    transfers between the threads.
+
+    The linkage @a L is used only by @c pop_all, which returns an @c IntrusiveDList<L>.
+
+    @tparam L The linkage descriptor.
+ */
+template <typename L> class IntrusiveSPSCRing
+{
+  using self_type = IntrusiveSPSCRing; ///< Self reference type.
+
+public:
+  /// List type for items taken from the ring.
+  using list_type = IntrusiveDList<L>;
+  /// Type of items in the ring.
+  using value_type = typename list_type::value_type;
+
+  /** Construct.
+   *
+   * @param capacity Maximum number of items, rounded up to a power of 2.
+   */
+  explicit IntrusiveSPSCRing(size_t capacity);
+
+  IntrusiveSPSCRing(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Add @a v to the ring.
+   *
+   * @param v Item to add.
+   * @return @c true if @a v was added, @c false if the ring is full.
+   *
+   * This must be called only from the producer thread.
+   */
+  bool push(value_type *v);
+
+  /** Remove the oldest item.
+   *
+   * @return The item, or @c nullptr if the ring is empty.
+   *
+   * This must be called only from the consumer thread.
+   */
+  value_type *pop();
+
+  /** Remove all items.
+   *
+   * @return The items, in the order they were pushed.
+   *
+   * This must be called only from the consumer thread.
+   */
+  list_type pop_all();
+
+  /// @return The maximum number of items in the ring.
+  size_t capacity() const;
+
+  /// @return @c true if there are no items in the ring.
+  bool empty() const;
+
+protected:
+  size_t _mask;                           ///< Index mask, one less than the capacity.
+  std::unique_ptr<value_type *[]> _slots; ///< Item pointers.
+
+  alignas(64) std::atomic<size_t> _head{0}; ///< Index of the next item to pop.
+  size_t _tail_cache{0};                    ///< Consumer copy of @a _tail.
+  alignas(64) std::atomic<size_t> _tail{0}; ///< Index of the next item to push.
+  size_t _head_cache{0};                    ///< Producer copy of @a _head.
+};
+
+// ---- IntrusiveMPSCQueue
+
+template <typename L>
+auto
+IntrusiveMPSCQueue<L>::busy() -> value_type * {
+  // Never a valid item address.
+  return reinterpret_cast<value_type *>(uintptr_t(1));
+}
+
+template <typename L>
+void
+IntrusiveMPSCQueue<L>::push(value_type *v) {
+  // The link is not yet visible to the consumer, so it can be set normally, but after the exchange
+  // it is read concurrently and must be set atomically.
+  L::next_ptr(v) = busy();
+  auto prev      = _top.exchange(v, std::memory_order_release);
+  __atomic_store_n(&L::next_ptr(v), prev, __ATOMIC_RELEASE);
+}
+
+template <typename L>
+void
+IntrusiveMPSCQueue<L>::take() {
+  auto v = _top.exchange(nullptr, std::memory_order_acquire);
+  if (nullptr == v) {
+    return;
+  }
+  // The stack is newest first, so inserting each item directly after the current tail puts it in
+  // front of those newer than it.
+  auto spot = _local.tail();
+  while (v) {
+    value_type *next;
+    for (unsigned spin = 0; busy() == (next = __atomic_load_n(&L::next_ptr(v), __ATOMIC_ACQUIRE)); ++spin) {
+      if (spin >= SPIN_LIMIT) {
+        std::this_thread::yield();
+      }
+    }
+    if (spot) {
+      _local.insert_after(spot, v);
+    } else {
+      _local.prepend(v);
+    }
+    v = next;
+  }
+}
+
+template <typename L>
+auto
+IntrusiveMPSCQueue<L>::pop() -> value_type * {
+  if (_local.empty()) {
+    this->take();
+  }
+  return _local.take_head();
+}
+
+template <typename L>
+auto
+IntrusiveMPSCQueue<L>::pop_all() -> list_type {
+  this->take();
+  return std::move(_local);
+}
+
+template <typename L>
+bool
+IntrusiveMPSCQueue<L>::empty() const {
+  return _local.empty() && nullptr == _top.load(std::memory_order_acquire);
+}
+
+// ---- IntrusiveSPSCRing
+
+template <typename L> IntrusiveSPSCRing<L>::IntrusiveSPSCRing(size_t capacity) {
+  size_t n = 1;
+  while (n < capacity) {
+    n <<= 1;
+  }
+  _mask = n - 1;
+  _slots.reset(new value_type *[n]);
+}
+
+template <typename L>
+size_t
+IntrusiveSPSCRing<L>::capacity() const {
+  return _mask + 1;
+}
+
+template <typename L>
+bool
+IntrusiveSPSCRing<L>::push(value_type *v) {
+  auto tail = _tail.load(std::memory_order_relaxed);
+  if (tail - _head_cache > _mask) {
+    _head_cache = _head.load(std::memory_order_acquire);
+    if (tail - _head_cache > _mask) {
+      return false;
+    }
+  }
+  _slots[tail & _mask] = v;
+  _tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename L>
+auto
+IntrusiveSPSCRing<L>::pop() -> value_type * {
+  auto head = _head.load(std::memory_order_relaxed);
+  if (head == _tail_cache) {
+    _tail_cache = _tail.load(std::memory_order_acquire);
+    if (head == _tail_cache) {
+      return nullptr;
+    }
+  }
+  auto v = _slots[head & _mask];
+  _head.store(head + 1, std::memory_order_release);
+  return v;
+}
+
+template <typename L>
+auto
+IntrusiveSPSCRing<L>::pop_all() -> list_type {
+  list_type zret;
+  auto head   = _head.load(std::memory_order_relaxed);
+  _tail_cache = _tail.load(std::memory_order_acquire);
+  for (auto idx = head; idx != _tail_cache; ++idx) {
+    zret.append(_slots[idx & _mask]);
+  }
+  _head.store(_tail_cache, std::memory_order_release);
+  return zret;
+}
+
+template <typename L>
+bool
+IntrusiveSPSCRing<L>::empty() const {
+  return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire);
+}
+
+} // namespace swoc
@@ -0,0 +1,748 @@
+/** @file
+
+    Intrusive ordered map.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "swoc/RBTree.h"
+
+namespace swoc
+{
+/** Base class for elements of an @c IntrusiveRBMap.
+ *
+ * This contains the tree and list links, and the number of elements in the subtree, which is
+ * maintained by @c structure_fixup. A subclass that overrides @c structure_fixup must call this
+ * @c structure_fixup.
+ */
+class RBMapNode : public detail::RBNode
+{
+  using self_type  = RBMapNode;      ///< Self reference type.
+  using super_type = detail::RBNode; ///< Parent type.
+  template <typename H> friend class IntrusiveRBMap;
+
+public:
+  /// Update the subtree size.
+  void structure_fixup() override;
+
+protected:
+  size_t _size = 1; ///< Number of nodes in the subtree rooted at this node.
+
+  /// @return The number of nodes in the tree rooted at @a n.
+  static size_t size_of(super_type const *n);
+};
+
+namespace detail
+{
+  /// Deduce the argument type of a descriptor function.
+  template <typename R, typename A> A rb_map_arg_of(R (*)(A));
+} // namespace detail
+
+/** Intrusive ordered map.
+
+    This is a red/black tree of elements that are not copied or allocated by the map - the elements
+    must be a subclass of @c RBMapNode, which contains all of the tree data. Removing an element
+    or destroying the map does not destroy any element. Elements are kept in key order, and elements
+    with equal keys are kept in the order they were inserted.
+
+    The map is configured by a descriptor class, in the same style as @c IntrusiveHashMap. This
+    must contain
+
+    - The static method <tt>key_type key_of(value_type *)</tt> which returns the key for an instance
+      of @c value_type. This must not be overloaded as it is used to deduce @c value_type.
+
+    - The static method <tt>bool less(key_type lhs, key_type rhs)</tt> which is a strict weak
+      ordering of the keys.
+
+    Example for timers ordered by expiration.
+
+    @code
+    struct Timer : public swoc::RBMapNode {
+      std::chrono::steady_clock::time_point _when;
+      ...
+    };
+    struct Descriptor {
+      static std::chrono::steady_clock::time_point key_of(Timer *t) { return t->_when; }
+      static bool less(std::chrono::steady_clock::time_point lhs, std::chrono::steady_clock::time_point rhs) { return lhs < rhs; }
+    };
+    using Timers = swoc::IntrusiveRBMap<Descriptor>;
+    @endcode
+
+    Lookup, insertion and removal are logarithmic. @c join and @c split move every element at or
+    after a key from one map to another, also in logarithmic time.
+ */
+template <typename H> class IntrusiveRBMap
+{
+  using self_type = IntrusiveRBMap; ///< Self reference type.
+  using Node      = detail::RBNode; ///< Tree node type.
+  using Direction = Node::Direction;
+
+public:
+  /// Type of elements in the map.
+  using value_type = std::remove_const_t<std::remove_pointer_t<decltype(detail::rb_map_arg_of(&H::key_of))>>;
+  /// Key type for the elements.
+  using key_type = decltype(H::key_of(static_cast<value_type *>(nullptr)));
+
+  static_assert(std::is_base_of_v<RBMapNode, value_type>, "IntrusiveRBMap elements must be a subclass of RBMapNode");
+
+  /// In order iterator.
+  template <typename V> class base_iterator
+  {
+    using self_type = base_iterator;
+    friend IntrusiveRBMap;
+
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = V;
+    using difference_type   = ptrdiff_t;
+    using pointer           = V *;
+    using reference         = V &;
+
+    base_iterator() = default;
+
+    /// Allow conversion from @c iterator to @c const_iterator.
+    template <typename U, typename = std::enable_if_t<std::is_const_v<V> && !std::is_const_v<U>>>
+    base_iterator(base_iterator<U> const &that) : _map(that._map), _node(that._node) {}
+
+    reference operator*() const;
+    pointer operator->() const;
+    /// Convenience conversion to pointer type.
+    operator pointer() const;
+
+    self_type &operator++();
+    self_type operator++(int);
+    self_type &operator--();
+    self_type operator--(int);
+
+    bool operator==(self_type const &that) const;
+    bool operator!=(self_type const &that) const;
+
+  protected:
+    template <typename U> friend class base_iterator;
+
+    base_iterator(IntrusiveRBMap const *map, Node *node);
+
+    IntrusiveRBMap const *_map = nullptr; ///< Containing map, needed to decrement from the end.
+    Node *_node                = nullptr; ///< Current node, @c nullptr for the end.
+  };
+
+  using iterator       = base_iterator<value_type>;
+  using const_iterator = base_iterator<value_type const>;
+
+  IntrusiveRBMap() = default;
+  IntrusiveRBMap(self_type const &) = delete;
+  IntrusiveRBMap(self_type &&that);
+  self_type &operator=(self_type const &) = delete;
+  self_type &operator=(self_type &&that);
+
+  /// @return The number of elements.
+  size_t count() const;
+
+  /// @return @c true if there are no elements.
+  bool empty() const;
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /// @return An iterator for @a v, which must be in the map.
+  iterator iterator_for(value_type *v);
+  const_iterator iterator_for(value_type const *v) const;
+
+  /** Insert an element.
+   *
+   * @param v The element, which must not be in a map.
+   * @return An iterator for @a v.
+   *
+   * If there are elements with a key equal to that of @a v, @a v is placed after them.
+   */
+  iterator insert(value_type *v);
+
+  /// @return An iterator for the first element with a key equal to @a key, or @c end if none.
+  iterator find(key_type key);
+  const_iterator find(key_type key) const;
+
+  /// @return An iterator for the first element with a key that is not less than @a key.
+  iterator lower_bound(key_type key);
+  const_iterator lower_bound(key_type key) const;
+
+  /// @return An iterator for the first element with a key that is greater than @a key.
+  iterator upper_bound(key_type key);
+  const_iterator upper_bound(key_type key) const;
+
+  /// @return The range of elements with a key equal to @a key.
+  std::pair<iterator, iterator> equal_range(key_type key);
+
+  /** Remove an element.
+   *
+   * @param v The element, which must be in this map.
+   * @return An iterator for the element after @a v.
+   */
+  iterator erase(value_type *v);
+
+  /// Remove the element at @a loc. @return An iterator for the next element.
+  iterator erase(iterator const &loc);
+
+  /** Remove a range of elements.
+   *
+   * @param first First element to remove.
+   * @param limit Element after the last element to remove.
+   * @return @a limit
+   */
+  iterator erase(iterator const &first, iterator const &limit);
+
+  /// Remove all elements. The elements are not changed.
+  self_type &clear();
+
+  /** Replace the contents with elements in key order.
+   *
+   * @tparam I Iterator type, which must dereference to a pointer to @c value_type.
+   * @param first First element.
+   * @param last Past the last element.
+   * @return @a this
+   *
+   * The map is cleared first. If the elements are in order this takes linear time, otherwise the
+   * elements are inserted individually.
+   */
+  template <typename I> self_type &build_from_sorted(I first, I last);
+
+  /** Move all of the elements of @a that to this map.
+   *
+   * @param that Source of the elements, which is empty afterwards.
+   * @return @a this
+   *
+   * If every key in @a that is not less than every key in this map, this takes logarithmic time.
+   * Otherwise the elements of @a that are inserted individually.
+   */
+  self_type &join(self_type &that);
+
+  /** Split the map.
+   *
+   * @param key Key at which to split.
+   * @return A map with the elements with keys not less than @a key.
+   *
+   * The elements with keys less than @a key remain in this map. This takes logarithmic time.
+   */
+  self_type split(key_type key);
+
+protected:
+  Node *_root = nullptr; ///< Root of the tree.
+  Node *_head = nullptr; ///< First element.
+  Node *_tail = nullptr; ///< Last element.
+
+  /// @return The element for node @a n.
+  static value_type *value_of(Node *n);
+
+  /// @return The key for node @a n.
+  static key_type key_of(Node *n);
+
+  /// @return The first node with a key not less than @a key, or @c nullptr if none.
+  Node *lower_node(key_type key) const;
+
+  /// @return The first node with a key greater than @a key, or @c nullptr if none.
+  Node *upper_node(key_type key) const;
+
+  /** Split a tree.
+   *
+   * @param n Root of the tree.
+   * @param height Black height of @a n.
+   * @param key Split key.
+   * @param left [out] Tree of nodes with keys less than @a key.
+   * @param left_height [out] Black height of @a left.
+   * @param right [out] Tree of nodes with keys not less than @a key.
+   * @param right_height [out] Black height of @a right.
+   */
+  static void split(Node *n, unsigned height, key_type key, Node *&left, unsigned &left_height, Node *&right,
+                    unsigned &right_height);
+
+  /// Detach the subtree at @a n from its parent as a tree, given its black height @a height.
+  static Node *detach(Node *n, unsigned &height);
+};
+
+// --- Implementation ---
+
+inline size_t
+RBMapNode::size_of(super_type const *n) {
+  return n ? static_cast<self_type const *>(n)->_size : 0;
+}
+
+inline void
+RBMapNode::structure_fixup() {
+  _size = 1 + size_of(_left) + size_of(_right);
+}
+
+template <typename H>
+template <typename V>
+IntrusiveRBMap<H>::base_iterator<V>::base_iterator(IntrusiveRBMap const *map, Node *node) : _map(map), _node(node) {}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator*() const -> reference {
+  return *value_of(_node);
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator->() const -> pointer {
+  return value_of(_node);
+}
+
+template <typename H> template <typename V> IntrusiveRBMap<H>::base_iterator<V>::operator pointer() const {
+  return _node ? value_of(_node) : nullptr;
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator++() -> self_type & {
+  _node = _node->_next;
+  return *this;
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator++(int) -> self_type {
+  self_type zret{*this};
+  ++*this;
+  return zret;
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator--() -> self_type & {
+  _node = _node ? _node->_prev : _map->_tail;
+  return *this;
+}
+
+template <typename H>
+template <typename V>
+auto
+IntrusiveRBMap<H>::base_iterator<V>::operator--(int) -> self_type {
+  self_type zret{*this};
+  --*this;
+  return zret;
+}
+
+template <typename H>
+template <typename V>
+bool
+IntrusiveRBMap<H>::base_iterator<V>::operator==(self_type const &that) const {
+  return _node == that._node;
+}
+
+template <typename H>
+template <typename V>
+bool
+IntrusiveRBMap<H>::base_iterator<V>::operator!=(self_type const &that) const {
+  return _node != that._node;
+}
+
+template <typename H>
+IntrusiveRBMap<H>::IntrusiveRBMap(self_type &&that)
+  : _root(std::exchange(that._root, nullptr)),
+    _head(std::exchange(that._head, nullptr)),
+    _tail(std::exchange(that._tail, nullptr)) {}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::operator=(self_type &&that) -> self_type & {
+  if (this != &that) {
+    _root = std::exchange(that._root, nullptr);
+    _head = std::exchange(that._head, nullptr);
+    _tail = std::exchange(that._tail, nullptr);
+  }
+  return *this;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::value_of(Node *n) -> value_type * {
+  return static_cast<value_type *>(static_cast<RBMapNode *>(n));
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::key_of(Node *n) -> key_type {
+  return H::key_of(value_of(n));
+}
+
+template <typename H>
+size_t
+IntrusiveRBMap<H>::count() const {
+  return RBMapNode::size_of(_root);
+}
+
+template <typename H>
+bool
+IntrusiveRBMap<H>::empty() const {
+  return nullptr == _root;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::begin() -> iterator {
+  return {this, _head};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::end() -> iterator {
+  return {this, nullptr};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::begin() const -> const_iterator {
+  return {this, _head};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::end() const -> const_iterator {
+  return {this, nullptr};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::iterator_for(value_type *v) -> iterator {
+  return {this, v};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::iterator_for(value_type const *v) const -> const_iterator {
+  return {this, const_cast<value_type *>(v)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::lower_node(key_type key) const -> Node * {
+  Node *zret = nullptr;
+  for (Node *n = _root; n;) {
+    if (H::less(key_of(n), key)) {
+      n = n->_right;
+    } else {
+      zret = n;
+      n    = n->_left;
+    }
+  }
+  return zret;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::upper_node(key_type key) const -> Node * {
+  Node *zret = nullptr;
+  for (Node *n = _root; n;) {
+    if (H::less(key, key_of(n))) {
+      zret = n;
+      n    = n->_left;
+    } else {
+      n = n->_right;
+    }
+  }
+  return zret;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::insert(value_type *v) -> iterator {
+  Node *node = v;
+  auto key   = H::key_of(v);
+
+  node->_color  = Node::Color::RED;
+  node->_parent = node->_left = node->_right = nullptr;
+  static_cast<RBMapNode *>(node)->_size      = 1;
+
+  if (nullptr == _root) {
+    node->_color = Node::Color::BLACK;
+    node->_next = node->_prev = nullptr;
+    _root = _head = _tail = node;
+  } else {
+    Node *parent = _root;
+    bool left_p;
+    while (true) {
+      left_p      = H::less(key, key_of(parent));
+      Node *child = left_p ? parent->_left : parent->_right;
+      if (nullptr == child) {
+        break;
+      }
+      parent = child;
+    }
+    Direction dir = left_p ? Direction::LEFT : Direction::RIGHT;
+    parent->set_child(node, dir);
+    // A new left child immediately precedes its parent, a new right child immediately follows it.
+    if (dir == Direction::LEFT) {
+      node->_next = parent;
+      node->_prev = parent->_prev;
+      (node->_prev ? node->_prev->_next : _head) = node;
+      parent->_prev                              = node;
+    } else {
+      node->_prev = parent;
+      node->_next = parent->_next;
+      (node->_next ? node->_next->_prev : _tail) = node;
+      parent->_next                              = node;
+    }
+    _root = node->rebalance_after_insert();
+  }
+  return {this, node};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::find(key_type key) -> iterator {
+  Node *n = this->lower_node(key);
+  return {this, (n && !H::less(key, key_of(n))) ? n : nullptr};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::find(key_type key) const -> const_iterator {
+  Node *n = this->lower_node(key);
+  return {this, (n && !H::less(key, key_of(n))) ? n : nullptr};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::lower_bound(key_type key) -> iterator {
+  return {this, this->lower_node(key)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::lower_bound(key_type key) const -> const_iterator {
+  return {this, this->lower_node(key)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::upper_bound(key_type key) -> iterator {
+  return {this, this->upper_node(key)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::upper_bound(key_type key) const -> const_iterator {
+  return {this, this->upper_node(key)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::equal_range(key_type key) -> std::pair<iterator, iterator> {
+  return {this->lower_bound(key), this->upper_bound(key)};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::erase(value_type *v) -> iterator {
+  Node *node = v;
+  Node *next = node->_next;
+  (node->_prev ? node->_prev->_next : _head) = node->_next;
+  (node->_next ? node->_next->_prev : _tail) = node->_prev;
+  _root                                      = node->remove();
+  node->_parent = node->_left = node->_right = node->_next = node->_prev = nullptr;
+  return {this, next};
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::erase(iterator const &loc) -> iterator {
+  return loc._node ? this->erase(value_of(loc._node)) : loc;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::erase(iterator const &first, iterator const &limit) -> iterator {
+  for (Node *n = first._node; n != limit._node;) {
+    Node *next = n->_next;
+    this->erase(value_of(n));
+    n = next;
+  }
+  return limit;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::clear() -> self_type & {
+  _root = _head = _tail = nullptr;
+  return *this;
+}
+
+template <typename H>
+template <typename I>
+auto
+IntrusiveRBMap<H>::build_from_sorted(I first, I last) -> self_type & {
+  this->clear();
+  size_t n      = 0;
+  bool sorted_p = true;
+  // Link the list, checking the order.
+  for (auto spot = first; spot != last; ++spot, ++n) {
+    Node *node = static_cast<value_type *>(*spot);
+    node->_next = nullptr;
+    node->_prev = _tail;
+    if (_tail) {
+      if (H::less(key_of(node), key_of(_tail))) {
+        sorted_p = false;
+        break;
+      }
+      _tail->_next = node;
+    } else {
+      _head = node;
+    }
+    _tail = node;
+  }
+
+  if (!sorted_p) {
+    this->clear();
+    for (; first != last; ++first) {
+      this->insert(*first);
+    }
+    return *this;
+  }
+
+  // Build a balanced tree from the list - every level is full except perhaps the last, which is red.
+  unsigned red_depth = 0;
+  while ((size_t(1) << (red_depth + 1)) <= n + 1) {
+    ++red_depth;
+  }
+  Node *cursor = _head;
+  auto build   = [&](auto &&self, size_t count, unsigned depth) -> Node * {
+    if (count == 0) {
+      return nullptr;
+    }
+    Node *left = self(self, count / 2, depth + 1);
+    Node *node = cursor;
+    cursor     = cursor->_next;
+    node->_parent = node->_left = node->_right = nullptr;
+    node->set_child(left, Direction::LEFT);
+    node->set_child(self(self, count - count / 2 - 1, depth + 1), Direction::RIGHT);
+    node->_color = depth == red_depth ? Node::Color::RED : Node::Color::BLACK;
+    node->structure_fixup();
+    return node;
+  };
+  _root = build(build, n, 0);
+  return *this;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::join(self_type &that) -> self_type & {
+  if (that.empty()) {
+    return *this;
+  }
+  if (this->empty()) {
+    return *this = std::move(that);
+  }
+  if (H::less(key_of(that._head), key_of(_tail))) {
+    // Overlapping keys, merge the hard way.
+    for (Node *n = that._head; n;) {
+      Node *next = n->_next;
+      this->insert(value_of(n));
+      n = next;
+    }
+    that.clear();
+    return *this;
+  }
+
+  // Use the first element in @a that as the pivot.
+  Node *pivot = that._head;
+  Node *right = pivot->remove();
+  auto lh     = Node::black_height(_root);
+  auto rh     = Node::black_height(right);
+  _root       = Node::join(_root, lh, pivot, right, rh);
+
+  _tail->_next = pivot;
+  pivot->_prev = _tail;
+  _tail        = that._tail;
+  that.clear();
+  return *this;
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::detach(Node *n, unsigned &height) -> Node * {
+  if (n) {
+    n->_parent = nullptr;
+    if (n->_color == Node::Color::RED) {
+      n->_color = Node::Color::BLACK;
+      ++height;
+    }
+  }
+  return n;
+}
+
+template <typename H>
+void
+IntrusiveRBMap<H>::split(Node *n, unsigned height, key_type key, Node *&left, unsigned &left_height, Node *&right,
+                         unsigned &right_height) {
+  if (nullptr == n) {
+    left = right = nullptr;
+    left_height = right_height = 0;
+    return;
+  }
+  // Black height of the children.
+  unsigned lh = height - (n->_color == Node::Color::BLACK), rh = lh;
+  Node *l     = detach(n->_left, lh);
+  Node *r     = detach(n->_right, rh);
+  Node *sub;
+  unsigned sub_height;
+  if (H::less(key_of(n), key)) { // @a n and its left subtree go left.
+    split(r, rh, key, sub, sub_height, right, right_height);
+    left = Node::join(l, lh, n, sub, sub_height, &left_height);
+  } else {
+    split(l, lh, key, left, left_height, sub, sub_height);
+    right = Node::join(sub, sub_height, n, r, rh, &right_height);
+  }
+  // The join may leave a red root, which is a valid tree but not a valid root.
+  left  = detach(left, left_height);
+  right = detach(right, right_height);
+}
+
+template <typename H>
+auto
+IntrusiveRBMap<H>::split(key_type key) -> self_type {
+  self_type zret;
+  Node *first = this->lower_node(key);
+  if (nullptr == first) {
+    return zret;
+  }
+  Node *left, *right;
+  unsigned lh, rh;
+  split(_root, Node::black_height(_root), key, left, lh, right, rh);
+  _root      = left;
+  zret._root = right;
+
+  zret._head = first;
+  zret._tail = _tail;
+  _tail      = first->_prev;
+  (_tail ? _tail->_next : _head) = nullptr;
+  first->_prev                   = nullptr;
+  return zret;
+}
+
+} // namespace swoc
@@ -0,0 +1,273 @@
+/** @file
+
+  Intrusive sharded hash map for concurrent use.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+
+#include "swoc/IntrusiveHashMap.h"
+
+namespace swoc
+{
+/** Intrusive hash map that can be shared between threads.
+
+    The map is split in to @a N shards, each of which is an @c IntrusiveHashMap with its own lock.
+    The shard for an element is selected by the high bits of its hash, so that the low bits
+    remain available for the buckets in the shard. Lookups take the shard lock shared, and so
+    lookups never block each other, while insertion or removal takes the lock of one shard
+    exclusively.
+
+    The descriptor @a H is the same as for @c IntrusiveHashMap. Because another thread may remove an
+    element at any time, lookup does not return an iterator or a pointer. Instead a functor is
+    invoked on the element while the shard lock is held. A consequence of this is that once @c erase
+    has returned, no other thread can have access to the element via the map and the client can
+    safely destroy it.
+
+    Lookups are not wait free. Each lookup does an atomic read-modify-write on the lock of its
+    shard, so lookups on the same shard move the cache line of the lock between cores and wait for
+    writers to that shard. Lookups on different shards don't interact. Wait free lookups would need
+    the shards to be safe to read during changes, with @c erase waiting for readers to finish (an
+    epoch or hazard pointer grace period) before returning, which is not done here.
+
+    @tparam H The descriptor.
+    @tparam N The number of shards, which must be a power of 2.
+ */
+template <typename H, size_t N = 16> class IntrusiveShardedHashMap
+{
+  using self_type = IntrusiveShardedHashMap;
+
+public:
+  /// The map type used for a shard.
+  using Map = IntrusiveHashMap<H>;
+  /// Type of elements in the map.
+  using value_type = typename Map::value_type;
+  /// Key type for the elements.
+  using key_type = typename Map::key_type;
+  /// The numeric hash ID computed from a key.
+  using hash_id = typename Map::hash_id;
+
+  /// Number of shards.
+  static constexpr size_t N_SHARDS = N;
+  static_assert(N > 0 && (N & (N - 1)) == 0, "Number of shards must be a power of 2");
+
+  IntrusiveShardedHashMap() = default;
+  IntrusiveShardedHashMap(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Insert an element.
+   *
+   * @param v Element to insert.
+   *
+   * As with @c IntrusiveHashMap duplicate keys are allowed.
+   */
+  void insert(value_type *v);
+
+  /** Find an element and invoke @a f on it.
+   *
+   * @tparam F Functor of the form <tt>void (value_type &)</tt>
+   * @param key Key to find.
+   * @param f Functor to invoke on the element.
+   * @return @c true if an element was found, @c false if not.
+   *
+   * @a f is invoked on the first element with a matching key, while the shard is locked. @a f must
+   * not modify the key of the element or call any method of this map for the same shard.
+   */
+  template <typename F> bool find(key_type key, F &&f) const;
+
+  /// @return @c true if there is an element with @a key, @c false if not.
+  bool contains(key_type key) const;
+
+  /** Remove an element with @a key.
+   *
+   * @param key Key of the element.
+   * @return The removed element, or @c nullptr if there was no element with @a key.
+   *
+   * If there are multiple elements with @a key only the first one is removed.
+   */
+  value_type *erase(key_type key);
+
+  /** Remove the element @a v.
+   *
+   * @param v Element to remove.
+   * @return @c true if @a v was in the map and was removed, @c false if not.
+   */
+  bool erase(value_type *v);
+
+  /** Apply @a f to every element in the map.
+   *
+   * @tparam F A functional object of the form <tt>void F(value_type&)</tt>
+   * @param f The function to apply.
+   * @return @a this
+   *
+   * The shards are locked exclusively one at a time, and so @a f is permitted to destroy the element.
+   */
+  template <typename F> self_type &apply(F &&f);
+
+  /// Remove all elements. The elements are not destroyed.
+  self_type &clear();
+
+  /** Number of elements.
+   *
+   * @return The number of elements in the map.
+   *
+   * The shards are counted one at a time, and so this is only an estimate if there are concurrent
+   * changes.
+   */
+  size_t count() const;
+
+  /// @return The shard index for the hash @a h.
+  static size_t shard_index(hash_id h);
+
+protected:
+  /// A shard of the map, aligned to prevent false sharing between the locks.
+  struct alignas(64) Shard {
+    mutable std::shared_mutex _mutex; ///< Lock for @a _map.
+    Map _map;                         ///< Elements in this shard.
+  };
+
+  /// Number of high hash bits used to select the shard.
+  static constexpr unsigned SHARD_BITS = [] {
+    unsigned n = 0;
+    while ((size_t(1) << n) < N) {
+      ++n;
+    }
+    return n;
+  }();
+
+  /// @return The shard for @a key.
+  Shard &shard_for(key_type key);
+  /// @return The shard for @a key.
+  Shard const &shard_for(key_type key) const;
+
+  std::array<Shard, N> _shards; ///< Map shards.
+};
+
+template <typename H, size_t N>
+size_t
+IntrusiveShardedHashMap<H, N>::shard_index(hash_id h) {
+  if constexpr (SHARD_BITS == 0) {
+    return 0;
+  } else {
+    using U = std::make_unsigned_t<hash_id>;
+    return static_cast<size_t>(static_cast<U>(h) >> (std::numeric_limits<U>::digits - SHARD_BITS));
+  }
+}
+
+template <typename H, size_t N>
+auto
+IntrusiveShardedHashMap<H, N>::shard_for(key_type key) -> Shard & {
+  return _shards[shard_index(H::hash_of(key))];
+}
+
+template <typename H, size_t N>
+auto
+IntrusiveShardedHashMap<H, N>::shard_for(key_type key) const -> Shard const & {
+  return _shards[shard_index(H::hash_of(key))];
+}
+
+template <typename H, size_t N>
+void
+IntrusiveShardedHashMap<H, N>::insert(value_type *v) {
+  auto &shard = this->shard_for(H::key_of(v));
+  std::unique_lock lock(shard._mutex);
+  shard._map.insert(v);
+}
+
+template <typename H, size_t N>
+template <typename F>
+bool
+IntrusiveShardedHashMap<H, N>::find(key_type key, F &&f) const {
+  auto &shard = this->shard_for(key);
+  std::shared_lock lock(shard._mutex);
+  auto spot = shard._map.find(key);
+  if (spot != shard._map.end()) {
+    f(const_cast<value_type &>(*spot));
+    return true;
+  }
+  return false;
+}
+
+template <typename H, size_t N>
+bool
+IntrusiveShardedHashMap<H, N>::contains(key_type key) const {
+  auto &shard = this->shard_for(key);
+  std::shared_lock lock(shard._mutex);
+  return shard._map.find(key) != shard._map.end();
+}
+
+template <typename H, size_t N>
+auto
+IntrusiveShardedHashMap<H, N>::erase(key_type key) -> value_type * {
+  auto &shard = this->shard_for(key);
+  std::unique_lock lock(shard._mutex);
+  auto spot = shard._map.find(key);
+  if (spot == shard._map.end()) {
+    return nullptr;
+  }
+  value_type *v = &*spot;
+  shard._map.erase(spot);
+  return v;
+}
+
+template <typename H, size_t N>
+bool
+IntrusiveShardedHashMap<H, N>::erase(value_type *v) {
+  auto &shard = this->shard_for(H::key_of(v));
+  std::unique_lock lock(shard._mutex);
+  return shard._map.erase(v);
+}
+
+template <typename H, size_t N>
+template <typename F>
+auto
+IntrusiveShardedHashMap<H, N>::apply(F &&f) -> self_type & {
+  for (auto &shard : _shards) {
+    std::unique_lock lock(shard._mutex);
+    shard._map.apply(f);
+  }
+  return *this;
+}
+
+template <typename H, size_t N>
+auto
+IntrusiveShardedHashMap<H, N>::clear() -> self_type & {
+  for (auto &shard : _shards) {
+    std::unique_lock lock(shard._mutex);
+    shard._map.clear();
+  }
+  return *this;
+}
+
+template <typename H, size_t N>
+size_t
+IntrusiveShardedHashMap<H, N>::count() const {
+  size_t zret = 0;
+  for (auto &shard : _shards) {
+    std::shared_lock lock(shard._mutex);
+    zret += shard._map.count();
+  }
+  return zret;
+}
+
+} // namespace swoc
@@ -24,9 +24,14 @@
 #include <functional>
 #include <array>
 #include <variant>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstddef>
 
 #include "swoc/IntrusiveHashMap.h"
 #include "swoc/MemArena.h"
+#include "swoc/TextView.h"
 #include "swoc/bwf_base.h"
 #include "swoc/ext/HashFNV.h"
 
@@ -218,6 +223,58 @@ public:
   /// Get the number of values with definitions.
   size_t count() const;
 
+  /** Compile the lookup tables.
+   *
+   * @return @a this
+   *
+   * This builds a minimal perfect hash of the names, so that name lookup is a single probe and a
+   * single comparison. If the values are dense, value lookup becomes direct indexing. This is done
+   * by the constructors, and needs to be done again only if names are defined afterwards, as that
+   * discards the compiled tables. Until then lookup is done with the hash tables, and so is correct
+   * but slower.
+   */
+  self_type &compile();
+
+  /// @return @c true if the lookup tables are compiled, @c false if not.
+  bool is_compiled() const;
+
+  class Snapshot;
+  /// Shared handle to an immutable snapshot.
+  using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+  /** Create an immutable snapshot.
+   *
+   * @return The snapshot.
+   *
+   * The snapshot is a copy of the definitions and default handlers in a single block of memory,
+   * with compiled lookup tables. It can be used for lookup from any number of threads without
+   * locking, and remains valid regardless of any later changes to this instance.
+   *
+   * After this has been called, every change (@c define or @c set_default) builds a new
+   * snapshot and atomically replaces the current one, which is available via @c snapshot.
+   * Those changes must still be serialized by the caller, but need not be synchronized with
+   * lookups done on snapshots.
+   */
+  SnapshotPtr freeze();
+
+  /** Get the current snapshot.
+   *
+   * @return The most recent snapshot, or @c nullptr if @c freeze has not been called.
+   *
+   * This is safe to call concurrently with changes to the instance.
+   */
+  SnapshotPtr snapshot() const;
+
+  class Matcher;
+
+  /** Create a matcher for the names.
+   *
+   * @return A matcher that recognizes every name, primary and secondary.
+   *
+   * The matcher is a copy and is not affected by later changes to this instance.
+   */
+  Matcher matcher() const;
+
   /// Iterator over pairs of values and primary name pairs.
   class const_iterator {
     using self_type = const_iterator;
@@ -357,6 +414,69 @@ protected:
   /// Copy @a name in to local storage.
   std::string_view localize(std::string_view const &name);
 
+  /// @return Case insensitive hash of @a name for the compiled tables.
+  static uint64_t fold_hash(std::string_view name);
+
+  /// @return Index in [0, @a n) for @a h displaced by @a seed.
+  static size_t pht_index(uint64_t h, uint32_t seed, size_t n);
+
+  /// @return The perfect hash slot for the name hash @a h, with @a n_seeds buckets and @a n slots.
+  static size_t pht_slot(uint64_t h, uint32_t const *seeds, size_t n_seeds, size_t n);
+
+  /// Compiled lookup tables.
+  struct Compiled {
+    std::vector<uint32_t> _seeds;      ///< Displacement for each hash bucket.
+    std::vector<Item const *> _slots;  ///< Items by perfect hash of the name.
+    std::vector<Item const *> _values; ///< Primary items by value, if the values are dense.
+    uintmax_t _value_base = 0;         ///< Value of the first element in @a _values.
+  };
+
+  /** Allocator that adds storage after the allocated object.
+   *
+   * This is used with @c std::allocate_shared so that a snapshot, its shared pointer control block
+   * and its tables are a single allocation. There must be only one allocation, which sets @a _tail
+   * to the start of the additional @a _extra bytes, aligned for any type.
+   */
+  template <typename T> struct TailAllocator {
+    using value_type = T;
+
+    size_t _extra; ///< Bytes to add after the object.
+    char **_tail;  ///< [out] Start of the added bytes.
+
+    TailAllocator(size_t extra, char **tail) : _extra(extra), _tail(tail) {}
+    template <typename U> TailAllocator(TailAllocator<U> const &that) : _extra(that._extra), _tail(that._tail) {}
+
+    T *
+    allocate(size_t n)
+    {
+      static constexpr size_t ALIGN = alignof(std::max_align_t);
+      size_t size                   = (n * sizeof(T) + ALIGN - 1) & ~(ALIGN - 1);
+      auto block                    = static_cast<char *>(::operator new(size + _extra));
+      *_tail                        = block + size;
+      return reinterpret_cast<T *>(block);
+    }
+
+    void
+    deallocate(T *p, size_t)
+    {
+      ::operator delete(p);
+    }
+
+    template <typename U>
+    bool
+    operator==(TailAllocator<U> const &that) const
+    {
+      return _tail == that._tail;
+    }
+
+    template <typename U>
+    bool
+    operator!=(TailAllocator<U> const &that) const
+    {
+      return _tail != that._tail;
+    }
+  };
+
   /// Storage for names.
   MemArena _arena{1024};
   /// Access by name.
@@ -365,6 +485,134 @@ protected:
   IntrusiveHashMap<typename Item::ValueLinkage> _by_value;
   NameDefault _name_default;   ///< Name to return if no value not found.
   ValueDefault _value_default; ///< Value to return if name not found.
+  Compiled _compiled;          ///< Compiled tables, empty if not compiled.
+  SnapshotPtr _snapshot;       ///< Current published snapshot, if any.
+
+  /// Publish a new snapshot if a snapshot has been created.
+  void republish();
+};
+
+/** Immutable copy of a @c Lexicon.
+ *
+ * This has the same lookup operators as a @c Lexicon but no way to change the definitions, and
+ * so is safe for concurrent use. Create with @c Lexicon::freeze.
+ */
+template <typename E> class Lexicon<E>::Snapshot {
+  using self_type = Snapshot;
+  friend Lexicon;
+
+public:
+  Snapshot(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Get the name for a @a value.
+   *
+   * @param value Value to look up.
+   * @return The primary name for @a value.
+   */
+  std::string_view operator[](E value) const;
+
+  /** Get the value for a @a name.
+   *
+   * @param name Name to look up.
+   * @return The value for the @a name.
+   */
+  E operator[](std::string_view const &name) const;
+
+  /// Get the number of values with definitions.
+  size_t count() const;
+
+protected:
+  /// A name and its value.
+  struct Entry {
+    E _value;
+    std::string_view _name;
+  };
+
+  Snapshot() = default;
+
+  NameDefault _name_default;        ///< Name to return if no value not found.
+  ValueDefault _value_default;      ///< Value to return if name not found.
+  uint32_t const *_seeds{nullptr};  ///< Perfect hash displacement for each bucket.
+  size_t _n_seeds{0};               ///< Number of buckets.
+  Entry const *_entries{nullptr};   ///< Entries, by perfect hash of the name.
+  size_t _n_entries{0};             ///< Number of entries.
+  uint32_t const *_values{nullptr}; ///< Primary entry indices, by value or sorted by value.
+  size_t _n_values{0};              ///< Number of elements in @a _values.
+  uintmax_t _value_base{0};         ///< Value of the first element of @a _values if dense.
+  bool _dense_p{false};             ///< @a _values is indexed by value.
+  size_t _count{0};                 ///< Number of values.
+
+  /// Marker in @a _values for no value.
+  static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+};
+
+/** Case insensitive matcher for the names of a @c Lexicon.
+ *
+ * This is a deterministic automaton over the names, so that text can be matched directly while
+ * scanning it - there is no need to first find the end of a token, then hash it and compare it.
+ * Each byte of the input is one table lookup. The bytes are mapped to classes, which are the
+ * distinct characters in the names ignoring case, and the transitions are stored as a double
+ * array, which is compact and needs no search. Create with @c Lexicon::matcher.
+ *
+ * The matcher is immutable and safe for concurrent use.
+ */
+template <typename E> class Lexicon<E>::Matcher {
+  using self_type = Matcher;
+  friend Lexicon;
+
+public:
+  /// Result of a match.
+  struct Match {
+    E _value{};           ///< Value of the matched name.
+    size_t _size = 0;     ///< Number of bytes consumed.
+    bool _found_p{false}; ///< A name was matched.
+
+    /// @return @c true if a name was matched.
+    explicit operator bool() const;
+  };
+
+  /// Construct a matcher that matches nothing.
+  Matcher() = default;
+
+  /** Match the longest name that is a prefix of @a text.
+   *
+   * @param text Input text.
+   * @return The value and size of the longest matching name, if any.
+   *
+   * If there is no match, @a _size is zero.
+   */
+  Match prefix(std::string_view text) const;
+
+  /** Match the leading token of @a text.
+   *
+   * @param text Input text.
+   * @param delimiters Characters that end a token.
+   * @return The value of the token, if the token is a name, and the token size.
+   *
+   * The token is the leading text up to the first delimiter or the end of @a text. Its size is
+   * returned in @a _size whether or not it is a name, so that the caller can skip it.
+   */
+  Match token(std::string_view text, CharSet const &delimiters) const;
+
+  /// @return The number of names.
+  size_t count() const;
+
+protected:
+  /// Automaton state.
+  struct State {
+    int32_t _base{0};    ///< Offset of the transitions from this state.
+    int32_t _check{-1};  ///< Source state of the transition to this state, -1 if none.
+    uint32_t _accept{0}; ///< Index of the value plus one if this state ends a name, 0 if not.
+  };
+
+  /// Character class for each byte, 0 if the byte is not in any name.
+  std::array<uint8_t, 256> _class{};
+  std::vector<State> _states = std::vector<State>(1); ///< States, the root state is first.
+  std::vector<E> _values;                             ///< Values of the names.
+
+  /// @return The state after @a c from state @a s, or -1 if there is none.
+  int32_t next(int32_t s, char c) const;
 };
 
 // ==============
@@ -414,7 +662,7 @@ Lexicon<E>::Item::ValueLinkage::key_of(Item *item) {
 template <typename E>
 uint32_t
 Lexicon<E>::Item::NameLinkage::hash_of(std::string_view s) {
-  return Hash32FNV1a().hash_immediate(transform_view_of(&toupper, s));
+  return static_cast<uint32_t>(Hash64WyNoCase().hash_immediate(s));
 }
 
 template <typename E>
@@ -452,6 +700,7 @@ Lexicon<E>::Lexicon(const std::initializer_list<Definition> &items, DefaultHandl
   {
     this->set_default(h);
   }
+  this->compile();
 }
 
 template <typename E>
@@ -465,6 +714,7 @@ Lexicon<E>::Lexicon(const std::initializer_list<Pair> &items, DefaultHandler han
   {
     this->set_default(h);
   }
+  this->compile();
 }
 
 template <typename E>
@@ -476,6 +726,15 @@ Lexicon<E>::localize(std::string_view const &name) {
 }
 
 template <typename E> std::string_view Lexicon<E>::operator[](E value) const {
+  if (auto const &values = _compiled._values; !values.empty())
+  {
+    auto idx = static_cast<uintmax_t>(value) - _compiled._value_base;
+    if (idx < values.size() && values[idx])
+    {
+      return values[idx]->_name;
+    }
+    return std::visit(NameDefaultVisitor{value}, _name_default);
+  }
   auto spot = _by_value.find(value);
   if (spot != _by_value.end())
   {
@@ -485,6 +744,15 @@ template <typename E> std::string_view Lexicon<E>::operator[](E value) const {
 }
 
 template <typename E> E Lexicon<E>::operator[](std::string_view const &name) const {
+  if (auto const &slots = _compiled._slots; !slots.empty())
+  {
+    auto item = slots[pht_slot(fold_hash(name), _compiled._seeds.data(), _compiled._seeds.size(), slots.size())];
+    if (item->_name.size() == name.size() && 0 == strcasecmp(item->_name, name))
+    {
+      return item->_value;
+    }
+    return std::visit(ValueDefaultVisitor{name}, _value_default);
+  }
   auto spot = _by_name.find(name);
   if (spot != _by_name.end())
   {
@@ -500,6 +768,7 @@ Lexicon<E>::define(E value, const std::initializer_list<std::string_view> &names
   {
     throw std::invalid_argument("A defined value must have at least a primary name");
   }
+  _compiled = Compiled{};
   for (auto name : names)
   {
     if (_by_name.find(name) != _by_name.end())
@@ -514,6 +783,7 @@ Lexicon<E>::define(E value, const std::initializer_list<std::string_view> &names
       _by_value.insert(i);
     }
   }
+  this->republish();
   return *this;
 }
 
@@ -557,6 +827,7 @@ Lexicon<E>::set_default(DefaultHandler const &handler) -> self_type & {
     _name_default = std::get<4>(handler);
     break;
   }
+  this->republish();
   return *this;
 }
 
@@ -566,6 +837,470 @@ Lexicon<E>::count() const {
   return _by_value.count();
 }
 
+template <typename E>
+uint64_t
+Lexicon<E>::fold_hash(std::string_view name) {
+  // Case is folded during hashing, to match the case insensitive comparison.
+  return Hash64WyNoCase().hash_immediate(name);
+}
+
+template <typename E>
+size_t
+Lexicon<E>::pht_index(uint64_t h, uint32_t seed, size_t n) {
+  // Mix in the seed with the murmur finalizer, then reduce to [0, n) with a multiply and shift.
+  h += seed * 0x9e3779b97f4a7c15ull;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(h)) * n) >> 32);
+}
+
+template <typename E>
+size_t
+Lexicon<E>::pht_slot(uint64_t h, uint32_t const *seeds, size_t n_seeds, size_t n) {
+  return pht_index(h, seeds[pht_index(h >> 32, 0, n_seeds)], n);
+}
+
+template <typename E>
+auto
+Lexicon<E>::compile() -> self_type & {
+  // Hash and displace - names are hashed in to buckets, then for each bucket, largest first, a seed is
+  // found that places every name in the bucket in a distinct free slot.
+  static constexpr uint32_t SEED_LIMIT = 1 << 20;
+  Compiled c;
+  size_t n = _by_name.count();
+  _compiled = Compiled{};
+  if (n == 0)
+  {
+    return *this;
+  }
+
+  std::vector<std::vector<std::tuple<Item const *, uint64_t>>> buckets(n / 2 + 1);
+  for (auto const &item : _by_name)
+  {
+    auto h = fold_hash(item._name);
+    buckets[pht_index(h >> 32, 0, buckets.size())].emplace_back(&item, h);
+  }
+  std::vector<unsigned> order(buckets.size());
+  for (unsigned i = 0; i < order.size(); ++i)
+  {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](unsigned lhs, unsigned rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+  c._seeds.resize(buckets.size(), 0);
+  c._slots.resize(n, nullptr);
+  std::vector<size_t> picked;
+  for (auto b : order)
+  {
+    auto const &bucket = buckets[b];
+    if (bucket.empty())
+    {
+      break;
+    }
+    uint32_t seed = 0;
+    for (; seed < SEED_LIMIT; ++seed)
+    {
+      picked.clear();
+      for (auto const &[item, h] : bucket)
+      {
+        auto idx = pht_index(h, seed, n);
+        if (c._slots[idx] || std::find(picked.begin(), picked.end(), idx) != picked.end())
+        {
+          break;
+        }
+        picked.push_back(idx);
+      }
+      if (picked.size() == bucket.size())
+      {
+        break;
+      }
+    }
+    if (seed >= SEED_LIMIT)
+    {
+      return *this; // Leave uncompiled, lookup still works.
+    }
+    c._seeds[b] = seed;
+    for (unsigned i = 0; i < picked.size(); ++i)
+    {
+      c._slots[picked[i]] = std::get<0>(bucket[i]);
+    }
+  }
+
+  // Values are dense if an array isn't much larger than the number of values.
+  if (_by_value.count() > 0)
+  {
+    auto [lo, hi] = std::minmax_element(_by_value.begin(), _by_value.end(), [](Item const &lhs, Item const &rhs) {
+      return static_cast<intmax_t>(lhs._value) < static_cast<intmax_t>(rhs._value);
+    });
+    uintmax_t span = static_cast<uintmax_t>(hi->_value) - static_cast<uintmax_t>(lo->_value);
+    if (span < 2 * _by_value.count() + 16)
+    {
+      c._value_base = static_cast<uintmax_t>(lo->_value);
+      c._values.resize(span + 1, nullptr);
+      for (auto const &item : _by_value)
+      {
+        c._values[static_cast<uintmax_t>(item._value) - c._value_base] = &item;
+      }
+    }
+  }
+
+  _compiled = std::move(c);
+  return *this;
+}
+
+template <typename E>
+bool
+Lexicon<E>::is_compiled() const {
+  return !_compiled._slots.empty();
+}
+
+template <typename E>
+auto
+Lexicon<E>::freeze() -> SnapshotPtr {
+  using Entry = typename Snapshot::Entry;
+  if (!this->is_compiled())
+  {
+    this->compile();
+    if (!this->is_compiled() && _by_name.count() > 0)
+    {
+      throw std::runtime_error("Lexicon: unable to compile lookup tables");
+    }
+  }
+
+  // Everything goes in one block - the control block and snapshot, then entries, seeds, values, and names.
+  auto const &slots   = _compiled._slots;
+  auto const &seeds   = _compiled._seeds;
+  bool dense_p        = !_compiled._values.empty();
+  size_t n_values     = dense_p ? _compiled._values.size() : _by_value.count();
+  size_t n_chars      = 0;
+  for (auto item : slots)
+  {
+    n_chars += item->_name.size();
+  }
+  auto round_up       = [](size_t n, size_t align) { return (n + align - 1) & ~(align - 1); };
+  size_t entries_off  = 0;
+  size_t seeds_off    = round_up(entries_off + slots.size() * sizeof(Entry), alignof(uint32_t));
+  size_t values_off   = seeds_off + seeds.size() * sizeof(uint32_t);
+  size_t chars_off    = values_off + n_values * sizeof(uint32_t);
+  // Local so that it can use the protected constructor, which @c allocate_shared can't.
+  struct Frozen : public Snapshot {};
+  char *block = nullptr;
+  auto snap   = std::allocate_shared<Frozen>(TailAllocator<Frozen>{chars_off + n_chars, &block});
+  SnapshotPtr zret{snap};
+
+  snap->_name_default  = _name_default;
+  snap->_value_default = _value_default;
+  snap->_count         = _by_value.count();
+
+  auto entries = reinterpret_cast<Entry *>(block + entries_off);
+  char *chars  = block + chars_off;
+  for (size_t i = 0; i < slots.size(); ++i)
+  {
+    auto name = slots[i]->_name;
+    memcpy(chars, name.data(), name.size());
+    new (entries + i) Entry{slots[i]->_value, {chars, name.size()}};
+    chars += name.size();
+  }
+  snap->_entries   = entries;
+  snap->_n_entries = slots.size();
+
+  auto snap_seeds = reinterpret_cast<uint32_t *>(block + seeds_off);
+  std::copy(seeds.begin(), seeds.end(), snap_seeds);
+  snap->_seeds   = snap_seeds;
+  snap->_n_seeds = seeds.size();
+
+  auto values   = reinterpret_cast<uint32_t *>(block + values_off);
+  auto index_of = [&](Item const *item) -> uint32_t {
+    return pht_slot(fold_hash(item->_name), seeds.data(), seeds.size(), slots.size());
+  };
+  if (dense_p)
+  {
+    for (size_t i = 0; i < n_values; ++i)
+    {
+      auto item = _compiled._values[i];
+      values[i] = item ? index_of(item) : Snapshot::NO_ENTRY;
+    }
+    snap->_value_base = _compiled._value_base;
+  } else {
+    size_t i = 0;
+    for (auto const &item : _by_value)
+    {
+      values[i++] = index_of(&item);
+    }
+    std::sort(values, values + n_values, [=](uint32_t lhs, uint32_t rhs) {
+      return static_cast<uintmax_t>(entries[lhs]._value) < static_cast<uintmax_t>(entries[rhs]._value);
+    });
+  }
+  snap->_values   = values;
+  snap->_n_values = n_values;
+  snap->_dense_p  = dense_p;
+
+  std::atomic_store(&_snapshot, zret);
+  return zret;
+}
+
+template <typename E>
+auto
+Lexicon<E>::snapshot() const -> SnapshotPtr {
+  return std::atomic_load(&_snapshot);
+}
+
+template <typename E>
+void
+Lexicon<E>::republish() {
+  if (std::atomic_load(&_snapshot))
+  {
+    this->freeze();
+  }
+}
+
+// --------
+// Snapshot
+
+template <typename E> std::string_view Lexicon<E>::Snapshot::operator[](E value) const {
+  uint32_t idx = NO_ENTRY;
+  auto key     = static_cast<uintmax_t>(value);
+  if (_dense_p)
+  {
+    if (key - _value_base < _n_values)
+    {
+      idx = _values[key - _value_base];
+    }
+  } else {
+    auto limit = _values + _n_values;
+    auto spot  = std::lower_bound(_values, limit, key, [this](uint32_t i, uintmax_t k) {
+      return static_cast<uintmax_t>(_entries[i]._value) < k;
+    });
+    if (spot != limit && static_cast<uintmax_t>(_entries[*spot]._value) == key)
+    {
+      idx = *spot;
+    }
+  }
+  if (idx != NO_ENTRY)
+  {
+    return _entries[idx]._name;
+  }
+  return std::visit(NameDefaultVisitor{value}, _name_default);
+}
+
+template <typename E> E Lexicon<E>::Snapshot::operator[](std::string_view const &name) const {
+  if (_n_entries > 0)
+  {
+    auto const &entry = _entries[pht_slot(fold_hash(name), _seeds, _n_seeds, _n_entries)];
+    if (entry._name.size() == name.size() && 0 == strcasecmp(entry._name, name))
+    {
+      return entry._value;
+    }
+  }
+  return std::visit(ValueDefaultVisitor{name}, _value_default);
+}
+
+template <typename E>
+size_t
+Lexicon<E>::Snapshot::count() const {
+  return _count;
+}
+
+// -------
+// Matcher
+
+template <typename E> Lexicon<E>::Matcher::Match::operator bool() const {
+  return _found_p;
+}
+
+template <typename E>
+int32_t
+Lexicon<E>::Matcher::next(int32_t s, char c) const {
+  auto cls = _class[static_cast<uint8_t>(c)];
+  if (cls == 0)
+  {
+    return -1;
+  }
+  // The state table is sized so that every transition from a valid state is in range.
+  auto t = _states[s]._base + cls;
+  return _states[t]._check == s ? t : -1;
+}
+
+template <typename E>
+auto
+Lexicon<E>::Matcher::prefix(std::string_view text) const -> Match {
+  Match zret;
+  int32_t s = 0;
+  if (auto accept = _states[0]._accept; accept)
+  {
+    zret._value   = _values[accept - 1];
+    zret._found_p = true;
+  }
+  for (size_t idx = 0; idx < text.size(); ++idx)
+  {
+    if ((s = this->next(s, text[idx])) < 0)
+    {
+      break;
+    }
+    if (auto accept = _states[s]._accept; accept)
+    {
+      zret._value   = _values[accept - 1];
+      zret._size    = idx + 1;
+      zret._found_p = true;
+    }
+  }
+  return zret;
+}
+
+template <typename E>
+auto
+Lexicon<E>::Matcher::token(std::string_view text, CharSet const &delimiters) const -> Match {
+  Match zret;
+  int32_t s  = 0;
+  size_t idx = 0;
+  for (; idx < text.size() && !delimiters(text[idx]); ++idx)
+  {
+    if ((s = this->next(s, text[idx])) < 0)
+    {
+      // Not a name, skip the rest of the token.
+      auto n     = TextView{text.substr(idx)}.find_first_of(delimiters);
+      zret._size = n == TextView::npos ? text.size() : idx + n;
+      return zret;
+    }
+  }
+  zret._size = idx;
+  if (auto accept = _states[s]._accept; accept)
+  {
+    zret._value   = _values[accept - 1];
+    zret._found_p = true;
+  }
+  return zret;
+}
+
+template <typename E>
+size_t
+Lexicon<E>::Matcher::count() const {
+  return _values.size();
+}
+
+template <typename E>
+auto
+Lexicon<E>::matcher() const -> Matcher {
+  Matcher zret;
+  auto fold = [](char c) { return static_cast<uint8_t>(tolower(static_cast<uint8_t>(c))); };
+
+  // Assign a class to each distinct character, and the same class to both cases of letters.
+  unsigned n_classes = 0;
+  for (auto const &item : _by_name)
+  {
+    for (auto c : item._name)
+    {
+      auto &cls = zret._class[fold(c)];
+      if (cls == 0)
+      {
+        if (n_classes >= std::numeric_limits<uint8_t>::max())
+        {
+          throw std::length_error("Lexicon: too many distinct characters in the names for a matcher");
+        }
+        cls = ++n_classes;
+      }
+    }
+  }
+  for (unsigned c = 'A'; c <= 'Z'; ++c)
+  {
+    zret._class[c] = zret._class[c - 'A' + 'a'];
+  }
+
+  // Build a trie of the names, then lay out the nodes breadth first as automaton states.
+  struct Node {
+    std::vector<std::pair<uint8_t, unsigned>> _children; ///< Class and node index, sorted by class.
+    uint32_t _accept = 0;                                 ///< Value index plus one, 0 if none.
+  };
+  std::vector<Node> trie(1);
+  for (auto const &item : _by_name)
+  {
+    unsigned node = 0;
+    for (auto c : item._name)
+    {
+      auto cls   = zret._class[fold(c)];
+      auto &kids = trie[node]._children;
+      auto spot  = std::lower_bound(kids.begin(), kids.end(), cls, [](auto const &kid, uint8_t k) { return kid.first < k; });
+      if (spot != kids.end() && spot->first == cls)
+      {
+        node = spot->second;
+      } else {
+        unsigned child = trie.size();
+        kids.emplace(spot, cls, child);
+        trie.emplace_back(); // Invalidates @a kids.
+        node = child;
+      }
+    }
+    if (trie[node]._accept == 0) // Names are unique, but be careful.
+    {
+      zret._values.push_back(item._value);
+      trie[node]._accept = zret._values.size();
+    }
+  }
+
+  auto &states = zret._states;
+  std::vector<bool> used(1, true); // Root state.
+  std::vector<std::pair<unsigned, int32_t>> queue{{0, 0}}; // Node and its state.
+  size_t first_free = 1;
+  states[0]._accept = trie[0]._accept;
+  for (size_t qidx = 0; qidx < queue.size(); ++qidx)
+  {
+    auto [node, s]   = queue[qidx];
+    auto const &kids = trie[node]._children;
+    if (kids.empty())
+    {
+      continue;
+    }
+    // Smallest base for which the slot of every child is free.
+    int32_t base = std::max<int32_t>(0, first_free - kids.front().first);
+    for (;; ++base)
+    {
+      bool ok_p = true;
+      for (auto const &[cls, child] : kids)
+      {
+        size_t t = base + cls;
+        if (t < used.size() && used[t])
+        {
+          ok_p = false;
+          break;
+        }
+      }
+      if (ok_p)
+      {
+        break;
+      }
+    }
+    states[s]._base = base;
+    for (auto const &[cls, child] : kids)
+    {
+      size_t t = base + cls;
+      if (t >= used.size())
+      {
+        used.resize(t + 1, false);
+        states.resize(t + 1);
+      }
+      used[t]           = true;
+      states[t]._check  = s;
+      states[t]._accept = trie[child]._accept;
+      queue.emplace_back(child, t);
+    }
+    while (first_free < used.size() && used[first_free])
+    {
+      ++first_free;
+    }
+  }
+  // Space so that a transition from any state is in range, without a bounds check.
+  int32_t limit = 0;
+  for (auto const &state : states)
+  {
+    limit = std::max(limit, state._base);
+  }
+  states.resize(limit + n_classes + 1);
+  return zret;
+}
+
 template <typename E>
 auto
 Lexicon<E>::begin() const -> const_iterator {
@@ -18,11 +18,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
 #include <new>
 #include <mutex>
 #include <memory>
 #include <utility>
-#include <new>
+#include <atomic>
+#include <memory_resource>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 
 #include "swoc/MemSpan.h"
 #include "swoc/Scalar.h"
@@ -30,6 +36,34 @@
 
 namespace swoc
 {
+class BufferWriter;
+namespace bwf
+{
+  struct Spec;
+}
+namespace file
+{
+  class path;
+}
+
+namespace detail
+{
+  /** Release of the block that contains a self contained arena.
+   *
+   * This must be the first base class of the arena so that it is destroyed last, after the
+   * @c memory_resource base, which otherwise would be destroyed in already released memory.
+   */
+  template <typename A> struct MemArenaSelfBlock {
+    void *_self_block = nullptr; ///< Block containing the arena, if any.
+
+    ~MemArenaSelfBlock() {
+      if (_self_block) {
+        A::free_block(static_cast<typename A::Block *>(_self_block));
+      }
+    }
+  };
+} // namespace detail
+
 /** A memory arena.
 
     The intended use is for allocating many small chunks of memory - few, large allocations are best
@@ -37,12 +71,23 @@ namespace swoc
     chunk across larger internal allocations ("reserving memory"). In addition the allocated memory
     chunks are presumed to have similar lifetimes so all of the memory in the arena can be released
     when the arena is destroyed.
+
+    The memory for internal blocks is obtained from @c malloc by default, or from an upstream
+    @c std::pmr::memory_resource if one is provided. The arena is itself a @c memory_resource so
+    that standard containers can allocate from it. De-allocation is a no-op, the memory is reclaimed
+    when the arena is cleared or destroyed.
  */
-class MemArena
+class MemArena : private detail::MemArenaSelfBlock<MemArena>, public std::pmr::memory_resource
 {
   using self_type = MemArena; ///< Self reference type.
+  friend detail::MemArenaSelfBlock<MemArena>;
 
 public:
+  class BlockCache;
+  class MappedSource;
+  class RegionSource;
+  class Image;
+
   /// Simple internal arena block of memory. Maintains the underlying memory.
   struct Block {
     /// A block must have at least this much free space to not be "full".
@@ -105,8 +150,10 @@ public:
      */
     explicit Block(size_t n);
 
-    size_t size;         ///< Actual block size.
-    size_t allocated{0}; ///< Current allocated (in use) bytes.
+    size_t size;                 ///< Actual block size.
+    size_t allocated{0};         ///< Current allocated (in use) bytes.
+    /// Source of the block memory, @c nullptr if from @c malloc.
+    std::pmr::memory_resource *_source{nullptr};
 
     struct Linkage {
       Block *_next{nullptr};
@@ -120,6 +167,493 @@ public:
 
   using BlockList = IntrusiveDList<Block::Linkage>;
 
+  /** Per thread cache of released blocks.
+   *
+   * Blocks released by an arena that uses the cache are retained instead of being returned to
+   * @c malloc, bucketed by the number of pages in the block. The next block of the same size made
+   * by any arena using the cache on the same thread is taken from the cache. A block released on a
+   * thread other than the one that created it is pushed on a lock free list in the originating
+   * cache, which the owning thread drains when it needs a block it does not have cached.
+   *
+   * A cache is created on demand for each thread and lives until both that thread has exited and
+   * every block obtained from it has been released.
+   *
+   * Memory from the cache can be used only by arenas. It is not aligned beyond what @c malloc provides.
+   *
+   * @see MemArena::use_block_cache
+   */
+  class BlockCache : public std::pmr::memory_resource
+  {
+    using self_type = BlockCache; ///< Self reference type.
+  public:
+    /// Blocks of at most this many pages are cached.
+    static constexpr size_t N_BUCKETS = 8;
+    /// Maximum number of blocks kept per bucket.
+    static constexpr size_t BUCKET_LIMIT = 16;
+
+    /// @return The cache for the current thread.
+    static self_type &local();
+
+    /** Get memory for a block.
+     *
+     * @param n Size of the memory, including the block header.
+     * @return Memory of size @a n.
+     *
+     * If @a n is not a cacheable size (see @c is_cacheable) the memory is obtained from @c malloc.
+     */
+    void *acquire(size_t n);
+
+    /** Release memory obtained from this cache.
+     *
+     * @param ptr Memory to release.
+     * @param n Size of the memory, which must be the size passed to @c acquire.
+     *
+     * This is thread safe with respect to other threads calling @c release but if called from a
+     * thread other than the owning thread, the memory is only available to the owning thread.
+     */
+    void release(void *ptr, size_t n);
+
+    /// Return all cached memory to @c malloc. This must be called only from the owning thread.
+    self_type &flush();
+
+    /// @return The number of blocks cached. This must be called only from the owning thread.
+    size_t count() const;
+
+    /** Check if a memory size is cached.
+     *
+     * @param n Size of the memory, including the block header.
+     * @return @c true if memory of size @a n can be handled by a cache.
+     */
+    static bool is_cacheable(size_t n);
+
+  protected:
+    /// Overlay for memory in the cache.
+    struct Item {
+      Item *_next; ///< Next item in the bucket or return list.
+      size_t _n;   ///< Size of the item memory.
+    };
+
+    /// Per thread reference to the cache, used to detach the cache when the thread exits.
+    struct Holder;
+    static thread_local Holder _local; ///< Reference for the current thread.
+
+    /// Only @c local creates instances.
+    BlockCache() = default;
+
+    /// @c memory_resource allocation, forwards to @c acquire.
+    void *do_allocate(size_t n, size_t align) override;
+    /// @c memory_resource de-allocation, forwards to @c release.
+    void do_deallocate(void *ptr, size_t n, size_t align) override;
+    /// @c memory_resource equivalence - only by identity.
+    bool do_is_equal(std::pmr::memory_resource const &that) const noexcept override;
+
+    /// @return The bucket index for memory of size @a n.
+    static unsigned bucket_index(size_t n);
+
+    /// Move items released from other threads in to the buckets.
+    void drain_returns();
+
+    /// Detach from the owning thread.
+    void detach();
+
+    /// Release a reference, destroying the cache if that was the last one.
+    void unref();
+
+    Item *_buckets[N_BUCKETS]   = {}; ///< Cached items, by number of pages.
+    unsigned _counts[N_BUCKETS] = {}; ///< Number of items in each bucket.
+
+    /// Items released from other threads.
+    std::atomic<Item *> _returns{nullptr};
+    /// One reference for the owning thread and one for every outstanding block.
+    std::atomic<size_t> _refs{1};
+  };
+
+  /** Block memory mapped directly from the operating system.
+   *
+   * This is an upstream memory resource for arenas that need control over the placement of their
+   * blocks. Each block is a separate anonymous mapping, which is given a NUMA memory policy and may
+   * be backed by huge pages. This is intended for large, long lived arenas such as configuration
+   * data that is frozen after loading. Blocks of less than a page still use a full page.
+   *
+   * The placement is a hint applied when the block is made - pages are still placed by the kernel
+   * when they are first touched, following the policy. Failure to set the policy is not an error,
+   * e.g. on a system without NUMA support the placement has no effect.
+   *
+   * For read mostly data used on every node, the data can be replicated by building it once per
+   * node in an arena using a source for that node. A byte copy of frozen blocks is not a replica,
+   * because the objects in the blocks contain pointers to each other.
+   *
+   * @see MemArena::MemArena(std::pmr::memory_resource *, size_t)
+   */
+  class MappedSource : public std::pmr::memory_resource
+  {
+    using self_type = MappedSource; ///< Self reference type.
+  public:
+    /// Size of a huge page.
+    static constexpr size_t HUGE_PAGE_SIZE = 1 << 21;
+
+    /// NUMA placement of block pages.
+    enum Placement {
+      DEFAULT,   ///< Use the policy of the process.
+      LOCAL,     ///< Prefer the node of the thread making the block.
+      NODE,      ///< Prefer a specific node.
+      INTERLEAVE ///< Interleave pages across all nodes.
+    };
+
+    /// Huge page use.
+    enum Pages {
+      NORMAL,      ///< Base pages only.
+      TRANSPARENT, ///< Align large blocks and advise transparent huge pages.
+      EXPLICIT     ///< Use reserved huge pages for large blocks if available, otherwise @c TRANSPARENT.
+    };
+
+    /** Constructor.
+     *
+     * @param placement Placement of block pages.
+     * @param pages Huge page use.
+     * @param node Node for @c NODE placement, ignored for other placements.
+     *
+     * Huge pages are used only for blocks of at least @c HUGE_PAGE_SIZE, and such blocks are rounded
+     * up to a multiple of @c HUGE_PAGE_SIZE. @see block_hint
+     */
+    explicit MappedSource(Placement placement = DEFAULT, Pages pages = NORMAL, int node = 0);
+
+    /** Get memory for a block.
+     *
+     * @param n Size of the memory, including the block header.
+     * @return Memory of size @a n, or @c nullptr if it could not be mapped.
+     */
+    void *acquire(size_t n);
+
+    /** Release memory obtained from @c acquire.
+     *
+     * @param ptr Memory to release.
+     * @param n Size of the memory, which must be the size passed to @c acquire.
+     */
+    void release(void *ptr, size_t n);
+
+    /// @return The placement.
+    Placement placement() const;
+
+    /// @return The huge page use.
+    Pages pages() const;
+
+    /** Arena size hint for a block of total size @a n.
+     *
+     * @param n Total size of the memory for a block.
+     * @return A size hint that makes a block of at most @a n bytes.
+     *
+     * This is useful with huge pages, where @a n is a multiple of @c HUGE_PAGE_SIZE, so that blocks
+     * made for the arena exactly fill the mapping.
+     */
+    static constexpr size_t block_hint(size_t n);
+
+    /// @return The node of the CPU running the current thread, or -1 if not known.
+    static int current_node();
+
+    /// @return The number of NUMA nodes, at least 1.
+    static unsigned node_count();
+
+  protected:
+    Placement _placement; ///< Page placement.
+    Pages _pages;         ///< Huge page use.
+    int _node;            ///< Node for @c NODE placement.
+
+    /// @return The size of the mapping for memory of size @a n.
+    size_t mapped_size(size_t n) const;
+
+    /// Apply the placement to the mapping at @a ptr of size @a n.
+    void place(void *ptr, size_t n) const;
+
+    /// @c memory_resource allocation, forwards to @c acquire.
+    void *do_allocate(size_t n, size_t align) override;
+    /// @c memory_resource de-allocation, forwards to @c release.
+    void do_deallocate(void *ptr, size_t n, size_t align) override;
+    /// @c memory_resource equivalence - only by identity.
+    bool do_is_equal(std::pmr::memory_resource const &that) const noexcept override;
+  };
+
+  /** Block memory from a single reserved range of addresses.
+   *
+   * This is an upstream memory resource that reserves a range of virtual addresses when it is
+   * constructed and makes blocks from it in increasing address order. Address space is not reused,
+   * the pages of a released block are returned to the operating system but the addresses are not
+   * used again. Pages are committed only when touched, so the range can be much larger than the
+   * expected use.
+   *
+   * Because all of the blocks of an arena using this source are together, the frozen generation of
+   * the arena can be written as an @c Image and mapped back in later. Each arena should have its
+   * own source, otherwise blocks of other arenas may be in the image.
+   */
+  class RegionSource : public std::pmr::memory_resource
+  {
+    using self_type = RegionSource; ///< Self reference type.
+  public:
+    /** Constructor.
+     *
+     * @param capacity Size of the range of addresses to reserve, rounded up to a page.
+     *
+     * If the range can not be reserved the capacity is zero.
+     */
+    explicit RegionSource(size_t capacity);
+
+    RegionSource(self_type const &) = delete;
+    self_type &operator=(self_type const &) = delete;
+
+    ~RegionSource() override;
+
+    /** Get memory for a block.
+     *
+     * @param n Size of the memory, including the block header.
+     * @return Memory of size @a n, or @c nullptr if the remaining range is too small.
+     */
+    void *acquire(size_t n);
+
+    /** Release memory obtained from @c acquire.
+     *
+     * @param ptr Memory to release.
+     * @param n Size of the memory, which must be the size passed to @c acquire.
+     */
+    void release(void *ptr, size_t n);
+
+    /// @return @c true if @a ptr is in the reserved range.
+    bool contains(void const *ptr) const;
+
+    /// @return The size of the reserved range.
+    size_t capacity() const;
+
+    /// @return The size of the part of the range that has been used for blocks.
+    size_t used() const;
+
+  protected:
+    char *_base      = nullptr; ///< Start of the range.
+    size_t _capacity = 0;       ///< Size of the range.
+    size_t _used     = 0;       ///< Size of the used part at the start of the range.
+
+    /// @return @a n rounded up to a page.
+    static size_t page_round(size_t n);
+
+    /// @c memory_resource allocation, forwards to @c acquire.
+    void *do_allocate(size_t n, size_t align) override;
+    /// @c memory_resource de-allocation, forwards to @c release.
+    void do_deallocate(void *ptr, size_t n, size_t align) override;
+    /// @c memory_resource equivalence - only by identity.
+    bool do_is_equal(std::pmr::memory_resource const &that) const noexcept override;
+  };
+
+  /** The frozen generation of an arena, mapped from a file.
+   *
+   * An image is written with @c write from an arena whose blocks come from a @c RegionSource. The
+   * image is the part of the region that contains the frozen blocks, and so the objects in it have
+   * the same relative positions as in the arena. When the image is loaded it is mapped from the file
+   * at a different address, so pointers between the objects must be either
+   *
+   * - @c OffsetPtr instances, which are valid at any address. The image can then be mapped read only
+   *   and the pages are shared by every process that loads it.
+   * - raw pointers, which must be updated using @c relocate after loading. This requires loading
+   *   with write access, and each page that is changed is copied for the process.
+   *
+   * One object in the image is marked as the root, to be used to find the others.
+   *
+   * An image is only a copy of memory, and can be used only on the same architecture and only with
+   * the same definitions of the types in it. Pointers to memory outside the image, such as to static
+   * data or to a different arena, are not valid in another process. Objects in the image are not
+   * destroyed, destructors registered with @c MemArena::make_managed are not run.
+   */
+  class Image
+  {
+    using self_type = Image; ///< Self reference type.
+  public:
+    /// Construct an empty image.
+    Image() = default;
+    Image(self_type const &) = delete;
+    Image(self_type &&that) noexcept;
+    ~Image();
+
+    self_type &operator=(self_type const &) = delete;
+    self_type &operator=(self_type &&that) noexcept;
+
+    /** Write the frozen generation of an arena to a file.
+     *
+     * @param path Path of the file, which is replaced if it exists.
+     * @param arena The arena.
+     * @param source The source for the blocks of @a arena.
+     * @param root The root object, which must be in the frozen generation, or @c nullptr.
+     * @param ec Error code result. This is @c EINVAL if @a arena is not frozen, or if a frozen block
+     * or @a root is not in @a source.
+     */
+    static void write(file::path const &path, MemArena const &arena, RegionSource const &source, void const *root,
+                      std::error_code &ec);
+
+    /** Load an image from a file.
+     *
+     * @param path Path to the file.
+     * @param ec Error code result. This is @c EINVAL if the file is not a valid image.
+     * @param writable Set to map the image with write access, which is required to use @c relocate.
+     * Changes are not written to the file.
+     * @return The loaded image, which is empty on error.
+     */
+    static Image load(file::path const &path, std::error_code &ec, bool writable = false);
+
+    /// @return A pointer to the root object, or @c nullptr if there is no root.
+    template <typename T> T *root() const;
+
+    /** Relocate a pointer from the arena to the image.
+     *
+     * @param ptr A pointer value from the arena that wrote the image.
+     * @return The corresponding address in the image, or @a ptr if it is not in the image.
+     *
+     * This is used on pointers in the image when it is loaded, in a single pass over the objects.
+     */
+    template <typename T> T *relocate(T *ptr) const;
+
+    /// @return The start of the image.
+    void *data() const;
+
+    /// @return The size of the image in bytes.
+    size_t size() const;
+
+    /// @return @c true if the image is empty.
+    bool empty() const;
+
+  protected:
+    void *_map       = nullptr; ///< Start of the mapping.
+    size_t _map_size = 0;       ///< Size of the mapping.
+    char *_data      = nullptr; ///< Start of the image in the mapping.
+    size_t _size     = 0;       ///< Size of the image.
+    uintptr_t _origin = 0;      ///< Address of the image in the arena that wrote it.
+    char *_root      = nullptr; ///< Root object.
+
+    /// Release the mapping.
+    void clear();
+  };
+
+  /// @c true if statistics are collected, which is selected by defining @c SWOC_MEMARENA_STATS.
+#if defined(SWOC_MEMARENA_STATS)
+  static constexpr bool STATS_P = true;
+#else
+  static constexpr bool STATS_P = false;
+#endif
+
+  /** Allocation statistics for an arena.
+   *
+   * These are collected over the lifetime of the arena, they are not reset by @c clear or @c thaw.
+   * If statistics are not enabled (see @c STATS_P) all of the values are zero.
+   */
+  struct Stats {
+    size_t _n_blocks       = 0; ///< Number of blocks made.
+    size_t _block_size     = 0; ///< Total free space of blocks when made.
+    size_t _n_allocs       = 0; ///< Number of allocations.
+    size_t _alloc_size     = 0; ///< Total size of allocations, including alignment padding.
+    size_t _n_misses       = 0; ///< Blocks made because no active block had enough space.
+    size_t _wasted         = 0; ///< Free space left in blocks when they became full.
+    size_t _peak_allocated = 0; ///< Maximum of @c allocated_size.
+    size_t _peak_reserved  = 0; ///< Maximum of @c reserved_size.
+  };
+
+  /** Allocation statistics for a call site.
+   *
+   * A tag is intended to be a static instance at a call site, or a set of related call sites.
+   * While a @c Tag::Scope for the tag exists, allocations from any arena in the same thread are
+   * counted in the tag. Every tag is in a process wide registry which can be iterated or formatted
+   * to report all of the tags. Tags are never removed from the registry, so a tag must not be
+   * destroyed before the end of the process.
+   *
+   * @code
+   * static MemArena::Tag tag{"config.hosts"};
+   * MemArena::Tag::Scope scope{tag};
+   * auto host = arena.make<Host>(...); // counted in @a tag
+   * @endcode
+   *
+   * If statistics are not enabled (see @c STATS_P) the tags are registered but never count anything.
+   */
+  class Tag
+  {
+    using self_type = Tag; ///< Self reference type.
+  public:
+    /// Make @a tag the current tag for the thread while in scope.
+    class Scope
+    {
+    public:
+      /// Make @a tag the current tag.
+      explicit Scope(Tag &tag);
+      /// Restore the previous tag.
+      ~Scope();
+
+      Scope(Scope const &) = delete;
+      Scope &operator=(Scope const &) = delete;
+
+    protected:
+      Tag *_prev; ///< Previous tag.
+    };
+
+    /// All tags, most recently constructed first.
+    class Registry
+    {
+    public:
+      /// Iterator over the tags.
+      class iterator
+      {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Tag const;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = value_type *;
+        using reference         = value_type &;
+
+        iterator(Tag const *tag = nullptr);
+        reference operator*() const;
+        pointer operator->() const;
+        iterator &operator++();
+        iterator operator++(int);
+        bool operator==(iterator const &that) const;
+        bool operator!=(iterator const &that) const;
+
+      protected:
+        Tag const *_tag; ///< Current tag.
+      };
+
+      iterator begin() const;
+      iterator end() const;
+    };
+
+    /** Construct and register.
+     *
+     * @param name Name of the tag, which must have static storage duration.
+     */
+    explicit Tag(std::string_view name);
+
+    Tag(self_type const &) = delete;
+    self_type &operator=(self_type const &) = delete;
+
+    /// @return The name of the tag.
+    std::string_view name() const;
+
+    /// @return The number of allocations.
+    size_t count() const;
+
+    /// @return The total size of allocations.
+    size_t size() const;
+
+    /// @return The registry of all tags.
+    static Registry registry();
+
+    /// @return The tag for the current thread, @c nullptr if none.
+    static self_type *current();
+
+    /// Count an allocation of size @a n.
+    void note(size_t n);
+
+  protected:
+    std::string_view _name;          ///< Name.
+    std::atomic<size_t> _count{0};   ///< Number of allocations.
+    std::atomic<size_t> _size{0};    ///< Size of allocations.
+    self_type const *_next{nullptr}; ///< Next tag in the registry.
+
+    static std::atomic<self_type const *> _registry; ///< Most recently constructed tag.
+    static thread_local self_type *_current;         ///< Current tag for the thread.
+  };
+
   /** Construct with reservation hint.
    *
    * No memory is initially reserved, but when memory is needed this will be done so at least
@@ -135,6 +669,16 @@ public:
    */
   explicit MemArena(size_t n = DEFAULT_BLOCK_SIZE);
 
+  /** Construct with an upstream memory source.
+   *
+   * @param upstream Source of memory for internal blocks.
+   * @param n Minimum number of available bytes in the first internally reserved block.
+   *
+   * @a upstream must outlive the arena. It is used for all blocks that are not provided by a
+   * @c BlockCache.
+   */
+  explicit MemArena(std::pmr::memory_resource *upstream, size_t n = DEFAULT_BLOCK_SIZE);
+
   /// no copying
   MemArena(self_type const &that) = delete;
 
@@ -181,6 +725,16 @@ public:
    */
   MemSpan<void> alloc(size_t n);
 
+  /** Allocate @a n bytes of storage aligned to @a align.
+   *
+   * @param n Number of bytes to allocate.
+   * @param align Required alignment, which must be a power of 2.
+   * @return a MemSpan of the allocated memory.
+   *
+   * Padding needed for the alignment counts as allocated memory.
+   */
+  MemSpan<void> alloc(size_t n, size_t align);
+
   /** Allocate and initialize a block of memory.
 
       The template type specifies the type to create and any arguments are forwarded to the
@@ -199,6 +753,17 @@ public:
   */
   template <typename T, typename... Args> T *make(Args &&... args);
 
+  /** Allocate and initialize an instance that is destroyed by the arena.
+   *
+   * This is the same as @c make except that if @a T is not trivially destructible, the destructor
+   * is recorded and run when the memory for the instance is released - by @c clear, @c discard,
+   * @c thaw or the destruction of the arena. Destructors are run in the reverse order of
+   * construction. Nothing is recorded for trivially destructible types.
+   *
+   * The destructor for an instance created this way must not be called explicitly.
+   */
+  template <typename T, typename... Args> T *make_managed(Args &&... args);
+
   /** Freeze reserved memory.
 
       All internal memory blocks are frozen and will not be involved in future allocations.
@@ -267,6 +832,24 @@ public:
   /// @returns the total number of bytes allocated within the arena.
   size_t allocated_size() const;
 
+  /** Enable the per thread block cache.
+   *
+   * @param flag @c true to use the cache, @c false to use @c malloc directly.
+   * @return @a this
+   *
+   * If enabled, blocks made by the arena are taken from the @c BlockCache for the current thread if
+   * possible, and released blocks are returned to the cache they came from instead of being freed.
+   * This makes steady state use of arenas that are repeatedly cleared or destroyed free of
+   * calls to @c malloc. Blocks always go back to their source, so this can be changed at any time.
+   * The cache takes precedence over an upstream resource.
+   *
+   * @see BlockCache
+   */
+  self_type &use_block_cache(bool flag = true);
+
+  /// @return The upstream memory resource, @c nullptr if @c malloc is used.
+  std::pmr::memory_resource *upstream() const;
+
   /** Check if a the byte at @a ptr is in memory owned by this arena.
    *
    * @param ptr Address of byte to check.
@@ -279,6 +862,9 @@ public:
    */
   size_t reserved_size() const;
 
+  /// @return Allocation statistics, all zero if not enabled.
+  Stats const &stats() const;
+
   using const_iterator = BlockList::const_iterator;
   using iterator       = const_iterator; // only const iteration allowed on blocks.
 
@@ -298,6 +884,49 @@ protected:
    */
   Block *make_block(size_t n);
 
+  /** Release the memory for block @a b.
+   *
+   * @param b Block to release.
+   *
+   * This is static so that it can be safely used while destroying an inverted arena.
+   */
+  static void free_block(Block *b);
+
+  /// @c memory_resource allocation.
+  void *do_allocate(size_t n, size_t align) override;
+  /// @c memory_resource de-allocation - no-op, memory is reclaimed in bulk.
+  void do_deallocate(void *ptr, size_t n, size_t align) override;
+  /// @c memory_resource equivalence - only by identity.
+  bool do_is_equal(std::pmr::memory_resource const &that) const noexcept override;
+
+  /// Destructor for an instance in the arena.
+  struct Finalizer {
+    void (*_fn)(void *); ///< Destroy the instance.
+    void *_ptr;          ///< The instance.
+  };
+
+  /// Array of finalizers in the arena.
+  struct FinalizerChunk {
+    static constexpr unsigned N = 15;      ///< Finalizers per chunk.
+    FinalizerChunk *_next       = nullptr; ///< Older chunk.
+    unsigned _count             = 0;       ///< Number of finalizers in use.
+    Finalizer _items[N];                   ///< Finalizers, in order of construction.
+  };
+
+  /// @return The next free finalizer in the active generation.
+  Finalizer *finalizer_slot();
+
+  /** Run finalizers.
+   *
+   * @param list The finalizers, newest chunk first.
+   *
+   * The finalizers are run in the reverse order they were added.
+   */
+  static void finalize(FinalizerChunk *list);
+
+  /// Run the finalizers for the active generation.
+  void finalize_active();
+
   /// Clean up the frozen list.
   void destroy_frozen();
 
@@ -322,9 +951,22 @@ protected:
   /// This is not zero iff @c reserve was called.
   size_t _reserve_hint = 0;
 
+  FinalizerChunk *_active_finalizers = nullptr; ///< Destructors for the active generation.
+  FinalizerChunk *_frozen_finalizers = nullptr; ///< Destructors for the frozen generation.
+
+  bool _cache_p = false;                          ///< Use the thread block cache.
+  std::pmr::memory_resource *_upstream = nullptr; ///< Source of block memory, @c malloc if @c nullptr.
+
   BlockList _frozen; ///< Previous generation, frozen memory.
   BlockList _active; ///< Current generation. Allocate here.
 
+#if defined(SWOC_MEMARENA_STATS)
+  Stats _stats; ///< Allocation statistics.
+#endif
+
+  /// Update statistics for an allocation of @a n bytes from @a block.
+  void note_alloc(Block *block, size_t n, bool was_full);
+
   // Note on _active block list - blocks that become full are moved to the end of the list.
   // This means that when searching for a block with space, the first full block encountered
   // marks the last block to check. This keeps the set of blocks to check short.
@@ -374,6 +1016,9 @@ public:
 
   /// Drop all items in the free list.
   void clear();
+
+  /// @return The arena used for memory.
+  MemArena &arena();
 };
 // Implementation
 
@@ -422,8 +1067,30 @@ template <typename T, typename... Args> T *MemArena::make(Args &&... args) {
   return new (this->alloc(sizeof(T)).data()) T(std::forward<Args>(args)...);
 }
 
+template <typename T, typename... Args> T *MemArena::make_managed(Args &&... args) {
+  if constexpr (std::is_trivially_destructible_v<T>) {
+    return this->make<T>(std::forward<Args>(args)...);
+  } else {
+    this->finalizer_slot(); // make room first so that normally recording can't fail.
+    T *zret = new (this->alloc(sizeof(T), alignof(T)).data()) T(std::forward<Args>(args)...);
+    Finalizer *slot;
+    try {
+      slot = this->finalizer_slot(); // constructor may have used the room.
+    } catch (...) {
+      zret->~T();
+      throw;
+    }
+    slot->_fn  = [](void *ptr) -> void { static_cast<T *>(ptr)->~T(); };
+    slot->_ptr = zret;
+    ++_active_finalizers->_count;
+    return zret;
+  }
+}
+
 inline MemArena::MemArena(size_t n) : _reserve_hint(n) {}
 
+inline MemArena::MemArena(std::pmr::memory_resource *upstream, size_t n) : _reserve_hint(n), _upstream(upstream) {}
+
 inline MemSpan<void> MemArena::Block::remnant() {
   return {this->data() + allocated, this->remaining()};
 }
@@ -453,6 +1120,203 @@ inline size_t MemArena::reserved_size() const {
   return _active_reserved + _frozen_reserved;
 }
 
+inline auto MemArena::stats() const -> Stats const & {
+#if defined(SWOC_MEMARENA_STATS)
+  return _stats;
+#else
+  static constexpr Stats NO_STATS;
+  return NO_STATS;
+#endif
+}
+
+inline void MemArena::note_alloc([[maybe_unused]] Block *block, [[maybe_unused]] size_t n, [[maybe_unused]] bool was_full) {
+#if defined(SWOC_MEMARENA_STATS)
+  ++_stats._n_allocs;
+  _stats._alloc_size     += n;
+  _stats._peak_allocated = std::max(_stats._peak_allocated, this->allocated_size());
+  if (!was_full && block->is_full()) {
+    _stats._wasted += block->remaining();
+  }
+  if (auto tag = Tag::current(); tag) {
+    tag->note(n);
+  }
+#endif
+}
+
+inline MemArena::Tag::Scope::Scope(Tag &tag) : _prev(_current) {
+  _current = &tag;
+}
+
+inline MemArena::Tag::Scope::~Scope() {
+  _current = _prev;
+}
+
+inline MemArena::Tag::Registry::iterator::iterator(Tag const *tag) : _tag(tag) {}
+
+inline auto MemArena::Tag::Registry::iterator::operator*() const -> reference {
+  return *_tag;
+}
+
+inline auto MemArena::Tag::Registry::iterator::operator->() const -> pointer {
+  return _tag;
+}
+
+inline auto MemArena::Tag::Registry::iterator::operator++() -> iterator & {
+  _tag = _tag->_next;
+  return *this;
+}
+
+inline auto MemArena::Tag::Registry::iterator::operator++(int) -> iterator {
+  auto zret = *this;
+  ++*this;
+  return zret;
+}
+
+inline bool MemArena::Tag::Registry::iterator::operator==(iterator const &that) const {
+  return _tag == that._tag;
+}
+
+inline bool MemArena::Tag::Registry::iterator::operator!=(iterator const &that) const {
+  return _tag != that._tag;
+}
+
+inline auto MemArena::Tag::Registry::begin() const -> iterator {
+  return _registry.load(std::memory_order_acquire);
+}
+
+inline auto MemArena::Tag::Registry::end() const -> iterator {
+  return {};
+}
+
+inline std::string_view MemArena::Tag::name() const {
+  return _name;
+}
+
+inline size_t MemArena::Tag::count() const {
+  return _count.load(std::memory_order_relaxed);
+}
+
+inline size_t MemArena::Tag::size() const {
+  return _size.load(std::memory_order_relaxed);
+}
+
+inline auto MemArena::Tag::registry() -> Registry {
+  return {};
+}
+
+inline auto MemArena::Tag::current() -> self_type * {
+  return _current;
+}
+
+inline void MemArena::Tag::note(size_t n) {
+  _count.fetch_add(1, std::memory_order_relaxed);
+  _size.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline auto MemArena::use_block_cache(bool flag) -> self_type & {
+  _cache_p = flag;
+  return *this;
+}
+
+inline std::pmr::memory_resource *MemArena::upstream() const {
+  return _upstream;
+}
+
+inline bool MemArena::BlockCache::is_cacheable(size_t n) {
+  return n <= N_BUCKETS * Page::SCALE - ALLOC_HEADER_SIZE && 0 == (n + ALLOC_HEADER_SIZE) % Page::SCALE;
+}
+
+inline unsigned MemArena::BlockCache::bucket_index(size_t n) {
+  return (n + ALLOC_HEADER_SIZE) / Page::SCALE - 1;
+}
+
+inline MemArena::MappedSource::MappedSource(Placement placement, Pages pages, int node)
+  : _placement(placement), _pages(pages), _node(node) {}
+
+inline auto MemArena::MappedSource::placement() const -> Placement {
+  return _placement;
+}
+
+inline auto MemArena::MappedSource::pages() const -> Pages {
+  return _pages;
+}
+
+inline constexpr size_t MemArena::MappedSource::block_hint(size_t n) {
+  return n - ALLOC_HEADER_SIZE - sizeof(Block);
+}
+
+inline bool
+MemArena::RegionSource::contains(void const *ptr) const {
+  auto p = static_cast<char const *>(ptr);
+  return _base <= p && p < _base + _capacity;
+}
+
+inline size_t
+MemArena::RegionSource::capacity() const {
+  return _capacity;
+}
+
+inline size_t
+MemArena::RegionSource::used() const {
+  return _used;
+}
+
+inline MemArena::Image::Image(self_type &&that) noexcept
+  : _map(that._map), _map_size(that._map_size), _data(that._data), _size(that._size), _origin(that._origin), _root(that._root) {
+  that._map      = nullptr;
+  that._map_size = that._size = 0;
+  that._data = that._root = nullptr;
+}
+
+inline auto
+MemArena::Image::operator=(self_type &&that) noexcept -> self_type & {
+  if (this != &that) {
+    this->clear();
+    std::swap(_map, that._map);
+    std::swap(_map_size, that._map_size);
+    std::swap(_data, that._data);
+    std::swap(_size, that._size);
+    std::swap(_origin, that._origin);
+    std::swap(_root, that._root);
+  }
+  return *this;
+}
+
+inline MemArena::Image::~Image() {
+  this->clear();
+}
+
+template <typename T>
+T *
+MemArena::Image::root() const {
+  return reinterpret_cast<T *>(_root);
+}
+
+template <typename T>
+T *
+MemArena::Image::relocate(T *ptr) const {
+  auto addr = reinterpret_cast<uintptr_t>(ptr);
+  if (addr - _origin < _size) {
+    return reinterpret_cast<T *>(_data + (addr - _origin));
+  }
+  return ptr;
+}
+
+inline void *
+MemArena::Image::data() const {
+  return _data;
+}
+
+inline size_t
+MemArena::Image::size() const {
+  return _size;
+}
+
+inline bool
+MemArena::Image::empty() const {
+  return _size == 0;
+}
+
 inline auto MemArena::begin() const -> const_iterator {
   return _active.begin();
 }
@@ -469,6 +1333,15 @@ inline auto MemArena::frozen_end() const -> const_iterator {
   return _frozen.end();
 }
 
+/// Format the statistics of an arena.
+BufferWriter &bwformat(BufferWriter &w, bwf::Spec const &spec, MemArena::Stats const &stats);
+
+/// Format the name and counts of a tag.
+BufferWriter &bwformat(BufferWriter &w, bwf::Spec const &spec, MemArena::Tag const &tag);
+
+/// Format all tags, one per line.
+BufferWriter &bwformat(BufferWriter &w, bwf::Spec const &spec, MemArena::Tag::Registry const &registry);
+
 template <typename T> FixedArena<T>::FixedArena(MemArena &arena) : _arena(arena) {
   static_assert(sizeof(T) >= sizeof(T *));
 }
@@ -496,4 +1369,8 @@ void FixedArena<T>::clear() {
   _list._next = nullptr;
 }
 
+template <typename T> MemArena &FixedArena<T>::arena() {
+  return _arena;
+}
+
 } // namespace swoc
@@ -0,0 +1,139 @@
+/** @file
+
+  Self relative pointer.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace swoc
+{
+/** A pointer stored as the distance from the pointer to its target.
+
+    The value depends only on the relative position of the pointer and its target, so an object
+    graph that uses these for its internal links is still valid if the memory containing all of it
+    is copied or mapped at a different address. This is intended for data in a @c MemArena that is
+    written as an image, @see MemArena::Image.
+
+    Because the value is relative to the location of the pointer, copying or moving a pointer
+    recomputes the distance for the new location. A pointer can point at itself, the null pointer is
+    represented by a distance of 1, which can never be the distance to a different, aligned object.
+
+    @tparam T Type of the target.
+ */
+template <typename T> class OffsetPtr
+{
+  using self_type = OffsetPtr; ///< Self reference type.
+
+public:
+  using element_type = T; ///< Export.
+
+  /// Construct a null pointer.
+  OffsetPtr() = default;
+
+  /// Construct pointing at @a ptr.
+  OffsetPtr(T *ptr);
+
+  /// Construct pointing at the target of @a that.
+  OffsetPtr(self_type const &that);
+
+  /// Point at @a ptr.
+  self_type &operator=(T *ptr);
+
+  /// Point at the target of @a that.
+  self_type &operator=(self_type const &that);
+
+  /// @return The target, or @c nullptr.
+  T *get() const;
+
+  /// @return The target, or @c nullptr.
+  operator T *() const;
+
+  T *operator->() const;
+  T &operator*() const;
+
+  /// @return @c true if not null.
+  explicit operator bool() const;
+
+protected:
+  /// Distance value for the null pointer.
+  static constexpr std::ptrdiff_t NIL = 1;
+
+  std::ptrdiff_t _offset = NIL; ///< Distance in bytes from @a this to the target.
+
+  /// Set the distance to @a ptr.
+  void assign(T *ptr);
+};
+
+template <typename T> OffsetPtr<T>::OffsetPtr(T *ptr) {
+  this->assign(ptr);
+}
+
+template <typename T> OffsetPtr<T>::OffsetPtr(self_type const &that) {
+  this->assign(that.get());
+}
+
+template <typename T>
+auto
+OffsetPtr<T>::operator=(T *ptr) -> self_type & {
+  this->assign(ptr);
+  return *this;
+}
+
+template <typename T>
+auto
+OffsetPtr<T>::operator=(self_type const &that) -> self_type & {
+  this->assign(that.get());
+  return *this;
+}
+
+template <typename T>
+void
+OffsetPtr<T>::assign(T *ptr) {
+  _offset = ptr ? reinterpret_cast<intptr_t>(ptr) - reinterpret_cast<intptr_t>(this) : NIL;
+}
+
+template <typename T>
+T *
+OffsetPtr<T>::get() const {
+  return _offset == NIL ? nullptr : reinterpret_cast<T *>(reinterpret_cast<intptr_t>(this) + _offset);
+}
+
+template <typename T> OffsetPtr<T>::operator T *() const {
+  return this->get();
+}
+
+template <typename T>
+T *
+OffsetPtr<T>::operator->() const {
+  return this->get();
+}
+
+template <typename T>
+T &
+OffsetPtr<T>::operator*() const {
+  return *this->get();
+}
+
+template <typename T> OffsetPtr<T>::operator bool() const {
+  return _offset != NIL;
+}
+
+} // namespace swoc
@@ -173,6 +173,29 @@ namespace detail
      */
     self_type *ripple_structure_fixup();
 
+    /** Black height of a tree.
+     *
+     * @param n Root of the tree, which may be @c nullptr.
+     * @return The number of black nodes on a path from @a n to a leaf.
+     */
+    static unsigned black_height(self_type const *n);
+
+    /** Join two trees with a node between them.
+     *
+     * @param left Root of the lower tree, or @c nullptr.
+     * @param left_height Black height of @a left.
+     * @param pivot Node to place between the trees, which must not be in a tree.
+     * @param right Root of the upper tree, or @c nullptr.
+     * @param right_height Black height of @a right.
+     * @param height [out] If not @c nullptr, set to the black height of the result.
+     * @return The root of the joined tree.
+     *
+     * Every node in @a left must precede @a pivot and every node in @a right must follow it. The
+     * roots must be black. This takes time proportional to the difference of the heights.
+     */
+    static self_type *join(self_type *left, unsigned left_height, self_type *pivot, self_type *right,
+                           unsigned right_height, unsigned *height = nullptr);
+
     Color _color{Color::RED};    ///< node color
     self_type *_parent{nullptr}; ///< parent node (needed for rotations)
     self_type *_left{nullptr};   ///< left child
@@ -195,6 +218,11 @@ namespace detail
 
   // --- Implementation ---
 
+  inline RBNode *
+  RBNode::child_at(Direction d) const {
+    return d == Direction::RIGHT ? _right : d == Direction::LEFT ? _left : nullptr;
+  }
+
   inline auto
   RBNode::direction_of(self_type *const &n) const -> Direction {
     return (n == _left) ? Direction::LEFT : (n == _right) ? Direction::RIGHT : Direction::NONE;
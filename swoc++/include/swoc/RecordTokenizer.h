@@ -0,0 +1,168 @@
+/** @file
+
+    Tokenizer for delimited records.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "swoc/TextView.h"
+
+namespace swoc
+{
+/** Split text in to records of delimited fields.
+ *
+ * The text is a sequence of records separated by newlines, each of which is a sequence of fields
+ * separated by a delimiter character, e.g. CSV or TSV. A field can be quoted, in which case
+ * delimiters and newlines in the field are not structural. Fields are views of the original text -
+ * there are no copies.
+ *
+ * The text is classified in blocks of 64 bytes, computing bit masks of the delimiters and newlines
+ * that are not quoted. This is done with vector instructions if available. Fields are then found
+ * from the masks, so each byte is examined once.
+ *
+ * - An empty line is skipped.
+ * - A carriage return before a newline is dropped.
+ * - The enclosing quotes of a quoted field are removed. A quote in a quoted field is represented
+ *   by two quotes, which are not changed because that would require a copy.
+ *
+ * @code
+ *   RecordTokenizer tokens{content};
+ *   tokens.project({0, 2}); // only the first and third columns.
+ *   std::vector<TextView> fields;
+ *   while (tokens.next(fields)) {
+ *     IPRange range{fields[0]};
+ *     ...
+ *   }
+ * @endcode
+ */
+class RecordTokenizer
+{
+  using self_type = RecordTokenizer; ///< Self reference type.
+
+public:
+  /// Bytes classified per block.
+  static constexpr size_t BLOCK_SIZE = 64;
+  /// Maximum number of columns that can be selected by a projection.
+  static constexpr unsigned MAX_PROJECTED = 64;
+
+  /** Construct.
+   *
+   * @param text Text to tokenize, which must remain valid while fields are used.
+   * @param delimiter Field separator.
+   * @param quote Quote character, or @c 0 for no quoting.
+   */
+  explicit RecordTokenizer(TextView text, char delimiter = ',', char quote = '"');
+
+  /** Select columns.
+   *
+   * @param columns Zero based indices of the columns to keep.
+   * @return @a this
+   *
+   * Only the fields for @a columns are returned by @c next, in column order. The rest of a record
+   * after the last selected column is skipped without splitting it. Indices must be less than
+   * @c MAX_PROJECTED. An empty list selects all columns.
+   */
+  self_type &project(std::initializer_list<unsigned> columns);
+
+  /** Get the next record.
+   *
+   * @param fields [out] The fields of the record.
+   * @return @c true if there was a record, @c false if there are no more records.
+   *
+   * @a fields is cleared before adding the fields.
+   */
+  bool next(std::vector<TextView> &fields);
+
+  /** Line number of the last record returned by @c next.
+   *
+   * @return The line number, starting with 1.
+   *
+   * This is the line in the text on which the record starts, so newlines in quoted fields are
+   * counted as well as those that end records.
+   */
+  size_t line() const;
+
+protected:
+  TextView _text;        ///< Text to tokenize.
+  char _delimiter;       ///< Field separator.
+  char _quote;           ///< Quote character.
+  size_t _pos       = 0; ///< Start of the next field.
+  size_t _line      = 0; ///< Line number of the last record.
+  size_t _n_newline = 0; ///< Number of newlines consumed, quoted or not.
+
+  uint64_t _projection  = ~uint64_t(0); ///< Selected columns.
+  unsigned _last_column = ~0U;          ///< Last selected column, or all ones if all columns.
+
+  // Classification state.
+  size_t _block      = 0;     ///< Offset of the classified block.
+  bool _classified_p = false; ///< @a _seps and @a _newlines are valid for @a _block.
+  uint64_t _seps     = 0;     ///< Unquoted delimiters in the block not yet consumed.
+  uint64_t _newlines = 0;     ///< Unquoted newlines in the block not yet consumed.
+  uint64_t _quoted   = 0;     ///< Quoted newlines in the block not yet counted.
+  uint64_t _in_quote = 0;     ///< All ones if the previous block ended in a quoted field.
+
+  /// Classify the block at @a _block.
+  void classify();
+
+  /** Find the next structural character.
+   *
+   * @param newline_p Find only newlines, skipping delimiters.
+   * @return The offset of the character, or the size of the text if there is none.
+   */
+  size_t next_structural(bool newline_p);
+
+  /// @return @a field without enclosing quotes.
+  TextView unquote(TextView field) const;
+};
+
+inline RecordTokenizer::RecordTokenizer(TextView text, char delimiter, char quote)
+  : _text(text), _delimiter(delimiter), _quote(quote) {}
+
+inline size_t
+RecordTokenizer::line() const {
+  return _line;
+}
+
+inline size_t
+RecordTokenizer::next_structural(bool newline_p) {
+  while (_block < _text.size()) {
+    if (!_classified_p) {
+      this->classify();
+      _classified_p = true;
+    }
+    if (uint64_t bits = newline_p ? _newlines : (_seps | _newlines); bits) {
+      unsigned idx  = __builtin_ctzll(bits);
+      uint64_t used = (uint64_t(2) << idx) - 1; // this and all earlier positions.
+      _seps &= ~used;
+      _newlines &= ~used;
+      _n_newline += __builtin_popcountll(_quoted & used);
+      _quoted &= ~used;
+      return _block + idx;
+    }
+    _n_newline    += __builtin_popcountll(_quoted);
+    _block        += BLOCK_SIZE;
+    _classified_p = false;
+  }
+  return _text.size();
+}
+
+} // namespace swoc
@@ -0,0 +1,259 @@
+/** @file
+
+  Sharded counters for @c Scalar values.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <set>
+
+#include "swoc/Scalar.h"
+#include "swoc/bwf_base.h"
+
+namespace swoc
+{
+namespace detail
+{
+  /** Index of a thread among the live threads.
+   *
+   * Each thread is assigned the smallest index not in use by another live thread, and the index is
+   * released when the thread exits. Indices are therefore distinct, and less than the number of live
+   * threads. Because the index is released and assigned under a lock, everything the previous
+   * owner of an index did happens before the next owner gets the index.
+   */
+  class ThreadIndex
+  {
+  public:
+    ThreadIndex();
+    ~ThreadIndex();
+
+    /// @return The index of the current thread.
+    static size_t get();
+
+  protected:
+    size_t _idx; ///< Index of this thread.
+
+    /// Shared state for assigning indices.
+    struct Registry {
+      std::mutex _mutex;      ///< Lock for the other members.
+      std::set<size_t> _free; ///< Released indices less than @a _next.
+      size_t _next = 0;       ///< Smallest index never assigned.
+    };
+    static Registry &registry();
+  };
+
+  inline auto
+  ThreadIndex::registry() -> Registry & {
+    static Registry r;
+    return r;
+  }
+
+  inline ThreadIndex::ThreadIndex() {
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r._mutex);
+    if (r._free.empty()) {
+      _idx = r._next++;
+    } else {
+      _idx = *r._free.begin();
+      r._free.erase(r._free.begin());
+    }
+  }
+
+  inline ThreadIndex::~ThreadIndex() {
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r._mutex);
+    r._free.insert(_idx);
+  }
+
+  inline size_t
+  ThreadIndex::get() {
+    static thread_local ThreadIndex idx;
+    return idx._idx;
+  }
+} // namespace detail
+
+/** A @c Scalar shared between threads.
+
+    This is a counter or gauge for statistics that are changed by many threads and read rarely. The
+    count is split in to @a N shards, each in its own cache line. Each live thread is assigned its
+    own shard by @c detail::ThreadIndex, and as no other thread changes that shard, a change is a
+    relaxed load and store rather than a locked add. Reading the value adds the shards and returns
+    the total as an instance of @a S, so that the units are kept.
+
+    If there are more than @a N live threads, the additional threads share an overflow shard which
+    is changed with atomic adds. A shard is not cleared when its thread exits, and the next thread
+    assigned that index continues the count.
+
+    The value read may not include changes that are concurrent with the read, but no change is lost.
+
+    @tparam S The @c Scalar type.
+    @tparam N The number of shards.
+ */
+template <typename S, size_t N = 16> class ShardedScalar
+{
+  using self_type = ShardedScalar; ///< Self reference type.
+
+public:
+  using scalar_type = S;                   ///< Type of the value.
+  using Counter     = typename S::Counter; ///< Type of the count.
+  static constexpr size_t N_SHARDS = N;    ///< Number of shards.
+
+  static_assert(N > 0, "ShardedScalar must have at least one shard.");
+
+  /// Construct with a value of zero.
+  ShardedScalar() = default;
+
+  ShardedScalar(self_type const &) = delete;
+  self_type &operator=(self_type const &) = delete;
+
+  /** Increase the count.
+   *
+   * @param n Number of units to add.
+   * @return @a this
+   */
+  self_type &inc(Counter n = 1);
+
+  /** Decrease the count.
+   *
+   * @param n Number of units to subtract.
+   * @return @a this
+   */
+  self_type &dec(Counter n = 1);
+
+  /// Add @a s to the value.
+  self_type &operator+=(S const &s);
+
+  /// Subtract @a s from the value.
+  self_type &operator-=(S const &s);
+
+  /// @return The value, which is the sum of the shards.
+  S fold() const;
+
+  /// @return The value, which is the sum of the shards.
+  operator S() const;
+
+  /** Reset the value to zero.
+   *
+   * @return The value before the reset.
+   *
+   * The sum of the shards becomes the new base of the value, so a change concurrent with this is
+   * either in the returned value or left in the instance.
+   */
+  S reset();
+
+protected:
+  /// A shard of the count, in its own cache line.
+  struct alignas(64) Shard {
+    std::atomic<Counter> _n{0}; ///< Count for this shard.
+  };
+
+  /// Shards of the count, one per thread index and then the overflow shard.
+  std::array<Shard, N + 1> _shards;
+  /// Sum of the shards at the last reset, which is not part of the value.
+  alignas(64) std::atomic<Counter> _base{0};
+
+  /// Add @a n to the shard for the current thread.
+  void add(Counter n);
+
+  /// @return The sum of the shards.
+  Counter sum() const;
+};
+
+template <typename S, size_t N>
+void
+ShardedScalar<S, N>::add(Counter n) {
+  auto idx = detail::ThreadIndex::get();
+  if (idx < N) {
+    // Only this thread changes the shard, so the update doesn't need to be atomic.
+    auto &shard = _shards[idx]._n;
+    shard.store(shard.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  } else {
+    _shards[N]._n.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+template <typename S, size_t N>
+auto
+ShardedScalar<S, N>::sum() const -> Counter {
+  Counter n = 0;
+  for (auto const &shard : _shards) {
+    n += shard._n.load(std::memory_order_relaxed);
+  }
+  return n;
+}
+
+template <typename S, size_t N>
+auto
+ShardedScalar<S, N>::inc(Counter n) -> self_type & {
+  this->add(n);
+  return *this;
+}
+
+template <typename S, size_t N>
+auto
+ShardedScalar<S, N>::dec(Counter n) -> self_type & {
+  this->add(-n);
+  return *this;
+}
+
+template <typename S, size_t N>
+auto
+ShardedScalar<S, N>::operator+=(S const &s) -> self_type & {
+  return this->inc(s.count());
+}
+
+template <typename S, size_t N>
+auto
+ShardedScalar<S, N>::operator-=(S const &s) -> self_type & {
+  return this->dec(s.count());
+}
+
+template <typename S, size_t N>
+S
+ShardedScalar<S, N>::fold() const {
+  return S{this->sum() - _base.load(std::memory_order_relaxed)};
+}
+
+template <typename S, size_t N> ShardedScalar<S, N>::operator S() const {
+  return this->fold();
+}
+
+template <typename S, size_t N>
+S
+ShardedScalar<S, N>::reset() {
+  // The shards belong to their threads and can't be cleared, so instead the sum is saved as the base.
+  Counter base = _base.load(std::memory_order_relaxed);
+  Counter n;
+  do {
+    n = this->sum();
+  } while (!_base.compare_exchange_weak(base, n, std::memory_order_relaxed));
+  return S{n - base};
+}
+
+/// Format the value of @a x, as for @c Scalar.
+template <typename S, size_t N>
+BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &spec, ShardedScalar<S, N> const &x) {
+  return bwformat(w, spec, x.fold());
+}
+
+} // namespace swoc
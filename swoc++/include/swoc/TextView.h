@@ -26,7 +26,9 @@
 
 #pragma once
 #include <bitset>
+#include <cstdint>
 #include <iosfwd>
+#include <limits>
 #include <memory.h>
 #include <string>
 #include <string_view>
@@ -85,6 +87,85 @@ strcmp(const std::string_view &lhs, const std::string_view &rhs) {
 namespace swoc
 {
 class TextView;
+template <typename T> class MemSpan;
+
+/** A set of characters.
+ *
+ * This is a literal type and so a set can be constructed at compile time, which avoids rebuilding
+ * the set on every call to a delimiter based method of @c TextView.
+ *
+ * @code
+ *   static constexpr swoc::CharSet SEPARATORS{",;"};
+ *   auto token = text.take_prefix_at(SEPARATORS);
+ * @endcode
+ *
+ * Along with the membership bits the set retains the distinct characters if there are not too
+ * many, which enables vectorized searching. The set can also be used directly as a predicate.
+ */
+class CharSet {
+  using self_type = CharSet;
+
+public:
+  /// Maximum number of distinct characters for vectorized search.
+  static constexpr size_t VECTOR_LIMIT = 16;
+
+  /// Construct an empty set.
+  constexpr CharSet() = default;
+
+  /** Construct from the characters in @a chars.
+   *
+   * @param chars The members of the set.
+   *
+   * Duplicate characters are permitted and ignored.
+   */
+  explicit constexpr CharSet(std::string_view const &chars);
+
+  /// @return @c true if @a c is in the set, @c false if not.
+  constexpr bool contains(char c) const;
+
+  /// @return @c true if @a c is in the set, @c false if not.
+  constexpr bool operator()(char c) const;
+
+  /// @return The number of distinct characters in the set.
+  constexpr size_t count() const;
+
+protected:
+  uint64_t _bits[4]         = {0, 0, 0, 0}; ///< Membership bits.
+  char _chars[VECTOR_LIMIT] = {};           ///< Distinct members, valid if @a _count is at most @c VECTOR_LIMIT.
+  uint16_t _count           = 0;            ///< Number of distinct members.
+
+  friend class TextView;
+};
+
+// === CharSet Implementation ===
+inline constexpr CharSet::CharSet(std::string_view const &chars) {
+  for (char c : chars) {
+    auto idx = static_cast<uint8_t>(c);
+    if (0 == (_bits[idx >> 6] & (uint64_t(1) << (idx & 0x3F)))) {
+      _bits[idx >> 6] |= uint64_t(1) << (idx & 0x3F);
+      if (_count < VECTOR_LIMIT) {
+        _chars[_count] = c;
+      }
+      ++_count;
+    }
+  }
+}
+
+inline constexpr bool
+CharSet::contains(char c) const {
+  auto idx = static_cast<uint8_t>(c);
+  return 0 != (_bits[idx >> 6] & (uint64_t(1) << (idx & 0x3F)));
+}
+
+inline constexpr bool
+CharSet::operator()(char c) const {
+  return this->contains(c);
+}
+
+inline constexpr size_t
+CharSet::count() const {
+  return _count;
+}
 
 /** A read only view of a contiguous piece of memory.
 
@@ -223,6 +304,20 @@ public:
   /// Clear the view (become an empty view).
   self_type &clear();
 
+  using super_type::find_first_of;
+  using super_type::find_first_not_of;
+  using super_type::find_last_of;
+  using super_type::find_last_not_of;
+
+  /// @return The offset of the first character in @a set, or @c npos if there is none.
+  size_t find_first_of(CharSet const &set) const;
+  /// @return The offset of the first character not in @a set, or @c npos if there is none.
+  size_t find_first_not_of(CharSet const &set) const;
+  /// @return The offset of the last character in @a set, or @c npos if there is none.
+  size_t find_last_of(CharSet const &set) const;
+  /// @return The offset of the last character not in @a set, or @c npos if there is none.
+  size_t find_last_not_of(CharSet const &set) const;
+
   /// Get the offset of the first character for which @a pred is @c true.
   template <typename F> size_t find_if(F const &pred) const;
   /// Get the offset of the last character for which @a pred is @c true.
@@ -248,6 +343,12 @@ public:
    */
   self_type &ltrim(const char *delimiters);
 
+  /** Remove bytes from the start of the view that are in @a set.
+   *
+   * @return @a this
+   */
+  self_type &ltrim(CharSet const &set);
+
   /** Remove bytes from the start of the view for which @a pred is @c true.
       @a pred must be a functor taking a @c char argument and returning @c bool.
       @return @c *this
@@ -265,6 +366,11 @@ public:
    */
   self_type &rtrim(std::string_view const &delimiters);
 
+  /** Remove bytes from the end of the view that are in @a set.
+   * @return @a this
+   */
+  self_type &rtrim(CharSet const &set);
+
   /** Remove bytes from the end of the view for which @a pred is @c true.
    *
    * @a pred must be a functor taking a @c char argument and returning @c bool.
@@ -290,6 +396,14 @@ public:
   */
   self_type &trim(const char *delimiters);
 
+  /** Remove bytes from the start and end of the view that are in @a set.
+   * @return @a this
+   */
+  self_type &trim(CharSet const &set);
+
+  /// The white space characters, as for @c isspace in the "C" locale.
+  static constexpr CharSet WHITESPACE{" \t\n\v\f\r"};
+
   /** Remove bytes from the start and end of the view for which @a pred is @c true.
       @a pred must be a functor taking a @c char argument and returning @c bool.
       @return @c *this
@@ -739,11 +853,27 @@ public:
   self_type split_prefix(int n);
   self_type suffix(int n) const;
   self_type split_suffix(int n);
+
+  // Delimiter set overloads, which are equivalent to the @c std::string_view overloads but do not
+  // rebuild the set on every call.
+  self_type prefix_at(CharSet const &set) const;
+  self_type &remove_prefix_at(CharSet const &set);
+  self_type split_prefix_at(CharSet const &set);
+  self_type take_prefix_at(CharSet const &set);
+  self_type suffix_at(CharSet const &set) const;
+  self_type &remove_suffix_at(CharSet const &set);
+  self_type split_suffix_at(CharSet const &set);
+  self_type take_suffix_at(CharSet const &set);
   /// @endcond
 
 protected:
   /// Initialize a bit mask to mark which characters are in this view.
   static void init_delimiter_set(std::string_view const &delimiters, std::bitset<256> &set);
+
+  /// Find the first character in @a set, or not in @a set if @a invert is @c true.
+  size_t find_forward(CharSet const &set, bool invert) const;
+  /// Find the last character in @a set, or not in @a set if @a invert is @c true.
+  size_t find_backward(CharSet const &set, bool invert) const;
 };
 
 /// Internal table of digit values for characters.
@@ -774,6 +904,51 @@ intmax_t svtoi(TextView src, TextView *parsed = nullptr, int base = 0);
 */
 uintmax_t svtou(TextView src, TextView *parsed = nullptr, int base = 0);
 
+/** Convert a delimited list of numbers in @a src to signed numeric values.
+ *
+ * @param src The source text, updated to remove the parsed numbers.
+ * @param values Destination for the values.
+ * @param delimiters Characters that separate the numbers.
+ * @param base Numeric base, as for @c svtoi.
+ * @return The number of values parsed.
+ *
+ * White space around the numbers is ignored. Parsing stops when @a values is full, at the end of
+ * @a src, or at text that is not a number followed by a delimiter or the end of the text. @a src is
+ * left with the unparsed text, starting after the delimiter that follows the last parsed value. If
+ * every value is parsed @a src is empty.
+ *
+ * @code
+ *   intmax_t ports[8];
+ *   auto n = swoc::svtoi_list(text, swoc::MemSpan<intmax_t>{ports, 8});
+ * @endcode
+ *
+ * @note The caller must include @c MemSpan.h.
+ */
+size_t svtoi_list(TextView &src, MemSpan<intmax_t> values, CharSet const &delimiters = CharSet{","}, int base = 0);
+
+namespace detail
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SWOC_SVTO_SWAR 1
+/// Result of converting blocks of decimal digits.
+struct DecimalBlocks {
+  uintmax_t _value; ///< Value of the converted digits.
+  uint32_t _size;   ///< Number of digits converted.
+  bool _done_p;     ///< @c true if all of the leading digits were converted.
+};
+
+/** Convert leading decimal digits in blocks of 8 digits.
+ *
+ * @param src Text to convert.
+ * @return The converted value and how much of @a src was converted.
+ *
+ * This is the fast path for @c svto_radix<10>. Blocks are converted only while overflow is not
+ * possible, the remaining digits must be converted one at a time.
+ */
+DecimalBlocks svto_decimal_blocks(TextView src);
+#endif
+} // namespace detail
+
 /** Convert the text in @c src to an unsigned numeric value.
  *
  * @tparam N The radix (must be  1..36)
@@ -790,7 +965,7 @@ uintmax_t svtou(TextView src, TextView *parsed = nullptr, int base = 0);
  * powers of 2 shifts is used). It is used inside @c svtoi and @c svtou for the common cases of 8,
  * 10, and 16, therefore normally this isn't much more performant than @c svtoi. Because of this
  * only positive values are parsed. If determining the radix from the text or signed value parsing
- * is needed, used @c svtoi.
+ * is needed, used @c svtoi. For radix 10 up to 8 digits are converted per step, where supported.
  *
  * @a src is updated in place to indicate what characters were parsed. Parsing stops on the first
  * invalid digit, so any leading non-digit characters (e.g. whitespace) must already be removed.
@@ -804,15 +979,29 @@ uintmax_t
 svto_radix(swoc::TextView &src) {
   static_assert(0 < N && N <= 36, "Radix must be in the range 1..36");
   uintmax_t zret{0};
+#if defined(SWOC_SVTO_SWAR)
+  if constexpr (N == 10) {
+    if (src.size() >= 8)
+    {
+      auto blocks = detail::svto_decimal_blocks(src);
+      src.remove_prefix(blocks._size);
+      zret = blocks._value;
+      if (blocks._done_p)
+      {
+        return zret;
+      }
+    }
+  }
+#endif
+  static constexpr uintmax_t LIMIT = std::numeric_limits<uintmax_t>::max() / N;
   int8_t v;
   while (src.size() && (0 <= (v = swoc::svtoi_convert[uint8_t(*src)])) && v < N)
   {
-    auto n = zret * N + v;
-    if (n < zret)
+    if (zret >= LIMIT && (zret > LIMIT || uintmax_t(v) > std::numeric_limits<uintmax_t>::max() % N))
     { // overflow / wrap
       return std::numeric_limits<uintmax_t>::max();
     }
-    zret = n;
+    zret = zret * N + v;
     ++src;
   }
   return zret;
@@ -830,6 +1019,26 @@ svto_radix(swoc::TextView &&src) {
 // definition and the reference documentation is messed up. Sigh.
 
 // === TextView Implementation ===
+inline size_t
+TextView::find_first_of(CharSet const &set) const {
+  return this->find_forward(set, false);
+}
+
+inline size_t
+TextView::find_first_not_of(CharSet const &set) const {
+  return this->find_forward(set, true);
+}
+
+inline size_t
+TextView::find_last_of(CharSet const &set) const {
+  return this->find_backward(set, false);
+}
+
+inline size_t
+TextView::find_last_not_of(CharSet const &set) const {
+  return this->find_backward(set, true);
+}
+
 inline constexpr TextView::TextView(const char *ptr, size_t n) : super_type(ptr, n) {}
 inline constexpr TextView::TextView(char const *first, char const *last) : super_type(first, last - first) {}
 inline constexpr TextView::TextView(std::nullptr_t) : super_type(nullptr, 0) {}
@@ -940,8 +1149,13 @@ TextView::prefix_at(char c) const {
 
 inline TextView
 TextView::prefix_at(std::string_view const &delimiters) const {
+  return this->prefix_at(CharSet{delimiters});
+}
+
+inline TextView
+TextView::prefix_at(CharSet const &set) const {
   self_type zret; // default to empty return.
-  if (auto n = this->find_first_of(delimiters); n != npos)
+  if (auto n = this->find_first_of(set); n != npos)
   {
     zret.assign(this->data(), n);
   }
@@ -976,7 +1190,12 @@ TextView::remove_prefix_at(char c) {
 
 inline TextView &
 TextView::remove_prefix_at(std::string_view const &delimiters) {
-  if (auto n = this->find_first_of(delimiters); n != npos)
+  return this->remove_prefix_at(CharSet{delimiters});
+}
+
+inline TextView &
+TextView::remove_prefix_at(CharSet const &set) {
+  if (auto n = this->find_first_of(set); n != npos)
   {
     this->super_type::remove_prefix(n + 1);
   }
@@ -1016,7 +1235,12 @@ TextView::split_prefix_at(char c) {
 
 inline TextView
 TextView::split_prefix_at(std::string_view const &delimiters) {
-  return this->split_prefix(this->find_first_of(delimiters));
+  return this->split_prefix(this->find_first_of(CharSet{delimiters}));
+}
+
+inline TextView
+TextView::split_prefix_at(CharSet const &set) {
+  return this->split_prefix(this->find_first_of(set));
 }
 
 template <typename F>
@@ -1040,7 +1264,12 @@ TextView::take_prefix_at(char c) {
 
 inline TextView
 TextView::take_prefix_at(std::string_view const &delimiters) {
-  return this->take_prefix(this->find_first_of(delimiters));
+  return this->take_prefix(this->find_first_of(CharSet{delimiters}));
+}
+
+inline TextView
+TextView::take_prefix_at(CharSet const &set) {
+  return this->take_prefix(this->find_first_of(set));
 }
 
 template <typename F>
@@ -1073,8 +1302,13 @@ TextView::suffix_at(char c) const {
 
 inline TextView
 TextView::suffix_at(std::string_view const &delimiters) const {
+  return this->suffix_at(CharSet{delimiters});
+}
+
+inline TextView
+TextView::suffix_at(CharSet const &set) const {
   self_type zret;
-  if (auto n = this->find_last_of(delimiters); n != npos)
+  if (auto n = this->find_last_of(set); n != npos)
   {
     ++n;
     zret.assign(this->data() + n, this->size() - n);
@@ -1111,7 +1345,12 @@ TextView::remove_suffix_at(char c) {
 
 inline TextView &
 TextView::remove_suffix_at(std::string_view const &delimiters) {
-  if (auto n = this->find_last_of(delimiters); n != npos)
+  return this->remove_suffix_at(CharSet{delimiters});
+}
+
+inline TextView &
+TextView::remove_suffix_at(CharSet const &set) {
+  if (auto n = this->find_last_of(set); n != npos)
   {
     this->remove_suffix(this->size() - n);
   }
@@ -1150,7 +1389,12 @@ TextView::split_suffix_at(char c) {
 
 inline auto
 TextView::split_suffix_at(std::string_view const &delimiters) -> self_type {
-  auto idx = this->find_last_of(delimiters);
+  return this->split_suffix_at(CharSet{delimiters});
+}
+
+inline auto
+TextView::split_suffix_at(CharSet const &set) -> self_type {
+  auto idx = this->find_last_of(set);
   return npos == idx ? self_type{} : this->split_suffix(this->size() - (idx + 1));
 }
 
@@ -1179,7 +1423,12 @@ TextView::take_suffix_at(char c) {
 
 inline TextView
 TextView::take_suffix_at(std::string_view const &delimiters) {
-  return this->take_suffix(this->find_last_of(delimiters));
+  return this->take_suffix(this->find_last_of(CharSet{delimiters}));
+}
+
+inline TextView
+TextView::take_suffix_at(CharSet const &set) {
+  return this->take_suffix(this->find_last_of(set));
 }
 
 template <typename F>
@@ -1226,15 +1475,12 @@ TextView::trim(char c) {
 
 inline TextView &
 TextView::ltrim(std::string_view const &delimiters) {
-  std::bitset<256> valid;
-  this->init_delimiter_set(delimiters, valid);
-  const char *spot;
-  const char *limit;
-
-  for (spot = this->data(), limit = this->data_end(); spot < limit && valid[static_cast<uint8_t>(*spot)]; ++spot)
-    ;
-  this->remove_prefix(spot - this->data());
+  return this->ltrim(CharSet{delimiters});
+}
 
+inline TextView &
+TextView::ltrim(CharSet const &set) {
+  this->remove_prefix(this->find_first_not_of(set));
   return *this;
 }
 
@@ -1245,37 +1491,25 @@ TextView::ltrim(const char *delimiters) {
 
 inline TextView &
 TextView::rtrim(std::string_view const &delimiters) {
-  std::bitset<256> valid;
-  this->init_delimiter_set(delimiters, valid);
-  const char *spot  = this->data_end();
-  const char *limit = this->data();
-
-  while (limit < spot-- && valid[static_cast<uint8_t>(*spot)])
-    ;
+  return this->rtrim(CharSet{delimiters});
+}
 
-  this->remove_suffix(this->data_end() - (spot + 1));
+inline TextView &
+TextView::rtrim(CharSet const &set) {
+  auto n = this->find_last_not_of(set);
+  this->remove_suffix(this->size() - (n == npos ? 0 : n + 1));
   return *this;
 }
 
 inline TextView &
 TextView::trim(std::string_view const &delimiters) {
-  std::bitset<256> valid;
-  this->init_delimiter_set(delimiters, valid);
-  const char *spot;
-  const char *limit;
-
-  // Do this explicitly, so we don't have to initialize the character set twice.
-  for (spot = this->data(), limit = this->data_end(); spot < limit && valid[static_cast<uint8_t>(*spot)]; ++spot)
-    ;
-  this->remove_prefix(spot - this->data());
-
-  spot  = this->data_end();
-  limit = this->data();
-  while (limit < spot-- && valid[static_cast<uint8_t>(*spot)])
-    ;
-  this->remove_suffix(this->data_end() - (spot + 1));
+  // Build the set once for both ends.
+  return this->trim(CharSet{delimiters});
+}
 
-  return *this;
+inline TextView &
+TextView::trim(CharSet const &set) {
+  return this->ltrim(set).rtrim(set);
 }
 
 inline TextView &
@@ -1331,21 +1565,11 @@ TextView::starts_with(std::string_view const &prefix) const {
   return this->size() >= prefix.size() && 0 == ::memcmp(this->data(), prefix.data(), prefix.size());
 }
 
-inline bool
-TextView::starts_with_nocase(std::string_view const &prefix) const {
-  return this->size() >= prefix.size() && 0 == ::strncasecmp(this->data(), prefix.data(), prefix.size());
-}
-
 inline bool
 TextView::ends_with(std::string_view const &suffix) const {
   return this->size() >= suffix.size() && 0 == ::memcmp(this->data_end() - suffix.size(), suffix.data(), suffix.size());
 }
 
-inline bool
-TextView::ends_with_nocase(std::string_view const &suffix) const {
-  return this->size() >= suffix.size() && 0 == ::strncasecmp(this->data_end() - suffix.size(), suffix.data(), suffix.size());
-}
-
 template <typename Stream>
 Stream &
 TextView::stream_write(Stream &os, const TextView &b) const {
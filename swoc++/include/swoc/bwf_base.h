@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdlib>
 #include <utility>
 #include <cstring>
@@ -199,6 +200,201 @@ namespace bwf
     std::vector<Spec> _items; ///< Items from format string.
   };
 
+  /** Base class for compact pre-parsed formats.
+   *
+   * This contains the parsing and extraction logic for @c LocalFormat, which provides the storage.
+   * The format string is copied in to the storage, followed by an array of packed specifiers. The
+   * names, extensions, and literals of the specifiers are stored as offsets in to the copied
+   * format string, and so the storage contains no pointers and can be copied as raw memory. Values
+   * in a specifier are limited to fit the packed form - an attempt to use a larger value throws
+   * @c std::length_error. Long literals are split across items.
+   */
+  class CompactFormat
+  {
+    using self_type = CompactFormat; ///< Self reference type.
+
+  public:
+    /// Packed form of @c Spec.
+    struct Item {
+      uint16_t _name;    ///< Offset of the name, or the literal.
+      uint16_t _ext;     ///< Offset of the extension.
+      uint16_t _min;     ///< Minimum width.
+      uint16_t _max;     ///< Maximum width, @c MAX_UNLIMITED for unlimited.
+      uint8_t _name_len; ///< Length of the name, or the literal.
+      uint8_t _ext_len;  ///< Length of the extension.
+      char _fill;        ///< Fill character.
+      char _sign;        ///< Numeric sign style.
+      char _type;        ///< Type / radix indicator.
+      uint8_t _flags;    ///< Alignment and radix lead flag.
+      int8_t _prec;      ///< Precision.
+      int8_t _idx;       ///< Argument index.
+
+      static constexpr uint16_t MAX_UNLIMITED = std::numeric_limits<uint16_t>::max(); ///< Unlimited maximum width.
+      static constexpr size_t MAX_TEXT        = std::numeric_limits<uint8_t>::max();  ///< Maximum name or literal length.
+      static constexpr uint8_t ALIGN_MASK     = 0x7;                                  ///< Alignment bits in @a _flags.
+      static constexpr uint8_t RADIX_LEAD     = 0x8;                                  ///< Radix lead flag in @a _flags.
+
+      /** Copy @a spec into @a this.
+       *
+       * @param spec Source specifier.
+       * @param text The format string, which must contain the text views in @a spec.
+       */
+      void pack(Spec const &spec, std::string_view text);
+
+      /** Expand @a this in to a full specifier.
+       *
+       * @param text The copied format string.
+       * @return The specifier.
+       */
+      Spec unpack(char const *text) const;
+    };
+
+    /// Extraction support for compact formats.
+    struct Extractor {
+      char const *_text;   ///< Copied format string.
+      Item const *_items;  ///< Packed items.
+      unsigned _count;     ///< Number of items.
+      unsigned _idx = 0;   ///< Element index.
+      explicit operator bool() const;
+      bool operator()(std::string_view &literal_v, Spec &spec);
+    };
+
+    /// @return The number of literals and specifiers.
+    unsigned count() const;
+
+    /// @return The number of bytes of storage used.
+    size_t size() const;
+
+  protected:
+    /// Offset of the items in storage for a format string of length @a n.
+    static constexpr size_t items_offset(size_t n);
+
+    /** Parse a format string into storage.
+     *
+     * @param storage Destination memory, which must be aligned for @c Item.
+     * @param fmt Format string.
+     *
+     * @c std::length_error is thrown if @a fmt does not fit in @a storage.
+     */
+    void assign(MemSpan<char> storage, TextView fmt);
+
+    /// Wrap the packed format in @a storage in an extractor.
+    Extractor bind(char const *storage) const;
+
+    uint16_t _size  = 0; ///< Length of the format string.
+    uint16_t _count = 0; ///< Number of items.
+  };
+
+  /** A compact pre-parsed format with inline storage.
+   *
+   * @tparam N Number of bytes of storage.
+   *
+   * This is an alternative to @c Format which does not allocate and is trivially copyable. The
+   * default @a N makes an instance 128 bytes, two cache lines. Each item (specifier or literal) uses
+   * @c sizeof(CompactFormat::Item) bytes in addition to a copy of the format string.
+   */
+  template <size_t N = 124> class LocalFormat : public CompactFormat
+  {
+    using self_type  = LocalFormat;   ///< Self reference type.
+    using super_type = CompactFormat; ///< Parent type.
+
+    static_assert(N <= std::numeric_limits<uint16_t>::max(), "Storage too large for offsets");
+
+  public:
+    /// Construct from a format string @a fmt.
+    LocalFormat(TextView fmt);
+
+    /// Wrap the format instance in an extractor.
+    Extractor bind() const;
+
+  protected:
+    alignas(Item) char _data[N]; ///< Format string and packed items.
+  };
+
+  /** Compile time parsing of format strings.
+   *
+   * This is the @c constexpr equivalent of @c Format::TextViewExtractor and @c Spec::parse, used
+   * by @c StaticFormat. Errors are reported by throwing, which during constant evaluation makes
+   * the format string a compile error.
+   */
+  struct StaticFormatParser {
+    /// @return @c true if @a c is a specifier type indicator.
+    static constexpr bool is_type(char c);
+    /// @return The alignment for @a c, @c Spec::Align::NONE if @a c is not an alignment mark.
+    static constexpr Spec::Align align_of(char c);
+    /// @return @c true if @a c is a sign indicator.
+    static constexpr bool is_sign(char c);
+    /// Remove leading decimal digits from @a text and return their value.
+    static constexpr unsigned number(std::string_view &text);
+    /// @return The value of hexadecimal digit @a c, or -1 if @a c is not a hexadecimal digit.
+    static constexpr int hex_value(char c);
+
+    /** Parse out the next literal and/or specifier from @a fmt.
+     *
+     * @param fmt The format string [in|out]
+     * @param literal A literal if found
+     * @param specifier A specifier if found (less enclosing braces)
+     * @return @c true if a specifier was found, @c false if not.
+     */
+    static constexpr bool next(std::string_view &fmt, std::string_view &literal, std::string_view &specifier);
+
+    /// @return The specifier parsed from @a text.
+    static constexpr Spec spec(std::string_view text);
+
+    /// @return The number of items (literals and specifiers) in @a fmt.
+    static constexpr size_t count(std::string_view fmt);
+
+    /// @return The items in @a fmt, with implicit argument indices resolved.
+    template <size_t N> static constexpr std::array<Spec, N> items(std::string_view fmt);
+
+    /// @return The number of arguments used by @a items.
+    template <size_t N> static constexpr size_t arg_count(std::array<Spec, N> const &items);
+  };
+
+  /** A format string parsed at compile time.
+   *
+   * @tparam S Source of the format string. This must have a static @c constexpr method @c text
+   * which returns the format string.
+   *
+   * In contrast to @c Format the format string is parsed at compile time in to a fixed array of
+   * specifiers. Because the specifiers are constants, formatting dispatches directly to the
+   * formatter for each argument without runtime parsing or type erasure. The number of arguments
+   * is checked at compile time to match the format string, as is that every argument can be
+   * formatted. For convenience an instance is usually created with @c SWOC_BWF_FORMAT, e.g.
+   *
+   * @code
+   *   w.print(SWOC_BWF_FORMAT("Request {} of {} failed"), req_idx, req_count);
+   * @endcode
+   *
+   * Named specifiers are supported and are resolved via @c Global_Names when formatting.
+   */
+  template <typename S> class StaticFormat
+  {
+  public:
+    /// The format string.
+    static constexpr std::string_view TEXT = S::text();
+    /// Number of items (literals and specifiers) in the format.
+    static constexpr size_t N_ITEMS = StaticFormatParser::count(TEXT);
+    /// The parsed format.
+    static constexpr std::array<Spec, N_ITEMS> ITEMS = StaticFormatParser::items<N_ITEMS>(TEXT);
+    /// Number of arguments required by the format.
+    static constexpr size_t N_ARGS = StaticFormatParser::arg_count(ITEMS);
+
+    /** Generate formatted output.
+     *
+     * @param w Output.
+     * @param args Arguments for the format.
+     * @return @a w
+     */
+    template <typename... Args> static BufferWriter &write(BufferWriter &w, std::tuple<Args...> const &args);
+
+  protected:
+    /// Generate the output for item @a I.
+    template <size_t I, typename TUPLE> static void item(BufferWriter &w, TUPLE const &args);
+    /// Generate the output for the items in @a N.
+    template <typename TUPLE, size_t... N> static void items(BufferWriter &w, TUPLE const &args, std::index_sequence<N...>);
+  };
+
   // Name binding - support for having format specifier names.
 
   /** Signature for a functor bound to a name.
@@ -236,7 +432,6 @@ namespace bwf
      */
     virtual BufferWriter &operator()(BufferWriter &w, Spec const &spec) const = 0;
 
-  protected:
     /** Standardized missing name method.
      *
      * @param w The destination buffer.
@@ -288,6 +483,16 @@ namespace bwf
      */
     self_type &assign(std::string_view const &name, Generator const &generator);
 
+    /** Find the generator for @a name.
+     *
+     * @param name Name to find.
+     * @return The generator, or @c nullptr if @a name is not in the map.
+     *
+     * The returned pointer remains valid for the lifetime of @a this, and refers to the new
+     * generator if @a name is assigned again.
+     */
+    Generator const *find(std::string_view name) const;
+
   protected:
     /// Copy @a name in to local storage and return a view of it.
     std::string_view localize(std::string_view const &name);
@@ -434,6 +639,90 @@ namespace bwf
    */
   extern ExternalNames Global_Names;
 
+  /** A pre-parsed format with the names resolved in advance.
+   *
+   * @tparam F The generator signature of the name map.
+   *
+   * The names in the format string are looked up in the name map once, when the format is
+   * constructed, and printing calls the generators directly with no name lookup. The name map must
+   * outlive the format. A name that is not in the map when the format is constructed is an invalid
+   * name even if it is added later, but assigning a new generator to a name that was found is
+   * effective.
+   *
+   * For external names, such as @c Global_Names, the format can be passed to @c BufferWriter::print.
+   * For context names the context is provided with @c bind_names.
+   * @code
+   *   bwf::BoundFormat<Names::Signature> fmt{"{client-ip} - {path}", names};
+   *   w.print_nfv(fmt.bind_names(context), fmt.bind());
+   * @endcode
+   *
+   * @note Because the generators are found directly in the map, an override of
+   * @c ContextNames::operator() is not used.
+   */
+  template <typename F> class BoundFormat : public Format
+  {
+    using self_type  = BoundFormat; ///< Self reference type.
+    using super_type = Format;      ///< Parent type.
+  public:
+    /// Generator type.
+    using Generator = typename NameMap<F>::Generator;
+
+    /** Construct from a format string.
+     *
+     * @param fmt The format string.
+     * @param names The names for the format.
+     */
+    BoundFormat(TextView fmt, NameMap<F> const &names);
+
+    /// Specifier with the generator for its name.
+    struct BoundSpec : public Spec {
+      Generator const *_generator = nullptr; ///< Generator for the name, @c nullptr if not found.
+    };
+
+    /// Extraction support.
+    struct Extractor {
+      self_type const &_fmt; ///< Bound format.
+      int _idx = 0;          ///< Element index.
+      explicit operator bool() const;
+      bool operator()(std::string_view &literal_v, BoundSpec &spec);
+    };
+
+    /// Wrap the format instance in an extractor.
+    Extractor bind() const;
+
+    /** Name binding that calls the resolved generators.
+     *
+     * @tparam Context Types of the additional generator arguments.
+     */
+    template <typename... Context> class Binding : public NameBinding
+    {
+    public:
+      /// Output for a resolved specifier.
+      BufferWriter &operator()(BufferWriter &w, BoundSpec const &spec) const;
+
+      /// Output for a specifier that is not from a bound format, which is an invalid name.
+      BufferWriter &operator()(BufferWriter &w, Spec const &spec) const override;
+
+    protected:
+      /// Construct with the generator arguments.
+      explicit Binding(Context &... ctx);
+
+      std::tuple<Context &...> _ctx; ///< Context for generators.
+
+      friend BoundFormat;
+    };
+
+    /** Bind the generator arguments.
+     *
+     * @param ctx Arguments passed to the generators after the writer and specifier.
+     * @return A name binding for use with @c BufferWriter::print_nfv.
+     */
+    template <typename... Context> Binding<Context...> bind_names(Context &... ctx) const;
+
+  protected:
+    std::vector<Generator const *> _generators; ///< Generators, parallel to @a _items.
+  };
+
   // --------------- Implementation --------------------
   /// --- Spec ---
 
@@ -506,6 +795,272 @@ namespace bwf
   inline Format::TextViewExtractor::operator bool() const { return !_fmt.empty(); }
   inline Format::FormatExtractor::operator bool() const { return _idx < static_cast<int>(_fmt.size()); }
 
+  /// --- CompactFormat ---
+
+  inline CompactFormat::Extractor::operator bool() const { return _idx < _count; }
+
+  inline unsigned
+  CompactFormat::count() const
+  {
+    return _count;
+  }
+
+  constexpr size_t
+  CompactFormat::items_offset(size_t n)
+  {
+    return (n + alignof(Item) - 1) & ~(alignof(Item) - 1);
+  }
+
+  inline size_t
+  CompactFormat::size() const
+  {
+    return items_offset(_size) + _count * sizeof(Item);
+  }
+
+  inline auto
+  CompactFormat::bind(char const *storage) const -> Extractor
+  {
+    return {storage, reinterpret_cast<Item const *>(storage + items_offset(_size)), _count};
+  }
+
+  template <size_t N> LocalFormat<N>::LocalFormat(TextView fmt) { this->assign({_data, N}, fmt); }
+
+  template <size_t N>
+  auto
+  LocalFormat<N>::bind() const -> Extractor
+  {
+    return this->super_type::bind(_data);
+  }
+
+  /// --- StaticFormatParser ---
+
+  constexpr bool
+  StaticFormatParser::is_type(char c)
+  {
+    return c == 'b' || c == 'B' || c == 'd' || c == 'g' || c == 'o' || c == 'p' || c == 'P' || c == 'r' || c == 's' || c == 'S' ||
+           c == 'x' || c == 'X';
+  }
+
+  constexpr Spec::Align
+  StaticFormatParser::align_of(char c)
+  {
+    return c == '<' ? Spec::Align::LEFT :
+           c == '>' ? Spec::Align::RIGHT :
+           c == '^' ? Spec::Align::CENTER :
+           c == '=' ? Spec::Align::SIGN :
+                      Spec::Align::NONE;
+  }
+
+  constexpr bool
+  StaticFormatParser::is_sign(char c)
+  {
+    return c == Spec::SIGN_ALWAYS || c == Spec::SIGN_NEVER || c == Spec::SIGN_NEG;
+  }
+
+  constexpr unsigned
+  StaticFormatParser::number(std::string_view &text)
+  {
+    unsigned zret = 0;
+    while (text.size() && '0' <= text[0] && text[0] <= '9') {
+      zret = zret * 10 + (text[0] - '0');
+      text.remove_prefix(1);
+    }
+    return zret;
+  }
+
+  constexpr int
+  StaticFormatParser::hex_value(char c)
+  {
+    return ('0' <= c && c <= '9') ? c - '0' : ('a' <= c && c <= 'f') ? c - 'a' + 10 : ('A' <= c && c <= 'F') ? c - 'A' + 10 : -1;
+  }
+
+  constexpr bool
+  StaticFormatParser::next(std::string_view &fmt, std::string_view &literal, std::string_view &specifier)
+  {
+    auto off = fmt.find_first_of("{}");
+    if (off == std::string_view::npos) {
+      literal = fmt;
+      fmt.remove_prefix(fmt.size());
+      return false;
+    }
+
+    if (fmt.size() <= off + 1) {
+      throw std::invalid_argument("Invalid trailing character in format string.");
+    }
+    if (fmt[off] == fmt[off + 1]) {
+      // double braces count as literals, but must tweak to output only 1 brace.
+      literal = fmt.substr(0, off + 1);
+      fmt.remove_prefix(off + 2);
+      return false;
+    }
+    if ('}' == fmt[off]) {
+      throw std::invalid_argument("Unopened } in format string.");
+    }
+    literal = fmt.substr(0, off);
+    fmt.remove_prefix(off + 1);
+
+    off = fmt.find('}');
+    if (off == std::string_view::npos) {
+      throw std::invalid_argument("BWFormat: Unclosed { in format string");
+    }
+    specifier = fmt.substr(0, off);
+    fmt.remove_prefix(off + 1);
+    return true;
+  }
+
+  constexpr Spec
+  StaticFormatParser::spec(std::string_view text)
+  {
+    Spec zret;
+    auto off   = text.find(':');
+    zret._name = text.substr(0, off);
+    text.remove_prefix(off == std::string_view::npos ? text.size() : off + 1);
+    // if it's parsable as a number, treat it as an index.
+    std::string_view num = zret._name;
+    auto n               = number(num);
+    if (num.empty() && !zret._name.empty()) {
+      zret._idx = static_cast<int>(n);
+    }
+
+    off            = text.find(':');
+    auto sz        = text.substr(0, off);
+    zret._ext      = off == std::string_view::npos ? std::string_view{} : text.substr(off + 1);
+    if (sz.empty()) {
+      return zret;
+    }
+
+    // fill and alignment
+    if ('%' == sz[0]) {
+      if (sz.size() < 4) {
+        throw std::invalid_argument("Fill URI encoding without 2 hex characters and align mark");
+      }
+      if (Spec::Align::NONE == (zret._align = align_of(sz[3]))) {
+        throw std::invalid_argument("Fill URI without alignment mark");
+      }
+      if (hex_value(sz[1]) < 0 || hex_value(sz[2]) < 0) {
+        throw std::invalid_argument("URI encoding with non-hex characters");
+      }
+      zret._fill = static_cast<char>((hex_value(sz[1]) << 4) + hex_value(sz[2]));
+      sz.remove_prefix(4);
+    } else if (sz.size() > 1 && Spec::Align::NONE != (zret._align = align_of(sz[1]))) {
+      zret._fill = sz[0];
+      sz.remove_prefix(2);
+    } else if (Spec::Align::NONE != (zret._align = align_of(sz[0]))) {
+      sz.remove_prefix(1);
+    }
+    // sign
+    if (sz.size() && is_sign(sz[0])) {
+      zret._sign = sz[0];
+      sz.remove_prefix(1);
+    }
+    // radix prefix
+    if (sz.size() && '#' == sz[0]) {
+      zret._radix_lead_p = true;
+      sz.remove_prefix(1);
+    }
+    // 0 fill for integers
+    if (sz.size() && '0' == sz[0]) {
+      if (Spec::Align::NONE == zret._align) {
+        zret._align = Spec::Align::SIGN;
+      }
+      zret._fill = '0';
+      sz.remove_prefix(1);
+    }
+    num = sz;
+    n   = number(num);
+    if (num.size() < sz.size()) {
+      zret._min = n;
+      sz        = num;
+    }
+    // precision
+    if (sz.size() && '.' == sz[0]) {
+      sz.remove_prefix(1);
+      num = sz;
+      n   = number(num);
+      if (num.size() == sz.size()) {
+        throw std::invalid_argument("Precision mark without precision");
+      }
+      zret._prec = static_cast<int>(n);
+      sz         = num;
+    }
+    // style (type). Hex, octal, etc.
+    if (sz.size() && is_type(sz[0])) {
+      zret._type = sz[0];
+      sz.remove_prefix(1);
+    }
+    // maximum width
+    if (sz.size() && ',' == sz[0]) {
+      sz.remove_prefix(1);
+      num = sz;
+      n   = number(num);
+      if (num.size() == sz.size()) {
+        throw std::invalid_argument("Maximum width mark without width");
+      }
+      zret._max = n;
+      sz        = num;
+      // Can only have a type indicator here if there was a max width.
+      if (sz.size() && is_type(sz[0])) {
+        zret._type = sz[0];
+        sz.remove_prefix(1);
+      }
+    }
+    // In contrast to run time parsing, trailing junk is an error.
+    if (sz.size()) {
+      throw std::invalid_argument("Invalid characters in format specifier");
+    }
+    return zret;
+  }
+
+  constexpr size_t
+  StaticFormatParser::count(std::string_view fmt)
+  {
+    size_t zret = 0;
+    while (fmt.size()) {
+      std::string_view literal, specifier;
+      bool spec_p = next(fmt, literal, specifier);
+      zret += (literal.size() ? 1 : 0) + (spec_p ? 1 : 0);
+    }
+    return zret;
+  }
+
+  template <size_t N>
+  constexpr std::array<Spec, N>
+  StaticFormatParser::items(std::string_view fmt)
+  {
+    std::array<Spec, N> zret{};
+    size_t idx  = 0;
+    int arg_idx = 0;
+    while (fmt.size()) {
+      std::string_view literal, specifier;
+      bool spec_p = next(fmt, literal, specifier);
+      if (literal.size()) {
+        zret[idx]._type  = Spec::LITERAL_TYPE;
+        zret[idx++]._ext = literal;
+      }
+      if (spec_p) {
+        zret[idx] = spec(specifier);
+        if (zret[idx]._name.size() == 0) { // no name provided, use implicit index.
+          zret[idx]._idx = arg_idx++;
+        }
+        ++idx;
+      }
+    }
+    return zret;
+  }
+
+  template <size_t N>
+  constexpr size_t
+  StaticFormatParser::arg_count(std::array<Spec, N> const &items)
+  {
+    size_t zret = 0;
+    for (auto const &item : items) {
+      if (item._type != Spec::LITERAL_TYPE && item._idx >= 0 && size_t(item._idx) >= zret) {
+        zret = item._idx + 1;
+      }
+    }
+    return zret;
+  }
+
   /// --- Names / Generators ---
 
   inline BufferWriter &
@@ -567,6 +1122,88 @@ namespace bwf
     return *this;
   }
 
+  template <typename F>
+  auto
+  NameMap<F>::find(std::string_view name) const -> Generator const *
+  {
+    auto spot = _map.find(name);
+    return spot == _map.end() ? nullptr : &spot->second;
+  }
+
+  template <typename F> BoundFormat<F>::BoundFormat(TextView fmt, NameMap<F> const &names) : super_type(fmt)
+  {
+    _generators.reserve(_items.size());
+    for (auto const &item : _items) {
+      bool named_p = item._type != Spec::LITERAL_TYPE && item._idx < 0 && !item._name.empty();
+      _generators.push_back(named_p ? names.find(item._name) : nullptr);
+    }
+  }
+
+  template <typename F> BoundFormat<F>::Extractor::operator bool() const
+  {
+    return _idx < static_cast<int>(_fmt._items.size());
+  }
+
+  template <typename F>
+  bool
+  BoundFormat<F>::Extractor::operator()(std::string_view &literal_v, BoundSpec &spec)
+  {
+    auto const &items = _fmt._items;
+    literal_v         = {};
+    if (_idx < int(items.size()) && items[_idx]._type == Spec::LITERAL_TYPE) {
+      literal_v = items[_idx++]._ext;
+    }
+    if (_idx < int(items.size()) && items[_idx]._type != Spec::LITERAL_TYPE) {
+      static_cast<Spec &>(spec) = items[_idx];
+      spec._generator           = _fmt._generators[_idx];
+      ++_idx;
+      return true;
+    }
+    return false;
+  }
+
+  template <typename F>
+  auto
+  BoundFormat<F>::bind() const -> Extractor
+  {
+    return {*this};
+  }
+
+  template <typename F>
+  template <typename... Context>
+  BoundFormat<F>::Binding<Context...>::Binding(Context &... ctx) : _ctx(ctx...)
+  {
+  }
+
+  template <typename F>
+  template <typename... Context>
+  BufferWriter &
+  BoundFormat<F>::Binding<Context...>::operator()(BufferWriter &w, BoundSpec const &spec) const
+  {
+    if (spec._generator) {
+      std::apply([&](Context &... ctx) -> void { (*spec._generator)(w, spec, ctx...); }, _ctx);
+    } else {
+      NameBinding::err_invalid_name(w, spec);
+    }
+    return w;
+  }
+
+  template <typename F>
+  template <typename... Context>
+  BufferWriter &
+  BoundFormat<F>::Binding<Context...>::operator()(BufferWriter &w, Spec const &spec) const
+  {
+    return NameBinding::err_invalid_name(w, spec);
+  }
+
+  template <typename F>
+  template <typename... Context>
+  auto
+  BoundFormat<F>::bind_names(Context &... ctx) const -> Binding<Context...>
+  {
+    return Binding<Context...>(ctx...);
+  }
+
   inline BufferWriter &
   ExternalNames::operator()(BufferWriter &w, const Spec &spec) const
   {
@@ -643,6 +1280,24 @@ namespace bwf
   /// as needed without moving data in the output buffer.
   void Adjust_Alignment(BufferWriter &aux, Spec const &spec);
 
+  /** Generate the output for a single specifier.
+   *
+   * @param w Output buffer.
+   * @param spec Format specifier.
+   * @param f Functor of the form <tt>void (BufferWriter &)</tt> which generates the output.
+   *
+   * @a f is invoked on a local buffer in the auxiliary space of @a w, limited to the maximum width
+   * in @a spec. The output is then aligned and committed to @a w. If the commit in @a w requests a
+   * retry, @a f is invoked again.
+   */
+  template <typename F> void Format_Spec(BufferWriter &w, Spec const &spec, F &&f);
+
+  /// Check if a value of type @a T can be formatted.
+  template <typename T, typename = void> struct is_formattable : public std::false_type {};
+  template <typename T>
+  struct is_formattable<T, std::void_t<decltype(bwformat(std::declval<BufferWriter &>(), std::declval<Spec const &>(),
+                                                         std::declval<T const &>()))>> : public std::true_type {};
+
   /** Format @a n as an integral value.
    *
    * @param w Output buffer.
@@ -834,6 +1489,64 @@ namespace bwf
     return {Tuple_Nth(_tuple, idx)};
   }
 
+  template <typename F>
+  void
+  Format_Spec(BufferWriter &w, Spec const &spec, F &&f)
+  {
+    while (true) {
+      size_t width = w.remaining();
+      if (spec._max < width) {
+        width = spec._max;
+      }
+
+      FixedBufferWriter lw{w.aux_data(), width};
+      f(lw);
+      if (lw.extent()) {
+        bwf::Adjust_Alignment(lw, spec);
+        if (!w.commit(lw.extent())) {
+          continue;
+        }
+      }
+      break;
+    }
+  }
+
+  template <typename S>
+  template <size_t I, typename TUPLE>
+  void
+  StaticFormat<S>::item(BufferWriter &w, TUPLE const &args)
+  {
+    if constexpr (ITEMS[I]._type == Spec::LITERAL_TYPE) {
+      w.write(ITEMS[I]._ext);
+    } else if constexpr (ITEMS[I]._idx >= 0) {
+      constexpr size_t IDX = ITEMS[I]._idx;
+      static_assert(is_formattable<std::tuple_element_t<IDX, TUPLE>>::value, "No bwformat overload for format argument.");
+      Format_Spec(w, ITEMS[I], [&](BufferWriter &lw) { bwformat(lw, ITEMS[I], std::get<IDX>(args)); });
+    } else {
+      Format_Spec(w, ITEMS[I], [](BufferWriter &lw) { Global_Names.bind()(lw, ITEMS[I]); });
+    }
+  }
+
+  template <typename S>
+  template <typename TUPLE, size_t... N>
+  void
+  StaticFormat<S>::items(BufferWriter &w, TUPLE const &args, std::index_sequence<N...>)
+  {
+    (item<N>(w, args), ...);
+  }
+
+  template <typename S>
+  template <typename... Args>
+  BufferWriter &
+  StaticFormat<S>::write(BufferWriter &w, std::tuple<Args...> const &args)
+  {
+    static_assert(N_ARGS == sizeof...(Args), "Number of arguments does not match the format string.");
+    if constexpr (N_ARGS == sizeof...(Args)) { // avoid a cascade of errors after the assert.
+      items(w, args, std::make_index_sequence<N_ITEMS>());
+    }
+    return w;
+  }
+
 }; // namespace bwf
 
 template <typename Binding, typename Extractor>
@@ -865,14 +1578,7 @@ BufferWriter::print_nfv(Binding &&names, Extractor &&ex, bwf::ArgPack const &arg
         spec._idx = arg_idx++;
       }
 
-      while (true) {
-        size_t width = this->remaining();
-        if (spec._max < width) {
-          width = spec._max;
-        }
-
-        FixedBufferWriter lw{this->aux_data(), width};
-
+      bwf::Format_Spec(*this, spec, [&](BufferWriter &lw) {
         if (0 <= spec._idx) {
           if (spec._idx < N) {
             if (spec._type == bwf::Spec::CAPTURE_TYPE) {
@@ -886,14 +1592,7 @@ BufferWriter::print_nfv(Binding &&names, Extractor &&ex, bwf::ArgPack const &arg
         } else if (spec._name.size()) {
           names(lw, spec);
         }
-        if (lw.extent()) {
-          bwf::Adjust_Alignment(lw, spec);
-          if (!this->commit(lw.extent())) {
-            continue;
-          }
-        }
-        break;
-      }
+      });
     }
   }
   return *this;
@@ -927,6 +1626,48 @@ BufferWriter::print_v(const bwf::Format &fmt, const std::tuple<Args...> &args)
   return this->print_nfv(bwf::Global_Names.bind(), fmt.bind(), bwf::ArgTuple{args});
 }
 
+template <typename F, typename... Args>
+BufferWriter &
+BufferWriter::print(bwf::BoundFormat<F> const &fmt, Args &&... args)
+{
+  return this->print_nfv(fmt.bind_names(), fmt.bind(), bwf::ArgTuple{std::forward_as_tuple(args...)});
+}
+
+template <typename F, typename... Args>
+BufferWriter &
+BufferWriter::print_v(bwf::BoundFormat<F> const &fmt, std::tuple<Args...> const &args)
+{
+  return this->print_nfv(fmt.bind_names(), fmt.bind(), bwf::ArgTuple{args});
+}
+
+template <size_t N, typename... Args>
+BufferWriter &
+BufferWriter::print(bwf::LocalFormat<N> const &fmt, Args &&... args)
+{
+  return this->print_nfv(bwf::Global_Names.bind(), fmt.bind(), bwf::ArgTuple{std::forward_as_tuple(args...)});
+}
+
+template <size_t N, typename... Args>
+BufferWriter &
+BufferWriter::print_v(bwf::LocalFormat<N> const &fmt, std::tuple<Args...> const &args)
+{
+  return this->print_nfv(bwf::Global_Names.bind(), fmt.bind(), bwf::ArgTuple{args});
+}
+
+template <typename S, typename... Args>
+BufferWriter &
+BufferWriter::print(bwf::StaticFormat<S> const &fmt, Args &&... args)
+{
+  return this->print_v(fmt, std::forward_as_tuple(args...));
+}
+
+template <typename S, typename... Args>
+BufferWriter &
+BufferWriter::print_v(bwf::StaticFormat<S> const &, std::tuple<Args...> const &args)
+{
+  return bwf::StaticFormat<S>::write(*this, args);
+}
+
 template <typename Binding, typename Extractor>
 BufferWriter &
 BufferWriter::print_nfv(Binding const &names, Extractor &&f)
@@ -1037,7 +1778,7 @@ BufferWriter &
 bwformat(BufferWriter &w, bwf::Spec const &spec, TransformView<X, V> &&view)
 {
   while (view)
-    w.write(char(*(view++)));
+    w.put(char(*(view++)));
   return w;
 }
 
@@ -1081,7 +1822,7 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, I &&i) ->
   bool neg_p  = false;
   uintmax_t n = static_cast<uintmax_t>(i);
   if (i < 0) {
-    n     = static_cast<uintmax_t>(-i);
+    n     = 0 - static_cast<uintmax_t>(i); // well defined for the minimum value, unlike -i.
     neg_p = true;
   }
   return bwf::Format_Integer(w, spec, n, neg_p);
@@ -1090,7 +1831,7 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, I &&i) ->
 inline BufferWriter &
 bwformat(BufferWriter &w, bwf::Spec const &, char c)
 {
-  return w.write(c);
+  return w.put(c);
 }
 
 inline BufferWriter &
@@ -1159,6 +1900,30 @@ bwprint(std::string &s, TextView fmt, Args &&... args)
   return bwprint_v(s, fmt, std::forward_as_tuple(args...));
 }
 
+/** Generate formatted output to a @c std::string @a s using the compile time format @a fmt.
+ *
+ * @tparam S Format string source.
+ * @tparam Args Format argument types.
+ * @param s Output string.
+ * @param fmt Format.
+ * @param args Arguments for format string.
+ * @return @a s
+ *
+ * This is identical to the overload for a run time format string other than the format.
+ */
+template <typename S, typename... Args>
+std::string &
+bwprint(std::string &s, bwf::StaticFormat<S> const &fmt, Args &&... args)
+{
+  auto len = s.size(); // remember initial size
+  size_t n = FixedBufferWriter(s.data(), s.size()).print(fmt, args...).extent();
+  s.resize(n);   // always need to resize - if shorter, must clip pre-existing text.
+  if (n > len) { // dropped data, try again.
+    FixedBufferWriter(s.data(), s.size()).print(fmt, args...);
+  }
+  return s;
+}
+
 /// @cond COVARY
 template <typename... Args>
 auto
@@ -1188,6 +1953,48 @@ FixedBufferWriter::print_v(bwf::Format const &fmt, std::tuple<Args...> const &ar
   return static_cast<self_type &>(this->super_type::print_v(fmt, args));
 }
 
+template <size_t N, typename... Args>
+auto
+FixedBufferWriter::print(bwf::LocalFormat<N> const &fmt, Args &&... args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, std::forward_as_tuple(args...)));
+}
+
+template <size_t N, typename... Args>
+auto
+FixedBufferWriter::print_v(bwf::LocalFormat<N> const &fmt, std::tuple<Args...> const &args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, args));
+}
+
+template <typename F, typename... Args>
+auto
+FixedBufferWriter::print(bwf::BoundFormat<F> const &fmt, Args &&... args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, std::forward_as_tuple(args...)));
+}
+
+template <typename F, typename... Args>
+auto
+FixedBufferWriter::print_v(bwf::BoundFormat<F> const &fmt, std::tuple<Args...> const &args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, args));
+}
+
+template <typename S, typename... Args>
+auto
+FixedBufferWriter::print(bwf::StaticFormat<S> const &fmt, Args &&... args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, std::forward_as_tuple(args...)));
+}
+
+template <typename S, typename... Args>
+auto
+FixedBufferWriter::print_v(bwf::StaticFormat<S> const &fmt, std::tuple<Args...> const &args) -> self_type &
+{
+  return static_cast<self_type &>(this->super_type::print_v(fmt, args));
+}
+
 /// @endcond
 
 // Special case support for @c Scalar, because @c Scalar is a base utility for some other utilities
@@ -1273,3 +2080,23 @@ namespace bwf
 BufferWriter &bwformat(BufferWriter &w, bwf::Spec const &spec, bwf::HexDump const &hex);
 
 } // namespace swoc
+
+/** Create a @c swoc::bwf::StaticFormat from the string literal @a fmt.
+ *
+ * @code
+ *   w.print(SWOC_BWF_FORMAT("{} of {}"), n, count);
+ * @endcode
+ *
+ * The format string is parsed at compile time and any error in it is a compile error.
+ */
+#define SWOC_BWF_FORMAT(fmt)                                        \
+  ([] {                                                             \
+    struct swoc_bwf_format_text {                                   \
+      static constexpr std::string_view                             \
+      text()                                                        \
+      {                                                             \
+        return fmt;                                                 \
+      }                                                             \
+    };                                                              \
+    return ::swoc::bwf::StaticFormat<swoc_bwf_format_text>{};       \
+  }())
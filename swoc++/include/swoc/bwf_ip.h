@@ -38,4 +38,10 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, IPEndpoint const &addr) {
   return bwformat(w, spec, &addr.sa);
 }
 
+inline BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &spec, IPKey const &key) {
+  IPEndpoint ep;
+  return bwformat(w, spec, key.fill(&ep.sa));
+}
+
 } // namespace swoc
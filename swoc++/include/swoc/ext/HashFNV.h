@@ -20,11 +20,15 @@
   http://www.isthe.com/chongo/tech/comp/fnv/
 
   Currently implemented FNV-1a 32bit and FNV-1a 64bit
+
+  Also a word at a time 64 bit hash based on wyhash, https://github.com/wangyi-fudan/wyhash
  */
 
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <random>
 #include "swoc/TextView.h"
 
 namespace swoc
@@ -85,6 +89,79 @@ private:
   value_type hval{INIT};
 };
 
+/** Word at a time 64 bit hash.
+ *
+ * @tparam FOLD_P Fold case - if @c true hashing is case insensitive, matching @c toupper in the C locale.
+ *
+ * This uses the wyhash mixing function on 16 bytes at a time, which is much faster than FNV-1a for
+ * all but very short data. The hash is seeded, by default with a random value per process, which
+ * makes it difficult to construct inputs with colliding hashes. Data can be added in pieces, the
+ * result is the same as for a single @c update with all of the data.
+ *
+ * @see Hash64Wy
+ * @see Hash64WyNoCase
+ */
+template <bool FOLD_P> struct Hash64WyT {
+protected:
+  using self_type = Hash64WyT;
+
+public:
+  using value_type = uint64_t;
+
+  /// Construct using the process seed.
+  Hash64WyT();
+
+  /// Construct using @a seed.
+  explicit Hash64WyT(uint64_t seed);
+
+  self_type &update(std::string_view const &data);
+
+  self_type & final();
+
+  value_type get() const;
+
+  self_type &clear();
+
+  template <typename X, typename V> self_type &update(TransformView<X, V> view);
+
+  template <typename X, typename V> value_type hash_immediate(TransformView<X, V> const &view);
+
+  value_type hash_immediate(std::string_view const &data);
+
+  /// @return The random seed for this process, which is used by the default constructor.
+  static uint64_t process_seed();
+
+protected:
+  static constexpr uint64_t S0  = 0xa0761d6478bd642full;
+  static constexpr uint64_t S1  = 0xe7037ed1a0b428dbull;
+  static constexpr size_t BLOCK = 16; ///< Bytes per mix.
+
+  /// Multiply and fold the 128 bit product.
+  static uint64_t mum(uint64_t a, uint64_t b);
+  /// Fold case of the bytes in @a w, if @a FOLD_P.
+  static uint64_t fold(uint64_t w);
+  /// Load 8 bytes from @a src.
+  static uint64_t load8(char const *src);
+  /// Load 4 bytes from @a src.
+  static uint64_t load4(char const *src);
+  /// Mix a block.
+  void mix(char const *src);
+  /// Compute the final value from the last @a n bytes, at @a src, which is less than a block.
+  void finish(char const *src, size_t n);
+
+  uint64_t _seed;     ///< Seed.
+  uint64_t _acc;      ///< Accumulated block hash.
+  uint64_t _size{0};  ///< Total bytes hashed.
+  size_t _n{0};       ///< Bytes in @a _buff.
+  char _buff[BLOCK];  ///< Bytes not yet mixed.
+  value_type hval{0}; ///< Final hash value.
+};
+
+/// Word at a time 64 bit hash.
+using Hash64Wy = Hash64WyT<false>;
+/// Case insensitive word at a time 64 bit hash.
+using Hash64WyNoCase = Hash64WyT<true>;
+
 // ----------
 // Implementation
 
@@ -190,4 +267,192 @@ Hash64FNV1a::hash_immediate(std::string_view const &data) -> value_type
   return this->update(data).final().get();
 }
 
+// -- Wy --
+
+template <bool FOLD_P> Hash64WyT<FOLD_P>::Hash64WyT() : self_type(process_seed()) {}
+
+template <bool FOLD_P> Hash64WyT<FOLD_P>::Hash64WyT(uint64_t seed) : _seed(seed)
+{
+  this->clear();
+}
+
+template <bool FOLD_P>
+uint64_t
+Hash64WyT<FOLD_P>::process_seed()
+{
+  static const uint64_t seed = [] {
+    std::random_device rd;
+    return (uint64_t(rd()) << 32) ^ rd();
+  }();
+  return seed;
+}
+
+template <bool FOLD_P>
+uint64_t
+Hash64WyT<FOLD_P>::mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+  auto r = static_cast<unsigned __int128>(a) * b;
+  return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32), c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+  return lo ^ hi;
+#endif
+}
+
+template <bool FOLD_P>
+uint64_t
+Hash64WyT<FOLD_P>::fold(uint64_t w)
+{
+  if constexpr (FOLD_P) {
+    // Upper case all bytes at once - find the bytes in 'a'..'z' and clear bit 5 of those.
+    static constexpr uint64_t ONES = 0x0101010101010101ull;
+    uint64_t low7                  = w & (ONES * 0x7F);
+    uint64_t ge_a                  = low7 + ONES * (0x80 - 'a');
+    uint64_t gt_z                  = low7 + ONES * (0x7F - 'z');
+    w ^= ((ge_a ^ gt_z) & ~w & (ONES * 0x80)) >> 2;
+  }
+  return w;
+}
+
+template <bool FOLD_P>
+uint64_t
+Hash64WyT<FOLD_P>::load8(char const *src)
+{
+  uint64_t w;
+  memcpy(&w, src, sizeof(w));
+  return fold(w);
+}
+
+template <bool FOLD_P>
+uint64_t
+Hash64WyT<FOLD_P>::load4(char const *src)
+{
+  uint32_t w;
+  memcpy(&w, src, sizeof(w));
+  return fold(w);
+}
+
+template <bool FOLD_P>
+void
+Hash64WyT<FOLD_P>::mix(char const *src)
+{
+  _acc = mum(load8(src) ^ S1, load8(src + 8) ^ _acc);
+}
+
+template <bool FOLD_P>
+void
+Hash64WyT<FOLD_P>::finish(char const *src, size_t n)
+{
+  // Overlapping loads for the tail, which is unambiguous because the size is mixed in.
+  uint64_t a = 0, b = 0;
+  if (n >= 8) {
+    a = load8(src);
+    b = load8(src + n - 8);
+  } else if (n >= 4) {
+    a = (load4(src) << 32) | load4(src + n - 4);
+  } else if (n > 0) {
+    a = fold((uint64_t(uint8_t(src[0])) << 16) | (uint64_t(uint8_t(src[n >> 1])) << 8) | uint8_t(src[n - 1]));
+  }
+  hval = mum(S1 ^ _size, mum(a ^ S1, b ^ _acc));
+}
+
+template <bool FOLD_P>
+auto
+Hash64WyT<FOLD_P>::clear() -> self_type &
+{
+  _acc  = _seed ^ mum(_seed ^ S0, S1);
+  _size = 0;
+  _n    = 0;
+  hval  = 0;
+  return *this;
+}
+
+template <bool FOLD_P>
+auto
+Hash64WyT<FOLD_P>::update(std::string_view const &data) -> self_type &
+{
+  auto src = data.data();
+  auto n   = data.size();
+  _size += n;
+  if (_n) { // Fill the partial block first.
+    auto k = std::min(BLOCK - _n, n);
+    memcpy(_buff + _n, src, k);
+    _n += k;
+    src += k;
+    n -= k;
+    if (_n < BLOCK) {
+      return *this;
+    }
+    this->mix(_buff);
+    _n = 0;
+  }
+  for (; n >= BLOCK; n -= BLOCK, src += BLOCK) {
+    this->mix(src);
+  }
+  memcpy(_buff, src, n);
+  _n = n;
+  return *this;
+}
+
+template <bool FOLD_P>
+template <typename X, typename V>
+auto
+Hash64WyT<FOLD_P>::update(TransformView<X, V> view) -> self_type &
+{
+  for (; view; ++view) {
+    char c = static_cast<char>(*view);
+    this->update(std::string_view{&c, 1});
+  }
+  return *this;
+}
+
+template <bool FOLD_P>
+auto
+Hash64WyT<FOLD_P>::final() -> self_type &
+{
+  this->finish(_buff, _n);
+  return *this;
+}
+
+template <bool FOLD_P>
+auto
+Hash64WyT<FOLD_P>::get() const -> value_type
+{
+  return hval;
+}
+
+template <bool FOLD_P>
+template <typename X, typename V>
+auto
+Hash64WyT<FOLD_P>::hash_immediate(TransformView<X, V> const &view) -> value_type
+{
+  return this->update(view).final().get();
+}
+
+template <bool FOLD_P>
+auto
+Hash64WyT<FOLD_P>::hash_immediate(std::string_view const &data) -> value_type
+{
+  if (_size > 0) {
+    return this->update(data).final().get();
+  }
+  // Nothing buffered, the data can be used in place.
+  auto src = data.data();
+  auto n   = data.size();
+  _size    = n;
+  for (; n >= BLOCK; n -= BLOCK, src += BLOCK) {
+    this->mix(src);
+  }
+  memcpy(_buff, src, n); // Same state as @c update.
+  _n = n;
+  this->finish(src, n);
+  return hval;
+}
+
 } // namespace swoc
@@ -20,16 +20,27 @@
 
 #pragma once
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <utility>
 
+#include "swoc/IntrusiveDList.h"
 #include "swoc/TextView.h"
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#endif
+
 namespace swoc
 {
+class MemArena;
+
 namespace file
 {
   /** Utility class for file system paths.
@@ -160,6 +171,312 @@ namespace file
    */
   std::string load(const path &p, std::error_code &ec);
 
+  /** The contents of a file mapped in to memory.
+   *
+   * This owns a read only mapping of a file, which is released when the instance is destroyed.
+   * The contents are available as a @c TextView and can be parsed in place without a copy.
+   *
+   * @see load_mapped
+   */
+  class mapped_file {
+    using self_type = mapped_file;
+
+  public:
+    /// Construct an empty instance.
+    mapped_file() = default;
+    mapped_file(self_type const &) = delete;
+    mapped_file(self_type &&that) noexcept;
+    ~mapped_file();
+
+    self_type &operator=(self_type const &) = delete;
+    self_type &operator=(self_type &&that) noexcept;
+
+    /// @return A view of the file contents.
+    swoc::TextView view() const;
+
+    /// @return A view of the file contents.
+    operator swoc::TextView() const;
+
+    /// @return A pointer to the first byte of the contents.
+    char const *data() const;
+
+    /// @return The size of the contents in bytes.
+    size_t size() const;
+
+    /// @return @c true if there are no contents, @c false otherwise.
+    bool empty() const;
+
+    /** Advise the kernel of the expected access pattern.
+     *
+     * @param advice A @c madvise value, such as @c MADV_SEQUENTIAL or @c MADV_DONTNEED.
+     * @return An error code, which is zero on success.
+     */
+    std::error_code advise(int advice) const;
+
+    /// Release the mapping.
+    self_type &clear();
+
+  protected:
+    char const *_data = nullptr; ///< Start of the mapping.
+    size_t _size      = 0;       ///< Size of the mapping.
+
+    friend mapped_file load_mapped(const path &p, std::error_code &ec, int advice);
+  };
+
+  /** Map the file at @a p in to memory, read only.
+   *
+   * @param p Path to file.
+   * @param ec Error code result of the file operation.
+   * @param advice Initial @c madvise value for the mapping.
+   * @return The contents of the file.
+   *
+   * The default advice is @c MADV_SEQUENTIAL, for a single pass parse from start to end. An empty
+   * file yields an empty instance without error. The file can be of any size, there is no copy
+   * and no memory is allocated for the contents. This should be used only for files that are not
+   * changed while mapped, as changes will be visible in the contents and truncation of the file
+   * will cause a fault on access.
+   */
+  mapped_file load_mapped(const path &p, std::error_code &ec, int advice = MADV_SEQUENTIAL);
+
+  /** Read a file as a sequence of lines, in bounded memory.
+   *
+   * The file is read in chunks in to a buffer that is reused, and each line is returned as a view
+   * in to that buffer. A line that is not complete at the end of the buffer is moved to the start
+   * before the next chunk is read, so that lines never straddle a refill. The buffer grows only if
+   * a single line is larger than the buffer.
+   *
+   * @code
+   *   swoc::file::line_reader reader;
+   *   if (auto ec = reader.open(path); !ec) {
+   *     swoc::TextView line;
+   *     while (reader.next(line)) {
+   *       // process line
+   *     }
+   *   }
+   * @endcode
+   */
+  class line_reader {
+    using self_type = line_reader;
+
+  public:
+    /// Default size of the read buffer.
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+    /** Constructor.
+     *
+     * @param chunk_size Initial size of the read buffer.
+     */
+    explicit line_reader(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+    line_reader(self_type const &) = delete;
+    self_type &operator=(self_type const &) = delete;
+    ~line_reader();
+
+    /** Open the file at @a p for reading.
+     *
+     * @param p Path to the file.
+     * @return An error code, which is zero on success.
+     *
+     * Any currently open file is closed.
+     */
+    std::error_code open(path const &p);
+
+    /// Close the file.
+    self_type &close();
+
+    /** Get the next line.
+     *
+     * @param line [out] The line, without the delimiter.
+     * @param delimiter Line delimiter.
+     * @return @c true if a line was found, @c false at the end of the file or on an error.
+     *
+     * @a line is valid only until the next call to @c next or @c close. The last line of the file
+     * need not be terminated by @a delimiter.
+     */
+    bool next(swoc::TextView &line, char delimiter = '\n');
+
+    /// @return The error from the last read, if any.
+    std::error_code error() const;
+
+    /// @return The current size of the read buffer.
+    size_t capacity() const;
+
+  protected:
+    int _fd = -1;                  ///< File descriptor.
+    std::unique_ptr<char[]> _buff; ///< Read buffer.
+    size_t _capacity = 0;          ///< Size of @a _buff.
+    swoc::TextView _avail;         ///< Data in @a _buff not yet returned.
+    off_t _offset  = 0;            ///< File offset of the next read.
+    bool _eof_p    = false;        ///< No more data can be read.
+    std::error_code _ec;           ///< Read error.
+
+    /// Read the next chunk, keeping the data in @a _avail.
+    void fill();
+  };
+
+  /** Load files without blocking, in batches.
+   *
+   * Loads are queued with @c load and started with @c submit. On Linux this uses @c io_uring -
+   * every queued file is opened in one submission, then sized from its descriptor and read and
+   * closed in a second, so loading a batch of files is a few system calls regardless of the number
+   * of files. Reads continue until the file is read to its size when opened, or to its end if it
+   * shrank. The contents are allocated in a @c MemArena supplied by the caller. Completion
+   * callbacks are invoked only from @c poll or @c wait, in the calling thread.
+   *
+   * The benefit is that the caller does not block on the file system. For files that are already
+   * cached this is not faster than loading them directly, the operations done by the kernel are
+   * the same.
+   *
+   * The ring file descriptor is readable when there are completions, so it can be added to an event
+   * loop, which then calls @c poll. If @c io_uring is not available the files are loaded
+   * synchronously in @c poll or @c wait.
+   *
+   * @code
+   *   swoc::file::async_loader loader{arena};
+   *   for (auto const &p : fragments) {
+   *     loader.load(p, [&](swoc::file::path const &p, swoc::TextView content, std::error_code ec) { ... });
+   *   }
+   *   loader.wait();
+   * @endcode
+   *
+   * With C++20 a coroutine can instead use <tt>co_await loader.async_load(p)</tt>, which is resumed
+   * from @c poll or @c wait.
+   */
+  class async_loader {
+    using self_type = async_loader;
+
+  public:
+    /// Completion callback, with the path, the contents, and the error if any.
+    using callback_type = std::function<void(path const &p, swoc::TextView content, std::error_code ec)>;
+
+    /// Default maximum number of operations in flight.
+    static constexpr unsigned DEFAULT_DEPTH = 64;
+
+    /** Constructor.
+     *
+     * @param arena Arena for file contents.
+     * @param depth Maximum number of operations in flight, two for each file being loaded.
+     *
+     * If @a depth is zero files are loaded synchronously.
+     */
+    explicit async_loader(MemArena &arena, unsigned depth = DEFAULT_DEPTH);
+    async_loader(self_type const &) = delete;
+    self_type &operator=(self_type const &) = delete;
+
+    /// Wait for all loads in progress, and discard queued loads.
+    ~async_loader();
+
+    /** Queue the file at @a p to be loaded.
+     *
+     * @param p Path to file.
+     * @param cb Completion callback.
+     * @return @a this
+     */
+    self_type &load(path p, callback_type &&cb);
+
+    /** Start queued loads.
+     *
+     * @return The number of loads not yet complete.
+     */
+    size_t submit();
+
+    /** Process completed operations without blocking.
+     *
+     * @return The number of loads not yet complete.
+     *
+     * Callbacks for completed loads are invoked, and queued loads are started.
+     */
+    size_t poll();
+
+    /// Process loads until all are complete.
+    self_type &wait();
+
+    /// @return A file descriptor that is readable when @c poll has work, or -1 if there is none.
+    int fd() const;
+
+    /// @return @c true if @c io_uring is used.
+    bool is_async() const;
+
+    /// @return The number of @c io_uring_enter calls made, for tuning.
+    size_t enter_count() const;
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+    /// Result of awaiting a load.
+    struct load_result {
+      swoc::TextView content; ///< File contents.
+      std::error_code ec;     ///< Error, if any.
+    };
+
+    /// Awaitable for a load.
+    class awaiter {
+    public:
+      awaiter(async_loader &loader, path p) : _loader(loader), _path(std::move(p)) {}
+
+      bool
+      await_ready() const noexcept {
+        return false;
+      }
+
+      void
+      await_suspend(std::coroutine_handle<> h) {
+        _loader.load(std::move(_path), [this, h](path const &, swoc::TextView content, std::error_code ec) {
+          _result = {content, ec};
+          h.resume();
+        });
+      }
+
+      load_result
+      await_resume() const {
+        return _result;
+      }
+
+    protected:
+      async_loader &_loader; ///< Loader.
+      path _path;            ///< Path to load.
+      load_result _result;   ///< Result.
+    };
+
+    /// @return An awaitable that loads the file at @a p.
+    awaiter
+    async_load(path p) {
+      return {*this, std::move(p)};
+    }
+#endif
+
+  protected:
+    struct Request;
+    struct Ring;
+    /// Links for lists of requests.
+    struct Linkage {
+      static Request *&next_ptr(Request *req);
+      static Request *&prev_ptr(Request *req);
+    };
+    using List = IntrusiveDList<Linkage>;
+
+    MemArena &_arena;            ///< Arena for contents.
+    unsigned _depth;             ///< Maximum operations in flight.
+    std::unique_ptr<Ring> _ring; ///< The @c io_uring, if used.
+    unsigned _in_flight = 0;     ///< Operations prepared and not yet completed.
+    size_t _n_enter     = 0;     ///< Number of @c io_uring_enter calls.
+    List _queued;                ///< Not yet started.
+    List _active;                ///< Started and not complete.
+    List _done;                  ///< Complete, callback not yet invoked.
+
+    /// Prepare operations for queued loads, as there is room.
+    void start();
+
+    /// Handle the completion of an operation.
+    void complete(uint64_t tag, int result);
+
+    /// Start the next operations for @a req, or finish it.
+    void advance(Request *req);
+
+    /// Invoke callbacks for completed loads.
+    void deliver();
+
+    /// Load @a req synchronously.
+    void load_sync(Request *req);
+  };
+
   /* ------------------------------------------------------------------- */
 
   inline path::path(char const *src) : _path(src) {}
@@ -204,6 +521,63 @@ namespace file
     return !this->is_absolute();
   }
 
+  inline mapped_file::mapped_file(self_type &&that) noexcept : _data(that._data), _size(that._size) {
+    that._data = nullptr;
+    that._size = 0;
+  }
+
+  inline mapped_file::~mapped_file() {
+    this->clear();
+  }
+
+  inline mapped_file &
+  mapped_file::operator=(self_type &&that) noexcept {
+    if (this != &that) {
+      this->clear();
+      std::swap(_data, that._data);
+      std::swap(_size, that._size);
+    }
+    return *this;
+  }
+
+  inline swoc::TextView
+  mapped_file::view() const {
+    return {_data, _size};
+  }
+
+  inline mapped_file::operator swoc::TextView() const {
+    return this->view();
+  }
+
+  inline char const *
+  mapped_file::data() const {
+    return _data;
+  }
+
+  inline size_t
+  mapped_file::size() const {
+    return _size;
+  }
+
+  inline bool
+  mapped_file::empty() const {
+    return _size == 0;
+  }
+
+  inline line_reader::~line_reader() {
+    this->close();
+  }
+
+  inline std::error_code
+  line_reader::error() const {
+    return _ec;
+  }
+
+  inline size_t
+  line_reader::capacity() const {
+    return _capacity;
+  }
+
   inline path &
   path::operator/=(const self_type &that) {
     return *this /= std::string_view(that._path);
@@ -5,13 +5,24 @@
  */
 
 #include <netinet/in.h>
+#include <algorithm>
+#include <cstring>
+#include <queue>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 #include <swoc/DiscreteRange.h>
 #include <swoc/RBTree.h>
 #include "bwf_base.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace swoc
 {
 class IP4Addr;
@@ -318,6 +329,25 @@ protected:
   static constexpr std::array<unsigned, N_QUADS> QUAD_IDX = { 3,2,1,0,7,6,5,4 };
 
   IP6Addr(uint64_t msw, uint64_t lsw) : _addr{msw, lsw} {}
+
+#if defined(__SIZEOF_INT128__)
+  /// Host order address as a single integer, so that arithmetic and compares are done in registers without branches.
+  using u128_type = unsigned __int128;
+
+  /// @return The address as a host order integer.
+  u128_type
+  as_u128() const {
+    return (static_cast<u128_type>(_addr._u64[0]) << 64) | _addr._u64[1];
+  }
+
+  /// Set the address from the host order integer @a n.
+  self_type &
+  assign(u128_type n) {
+    _addr._u64[0] = static_cast<uint64_t>(n >> 64);
+    _addr._u64[1] = static_cast<uint64_t>(n);
+    return *this;
+  }
+#endif
 };
 
 /** Storage for an IP address.
@@ -432,6 +462,80 @@ protected:
   sa_family_t _family{AF_UNSPEC}; ///< Protocol family.
 };
 
+/** A compact key for an IP endpoint or address, for hash tables.
+
+    The address is stored as 16 bytes in network order, with an IPv4 address stored as an IPv4
+    mapped IPv6 address. It is followed by the port in network order and the family. This is 20
+    bytes without padding, so keys are hashed and compared as raw memory. @c IPEndpoint is not
+    suitable for this because it is a @c sockaddr union with unused bytes and with fields, such as
+    the IPv6 flow information, that are not part of the identity of the endpoint. The family is part
+    of the key, so an IPv4 address is not equal to the mapped IPv6 address.
+
+    To use as the key of an @c IntrusiveHashMap, inherit the descriptor from @c HashDescriptor.
+    @code
+      struct Descriptor : public IPKey::HashDescriptor, public IntrusiveLinkage<Connection> {
+        static IPKey const &key_of(Connection *c) { return c->_key; }
+      };
+    @endcode
+ */
+class IPKey {
+  using self_type = IPKey; ///< Self reference type.
+public:
+  static constexpr size_t SIZE = 20; ///< Size of the key in bytes.
+
+  /// Hash and equality for use in an @c IntrusiveHashMap descriptor.
+  struct HashDescriptor {
+    static uint64_t hash_of(self_type const &key);
+    static bool equal(self_type const &lhs, self_type const &rhs);
+  };
+
+  IPKey() = default; ///< Default constructor - invalid key.
+
+  /// Construct from the address and port in @a sa.
+  explicit IPKey(sockaddr const *sa);
+  /// Construct from the address and port in @a ep.
+  explicit IPKey(IPEndpoint const &ep);
+  /// Construct from @a addr and @a port, which is in network order.
+  explicit IPKey(IPAddr const &addr, in_port_t port = 0);
+
+  /// Set to the address and port in @a sa.
+  /// If @a sa is not an IP address the key is invalid.
+  self_type &assign(sockaddr const *sa);
+
+  /// Write to @c sockaddr, which must be large enough for the family.
+  sockaddr *fill(sockaddr *sa) const;
+
+  /// @return The address family.
+  sa_family_t family() const;
+  /// Test for validity.
+  bool is_valid() const;
+  /// @return The address.
+  IPAddr addr() const;
+  /// @return The port in network order.
+  in_port_t port() const;
+  /// @return The port in host order.
+  in_port_t host_order_port() const;
+
+  /** Compute a hash of the key.
+   *
+   * @return The hash.
+   *
+   * This is a single wide multiply of the two halves of the key, folded in to 64 bits. It is fast
+   * and mixes well, but is not intended to resist deliberate collisions.
+   */
+  uint64_t hash() const;
+
+protected:
+  friend bool operator==(self_type const &, self_type const &);
+
+  /// @return The port and family as a single word.
+  uint32_t tail() const;
+
+  alignas(4) uint8_t _addr[16] = {0}; ///< Address, network order.
+  in_port_t _port{0};                 ///< Port, network order.
+  sa_family_t _family{AF_UNSPEC};     ///< Address family.
+};
+
 /** An IP address mask.
  *
  * This is essentially a width for a bit mask.
@@ -636,6 +740,14 @@ public:
   /// Construct an empty space.
   IPSpace() = default;
 
+  /** Construct an empty space with an external arena.
+   *
+   * @param arena The arena for nodes.
+   *
+   * @see DiscreteSpace::DiscreteSpace(MemArena &)
+   */
+  explicit IPSpace(MemArena &arena) : _ip4(arena), _ip6(arena) {}
+
   /** Mark the range @a r with @a payload.
    *
    * @param r Range to mark.
@@ -646,6 +758,56 @@ public:
    */
   self_type & mark(IP4Range const &r, PAYLOAD const &payload);
 
+  /** Load a batch of IPv4 ranges.
+   *
+   * @tparam I Random access iterator type.
+   * @param first First element of the batch.
+   * @param last Past the last element of the batch.
+   * @return @a this
+   *
+   * Each element must be a pair-like of an @c IP4Range and a payload.
+   *
+   * @see DiscreteSpace::load
+   */
+  template <typename I> self_type &load(I first, I last) {
+    _ip4.load(first, last);
+    return *this;
+  }
+
+  /** Load ranges from text, parsing in parallel.
+   *
+   * @tparam F Line parser, with the signature <tt>bool (TextView line, IPRange &range, PAYLOAD &payload)</tt>.
+   * @param text Ranges, one per line, e.g. the contents of a mapped file.
+   * @param parse The line parser.
+   * @param n_threads Number of threads to use, or 0 to use the hardware concurrency.
+   * @return @a this
+   *
+   * @a text is split at line boundaries in to a part per thread. Each thread parses its lines
+   * with @a parse, which should return @c true if it loaded @a range and @a payload from @a line, and
+   * @c false if the line should be skipped. The parsed ranges are sorted per thread, then merged in
+   * to a single sorted batch. The result is the same as marking the ranges in the order of @a text,
+   * so that where ranges overlap the one later in @a text has priority. Ranges that overlap no other
+   * range are loaded as by @c load, and the rest are marked in text order, so overlapping ranges are
+   * slower to load.
+   *
+   * @a parse is invoked concurrently and so must be thread safe. It should not throw.
+   */
+  template <typename F> self_type &parallel_load(TextView text, F &&parse, unsigned n_threads = 0);
+
+  /** Set this space to a combination of two spaces.
+   *
+   * @tparam F Payload combiner, with the signature
+   * <tt>bool (PAYLOAD &result, PAYLOAD const *lhs, PAYLOAD const *rhs)</tt>.
+   * @param lhs First space.
+   * @param rhs Second space.
+   * @param combiner Payload combiner.
+   * @param n_threads Maximum number of threads, 0 to use the hardware concurrency.
+   * @return @a this
+   *
+   * @see DiscreteSpace::merge
+   */
+  template <typename F> self_type &merge(self_type const &lhs, self_type const &rhs, F &&combiner, unsigned n_threads = 0);
+
   /** Fill the @a range with @a payload.
    *
    * @param range Destination range.
@@ -698,6 +860,22 @@ public:
     return _ip4.find(addr);
   }
 
+  /** Find the payloads for a batch of addresses.
+   *
+   * @param addrs Addresses to find.
+   * @param results Payload for each address, or @c nullptr if not found.
+   *
+   * The searches are interleaved so that memory latency is overlapped between them.
+   */
+  void find(MemSpan<IP4Addr const> addrs, MemSpan<PAYLOAD *> results) {
+    _ip4.find(addrs, results);
+  }
+
+  /// @copydoc find(MemSpan<IP4Addr const>, MemSpan<PAYLOAD *>)
+  void find(MemSpan<IP6Addr const> addrs, MemSpan<PAYLOAD *> results) {
+    _ip6.find(addrs, results);
+  }
+
   /// @return The number of distinct ranges.
   size_t count() const { return _ip4.count() + _ip6.count(); }
 
@@ -707,6 +885,88 @@ public:
   typename IP4Space::iterator begin() { return _ip4.begin(); }
   typename IP4Space::iterator end() { return _ip4.end(); }
 
+  /** A read only, compact copy of an @c IPSpace.
+   *
+   * This is faster for lookup and is intended for spaces that are built once and then used for
+   * many lookups.
+   *
+   * @see DiscreteSpace::freeze
+   */
+  class Frozen {
+  public:
+    /// Construct an empty space.
+    Frozen() = default;
+
+    /// Construct from the current contents of @a space.
+    explicit Frozen(IPSpace const &space) : _ip4(space._ip4), _ip6(space._ip6) {}
+
+    /// @return The payload for @a addr, or @c nullptr if not found.
+    PAYLOAD const *find(IP4Addr const &addr) const { return _ip4.find(addr); }
+
+    /// @return The payload for @a addr, or @c nullptr if not found.
+    PAYLOAD const *find(IP6Addr const &addr) const { return _ip6.find(addr); }
+
+    /// Find the payloads for a batch of @a addrs.
+    void find(MemSpan<IP4Addr const> addrs, MemSpan<PAYLOAD const *> results) const { _ip4.find(addrs, results); }
+
+    /// Find the payloads for a batch of @a addrs.
+    void find(MemSpan<IP6Addr const> addrs, MemSpan<PAYLOAD const *> results) const { _ip6.find(addrs, results); }
+
+    /// @return The number of distinct ranges.
+    size_t count() const { return _ip4.count() + _ip6.count(); }
+
+    /// @return The size in bytes of the image of this space.
+    size_t image_size() const { return _ip4.image_size() + _ip6.image_size(); }
+
+    /** Write the image of this space.
+     *
+     * @param dst Memory for the image.
+     * @return The part of @a dst that was used, which is empty if @a dst is smaller than @c image_size.
+     *
+     * The image is the IPv4 image followed by the IPv6 image.
+     *
+     * @see FrozenDiscreteSpace::write_image
+     */
+    MemSpan<char> write_image(MemSpan<char> dst) const {
+      auto ip4 = _ip4.write_image(dst);
+      if (ip4.empty()) {
+        return {};
+      }
+      auto ip6 = _ip6.write_image(dst.subspan(ip4.size(), dst.size() - ip4.size()));
+      return ip6.empty() ? ip6 : dst.prefix(ip4.size() + ip6.size());
+    }
+
+    /** Use the space in an image.
+     *
+     * @param image An image written by @c write_image.
+     * @return @c true if the image was valid and attached, @c false if not, in which case the space
+     * is unchanged.
+     *
+     * @see FrozenDiscreteSpace::attach
+     */
+    bool attach(MemSpan<char const> image) {
+      decltype(_ip4) ip4;
+      decltype(_ip6) ip6;
+      if (!ip4.attach(image)) {
+        return false;
+      }
+      auto n = ip4.image_size();
+      if (!ip6.attach(image.subspan(n, image.size() - n))) {
+        return false;
+      }
+      _ip4 = std::move(ip4);
+      _ip6 = std::move(ip6);
+      return true;
+    }
+
+  protected:
+    FrozenDiscreteSpace<IP4Addr, PAYLOAD> _ip4;
+    FrozenDiscreteSpace<IP6Addr, PAYLOAD> _ip6;
+  };
+
+  /// @return A read only, compact copy of this space.
+  Frozen freeze() const { return Frozen{*this}; }
+
 protected:
   IP4Space _ip4;
   IP6Space _ip6;
@@ -728,6 +988,10 @@ inline IPAddr::IPAddr(IPEndpoint const &addr) {
   this->assign(&addr.sa);
 }
 
+inline IPAddr::IPAddr(string_view text) {
+  this->load(text);
+}
+
 inline IPAddr &
 IPAddr::operator=(in_addr_t addr) {
   _family    = AF_INET;
@@ -1005,6 +1269,159 @@ IPEndpoint::host_order_port(sockaddr const *addr) {
   return ntohs(self_type::port(addr));
 }
 
+// --- IPKey ---
+
+inline IPKey::IPKey(sockaddr const *sa) {
+  this->assign(sa);
+}
+
+inline IPKey::IPKey(IPEndpoint const &ep) {
+  this->assign(&ep.sa);
+}
+
+inline IPKey::IPKey(IPAddr const &addr, in_port_t port) : _port(port), _family(addr.family()) {
+  if (addr.is_ip4()) {
+    in_addr_t a = addr.network_ip4();
+    _addr[10] = _addr[11] = 0xFF;
+    memcpy(_addr + 12, &a, sizeof(a));
+  } else if (addr.is_ip6()) {
+    in6_addr a = addr.network_ip6();
+    memcpy(_addr, &a, sizeof(a));
+  } else { // not an IP address, leave @a _addr clear.
+    _port   = 0;
+    _family = AF_UNSPEC;
+  }
+}
+
+inline IPKey &
+IPKey::assign(sockaddr const *sa) {
+  if (sa && AF_INET == sa->sa_family) {
+    auto sin = reinterpret_cast<sockaddr_in const *>(sa);
+    memset(_addr, 0, 10);
+    _addr[10] = _addr[11] = 0xFF;
+    memcpy(_addr + 12, &sin->sin_addr, sizeof(sin->sin_addr));
+    _port   = sin->sin_port;
+    _family = AF_INET;
+  } else if (sa && AF_INET6 == sa->sa_family) {
+    auto sin6 = reinterpret_cast<sockaddr_in6 const *>(sa);
+    memcpy(_addr, &sin6->sin6_addr, sizeof(sin6->sin6_addr));
+    _port   = sin6->sin6_port;
+    _family = AF_INET6;
+  } else {
+    memset(_addr, 0, sizeof(_addr));
+    _port   = 0;
+    _family = AF_UNSPEC;
+  }
+  return *this;
+}
+
+inline sockaddr *
+IPKey::fill(sockaddr *sa) const {
+  if (AF_INET == _family) {
+    auto sin = reinterpret_cast<sockaddr_in *>(sa);
+    memset(sin, 0, sizeof(*sin));
+    sin->sin_family = AF_INET;
+    sin->sin_port   = _port;
+    memcpy(&sin->sin_addr, _addr + 12, sizeof(sin->sin_addr));
+  } else if (AF_INET6 == _family) {
+    auto sin6 = reinterpret_cast<sockaddr_in6 *>(sa);
+    memset(sin6, 0, sizeof(*sin6));
+    sin6->sin6_family = AF_INET6;
+    sin6->sin6_port   = _port;
+    memcpy(&sin6->sin6_addr, _addr, sizeof(sin6->sin6_addr));
+  } else {
+    IPEndpoint::invalidate(sa);
+  }
+  return sa;
+}
+
+inline sa_family_t
+IPKey::family() const {
+  return _family;
+}
+
+inline bool
+IPKey::is_valid() const {
+  return _family == AF_INET || _family == AF_INET6;
+}
+
+inline IPAddr
+IPKey::addr() const {
+  if (AF_INET == _family) {
+    in_addr_t a;
+    memcpy(&a, _addr + 12, sizeof(a));
+    return IPAddr{a};
+  } else if (AF_INET6 == _family) {
+    in6_addr a;
+    memcpy(&a, _addr, sizeof(a));
+    return IPAddr{a};
+  }
+  return IPAddr{};
+}
+
+inline in_port_t
+IPKey::port() const {
+  return _port;
+}
+
+inline in_port_t
+IPKey::host_order_port() const {
+  return ntohs(_port);
+}
+
+inline uint32_t
+IPKey::tail() const {
+  uint32_t zret;
+  memcpy(&zret, reinterpret_cast<uint8_t const *>(this) + sizeof(_addr), sizeof(zret));
+  return zret;
+}
+
+inline uint64_t
+IPKey::hash() const {
+  static constexpr uint64_t K0 = 0x9E3779B97F4A7C15ULL;
+  static constexpr uint64_t K1 = 0xC2B2AE3D27D4EB4FULL;
+  uint64_t lo, hi;
+  memcpy(&lo, _addr, sizeof(lo));
+  memcpy(&hi, _addr + sizeof(lo), sizeof(hi));
+  // The port and family go with the upper half of the address, which is zero for IPv4, so that both
+  // operands of the multiply vary for IPv4 keys.
+  lo ^= this->tail() ^ K0;
+  hi ^= K1;
+#if defined(__SIZEOF_INT128__)
+  auto m = static_cast<unsigned __int128>(lo) * hi;
+  return static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64);
+#else
+  uint64_t x = (lo ^ ((hi << 32) | (hi >> 32))) * K0;
+  return x ^ (x >> 32);
+#endif
+}
+
+inline bool
+operator==(IPKey const &lhs, IPKey const &rhs) {
+#if defined(__SSE2__)
+  auto l = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs._addr));
+  auto r = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs._addr));
+  return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) && lhs.tail() == rhs.tail();
+#else
+  return 0 == memcmp(lhs._addr, rhs._addr, sizeof(lhs._addr)) && lhs.tail() == rhs.tail();
+#endif
+}
+
+inline bool
+operator!=(IPKey const &lhs, IPKey const &rhs) {
+  return !(lhs == rhs);
+}
+
+inline uint64_t
+IPKey::HashDescriptor::hash_of(self_type const &key) {
+  return key.hash();
+}
+
+inline bool
+IPKey::HashDescriptor::equal(self_type const &lhs, self_type const &rhs) {
+  return lhs == rhs;
+}
+
 // --- IPAddr variants ---
 
 inline constexpr IP4Addr::IP4Addr(in_addr_t addr) : _addr(reorder(addr)) {}
@@ -1119,38 +1536,56 @@ inline auto IP6Addr::operator = (sockaddr_in6 const* addr) -> self_type & {
 
 inline IP6Addr &
 IP6Addr::operator++() {
+#if defined(__SIZEOF_INT128__)
+  return this->assign(this->as_u128() + 1);
+#else
   if (++(_addr._u64[1]) == 0) {
     ++(_addr._u64[0]);
   }
   return *this;
+#endif
 }
 
 inline IP6Addr &
 IP6Addr::operator--() {
+#if defined(__SIZEOF_INT128__)
+  return this->assign(this->as_u128() - 1);
+#else
   if (--(_addr._u64[1]) == ~static_cast<uint64_t >(0)) {
     --(_addr._u64[0]);
   }
   return *this;
+#endif
 }
 
 inline void IP6Addr::reorder(unsigned char dst[WORD_SIZE], unsigned char const src[WORD_SIZE]) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t word;
+  memcpy(&word, src, WORD_SIZE);
+  word = __builtin_bswap64(word);
+  memcpy(dst, &word, WORD_SIZE);
+#else
   for ( size_t idx = 0 ; idx < WORD_SIZE ; ++idx ) {
     dst[idx] = src[WORD_SIZE - (idx + 1)];
   }
+#endif
 }
 
 inline bool operator == (IP6Addr const& lhs, IP6Addr const& rhs) {
-  return lhs._addr._u64[0] == rhs._addr._u64[0] &&
-         lhs._addr._u64[1] == rhs._addr._u64[1];
+  // Not short circuit, so there is a single branch.
+  return ((lhs._addr._u64[0] ^ rhs._addr._u64[0]) | (lhs._addr._u64[1] ^ rhs._addr._u64[1])) == 0;
 }
 
 inline bool operator != (IP6Addr const& lhs, IP6Addr const& rhs) {
-  return lhs._addr._u64[0] != rhs._addr._u64[0] ||
-         lhs._addr._u64[1] != rhs._addr._u64[1];
+  return !(lhs == rhs);
 }
 
 inline bool operator < (IP6Addr const& lhs, IP6Addr const& rhs) {
+#if defined(__SIZEOF_INT128__)
+  return lhs.as_u128() < rhs.as_u128();
+#else
   return lhs._addr._u64[0] < rhs._addr._u64[0] || (lhs._addr._u64[0] == rhs._addr._u64[0] && lhs._addr._u64[1] < rhs._addr._u64[1]);
+#endif
 }
 
 inline bool operator > (IP6Addr const& lhs, IP6Addr const& rhs) {
@@ -1158,7 +1593,11 @@ inline bool operator > (IP6Addr const& lhs, IP6Addr const& rhs) {
 }
 
 inline bool operator <= (IP6Addr const& lhs, IP6Addr const& rhs) {
+#if defined(__SIZEOF_INT128__)
+  return lhs.as_u128() <= rhs.as_u128();
+#else
   return lhs._addr._u64[0] < rhs._addr._u64[0] || (lhs._addr._u64[0] == rhs._addr._u64[0] && lhs._addr._u64[1] <= rhs._addr._u64[1]);
+#endif
 }
 
 inline bool operator >= (IP6Addr const& lhs, IP6Addr const& rhs) {
@@ -1220,6 +1659,156 @@ template < typename PAYLOAD > auto IPSpace<PAYLOAD>::mark(swoc::IP4Range const &
   return *this;
 }
 
+namespace detail {
+/** Merge sorted runs in to a single sorted sequence.
+ *
+ * @param runs The sorted runs.
+ * @param less Ordering of the elements.
+ * @return The merged elements.
+ *
+ * The merge is stable, equivalent elements are ordered by run and then by position in the run.
+ */
+template <typename T, typename L> std::vector<T> merge_runs(std::vector<std::vector<T>> &runs, L const &less) {
+  using Cursor = std::pair<size_t, size_t>; // run, position
+  size_t total = 0;
+  for (auto const &run : runs) {
+    total += run.size();
+  }
+  std::vector<T> zret;
+  zret.reserve(total);
+  // The heap is a max heap, so this ordering puts the least element, earliest run first, at the top.
+  auto later = [&](Cursor const &lhs, Cursor const &rhs) -> bool {
+    auto const &x = runs[lhs.first][lhs.second];
+    auto const &y = runs[rhs.first][rhs.second];
+    return less(y, x) || (!less(x, y) && lhs.first > rhs.first);
+  };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
+  for (size_t idx = 0; idx < runs.size(); ++idx) {
+    if (!runs[idx].empty()) {
+      heap.push({idx, 0});
+    }
+  }
+  while (!heap.empty()) {
+    auto [idx, pos] = heap.top();
+    heap.pop();
+    zret.push_back(std::move(runs[idx][pos]));
+    if (++pos < runs[idx].size()) {
+      heap.push({idx, pos});
+    }
+  }
+  return zret;
+}
+
+/** Load ranges in to a space with the same result as marking them in text order.
+ *
+ * @param space The destination space.
+ * @param items Ranges sorted by minimum, as tuples of the range, the payload and the text offset.
+ *
+ * Ranges that overlap no other range have the same result in any order, and are loaded as a
+ * batch. The remaining ranges are marked in order of their text offset, so that of overlapping
+ * ranges the one later in the text has priority on the overlap.
+ */
+template <typename S, typename T>
+void
+load_in_order(S &space, std::vector<T> &items) {
+  using range_type  = std::decay_t<decltype(std::get<0>(items[0]))>;
+  using metric_type = std::decay_t<decltype(std::get<0>(items[0]).max())>;
+  std::vector<T> disjoint;
+  std::vector<T> overlap;
+  disjoint.reserve(items.size());
+  metric_type reach; // Largest maximum of the earlier ranges.
+  for (size_t idx = 0; idx < items.size(); ++idx) {
+    range_type range = std::get<0>(items[idx]);
+    // Because the ranges are sorted by minimum, a later range overlaps only if the next one does.
+    bool overlap_p = (idx > 0 && !(reach < range.min())) || (idx + 1 < items.size() && !(range.max() < std::get<0>(items[idx + 1]).min()));
+    if (idx == 0 || reach < range.max()) {
+      reach = range.max();
+    }
+    (overlap_p ? overlap : disjoint).push_back(std::move(items[idx]));
+  }
+  items.clear();
+  space.load(disjoint.begin(), disjoint.end());
+  std::stable_sort(overlap.begin(), overlap.end(), [](T const &lhs, T const &rhs) { return std::get<2>(lhs) < std::get<2>(rhs); });
+  for (auto const &item : overlap) {
+    space.mark(std::get<0>(item), std::get<1>(item));
+  }
+}
+} // namespace detail
+
+template <typename PAYLOAD>
+template <typename F>
+auto IPSpace<PAYLOAD>::parallel_load(TextView text, F &&parse, unsigned n_threads) -> self_type & {
+  // The text offset of each range is kept to order overlapping ranges.
+  using IP4Item = std::tuple<IP4Range, PAYLOAD, size_t>;
+  using IP6Item = std::tuple<IP6Range, PAYLOAD, size_t>;
+  TextView const src{text};
+  auto by_min = [](auto const &lhs, auto const &rhs) -> bool { return std::get<0>(lhs).min() < std::get<0>(rhs).min(); };
+
+  if (n_threads == 0) {
+    n_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  // Split in to roughly equal parts, at line boundaries.
+  std::vector<TextView> parts;
+  size_t part_size = std::max<size_t>(text.size() / n_threads, 1);
+  while (text) {
+    auto n = text.size() <= part_size ? TextView::npos : text.find('\n', part_size - 1);
+    n      = n == TextView::npos ? text.size() : n + 1;
+    parts.push_back(text.prefix(n));
+    text.remove_prefix(n);
+  }
+
+  std::vector<std::vector<IP4Item>> ip4_runs(parts.size());
+  std::vector<std::vector<IP6Item>> ip6_runs(parts.size());
+  auto worker = [&](size_t idx) {
+    TextView part{parts[idx]};
+    auto &ip4 = ip4_runs[idx];
+    auto &ip6 = ip6_runs[idx];
+    IPRange range;
+    PAYLOAD payload{};
+    while (part) {
+      auto line = part.take_prefix_at('\n');
+      if (parse(line, range, payload)) {
+        if (range.is(AF_INET)) {
+          ip4.emplace_back(static_cast<IP4Range const &>(range), payload, line.data() - src.data());
+        } else if (range.is(AF_INET6)) {
+          ip6.emplace_back(static_cast<IP6Range const &>(range), payload, line.data() - src.data());
+        }
+      }
+    }
+    std::stable_sort(ip4.begin(), ip4.end(), by_min);
+    std::stable_sort(ip6.begin(), ip6.end(), by_min);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t idx = 1; idx < parts.size(); ++idx) {
+    threads.emplace_back(worker, idx);
+  }
+  if (!parts.empty()) {
+    worker(0);
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  auto ip4 = detail::merge_runs(ip4_runs, by_min);
+  ip4_runs.clear();
+  detail::load_in_order(_ip4, ip4);
+  auto ip6 = detail::merge_runs(ip6_runs, by_min);
+  ip6_runs.clear();
+  detail::load_in_order(_ip6, ip6);
+  return *this;
+}
+
+template <typename PAYLOAD>
+template <typename F>
+auto
+IPSpace<PAYLOAD>::merge(self_type const &lhs, self_type const &rhs, F &&combiner, unsigned n_threads) -> self_type & {
+  _ip4.merge(lhs._ip4, rhs._ip4, combiner, n_threads);
+  _ip6.merge(lhs._ip6, rhs._ip6, combiner, n_threads);
+  return *this;
+}
+
 template < typename PAYLOAD > auto IPSpace<PAYLOAD>::fill(swoc::IPRange const &range, PAYLOAD const &payload) -> self_type & {
   if (range.is(AF_INET6)) {
     _ip6.fill(range, payload);
@@ -1247,4 +1836,18 @@ void IPSpace<PAYLOAD>::clear() {
 }
 
 
+static_assert(sizeof(IPKey) == IPKey::SIZE, "IPKey must not have padding");
+
 } // namespace swoc
+
+namespace std
+{
+/// Hash support for @c IPKey.
+template <> struct hash<swoc::IPKey> {
+  size_t
+  operator()(swoc::IPKey const &key) const {
+    return key.hash();
+  }
+};
+
+} // namespace std
@@ -0,0 +1,58 @@
+/** @file
+
+  Static tracepoints.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one or more contributor license agreements.
+  See the NOTICE file distributed with this work for additional information regarding copyright
+  ownership.  The ASF licenses this file to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance with the License.  You may obtain a
+  copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License
+  is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+  or implied. See the License for the specific language governing permissions and limitations under
+  the License.
+*/
+
+#pragma once
+
+/** @def SWOC_TRACE(name, ...)
+ *
+ * Static tracepoint @a name with arguments.
+ *
+ * If @c SWOC_TRACEPOINTS is defined, this is a USDT probe in the provider "swoc",
+ * which can be attached to by tools such as @c bpftrace, @c perf and SystemTap. An unattached probe
+ * is a single @c nop instruction and the arguments are only evaluated in to registers that are
+ * already live, so the probes are cheap enough to leave in release builds.
+ *
+ * Otherwise the probe and the evaluation of the arguments are removed entirely. The arguments are
+ * still checked by the compiler so that they don't warn as unused or break only when enabled.
+ *
+ * Arguments must be integers or pointers, and there can be at most 12.
+ */
+#if defined(SWOC_TRACEPOINTS)
+#include <sys/sdt.h>
+#define SWOC_TRACE(name, ...) STAP_PROBEV(swoc, name, __VA_ARGS__)
+#else
+#define SWOC_TRACE(name, ...)                    \
+  do {                                           \
+    if (false) {                                 \
+      ::swoc::detail::trace_args(__VA_ARGS__);   \
+    }                                            \
+  } while (false)
+
+namespace swoc
+{
+namespace detail
+{
+  /// Consume tracepoint arguments when tracepoints are disabled.
+  template <typename... Args>
+  constexpr void
+  trace_args(Args const &...) {}
+} // namespace detail
+} // namespace swoc
+#endif
@@ -5,7 +5,11 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
+#include <ostream>
+
 #include "swoc/ArenaWriter.h"
+#include "swoc/swoc_trace.h"
 
 namespace swoc
 {
@@ -42,6 +46,7 @@ ArenaWriter::commit(size_t n)
 void
 ArenaWriter::realloc(size_t n)
 {
+  SWOC_TRACE(arenawriter_realloc, this, this->size(), n);
   auto text                    = this->view(); // Current data.
   auto span                    = _arena.require(n).remnant().rebind<char>();
   const_cast<char *&>(_buffer) = span.data();
@@ -49,4 +54,157 @@ ArenaWriter::realloc(size_t n)
   memcpy(_buffer, text.data(), text.size());
 }
 
+SegmentedArenaWriter &
+SegmentedArenaWriter::write(char c)
+{
+  if (_attempted >= _capacity) {
+    this->extend(1);
+  }
+  _buffer[_attempted++] = c;
+  return *this;
+}
+
+SegmentedArenaWriter &
+SegmentedArenaWriter::write(void const *data, size_t n)
+{
+  auto src = static_cast<char const *>(data);
+  auto k   = std::min(n, _capacity - _attempted);
+  if (k > 0) {
+    memcpy(_buffer + _attempted, src, k);
+    _attempted += k;
+  }
+  if (n > k) { // Remainder goes in a new segment.
+    this->extend(n - k);
+    memcpy(_buffer, src + k, n - k);
+    _attempted = n - k;
+  }
+  return *this;
+}
+
+bool
+SegmentedArenaWriter::commit(size_t n)
+{
+  if (_attempted + n > _capacity) {
+    this->extend(n);
+    return false;
+  }
+  _attempted += n;
+  return true;
+}
+
+auto
+SegmentedArenaWriter::discard(size_t n) -> self_type &
+{
+  while (n > _attempted && _segments.size() > 1) {
+    n -= _attempted;
+    _segments.pop_back();
+    auto &seg = _segments.back();
+    _prior -= seg.iov_len;
+    const_cast<char *&>(_buffer) = static_cast<char *>(seg.iov_base);
+    _capacity = _attempted = seg.iov_len;
+  }
+  _attempted -= std::min(n, _attempted);
+  return *this;
+}
+
+char *
+SegmentedArenaWriter::at(size_t offset)
+{
+  if (offset >= _prior) {
+    return _buffer + (offset - _prior);
+  }
+  for (auto const &seg : _segments) {
+    if (offset < seg.iov_len) {
+      return static_cast<char *>(seg.iov_base) + offset;
+    }
+    offset -= seg.iov_len;
+  }
+  return nullptr; // Not reachable.
+}
+
+auto
+SegmentedArenaWriter::copy(size_t dst, size_t src, size_t n) -> self_type &
+{
+  auto limit = this->extent();
+  if (dst >= limit || src >= limit) {
+    return *this;
+  }
+  n = std::min({n, limit - dst, limit - src});
+  if (dst >= _prior && src >= _prior) { // All in the current segment.
+    std::memmove(_buffer + (dst - _prior), _buffer + (src - _prior), n);
+  } else if (dst < src) {
+    for (size_t i = 0; i < n; ++i) {
+      *this->at(dst + i) = *this->at(src + i);
+    }
+  } else {
+    for (size_t i = n; i > 0; --i) {
+      *this->at(dst + i - 1) = *this->at(src + i - 1);
+    }
+  }
+  return *this;
+}
+
+void
+SegmentedArenaWriter::extend(size_t n)
+{
+  if (!_segments.empty()) {
+    if (_attempted == 0) { // Unused, drop it.
+      _segments.pop_back();
+    } else {
+      _segments.back().iov_len = _attempted;
+      _prior += _attempted;
+    }
+  }
+  auto size = std::max(n, _segment_size);
+  if (_segment_size < MAX_SEGMENT_SIZE) {
+    _segment_size = std::min(_segment_size * 2, MAX_SEGMENT_SIZE);
+  }
+  auto span = _arena.alloc(size).rebind<char>();
+  _segments.push_back({span.data(), 0});
+  const_cast<char *&>(_buffer) = span.data();
+  _capacity                    = span.size();
+  _attempted                   = 0;
+}
+
+MemSpan<iovec>
+SegmentedArenaWriter::segments()
+{
+  if (!_segments.empty()) {
+    _segments.back().iov_len = _attempted;
+  }
+  return {_segments.data(), _segments.size()};
+}
+
+std::string_view
+SegmentedArenaWriter::view()
+{
+  if (_segments.size() > 1) {
+    auto n    = this->extent();
+    auto span = _arena.alloc(n).rebind<char>();
+    auto spot = span.data();
+    for (auto const &seg : this->segments()) {
+      memcpy(spot, seg.iov_base, seg.iov_len);
+      spot += seg.iov_len;
+    }
+    _segments.clear();
+    _segments.push_back({span.data(), n});
+    const_cast<char *&>(_buffer) = span.data();
+    _capacity = _attempted = n;
+    _prior                 = 0;
+  }
+  return {_buffer, _attempted};
+}
+
+std::ostream &
+SegmentedArenaWriter::operator>>(std::ostream &stream) const
+{
+  for (size_t i = 0; i + 1 < _segments.size(); ++i) {
+    stream.write(static_cast<char const *>(_segments[i].iov_base), _segments[i].iov_len);
+  }
+  if (_attempted) {
+    stream.write(_buffer, _attempted);
+  }
+  return stream;
+}
+
 } // namespace swoc
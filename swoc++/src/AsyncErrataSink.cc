@@ -0,0 +1,263 @@
+/** @file
+
+    Asynchronous sink for Errata.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+
+#include "swoc/AsyncErrataSink.h"
+
+namespace swoc
+{
+namespace
+{
+  /// Source of sink identifiers.
+  std::atomic<uint64_t> Next_Sink_Id{1};
+
+  /// Size of a record header, which is the size of the record data.
+  constexpr size_t HDR_SIZE = sizeof(uint32_t);
+  /// Header value to mark the rest of the ring as unused, the next record is at the start.
+  constexpr uint32_t PAD = std::numeric_limits<uint32_t>::max();
+  /// Maximum number of records per @c writev.
+  constexpr int BATCH_SIZE = 64;
+
+  /// @return @a n rounded up to the record alignment.
+  inline size_t
+  Record_Round(size_t n)
+  {
+    return (n + HDR_SIZE - 1) & ~(HDR_SIZE - 1);
+  }
+} // namespace
+
+/** Ring buffer of formatted @c Errata.
+ *
+ * A ring has a single producer, the thread that owns it, and a single consumer, the thread that is
+ * draining. Each record is a header with the data size followed by the data, padded to the header
+ * alignment. The positions increase monotonically and are masked to find the location.
+ */
+struct AsyncErrataSink::Ring {
+  explicit Ring(size_t size) : _data(new char[size]), _mask(size - 1) {}
+
+  std::unique_ptr<char[]> _data;              ///< Record storage.
+  size_t _mask;                               ///< Size - 1, for masking positions.
+  std::atomic<bool> _owned_p{true};           ///< A thread is using this ring.
+  alignas(64) std::atomic<uint64_t> _head{0}; ///< Producer position.
+  alignas(64) std::atomic<uint64_t> _tail{0}; ///< Consumer position.
+};
+
+/// Rings for the current thread, released for reuse by other threads when the thread exits.
+struct AsyncErrataSink::ThreadRings {
+  ~ThreadRings()
+  {
+    for (auto &[id, ring] : _rings) {
+      ring->_owned_p = false;
+    }
+  }
+
+  std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> _rings; ///< Sink id and ring.
+};
+
+AsyncErrataSink::AsyncErrataSink(int fd, size_t ring_size, std::chrono::milliseconds interval)
+  : _fd(fd), _ring_size(256), _id(Next_Sink_Id++), _interval(interval)
+{
+  while (_ring_size < ring_size) {
+    _ring_size <<= 1;
+  }
+  _thread = std::thread(&self_type::run, this);
+}
+
+AsyncErrataSink::~AsyncErrataSink()
+{
+  _stop_p = true;
+  _wake.notify_one();
+  _thread.join();
+}
+
+auto
+AsyncErrataSink::local_ring() const -> Ring &
+{
+  static thread_local ThreadRings local;
+  for (auto &[id, ring] : local._rings) {
+    if (id == _id) {
+      return *ring;
+    }
+  }
+
+  // First use from this thread - prefer a ring released by a thread that has exited.
+  std::shared_ptr<Ring> ring;
+  {
+    std::lock_guard lock(_rings_mutex);
+    for (auto &r : _rings) {
+      bool owned_p = false;
+      if (r->_owned_p.compare_exchange_strong(owned_p, true)) {
+        ring = r;
+        break;
+      }
+    }
+    if (!ring) {
+      ring = std::make_shared<Ring>(_ring_size);
+      _rings.push_back(ring);
+    }
+  }
+  local._rings.emplace_back(_id, ring);
+  return *ring;
+}
+
+void
+AsyncErrataSink::operator()(Errata const &erratum) const
+{
+  Ring &ring  = this->local_ring();
+  size_t size = ring._mask + 1;
+  char *base  = ring._data.get();
+  auto head   = ring._head.load(std::memory_order_relaxed);
+  auto tail   = ring._tail.load(std::memory_order_acquire);
+  size_t free = size - (head - tail);
+  size_t pos  = head & ring._mask;
+  size_t span = std::min(free, size - pos); // Contiguous free space.
+
+  if (span <= HDR_SIZE) {
+    if (span == free) { // full.
+      ++_dropped;
+      return;
+    }
+    // Room for only a header before the end - pad and continue at the start. If the record is
+    // then dropped the head isn't updated, and the pad is written again by the next record.
+    memcpy(base + pos, &PAD, HDR_SIZE);
+    head += span;
+    free -= span;
+    pos  = 0;
+    span = free;
+  }
+  FixedBufferWriter w{base + pos + HDR_SIZE, span - HDR_SIZE};
+  w.print("{}", erratum);
+  uint32_t n = w.extent();
+  if (!w.error()) {
+    memcpy(base + pos, &n, HDR_SIZE);
+    head += HDR_SIZE + Record_Round(n);
+  } else if (span < free && HDR_SIZE + n <= free - span) {
+    // Doesn't fit before the end, but does fit at the start.
+    FixedBufferWriter{base + HDR_SIZE, free - span - HDR_SIZE}.print("{}", erratum);
+    memcpy(base + pos, &PAD, HDR_SIZE);
+    memcpy(base, &n, HDR_SIZE);
+    head += span + HDR_SIZE + Record_Round(n);
+  } else {
+    ++_dropped;
+    return;
+  }
+  ring._head.store(head, std::memory_order_release);
+
+  if (head - tail > size / 2) {
+    _wake.notify_one();
+  }
+}
+
+bool
+AsyncErrataSink::drain() const
+{
+  std::lock_guard drain_lock(_drain_mutex);
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard lock(_rings_mutex);
+    rings = _rings;
+  }
+
+  iovec iov[BATCH_SIZE];
+  int n_iov        = 0;
+  size_t n_records = 0;
+  std::vector<std::pair<Ring *, uint64_t>> marks; // New tail positions.
+
+  // Write the batch, then release the space.
+  auto write_batch = [&]() -> void {
+    iovec *v = iov;
+    int n    = n_iov;
+    while (n > 0) {
+      auto r = ::writev(_fd, v, n);
+      if (r < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ++_errors;
+        break;
+      }
+      for (; n > 0 && size_t(r) >= v->iov_len; ++v, --n) {
+        r -= v->iov_len;
+      }
+      if (n > 0) {
+        v->iov_base = static_cast<char *>(v->iov_base) + r;
+        v->iov_len -= r;
+      }
+    }
+    for (auto [ring, tail] : marks) {
+      ring->_tail.store(tail, std::memory_order_release);
+    }
+    _written += n_records;
+    marks.clear();
+    n_iov     = 0;
+    n_records = 0;
+  };
+
+  bool zret = false;
+  for (auto &ring : rings) {
+    size_t size = ring->_mask + 1;
+    char *base  = ring->_data.get();
+    auto tail   = ring->_tail.load(std::memory_order_relaxed);
+    auto head   = ring->_head.load(std::memory_order_acquire);
+    while (tail < head) {
+      size_t pos = tail & ring->_mask;
+      uint32_t n;
+      memcpy(&n, base + pos, HDR_SIZE);
+      if (n == PAD) {
+        tail += size - pos;
+        continue;
+      }
+      iov[n_iov++] = {base + pos + HDR_SIZE, n};
+      tail += HDR_SIZE + Record_Round(n);
+      ++n_records;
+      zret = true;
+      if (n_iov == BATCH_SIZE) {
+        marks.emplace_back(ring.get(), tail);
+        write_batch();
+      }
+    }
+    marks.emplace_back(ring.get(), tail);
+  }
+  write_batch();
+  return zret;
+}
+
+void
+AsyncErrataSink::flush() const
+{
+  this->drain();
+}
+
+void
+AsyncErrataSink::run()
+{
+  while (!_stop_p) {
+    if (!this->drain()) {
+      std::unique_lock lock(_wake_mutex);
+      _wake.wait_for(lock, _interval);
+    }
+  }
+  this->drain();
+}
+
+} // namespace swoc
@@ -0,0 +1,129 @@
+/** @file
+
+    Interned strings.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#include "swoc/AtomTable.h"
+#include "swoc/ext/HashFNV.h"
+
+using namespace swoc;
+
+AtomTable::AtomTable(Mode mode) : _mode(mode) {}
+
+uint64_t
+AtomTable::hash_of(std::string_view text)
+{
+  return Hash64WyNoCase{}.hash_immediate(text);
+}
+
+auto
+AtomTable::lookup(Key const &key) const -> Data const *
+{
+  auto spot = _index.find(key);
+  return spot == _index.end() ? nullptr : &*spot;
+}
+
+auto
+AtomTable::make(std::string_view text, uint64_t hash, Data const *folded) -> Data const *
+{
+  // Aligned explicitly, because the text of other atoms leaves the arena at arbitrary alignment.
+  auto data = new (_arena.alloc(sizeof(Data), alignof(Data)).data()) Data;
+  auto span = _arena.alloc(text.size() + 1).rebind<char>();
+  std::memcpy(span.data(), text.data(), text.size());
+  span[text.size()] = '\0';
+  data->_hash       = hash;
+  data->_folded     = folded ? folded : data;
+  data->_text       = std::string_view{span.data(), text.size()};
+  _index.insert(data);
+  return data;
+}
+
+auto
+AtomTable::insert(Key const &key) -> Data const *
+{
+  auto const &text = key._text;
+  auto upper       = std::find_if(text.begin(), text.end(), [](char c) { return 0 != isupper(static_cast<unsigned char>(c)); });
+  if (upper == text.end()) {
+    return this->make(text, key._hash, nullptr);
+  }
+  // The folded form has the same hash, so it is found or added first and the atom refers to it.
+  std::string lower{text};
+  for (size_t idx = upper - text.begin(); idx < lower.size(); ++idx) {
+    lower[idx] = tolower(static_cast<unsigned char>(lower[idx]));
+  }
+  Key folded_key{lower, key._hash};
+  auto folded = this->lookup(folded_key);
+  if (nullptr == folded) {
+    folded = this->make(lower, key._hash, nullptr);
+  }
+  return this->make(text, key._hash, folded);
+}
+
+Atom
+AtomTable::intern(std::string_view text)
+{
+  Key key{text, hash_of(text)};
+  if (_mode == SHARED) {
+    {
+      std::shared_lock lock(_mutex);
+      if (auto data = this->lookup(key); data) {
+        return Atom{data};
+      }
+    }
+    std::unique_lock lock(_mutex);
+    // Another thread may have added it while the lock was released.
+    if (auto data = this->lookup(key); data) {
+      return Atom{data};
+    }
+    return Atom{this->insert(key)};
+  }
+  if (auto data = this->lookup(key); data) {
+    return Atom{data};
+  }
+  return Atom{this->insert(key)};
+}
+
+Atom
+AtomTable::find(std::string_view text) const
+{
+  Key key{text, hash_of(text)};
+  std::shared_lock lock(_mutex, std::defer_lock);
+  if (_mode == SHARED) {
+    lock.lock();
+  }
+  return Atom{this->lookup(key)};
+}
+
+auto
+AtomTable::clear() -> self_type &
+{
+  std::unique_lock lock(_mutex, std::defer_lock);
+  if (_mode == SHARED) {
+    lock.lock();
+  }
+  _index.clear();
+  _arena.clear();
+  _generation.fetch_add(1, std::memory_order_release);
+  return *this;
+}
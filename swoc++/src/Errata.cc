@@ -51,6 +51,71 @@ Errata::Data::localize(string_view src)
   return span.view();
 }
 
+/* ----------------------------------------------------------------------- */
+// methods for Errata::Inline
+
+void
+Errata::Inline::copy_text(char *dst) const
+{
+  memcpy(dst, _text, _used);
+  for (unsigned i = 0; i < _count; ++i) {
+    if (_render[i]) {
+      _copy[i](dst + _capture[i], _text + _capture[i]);
+    }
+  }
+}
+
+void
+Errata::Inline::copy(self_type const &that)
+{
+  that.copy_text(_text);
+  _used = that._used;
+  for (unsigned i = 0; i < that._count; ++i) {
+    auto &src = that[i];
+    std::string_view text;
+    if (nullptr == (_render[i] = that._render[i])) {
+      text = {_text + (src._text.data() - that._text), src._text.size()};
+    }
+    _copy[i]     = that._copy[i];
+    _capture[i]  = that._capture[i];
+    auto note    = new (&_slots[i]) Annotation(src._severity, text);
+    note->_level = src._level;
+    _notes.prepend(note);
+  }
+  _count     = that._count;
+  _n_pending = that._n_pending;
+  _severity  = that._severity;
+}
+
+void
+Errata::Inline::clear()
+{
+  _notes.clear();
+  _count     = 0;
+  _n_pending = 0;
+  _used      = 0;
+  _severity  = Errata::DEFAULT_SEVERITY;
+}
+
+/* ----------------------------------------------------------------------- */
+// methods for Errata::Data
+
+string_view
+Errata::Data::render(Render render, void const *capture, char const *base)
+{
+  auto span = this->remnant();
+  FixedBufferWriter w{span};
+  render(w, capture, base);
+  if (w.error()) {
+    span = this->alloc(w.extent());
+    FixedBufferWriter w2{span};
+    render(w2, capture, base);
+  } else {
+    span = this->alloc(w.extent());
+  }
+  return span.view();
+}
+
 /* ----------------------------------------------------------------------- */
 // methods for Errata
 
@@ -72,16 +137,48 @@ Errata::release()
       _data->~Data();
     }
     _data = nullptr;
+  } else if (_inline._count) {
+    for (auto &f : Sink_List) {
+      (*f)(*this);
+    }
+    _inline.clear();
+    // A sink may have copied this instance, which moved the annotations to shared data.
+    if (_data) {
+      if (--(_data->_ref_count) == 0) {
+        _data->~Data();
+      }
+      _data = nullptr;
+    }
   }
 }
 
 const Errata::Data *
-Errata::data()
+Errata::data() const
 {
   if (!_data) {
     MemArena arena{512};
     _data = arena.make<Data>(std::move(arena));
     ++(_data->_ref_count);
+    // Move inline annotations, oldest first to preserve the order. Deferred annotations stay
+    // deferred, with the captures in a copy of the inline storage.
+    char *base = nullptr;
+    if (_inline._n_pending) {
+      base = static_cast<char *>(_data->_arena.alloc(_inline._used, alignof(std::max_align_t)).data());
+      _inline.copy_text(base);
+    }
+    for (unsigned i = 0; i < _inline._count; ++i) {
+      auto &src     = _inline[i];
+      Annotation *n = _data->make<Annotation>(src._severity, std::string_view{});
+      n->_level     = src._level;
+      _data->_notes.prepend(n);
+      if (_inline._render[i]) {
+        _data->_pending = _data->make<Pending>(Pending{_data->_pending, n, _inline._render[i], base + _inline._capture[i], base});
+      } else {
+        n->_text = _data->localize(src._text);
+      }
+    }
+    _data->_severity = _inline._severity;
+    _inline.clear();
   }
   return _data;
 }
@@ -100,41 +197,64 @@ Errata::writeable_data()
   return _data;
 }
 
+void
+Errata::render_pending()
+{
+  if (!_data && _inline._n_pending) {
+    this->data();
+  }
+  if (_data) {
+    for (auto p = _data->_pending; p; p = p->_next) {
+      p->_note->_text = _data->render(p->_render, p->_capture, p->_base);
+    }
+    _data->_pending = nullptr;
+  }
+}
+
 Errata::iterator
 Errata::begin()
 {
-  return _data ? _data->_notes.begin() : iterator();
+  this->render_if_pending();
+  return _data ? _data->_notes.begin() : _inline._notes.begin();
 }
 
 Errata::const_iterator
 Errata::begin() const
 {
-  return _data ? _data->_notes.begin() : const_iterator();
+  this->render_if_pending();
+  return _data ? _data->_notes.begin() : _inline._notes.begin();
 }
 
 Errata::iterator
 Errata::end()
 {
-  return _data ? _data->_notes.end() : iterator();
+  return _data ? _data->_notes.end() : _inline._notes.end();
 }
 
 Errata::const_iterator
 Errata::end() const
 {
-  return _data ? _data->_notes.end() : const_iterator();
+  return _data ? _data->_notes.end() : _inline._notes.end();
 }
 
 Severity
 Errata::severity() const
 {
-  return _data ? _data->_severity : DEFAULT_SEVERITY;
+  return _data ? _data->_severity : _inline._severity;
 }
 
 Errata &
 Errata::note(Severity severity, std::string_view text)
 {
+  if (!_data && _inline._count < Inline::N_NOTES) {
+    if (auto span = _inline.remnant(); span.size() >= text.size()) {
+      memcpy(span.data(), text.data(), text.size());
+      _inline.commit(severity, text.size());
+      return *this;
+    }
+  }
   auto d        = this->writeable_data();
-  Annotation *n = d->_arena.make<Annotation>(severity, d->localize(text));
+  Annotation *n = d->make<Annotation>(severity, d->localize(text));
   d->_notes.prepend(n);
   _data->_severity = std::max(_data->_severity, severity);
   return *this;
@@ -144,7 +264,7 @@ Errata &
 Errata::note_localized(Severity severity, std::string_view const &text)
 {
   auto d        = this->writeable_data();
-  Annotation *n = d->_arena.make<Annotation>(severity, text);
+  Annotation *n = d->make<Annotation>(severity, text);
   n->_level     = d->_level;
   d->_notes.prepend(n);
   _data->_severity = std::max(_data->_severity, severity);
@@ -172,6 +292,8 @@ Errata::clear()
   if (_data) {
     _data->_notes.clear(); // Prevent sink processing.
     this->release();
+  } else {
+    _inline.clear();
   }
   return *this;
 }
@@ -0,0 +1,246 @@
+/** @file
+
+    @c BufferWriter for a file descriptor.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <climits>
+
+#include "swoc/FdWriter.h"
+
+namespace swoc
+{
+FdWriter::FdWriter(int fd, size_t buffer_size, bool async_p) : _fd(fd)
+{
+  buffer_size = std::max(buffer_size, MIN_BUFFER_SIZE);
+  for (auto &batch : _batch) {
+    batch._buffer.reset(new char[buffer_size]);
+    batch._size = buffer_size;
+    batch._iov.reserve(MAX_IOV);
+  }
+  const_cast<char *&>(_buffer) = _batch[0]._buffer.get();
+  _capacity                    = buffer_size;
+  if (async_p) {
+    _thread = std::thread(&self_type::run, this);
+  }
+}
+
+FdWriter::~FdWriter()
+{
+  this->flush();
+  if (_thread.joinable()) {
+    {
+      std::lock_guard lock(_mutex);
+      _stop_p = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+  }
+}
+
+FdWriter &
+FdWriter::write(char c)
+{
+  if (_attempted >= _capacity) {
+    this->submit();
+  }
+  _buffer[_attempted++] = c;
+  return *this;
+}
+
+FdWriter &
+FdWriter::write(void const *data, size_t n)
+{
+  auto src = static_cast<char const *>(data);
+  while (n > 0) {
+    if (_attempted >= _capacity) {
+      this->submit();
+    }
+    auto k = std::min(n, _capacity - _attempted);
+    memcpy(_buffer + _attempted, src, k);
+    _attempted += k;
+    src        += k;
+    n          -= k;
+  }
+  return *this;
+}
+
+auto
+FdWriter::reference(std::string_view view) -> self_type &
+{
+  if (!view.empty()) {
+    auto &iov = _batch[_current]._iov;
+    if (iov.size() + 2 > MAX_IOV) {
+      this->submit();
+    }
+    if (_attempted > _mark) {
+      iov.push_back({_buffer + _mark, _attempted - _mark});
+      _mark = _attempted;
+    }
+    iov.push_back({const_cast<char *>(view.data()), view.size()});
+    _prior += view.size();
+  }
+  return *this;
+}
+
+bool
+FdWriter::commit(size_t n)
+{
+  if (_attempted + n > _capacity) {
+    this->submit();
+    this->reserve(n);
+    return false;
+  }
+  _attempted += n;
+  return true;
+}
+
+auto
+FdWriter::discard(size_t n) -> self_type &
+{
+  _attempted -= std::min(n, _attempted - _mark);
+  return *this;
+}
+
+auto
+FdWriter::copy(size_t dst, size_t src, size_t n) -> self_type &
+{
+  auto base  = _prior + _mark; // Output offset of the start of the changeable text.
+  auto limit = this->extent();
+  if (dst < base || src < base || dst >= limit || src >= limit) {
+    return *this;
+  }
+  n = std::min({n, limit - dst, limit - src});
+  std::memmove(_buffer + _mark + (dst - base), _buffer + _mark + (src - base), n);
+  return *this;
+}
+
+auto
+FdWriter::flush() -> self_type &
+{
+  this->submit();
+  if (_thread.joinable()) {
+    std::unique_lock lock(_mutex);
+    _cv.wait(lock, [&]() { return _pending == nullptr; });
+  }
+  return *this;
+}
+
+void
+FdWriter::submit()
+{
+  auto &batch = _batch[_current];
+  if (_attempted > _mark) {
+    batch._iov.push_back({_buffer + _mark, _attempted - _mark});
+  }
+  _prior += _attempted;
+
+  if (!batch._iov.empty()) {
+    if (_thread.joinable()) {
+      {
+        std::unique_lock lock(_mutex);
+        _cv.wait(lock, [&]() { return _pending == nullptr; }); // wait for the other batch.
+        _pending = &batch;
+      }
+      _cv.notify_all();
+      _current = 1 - _current;
+    } else {
+      this->write_batch(batch);
+    }
+  }
+
+  auto &next                   = _batch[_current];
+  const_cast<char *&>(_buffer) = next._buffer.get();
+  _capacity                    = next._size;
+  _attempted                   = 0;
+  _mark                        = 0;
+}
+
+void
+FdWriter::reserve(size_t n)
+{
+  auto &batch = _batch[_current];
+  if (batch._size < n) {
+    batch._buffer.reset(new char[n]);
+    batch._size                  = n;
+    const_cast<char *&>(_buffer) = batch._buffer.get();
+    _capacity                    = n;
+  }
+}
+
+void
+FdWriter::write_batch(Batch &batch)
+{
+  iovec *v = batch._iov.data();
+  int n    = batch._iov.size();
+  while (n > 0) {
+    auto r = ::writev(_fd, v, std::min(n, IOV_MAX));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      int zero = 0;
+      _errno.compare_exchange_strong(zero, errno);
+      break;
+    }
+    for (; n > 0 && size_t(r) >= v->iov_len; ++v, --n) {
+      r -= v->iov_len;
+    }
+    if (n > 0) {
+      v->iov_base = static_cast<char *>(v->iov_base) + r;
+      v->iov_len -= r;
+    }
+  }
+  batch._iov.clear();
+}
+
+void
+FdWriter::run()
+{
+  std::unique_lock lock(_mutex);
+  while (true) {
+    _cv.wait(lock, [&]() { return _pending != nullptr || _stop_p; });
+    if (_pending) {
+      auto batch = _pending;
+      lock.unlock();
+      this->write_batch(*batch);
+      lock.lock();
+      _pending = nullptr;
+      _cv.notify_all();
+    } else {
+      break;
+    }
+  }
+}
+
+std::ostream &
+FdWriter::operator>>(std::ostream &stream) const
+{
+  for (auto const &v : _batch[_current]._iov) {
+    stream.write(static_cast<char const *>(v.iov_base), v.iov_len);
+  }
+  if (_attempted > _mark) {
+    stream.write(_buffer + _mark, _attempted - _mark);
+  }
+  return stream;
+}
+
+} // namespace swoc
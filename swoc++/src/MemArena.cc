@@ -19,7 +19,23 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #include "swoc/MemArena.h"
+#include "swoc/TextView.h"
+#include "swoc/swoc_file.h"
+#include "swoc/bwf_base.h"
+#include "swoc/swoc_trace.h"
 
 using namespace swoc;
 
@@ -29,6 +45,556 @@ MemArena::Block::operator delete(void *ptr)
   ::free(ptr);
 }
 
+/// Thread local reference to the thread's block cache.
+struct MemArena::BlockCache::Holder {
+  BlockCache *_cache = nullptr;
+  ~Holder()
+  {
+    if (_cache) {
+      _cache->detach();
+    }
+  }
+};
+
+thread_local MemArena::BlockCache::Holder MemArena::BlockCache::_local;
+
+MemArena::BlockCache &
+MemArena::BlockCache::local()
+{
+  if (nullptr == _local._cache) {
+    _local._cache = new BlockCache;
+  }
+  return *_local._cache;
+}
+
+void *
+MemArena::BlockCache::acquire(size_t n)
+{
+  _refs.fetch_add(1, std::memory_order_relaxed);
+  if (!is_cacheable(n)) {
+    return ::malloc(n);
+  }
+  auto idx = bucket_index(n);
+  if (nullptr == _buckets[idx]) {
+    this->drain_returns();
+  }
+  if (Item *item = _buckets[idx]; item) {
+    _buckets[idx] = item->_next;
+    --_counts[idx];
+    return item;
+  }
+  return ::malloc(n);
+}
+
+void
+MemArena::BlockCache::release(void *ptr, size_t n)
+{
+  auto item = static_cast<Item *>(ptr);
+  item->_n  = n;
+  if (!is_cacheable(n)) {
+    ::free(item);
+  } else if (this == _local._cache) {
+    auto idx = bucket_index(n);
+    if (_counts[idx] < BUCKET_LIMIT) {
+      item->_next   = _buckets[idx];
+      _buckets[idx] = item;
+      ++_counts[idx];
+    } else {
+      ::free(item);
+    }
+  } else {
+    // Wrong thread - push on the return list, the owning thread will pick it up.
+    item->_next = _returns.load(std::memory_order_relaxed);
+    while (!_returns.compare_exchange_weak(item->_next, item, std::memory_order_release, std::memory_order_relaxed))
+      ;
+  }
+  this->unref();
+}
+
+void *
+MemArena::BlockCache::do_allocate(size_t n, size_t)
+{
+  return this->acquire(n);
+}
+
+void
+MemArena::BlockCache::do_deallocate(void *ptr, size_t n, size_t)
+{
+  this->release(ptr, n);
+}
+
+bool
+MemArena::BlockCache::do_is_equal(std::pmr::memory_resource const &that) const noexcept
+{
+  return this == &that;
+}
+
+void
+MemArena::BlockCache::drain_returns()
+{
+  Item *item = _returns.exchange(nullptr, std::memory_order_acquire);
+  while (item) {
+    Item *next = item->_next;
+    auto idx   = bucket_index(item->_n);
+    if (_counts[idx] < BUCKET_LIMIT) {
+      item->_next   = _buckets[idx];
+      _buckets[idx] = item;
+      ++_counts[idx];
+    } else {
+      ::free(item);
+    }
+    item = next;
+  }
+}
+
+auto
+MemArena::BlockCache::flush() -> self_type &
+{
+  this->drain_returns();
+  for (unsigned idx = 0; idx < N_BUCKETS; ++idx) {
+    while (Item *item = _buckets[idx]) {
+      _buckets[idx] = item->_next;
+      ::free(item);
+    }
+    _counts[idx] = 0;
+  }
+  return *this;
+}
+
+size_t
+MemArena::BlockCache::count() const
+{
+  size_t zret = 0;
+  for (auto n : _counts) {
+    zret += n;
+  }
+  return zret;
+}
+
+void
+MemArena::BlockCache::detach()
+{
+  this->flush();
+  this->unref();
+}
+
+void
+MemArena::BlockCache::unref()
+{
+  if (1 == _refs.fetch_sub(1, std::memory_order_acq_rel)) {
+    // Owning thread is gone and so is every block - anything left is on the return list.
+    for (Item *item = _returns.exchange(nullptr, std::memory_order_acquire); item;) {
+      Item *next = item->_next;
+      ::free(item);
+      item = next;
+    }
+    delete this;
+  }
+}
+
+namespace
+{
+// Memory policy modes, from linux/mempolicy.h.
+constexpr int MPOL_PREFERRED_MODE  = 1;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+// Largest supported node count for a policy.
+constexpr unsigned MAX_NODES = 1024;
+using NodeMask               = std::array<unsigned long, MAX_NODES / (CHAR_BIT * sizeof(unsigned long))>;
+
+void
+set_node(NodeMask &mask, unsigned node)
+{
+  constexpr unsigned BITS = CHAR_BIT * sizeof(unsigned long);
+  mask[node / BITS] |= 1UL << (node % BITS);
+}
+} // namespace
+
+void *
+MemArena::MappedSource::acquire(size_t n)
+{
+  auto size = this->mapped_size(n);
+  void *ptr = MAP_FAILED;
+  if (size >= HUGE_PAGE_SIZE && _pages != NORMAL) {
+#if defined(MAP_HUGETLB)
+    if (_pages == EXPLICIT) {
+      ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (ptr == MAP_FAILED) {
+      // Over map and trim to get a huge page aligned mapping.
+      auto span = ::mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (span == MAP_FAILED) {
+        return nullptr;
+      }
+      auto base   = reinterpret_cast<uintptr_t>(span);
+      auto start  = (base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+      auto head   = start - base;
+      auto excess = HUGE_PAGE_SIZE - head;
+      if (head) {
+        ::munmap(span, head);
+      }
+      if (excess) {
+        ::munmap(reinterpret_cast<void *>(start + size), excess);
+      }
+      ptr = reinterpret_cast<void *>(start);
+#if defined(MADV_HUGEPAGE)
+      ::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    }
+  } else {
+    ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return nullptr;
+    }
+  }
+  this->place(ptr, size);
+  return ptr;
+}
+
+void
+MemArena::MappedSource::release(void *ptr, size_t n)
+{
+  ::munmap(ptr, this->mapped_size(n));
+}
+
+size_t
+MemArena::MappedSource::mapped_size(size_t n) const
+{
+  static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  auto unit                     = (n >= HUGE_PAGE_SIZE && _pages != NORMAL) ? HUGE_PAGE_SIZE : page_size;
+  return (n + unit - 1) / unit * unit;
+}
+
+void
+MemArena::MappedSource::place(void *ptr, size_t n) const
+{
+#if defined(__linux__) && defined(SYS_mbind)
+  NodeMask mask{};
+  int mode = MPOL_PREFERRED_MODE;
+  switch (_placement) {
+  case DEFAULT:
+    return;
+  case LOCAL: {
+    auto node = current_node();
+    if (node < 0) {
+      return;
+    }
+    set_node(mask, node);
+    break;
+  }
+  case NODE:
+    if (_node < 0 || unsigned(_node) >= MAX_NODES) {
+      return;
+    }
+    set_node(mask, _node);
+    break;
+  case INTERLEAVE:
+    mode = MPOL_INTERLEAVE_MODE;
+    for (unsigned node = 0, limit = std::min(node_count(), MAX_NODES); node < limit; ++node) {
+      set_node(mask, node);
+    }
+    break;
+  }
+  // Failure is ignored, the placement is only a hint.
+  ::syscall(SYS_mbind, ptr, n, mode, mask.data(), MAX_NODES, 0);
+#endif
+}
+
+int
+MemArena::MappedSource::current_node()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu, node;
+  if (0 == ::syscall(SYS_getcpu, &cpu, &node, nullptr)) {
+    return node;
+  }
+#endif
+  return -1;
+}
+
+unsigned
+MemArena::MappedSource::node_count()
+{
+  static const unsigned count = []() -> unsigned {
+    // The file is a list of node ranges, e.g. "0-1,3".
+    std::error_code ec;
+    auto content = file::load(file::path{"/sys/devices/system/node/possible"}, ec);
+    unsigned zret = 1;
+    TextView text{content.data(), content.size()};
+    while (text.ltrim_if(&isspace)) {
+      auto token = text.take_prefix_at(',').trim_if(&isspace);
+      if (auto idx = token.rfind('-'); idx != TextView::npos) {
+        token.remove_prefix(idx + 1); // only the upper bound matters.
+      }
+      if (!token.empty()) {
+        zret = std::max<unsigned>(zret, svtou(token) + 1);
+      }
+    }
+    return zret;
+  }();
+  return count;
+}
+
+void *
+MemArena::MappedSource::do_allocate(size_t n, size_t)
+{
+  if (auto ptr = this->acquire(n); ptr) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void
+MemArena::MappedSource::do_deallocate(void *ptr, size_t n, size_t)
+{
+  this->release(ptr, n);
+}
+
+bool
+MemArena::MappedSource::do_is_equal(std::pmr::memory_resource const &that) const noexcept
+{
+  return this == &that;
+}
+
+MemArena::RegionSource::RegionSource(size_t capacity)
+{
+  auto size = page_round(capacity);
+  auto ptr  = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (ptr != MAP_FAILED) {
+    _base     = static_cast<char *>(ptr);
+    _capacity = size;
+  }
+}
+
+MemArena::RegionSource::~RegionSource()
+{
+  if (_base) {
+    ::munmap(_base, _capacity);
+  }
+}
+
+size_t
+MemArena::RegionSource::page_round(size_t n)
+{
+  static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  return (n + page_size - 1) / page_size * page_size;
+}
+
+void *
+MemArena::RegionSource::acquire(size_t n)
+{
+  auto size = page_round(n);
+  if (size > _capacity - _used) {
+    return nullptr;
+  }
+  auto ptr  = _base + _used;
+  _used    += size;
+  return ptr;
+}
+
+void
+MemArena::RegionSource::release(void *ptr, size_t n)
+{
+  // The addresses are not reused, so the pages can be dropped and will read as zero.
+  ::madvise(ptr, page_round(n), MADV_DONTNEED);
+}
+
+void *
+MemArena::RegionSource::do_allocate(size_t n, size_t)
+{
+  if (auto ptr = this->acquire(n); ptr) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void
+MemArena::RegionSource::do_deallocate(void *ptr, size_t n, size_t)
+{
+  this->release(ptr, n);
+}
+
+bool
+MemArena::RegionSource::do_is_equal(std::pmr::memory_resource const &that) const noexcept
+{
+  return this == &that;
+}
+
+namespace
+{
+/// Header at the start of an arena image file, padded to @c SIZE bytes.
+struct ImageHeader {
+  static constexpr char MAGIC[8]    = {'s', 'w', 'o', 'c', 'A', 'I', 'M', 'G'}; ///< File identifier.
+  static constexpr uint32_t VERSION = 1;                                    ///< Current format version.
+  /// Size of the header, which keeps the image aligned to a page in the file.
+  static constexpr uint32_t SIZE = 4096;
+  /// Root offset if there is no root.
+  static constexpr uint64_t NO_ROOT = ~uint64_t(0);
+
+  char _magic[8];    ///< Must be @c MAGIC.
+  uint32_t _version; ///< Format version.
+  uint32_t _size;    ///< Size of the header, must be @c SIZE.
+  uint64_t _origin;  ///< Address of the image in the arena.
+  uint64_t _length;  ///< Size of the image.
+  uint64_t _root;    ///< Offset of the root object in the image, or @c NO_ROOT.
+};
+
+std::error_code
+errno_code()
+{
+  return std::error_code(errno, std::system_category());
+}
+
+std::error_code
+invalid_code()
+{
+  return std::error_code(EINVAL, std::system_category());
+}
+
+/// Write all of @a n bytes at @a data to @a fd.
+bool
+write_all(int fd, void const *data, size_t n)
+{
+  auto ptr = static_cast<char const *>(data);
+  while (n > 0) {
+    auto r = ::write(fd, ptr, n);
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += r;
+    n   -= r;
+  }
+  return true;
+}
+} // namespace
+
+void
+MemArena::Image::write(file::path const &path, MemArena const &arena, RegionSource const &source, void const *root,
+                       std::error_code &ec)
+{
+  ec.clear();
+  if (arena.frozen_begin() == arena.frozen_end()) {
+    ec = invalid_code();
+    return;
+  }
+  // The image is from the start of the first frozen block to the end of the allocated memory in the
+  // last one. Blocks are made in increasing address order so there is at most a little unused
+  // memory between them.
+  char const *first = nullptr;
+  char const *limit = nullptr;
+  for (auto spot = arena.frozen_begin(); spot != arena.frozen_end(); ++spot) {
+    auto start = reinterpret_cast<char const *>(&*spot);
+    if (!source.contains(start)) {
+      ec = invalid_code();
+      return;
+    }
+    auto end = spot->data() + spot->allocated;
+    first    = first ? std::min(first, start) : start;
+    limit    = std::max(limit, end);
+  }
+  auto r = static_cast<char const *>(root);
+  if (root && !(first <= r && r < limit && arena.contains(r))) {
+    ec = invalid_code();
+    return;
+  }
+
+  char hdr_buff[ImageHeader::SIZE] = {};
+  ImageHeader hdr;
+  std::memcpy(hdr._magic, ImageHeader::MAGIC, sizeof(hdr._magic));
+  hdr._version = ImageHeader::VERSION;
+  hdr._size    = ImageHeader::SIZE;
+  hdr._origin  = reinterpret_cast<uintptr_t>(first);
+  hdr._length  = limit - first;
+  hdr._root    = root ? uint64_t(r - first) : ImageHeader::NO_ROOT;
+  std::memcpy(hdr_buff, &hdr, sizeof(hdr));
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    ec = errno_code();
+    return;
+  }
+  if (!write_all(fd, hdr_buff, sizeof(hdr_buff)) || !write_all(fd, first, limit - first)) {
+    ec = errno_code();
+  }
+  if (::close(fd) != 0 && !ec) {
+    ec = errno_code();
+  }
+}
+
+auto
+MemArena::Image::load(file::path const &path, std::error_code &ec, bool writable) -> self_type
+{
+  self_type zret;
+  ec.clear();
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    ec = errno_code();
+    return zret;
+  }
+  struct stat info;
+  if (::fstat(fd, &info) != 0) {
+    ec = errno_code();
+    ::close(fd);
+    return zret;
+  }
+  size_t file_size = info.st_size;
+  if (file_size < ImageHeader::SIZE) {
+    ec = invalid_code();
+    ::close(fd);
+    return zret;
+  }
+  auto ptr = ::mmap(nullptr, file_size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_PRIVATE, fd, 0);
+  if (ptr == MAP_FAILED) {
+    ec = errno_code();
+  }
+  ::close(fd);
+  if (ec) {
+    return zret;
+  }
+  zret._map      = ptr;
+  zret._map_size = file_size;
+
+  ImageHeader hdr;
+  std::memcpy(&hdr, ptr, sizeof(hdr));
+  if (0 != std::memcmp(hdr._magic, ImageHeader::MAGIC, sizeof(hdr._magic)) || hdr._version != ImageHeader::VERSION ||
+      hdr._size != ImageHeader::SIZE || hdr._length > file_size - ImageHeader::SIZE ||
+      (hdr._root != ImageHeader::NO_ROOT && hdr._root >= hdr._length)) {
+    ec = invalid_code();
+    zret.clear();
+    return zret;
+  }
+  zret._data   = static_cast<char *>(ptr) + ImageHeader::SIZE;
+  zret._size   = hdr._length;
+  zret._origin = hdr._origin;
+  zret._root   = hdr._root == ImageHeader::NO_ROOT ? nullptr : zret._data + hdr._root;
+  return zret;
+}
+
+void
+MemArena::Image::clear()
+{
+  if (_map) {
+    ::munmap(_map, _map_size);
+  }
+  _map      = nullptr;
+  _map_size = _size = 0;
+  _data = _root = nullptr;
+  _origin       = 0;
+}
+
+std::atomic<MemArena::Tag const *> MemArena::Tag::_registry{nullptr};
+thread_local MemArena::Tag *MemArena::Tag::_current = nullptr;
+
+MemArena::Tag::Tag(std::string_view name) : _name(name)
+{
+  _next = _registry.load(std::memory_order_relaxed);
+  while (!_registry.compare_exchange_weak(_next, this, std::memory_order_release, std::memory_order_relaxed))
+    ;
+}
+
 // Need to break these out because the default implementation doesn't clear the
 // integral values in @a that.
 
@@ -38,12 +604,20 @@ MemArena::MemArena(swoc::MemArena::self_type &&that)
     _frozen_allocated(that._frozen_allocated),
     _frozen_reserved(that._frozen_reserved),
     _reserve_hint(that._reserve_hint),
+    _active_finalizers(that._active_finalizers),
+    _frozen_finalizers(that._frozen_finalizers),
+    _cache_p(that._cache_p),
+    _upstream(that._upstream),
     _frozen(std::move(that._frozen)),
     _active(std::move(that._active))
 {
   that._active_allocated = that._active_reserved = 0;
   that._frozen_allocated = that._frozen_reserved = 0;
   that._reserve_hint                             = 0;
+  that._active_finalizers = that._frozen_finalizers = nullptr;
+#if defined(SWOC_MEMARENA_STATS)
+  _stats = std::exchange(that._stats, Stats{});
+#endif
 }
 
 MemArena *
@@ -62,8 +636,15 @@ MemArena::operator=(swoc::MemArena::self_type &&that)
   std::swap(_frozen_allocated, that._frozen_allocated);
   std::swap(_frozen_reserved, that._frozen_reserved);
   std::swap(_reserve_hint, that._reserve_hint);
+  std::swap(_active_finalizers, that._active_finalizers);
+  std::swap(_frozen_finalizers, that._frozen_finalizers);
+  _cache_p  = that._cache_p;
+  _upstream = that._upstream;
   _active = std::move(that._active);
   _frozen = std::move(that._frozen);
+#if defined(SWOC_MEMARENA_STATS)
+  std::swap(_stats, that._stats);
+#endif
   return *this;
 }
 
@@ -85,7 +666,8 @@ MemArena::make_block(size_t n)
   // Add in overhead and round up to paragraph units.
   n = Paragraph{round_up(n + ALLOC_HEADER_SIZE + sizeof(Block))};
   // If a page or more, round up to page unit size and clip back to account for alloc header.
-  if (n >= Page::SCALE) {
+  // If caching, always use page units so that blocks are interchangeable.
+  if (n >= Page::SCALE || _cache_p) {
     n = Page{round_up(n)} - ALLOC_HEADER_SIZE;
   }
 
@@ -94,17 +676,41 @@ MemArena::make_block(size_t n)
   // Easier to use malloc and override @c delete.
   auto free_space = n - sizeof(Block);
   _active_reserved += free_space;
+  SWOC_TRACE(memarena_make_block, this, free_space, _active_reserved);
+#if defined(SWOC_MEMARENA_STATS)
+  ++_stats._n_blocks;
+  _stats._block_size    += free_space;
+  _stats._peak_reserved = std::max(_stats._peak_reserved, this->reserved_size());
+#endif
+  std::pmr::memory_resource *source = _cache_p ? &BlockCache::local() : _upstream;
+  if (source) {
+    auto block     = new (source->allocate(n, alignof(std::max_align_t))) Block(free_space);
+    block->_source = source;
+    return block;
+  }
   return new (::malloc(n)) Block(free_space);
 }
 
+void
+MemArena::free_block(Block *b)
+{
+  if (b->_source) {
+    b->_source->deallocate(b, b->size + sizeof(Block), alignof(std::max_align_t));
+  } else {
+    delete b;
+  }
+}
+
 MemSpan<void>
 MemArena::alloc(size_t n)
 {
   MemSpan<void> zret;
   this->require(n);
-  auto block = _active.head();
-  zret       = block->alloc(n);
+  auto block  = _active.head();
+  bool full_p = block->is_full();
+  zret        = block->alloc(n);
   _active_allocated += n;
+  this->note_alloc(block, n, full_p);
   // If this block is now full, move it to the back.
   if (block->is_full() && block != _active.tail()) {
     _active.erase(block);
@@ -113,11 +719,88 @@ MemArena::alloc(size_t n)
   return zret;
 }
 
+MemSpan<void>
+MemArena::alloc(size_t n, size_t align)
+{
+  // Padding needed to align the remnant of @a b.
+  auto padding = [=](Block *b) -> size_t {
+    return (align - (reinterpret_cast<uintptr_t>(b->remnant().data()) & (align - 1))) & (align - 1);
+  };
+
+  if (_active.empty() || _active.head()->remaining() < n + padding(_active.head())) {
+    this->require(n + align - 1); // enough for any padding.
+  }
+  auto block  = _active.head();
+  auto pad    = padding(block);
+  bool full_p = block->is_full();
+  MemSpan<void> zret{block->alloc(pad + n)};
+  zret.remove_prefix(pad);
+  _active_allocated += pad + n;
+  this->note_alloc(block, pad + n, full_p);
+  if (block->is_full() && block != _active.tail()) {
+    _active.erase(block);
+    _active.append(block);
+  }
+  return zret;
+}
+
+void *
+MemArena::do_allocate(size_t n, size_t align)
+{
+  return this->alloc(n, align).data();
+}
+
+void
+MemArena::do_deallocate(void *, size_t, size_t)
+{
+}
+
+bool
+MemArena::do_is_equal(std::pmr::memory_resource const &that) const noexcept
+{
+  return this == &that;
+}
+
+auto
+MemArena::finalizer_slot() -> Finalizer *
+{
+  if (nullptr == _active_finalizers || _active_finalizers->_count >= FinalizerChunk::N) {
+    auto chunk         = new (this->alloc(sizeof(FinalizerChunk), alignof(FinalizerChunk)).data()) FinalizerChunk;
+    chunk->_next       = _active_finalizers;
+    _active_finalizers = chunk;
+  }
+  return _active_finalizers->_items + _active_finalizers->_count;
+}
+
+void
+MemArena::finalize(FinalizerChunk *list)
+{
+  for (; list; list = list->_next) {
+    while (list->_count > 0) {
+      auto &item = list->_items[--list->_count];
+      item._fn(item._ptr);
+    }
+  }
+}
+
+void
+MemArena::finalize_active()
+{
+  // Destructors can make more managed instances, which must be destroyed as well.
+  while (auto list = _active_finalizers) {
+    _active_finalizers = nullptr;
+    finalize(list);
+  }
+}
+
 MemArena &
 MemArena::freeze(size_t n)
 {
+  SWOC_TRACE(memarena_freeze, this, _active_allocated, _active_reserved);
   this->destroy_frozen();
-  _frozen = std::move(_active);
+  _frozen            = std::move(_active);
+  _frozen_finalizers = _active_finalizers;
+  _active_finalizers = nullptr;
   // Update the meta data.
   _frozen_allocated = _active_allocated;
   _active_allocated = 0;
@@ -132,6 +815,7 @@ MemArena::freeze(size_t n)
 MemArena &
 MemArena::thaw()
 {
+  SWOC_TRACE(memarena_thaw, this, _frozen_reserved);
   this->destroy_frozen();
   _frozen_reserved = _frozen_allocated = 0;
   return *this;
@@ -163,6 +847,9 @@ MemArena::require(size_t n)
         ++spot;
     }
     if (spot == _active.end()) { // no block has enough free space
+#if defined(SWOC_MEMARENA_STATS)
+      ++_stats._n_misses;
+#endif
       block = this->make_block(n);
       _active.prepend(block);
     } else if (spot != _active.begin()) {
@@ -178,13 +865,15 @@ MemArena::require(size_t n)
 void
 MemArena::destroy_active()
 {
-  _active.apply([](Block *b) { delete b; }).clear();
+  this->finalize_active();
+  _active.apply(&free_block).clear();
 }
 
 void
 MemArena::destroy_frozen()
 {
-  _frozen.apply([](Block *b) { delete b; }).clear();
+  finalize(std::exchange(_frozen_finalizers, nullptr));
+  _frozen.apply(&free_block).clear();
 }
 
 MemArena &
@@ -193,8 +882,8 @@ MemArena::clear(size_t hint)
   _reserve_hint    = hint ? hint : _frozen_allocated + _active_allocated;
   _frozen_reserved = _frozen_allocated = 0;
   _active_reserved = _active_allocated = 0;
+  this->destroy_active(); // newer generation first, for destructor order.
   this->destroy_frozen();
-  this->destroy_active();
 
   return *this;
 }
@@ -203,6 +892,7 @@ MemArena &
 MemArena::discard(size_t hint)
 {
   _reserve_hint = hint ? hint : _frozen_allocated + _active_allocated;
+  this->finalize_active();
   for (auto &block : _active) {
     block.discard();
   }
@@ -212,19 +902,61 @@ MemArena::discard(size_t hint)
 
 MemArena::~MemArena()
 {
+  // Destroy managed instances first, while all the memory is still valid.
+  this->finalize_active();
+  finalize(_frozen_finalizers);
+
   // Destruct in a way that makes it safe for the instance to be in one of its own memory blocks.
   Block *ba = _active.head();
   Block *bf = _frozen.head();
   _active.clear();
   _frozen.clear();
+  // The block containing this instance, if any, is released by the base class after the other
+  // base classes are destroyed.
   while (bf) {
     Block *b = bf;
     bf       = bf->_link._next;
-    delete b;
+    if (b->contains(this)) {
+      _self_block = b;
+    } else {
+      free_block(b);
+    }
   }
   while (ba) {
     Block *b = ba;
     ba       = ba->_link._next;
-    delete b;
+    if (b->contains(this)) {
+      _self_block = b;
+    } else {
+      free_block(b);
+    }
+  }
+}
+
+namespace swoc
+{
+BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &, MemArena::Stats const &stats)
+{
+  return w.print("blocks {} ({} bytes), allocs {} ({} bytes), misses {}, wasted {} bytes, peak allocated {} bytes, peak "
+                 "reserved {} bytes",
+                 stats._n_blocks, stats._block_size, stats._n_allocs, stats._alloc_size, stats._n_misses, stats._wasted,
+                 stats._peak_allocated, stats._peak_reserved);
+}
+
+BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &, MemArena::Tag const &tag)
+{
+  return w.print("{}: allocs {} ({} bytes)", tag.name(), tag.count(), tag.size());
+}
+
+BufferWriter &
+bwformat(BufferWriter &w, bwf::Spec const &spec, MemArena::Tag::Registry const &registry)
+{
+  for (auto const &tag : registry) {
+    bwformat(w, spec, tag);
+    w.write('\n');
   }
+  return w;
 }
+} // namespace swoc
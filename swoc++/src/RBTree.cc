@@ -42,12 +42,6 @@ namespace detail
     return n == c;
   }
 
-  RBNode *
-  RBNode::child_at(Direction d) const
-  {
-    return d == Direction::RIGHT ? _right : d == Direction::LEFT ? _left : nullptr;
-  }
-
   RBNode *
   RBNode::rotate(Direction dir)
   {
@@ -62,8 +56,8 @@ namespace detail
       this->set_child(child->child_at(dir), other_dir);
       child->clear_child(dir);
       child->set_child(this, dir);
+      this->structure_fixup(); // now a child of @a child, so must be first.
       child->structure_fixup();
-      this->structure_fixup();
       if (parent) {
         parent->clear_child(child_dir);
         parent->set_child(child, child_dir);
@@ -366,6 +360,62 @@ namespace detail
 #endif
   }
 
+  unsigned
+  RBNode::black_height(self_type const *n)
+  {
+    unsigned zret = 0;
+    for (; n; n = n->_left) {
+      zret += n->_color == Color::BLACK;
+    }
+    return zret;
+  }
+
+  RBNode *
+  RBNode::join(self_type *left, unsigned left_height, self_type *pivot, self_type *right, unsigned right_height,
+               unsigned *height)
+  {
+    // Descend the spine of the taller tree facing the other tree to a black node of the same black
+    // height as the other tree, and replace that node with @a pivot, which takes it and the other
+    // tree as children. The only possible violation is a red parent for @a pivot.
+    bool left_p      = left_height >= right_height; // @a left is the taller tree.
+    Direction dir    = left_p ? Direction::RIGHT : Direction::LEFT;
+    self_type *n     = left_p ? left : right;
+    self_type *other = left_p ? right : left;
+    unsigned h       = left_p ? left_height : right_height;
+    unsigned target  = left_p ? right_height : left_height;
+    self_type *parent{nullptr};
+
+    while (n && (n->_color == Color::RED || h > target)) {
+      h      -= n->_color == Color::BLACK;
+      parent = n;
+      n      = n->child_at(dir);
+    }
+
+    pivot->_color  = Color::RED;
+    pivot->_parent = pivot->_left = pivot->_right = nullptr;
+    if (parent) {
+      parent->set_child(pivot, dir);
+    }
+    pivot->set_child(n, pivot->flip(dir));
+    pivot->set_child(other, dir);
+    self_type *root = pivot->rebalance_after_insert();
+
+    if (height) {
+      // The subtrees below @a pivot are not changed by the rebalance, so count from one of them.
+      self_type const *base = other ? other : n;
+      unsigned zret         = target;
+      if (nullptr == base) { // both empty, count through @a pivot.
+        zret = black_height(pivot);
+        base = pivot;
+      }
+      for (auto p = base->_parent; p; p = p->_parent) {
+        zret += p->_color == Color::BLACK;
+      }
+      *height = zret;
+    }
+    return root;
+  }
+
   auto
   RBNode::left_most_descendant() const -> self_type *
   {
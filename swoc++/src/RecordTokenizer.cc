@@ -0,0 +1,160 @@
+/** @file
+
+    Tokenizer for delimited records.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "swoc/RecordTokenizer.h"
+
+using namespace swoc;
+
+namespace
+{
+/// @return A mask with bit @a i set if there is an odd number of bits set in positions 0..i of @a x.
+inline uint64_t
+prefix_xor(uint64_t x)
+{
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+} // namespace
+
+RecordTokenizer &
+RecordTokenizer::project(std::initializer_list<unsigned> columns)
+{
+  if (columns.size() == 0) {
+    _projection  = ~uint64_t(0);
+    _last_column = ~0U;
+  } else {
+    _projection  = 0;
+    _last_column = 0;
+    for (auto c : columns) {
+      if (c < MAX_PROJECTED) {
+        _projection |= uint64_t(1) << c;
+        _last_column = std::max(_last_column, c);
+      }
+    }
+  }
+  return *this;
+}
+
+void
+RecordTokenizer::classify()
+{
+  char const *src = _text.data() + _block;
+  size_t n        = std::min(BLOCK_SIZE, _text.size() - _block);
+  char tail[BLOCK_SIZE];
+  if (n < BLOCK_SIZE) {
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, src, n);
+    src = tail;
+  }
+
+  uint64_t seps = 0, newlines = 0, quotes = 0;
+#if defined(__SSE2__)
+  auto v_sep   = _mm_set1_epi8(_delimiter);
+  auto v_nl    = _mm_set1_epi8('\n');
+  auto v_quote = _mm_set1_epi8(_quote);
+  for (unsigned i = 0; i < BLOCK_SIZE / 16; ++i) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + 16 * i));
+    seps |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, v_sep)))) << (16 * i);
+    newlines |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, v_nl)))) << (16 * i);
+    quotes |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, v_quote)))) << (16 * i);
+  }
+#else
+  for (unsigned i = 0; i < BLOCK_SIZE; ++i) {
+    seps |= uint64_t(src[i] == _delimiter) << i;
+    newlines |= uint64_t(src[i] == '\n') << i;
+    quotes |= uint64_t(src[i] == _quote) << i;
+  }
+#endif
+
+  // Drop matches in the padding and quotes if quoting is disabled.
+  uint64_t valid = n < BLOCK_SIZE ? (uint64_t(1) << n) - 1 : ~uint64_t(0);
+  if (_quote == 0) {
+    quotes = 0;
+  }
+  // Each quote toggles the quoted state, so a position is quoted if there is an odd number of
+  // quotes before it, including those in previous blocks.
+  uint64_t quoted = prefix_xor(quotes & valid) ^ _in_quote;
+  _in_quote       = uint64_t(int64_t(quoted) >> 63); // all ones if the last position is quoted.
+  _seps           = seps & ~quoted & valid;
+  _newlines       = newlines & ~quoted & valid;
+  _quoted         = newlines & quoted & valid;
+}
+
+TextView
+RecordTokenizer::unquote(TextView field) const
+{
+  if (_quote && field.size() >= 2 && field.front() == _quote && field.back() == _quote) {
+    field.remove_prefix(1).remove_suffix(1);
+  }
+  return field;
+}
+
+bool
+RecordTokenizer::next(std::vector<TextView> &fields)
+{
+  auto const size = _text.size();
+  fields.clear();
+  while (_pos < size) {
+    auto line    = _n_newline + 1;
+    unsigned col = 0;
+    bool blank_p = false;
+    bool end_p   = false;
+    while (!end_p) {
+      if (col > _last_column) { // nothing else selected, skip the rest of the record.
+        auto idx = this->next_structural(true);
+        _n_newline += idx < size;
+        _pos = idx + 1;
+        break;
+      }
+      auto idx = this->next_structural(false);
+      end_p    = idx >= size || _text[idx] == '\n';
+      TextView field{_text.data() + _pos, idx - _pos};
+      if (end_p) {
+        if (field && field.back() == '\r') {
+          field.remove_suffix(1);
+        }
+        blank_p = col == 0 && field.empty();
+        _n_newline += idx < size;
+      }
+      if (!blank_p && (_last_column == ~0U || (_projection >> col) & 1)) {
+        fields.push_back(this->unquote(field));
+      }
+      ++col;
+      _pos = idx + 1;
+    }
+    if (!blank_p) {
+      _line = line;
+      return true;
+    }
+  }
+  return false;
+}
@@ -23,9 +23,241 @@
     the License.
 */
 #include "swoc/TextView.h"
+#include "swoc/MemSpan.h"
 #include <cctype>
 #include <sstream>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using swoc::CharSet;
+using swoc::TextView;
+
+/// @cond INTERNAL_DETAIL
+namespace
+{
+// Vectorized search kernels. A block is checked for the characters of the set by comparing against
+// each member, which is why only sets with at most @c CharSet::VECTOR_LIMIT members are
+// vectorized. The resulting bit mask is inverted to search for characters @b not in the set. The
+// 256 bit wide version is selected at run time if the CPU supports it.
+
+/// Scalar search forward from @a pos.
+size_t
+Find_Forward_Scalar(char const *s, size_t n, size_t pos, CharSet const &set, bool invert)
+{
+  for (; pos < n; ++pos) {
+    if (set.contains(s[pos]) != invert) {
+      return pos;
+    }
+  }
+  return TextView::npos;
+}
+
+/// Scalar search backward in the first @a n characters.
+size_t
+Find_Backward_Scalar(char const *s, size_t n, CharSet const &set, bool invert)
+{
+  while (n > 0) {
+    if (set.contains(s[--n]) != invert) {
+      return n;
+    }
+  }
+  return TextView::npos;
+}
+
+/// Fold ASCII upper case to lower case.
+inline int
+Fold_Case(char c)
+{
+  auto u = static_cast<unsigned char>(c);
+  return (u - 'A') < 26u ? u + ('a' - 'A') : u;
+}
+
+#if defined(__SSE2__)
+/// Search forward 16 bytes at a time, finishing with the scalar search.
+size_t
+Find_Forward_SSE2(char const *s, size_t n, size_t pos, char const *chars, unsigned k, CharSet const &set, bool invert)
+{
+  if (pos + 16 <= n) {
+    __m128i needles[CharSet::VECTOR_LIMIT];
+    for (unsigned i = 0; i < k; ++i) {
+      needles[i] = _mm_set1_epi8(chars[i]);
+    }
+    unsigned flip = invert ? 0xFFFF : 0;
+    for (; pos + 16 <= n; pos += 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(s + pos));
+      __m128i hit   = _mm_setzero_si128();
+      for (unsigned i = 0; i < k; ++i) {
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[i]));
+      }
+      if (unsigned mask = unsigned(_mm_movemask_epi8(hit)) ^ flip; mask) {
+        return pos + __builtin_ctz(mask);
+      }
+    }
+  }
+  return Find_Forward_Scalar(s, n, pos, set, invert);
+}
+
+/// Search backward 16 bytes at a time, finishing with the scalar search.
+size_t
+Find_Backward_SSE2(char const *s, size_t n, char const *chars, unsigned k, CharSet const &set, bool invert)
+{
+  if (n >= 16) {
+    __m128i needles[CharSet::VECTOR_LIMIT];
+    for (unsigned i = 0; i < k; ++i) {
+      needles[i] = _mm_set1_epi8(chars[i]);
+    }
+    unsigned flip = invert ? 0xFFFF : 0;
+    for (; n >= 16; n -= 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(s + n - 16));
+      __m128i hit   = _mm_setzero_si128();
+      for (unsigned i = 0; i < k; ++i) {
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[i]));
+      }
+      if (unsigned mask = unsigned(_mm_movemask_epi8(hit)) ^ flip; mask) {
+        return n - 16 + (31 - __builtin_clz(mask));
+      }
+    }
+  }
+  return Find_Backward_Scalar(s, n, set, invert);
+}
+
+/// Fold the ASCII upper case characters in @a block to lower case.
+inline __m128i
+Fold_Case(__m128i block)
+{
+  // Shift 'A'..'Z' to the bottom of the signed range so a single signed compare selects them.
+  __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8(char(0x80 - 'A')));
+  __m128i upper   = _mm_cmpgt_epi8(_mm_set1_epi8(char(-0x80 + 26)), shifted);
+  return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+}
+#endif
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define SWOC_TEXTVIEW_AVX2 1
+
+/// Search forward 32 bytes at a time, finishing with the 16 byte search.
+__attribute__((target("avx2"))) size_t
+Find_Forward_AVX2(char const *s, size_t n, size_t pos, char const *chars, unsigned k, CharSet const &set, bool invert)
+{
+  if (pos + 32 <= n) {
+    __m256i needles[CharSet::VECTOR_LIMIT];
+    for (unsigned i = 0; i < k; ++i) {
+      needles[i] = _mm256_set1_epi8(chars[i]);
+    }
+    uint32_t flip = invert ? ~uint32_t(0) : 0;
+    for (; pos + 32 <= n; pos += 32) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(s + pos));
+      __m256i hit   = _mm256_setzero_si256();
+      for (unsigned i = 0; i < k; ++i) {
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, needles[i]));
+      }
+      if (uint32_t mask = uint32_t(_mm256_movemask_epi8(hit)) ^ flip; mask) {
+        return pos + __builtin_ctz(mask);
+      }
+    }
+  }
+  return Find_Forward_SSE2(s, n, pos, chars, k, set, invert);
+}
+
+/// Search backward 32 bytes at a time, finishing with the 16 byte search.
+__attribute__((target("avx2"))) size_t
+Find_Backward_AVX2(char const *s, size_t n, char const *chars, unsigned k, CharSet const &set, bool invert)
+{
+  if (n >= 32) {
+    __m256i needles[CharSet::VECTOR_LIMIT];
+    for (unsigned i = 0; i < k; ++i) {
+      needles[i] = _mm256_set1_epi8(chars[i]);
+    }
+    uint32_t flip = invert ? ~uint32_t(0) : 0;
+    for (; n >= 32; n -= 32) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(s + n - 32));
+      __m256i hit   = _mm256_setzero_si256();
+      for (unsigned i = 0; i < k; ++i) {
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, needles[i]));
+      }
+      if (uint32_t mask = uint32_t(_mm256_movemask_epi8(hit)) ^ flip; mask) {
+        return n - 32 + (31 - __builtin_clz(mask));
+      }
+    }
+  }
+  return Find_Backward_SSE2(s, n, chars, k, set, invert);
+}
+
+/// @return @c true if the 256 bit kernels can be used.
+bool
+Have_AVX2()
+{
+  static bool const zret = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+  return zret;
+}
+#endif
+
+} // namespace
+/// @endcond
+
+// Dispatch to the widest available kernel.
+size_t
+TextView::find_forward(CharSet const &set, bool invert) const
+{
+#if defined(__SSE2__)
+  if (set._count <= CharSet::VECTOR_LIMIT) {
+#if defined(SWOC_TEXTVIEW_AVX2)
+    if (this->size() >= 32 && Have_AVX2()) {
+      return Find_Forward_AVX2(this->data(), this->size(), 0, set._chars, set._count, set, invert);
+    }
+#endif
+    return Find_Forward_SSE2(this->data(), this->size(), 0, set._chars, set._count, set, invert);
+  }
+#endif
+  return Find_Forward_Scalar(this->data(), this->size(), 0, set, invert);
+}
+
+size_t
+TextView::find_backward(CharSet const &set, bool invert) const
+{
+#if defined(__SSE2__)
+  if (set._count <= CharSet::VECTOR_LIMIT) {
+#if defined(SWOC_TEXTVIEW_AVX2)
+    if (this->size() >= 32 && Have_AVX2()) {
+      return Find_Backward_AVX2(this->data(), this->size(), set._chars, set._count, set, invert);
+    }
+#endif
+    return Find_Backward_SSE2(this->data(), this->size(), set._chars, set._count, set, invert);
+  }
+#endif
+  return Find_Backward_Scalar(this->data(), this->size(), set, invert);
+}
+
+/// @cond INTERNAL_DETAIL
+namespace
+{
+/// Compare @a n characters of @a lhs and @a rhs ignoring ASCII case, with the result as for @c strncasecmp.
+int
+Compare_NoCase(char const *lhs, char const *rhs, size_t n)
+{
+  size_t idx = 0;
+#if defined(__SSE2__)
+  for (; idx + 16 <= n; idx += 16) {
+    __m128i l = Fold_Case(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs + idx)));
+    __m128i r = Fold_Case(_mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs + idx)));
+    if (unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(l, r))) ^ 0xFFFF; mask) {
+      idx += __builtin_ctz(mask);
+      return Fold_Case(lhs[idx]) - Fold_Case(rhs[idx]);
+    }
+  }
+#endif
+  for (; idx < n; ++idx) {
+    if (int d = Fold_Case(lhs[idx]) - Fold_Case(rhs[idx]); d) {
+      return d;
+    }
+  }
+  return 0;
+}
+} // namespace
+/// @endcond
+
 int
 memcmp(std::string_view const &lhs, std::string_view const &rhs)
 {
@@ -62,11 +294,23 @@ strcasecmp(const std::string_view &lhs, const std::string_view &rhs)
     return 0;
   }
 
-  int r = ::strncasecmp(lhs.data(), rhs.data(), n);
+  int r = Compare_NoCase(lhs.data(), rhs.data(), n);
 
   return r ? r : zret;
 }
 
+bool
+TextView::starts_with_nocase(std::string_view const &prefix) const
+{
+  return this->size() >= prefix.size() && 0 == Compare_NoCase(this->data(), prefix.data(), prefix.size());
+}
+
+bool
+TextView::ends_with_nocase(std::string_view const &suffix) const
+{
+  return this->size() >= suffix.size() && 0 == Compare_NoCase(this->data_end() - suffix.size(), suffix.data(), suffix.size());
+}
+
 /// @cond INTERNAL_DETAIL
 const int8_t swoc::svtoi_convert[256] = {
   /* [can't do this nicely because clang format won't allow exdented comments]
@@ -91,12 +335,70 @@ const int8_t swoc::svtoi_convert[256] = {
 };
 /// @endcond
 
+#if defined(SWOC_SVTO_SWAR)
+/// @cond INTERNAL_DETAIL
+namespace
+{
+/** Convert up to 8 leading decimal digits in one step.
+ *
+ * @param src Text to convert, which must have at least 8 bytes.
+ * @param value [out] The value of the leading digits.
+ * @return The number of leading digits, which is the number converted.
+ *
+ * The 8 bytes are checked and converted in parallel in a single 64 bit word.
+ */
+unsigned
+Decimal_Block(char const *src, uint64_t &value)
+{
+  static constexpr uint64_t HIGH_NIBBLE = 0xF0F0F0F0F0F0F0F0;
+  uint64_t x;
+  memcpy(&x, src, sizeof(x));
+  // A byte is a digit iff its high nibble is 3 both before and after adding 6. A carry out of a
+  // non-digit byte can only corrupt the bytes after it, which are not used.
+  uint64_t check = (x & HIGH_NIBBLE) | (((x + 0x0606060606060606) & HIGH_NIBBLE) >> 4);
+  uint64_t miss  = check ^ 0x3333333333333333;
+  unsigned n     = miss ? __builtin_ctzll(miss) / 8 : 8;
+  if (n == 0) {
+    value = 0;
+    return 0;
+  }
+  // Keep only the digits, at the high end so the dropped bytes become leading zeros.
+  uint64_t v = (x - 0x3030303030303030) << (8 * (8 - n));
+  v          = (v * 10) + (v >> 8); // pairs of digits
+  v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+  value = v;
+  return n;
+}
+} // namespace
+/// @endcond
+
+swoc::detail::DecimalBlocks
+swoc::detail::svto_decimal_blocks(TextView src)
+{
+  static constexpr uint64_t SCALE[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+  DecimalBlocks zret{0, 0, false};
+  // Up to 16 digits, so there is no overflow.
+  while (src.size() >= 8 && zret._size + 8 <= std::numeric_limits<uintmax_t>::digits10) {
+    uint64_t block;
+    unsigned n  = Decimal_Block(src.data(), block);
+    zret._value = zret._value * SCALE[n] + block;
+    zret._size += n;
+    if (n < 8) {
+      zret._done_p = true;
+      break;
+    }
+    src.remove_prefix(n);
+  }
+  return zret;
+}
+#endif
+
 intmax_t
 swoc::svtoi(TextView src, TextView *out, int base)
 {
   intmax_t zret = 0;
 
-  if (src.ltrim_if(&isspace) && src) {
+  if (src.ltrim(TextView::WHITESPACE) && src) {
     TextView parsed;
     const char *start = src.data();
     bool neg          = false;
@@ -130,7 +432,7 @@ swoc::svtou(TextView src, TextView *out, int base)
   if (!(0 <= base && base <= 36)) {
     return 0;
   }
-  if (src.ltrim_if(&isspace).size()) {
+  if (src.ltrim(TextView::WHITESPACE).size()) {
     auto origin = src.data();
     int8_t v;
     // If base is 0, it wasn't specified - check for standard base prefixes
@@ -159,12 +461,11 @@ swoc::svtou(TextView src, TextView *out, int base)
       break;
     default:
       while (src.size() && (0 <= (v = svtoi_convert[static_cast<unsigned char>(*src)])) && v < base) {
-        auto n = zret * base + v;
-        if (n < zret) {
+        if (zret > (std::numeric_limits<uintmax_t>::max() - v) / base) {
           zret = std::numeric_limits<uintmax_t>::max();
           break; // overflow, stop parsing.
         }
-        zret = n;
+        zret = zret * base + v;
         ++src;
       }
       break;
@@ -177,6 +478,27 @@ swoc::svtou(TextView src, TextView *out, int base)
   return zret;
 }
 
+size_t
+swoc::svtoi_list(TextView &src, MemSpan<intmax_t> values, CharSet const &delimiters, int base)
+{
+  size_t n = 0;
+  while (n < values.count() && src.ltrim(TextView::WHITESPACE)) {
+    TextView parsed;
+    auto value = svtoi(src, &parsed, base);
+    if (parsed.empty()) {
+      break;
+    }
+    TextView rest{parsed.data_end(), src.data_end()};
+    // White space may itself be a delimiter, so check for a delimiter before skipping it.
+    if (rest && !delimiters.contains(*rest) && rest.ltrim(TextView::WHITESPACE) && !delimiters.contains(*rest)) {
+      break;
+    }
+    values[n++] = value;
+    src         = rest.remove_prefix(1);
+  }
+  return n;
+}
+
 // Do the template instantions.
 template std::ostream &swoc::TextView::stream_write(std::ostream &, const swoc::TextView &) const;
 
@@ -20,12 +20,17 @@
 
 #include <array>
 #include <cctype>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <ctime>
 #include <sys/param.h>
 #include <unistd.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "swoc/BufferWriter.h"
 #include "swoc/bwf_base.h"
 #include "swoc/bwf_ex.h"
@@ -56,6 +61,7 @@ namespace bwf
     _data['o'] = TYPE_CHAR | NUMERIC_TYPE_CHAR;
     _data['p'] = TYPE_CHAR;
     _data['P'] = TYPE_CHAR | UPPER_TYPE_CHAR;
+    _data['r'] = TYPE_CHAR;
     _data['s'] = TYPE_CHAR;
     _data['S'] = TYPE_CHAR | UPPER_TYPE_CHAR;
     _data['x'] = TYPE_CHAR | NUMERIC_TYPE_CHAR;
@@ -326,10 +332,76 @@ namespace bwf
   {
     char UPPER_DIGITS[]                                 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
     char LOWER_DIGITS[]                                 = "0123456789abcdefghijklmnopqrstuvwxyz";
-    static const std::array<uint64_t, 11> POWERS_OF_TEN = {
-      {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000, 10000000000}};
+    static constexpr std::array<uint64_t, 20> POWERS_OF_TEN = {{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                                                                 1000000000, 10000000000, 100000000000, 1000000000000,
+                                                                 10000000000000, 100000000000000, 1000000000000000,
+                                                                 10000000000000000, 100000000000000000, 1000000000000000000,
+                                                                 10000000000000000000ULL}};
+    /// Decimal digit pairs "00" .. "99", for converting two digits at a time.
+    static constexpr char DIGIT_PAIRS[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                          "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                          "8081828384858687888990919293949596979899";
+    /// Hexadecimal digit pairs for each byte value, lower and upper case.
+    struct HexPairs {
+      constexpr HexPairs(char const *digits) : _data()
+      {
+        for (unsigned i = 0; i < 256; ++i) {
+          _data[2 * i]     = digits[i >> 4];
+          _data[2 * i + 1] = digits[i & 0xF];
+        }
+      }
+      char _data[512];
+    };
+    static constexpr HexPairs LOWER_HEX_PAIRS{"0123456789abcdef"};
+    static constexpr HexPairs UPPER_HEX_PAIRS{"0123456789ABCDEF"};
   } // namespace
 
+  /** Number of decimal digits in @a n.
+   *
+   * This is computed from the bit width of @a n, which approximates the base 10 logarithm to
+   * within one, and then a single (branch free) comparison against a power of 10.
+   */
+  inline unsigned
+  Decimal_Digits(uint64_t n)
+  {
+    n          = n | 1; // zero has one digit, and clz is undefined on zero.
+    unsigned t = ((64 - __builtin_clzll(n)) * 1233) >> 12; // 1233 / 4096 ~ log10(2)
+    return t - (n < POWERS_OF_TEN[t]) + 1;
+  }
+
+  /** Decimal conversion.
+   *
+   * @param n Value to convert.
+   * @param buff Output buffer.
+   * @param width Size of @a buff.
+   * @return The number of digits.
+   *
+   * The digits are right justified in @a buff. This is specialized from @c To_Radix because it is
+   * extremely common - two digits are converted per division.
+   */
+  size_t
+  To_Decimal(uintmax_t n, char *buff, size_t width)
+  {
+    static_assert(sizeof(uintmax_t) == sizeof(uint64_t), "Decimal conversion requires 64 bit integers");
+    size_t zret = Decimal_Digits(n);
+    char *out   = buff + width;
+    while (n >= 100) {
+      auto r = (n % 100) * 2;
+      n /= 100;
+      out -= 2;
+      out[0] = DIGIT_PAIRS[r];
+      out[1] = DIGIT_PAIRS[r + 1];
+    }
+    if (n >= 10) {
+      out -= 2;
+      out[0] = DIGIT_PAIRS[n * 2];
+      out[1] = DIGIT_PAIRS[n * 2 + 1];
+    } else {
+      *--out = '0' + n;
+    }
+    return zret;
+  }
+
   /// Templated radix based conversions. Only a small number of radix are
   /// supported and providing a template minimizes cut and paste code while also
   /// enabling compiler optimizations (e.g. for power of 2 radix the modulo /
@@ -358,46 +430,46 @@ namespace bwf
     switch (align) {
     case Spec::Align::LEFT:
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       f();
       while (width-- > 0) {
-        w.write(fill);
+        w.put(fill);
       }
       break;
     case Spec::Align::RIGHT:
       while (width-- > 0) {
-        w.write(fill);
+        w.put(fill);
       }
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       f();
       break;
     case Spec::Align::CENTER:
       for (int i = width / 2; i > 0; --i) {
-        w.write(fill);
+        w.put(fill);
       }
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       f();
       for (int i = (width + 1) / 2; i > 0; --i) {
-        w.write(fill);
+        w.put(fill);
       }
       break;
     case Spec::Align::SIGN:
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       while (width-- > 0) {
-        w.write(fill);
+        w.put(fill);
       }
       f();
       break;
     default:
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       f();
       break;
@@ -444,7 +516,7 @@ namespace bwf
       break;
     default:
       prefix1 = 0;
-      n       = bwf::To_Radix<10>(i, buff, sizeof(buff), bwf::LOWER_DIGITS);
+      n       = bwf::To_Decimal(i, buff, sizeof(buff));
       break;
     }
     // Clip fill width by stuff that's already committed to be written.
@@ -463,25 +535,25 @@ namespace bwf
     if (spec._align == Spec::Align::SIGN) { // custom for signed case because
                                             // prefix and digits are seperated.
       if (neg) {
-        w.write(neg);
+        w.put(neg);
       }
       if (prefix1) {
-        w.write(prefix1);
+        w.put(prefix1);
         if (prefix2) {
-          w.write(prefix2);
+          w.put(prefix2);
         }
       }
       while (width-- > 0) {
-        w.write(spec._fill);
+        w.put(spec._fill);
       }
       w.write(digits);
     } else { // use generic Write_Aligned
       Write_Aligned(w,
                     [&]() {
                       if (prefix1) {
-                        w.write(prefix1);
+                        w.put(prefix1);
                         if (prefix2) {
-                          w.write(prefix2);
+                          w.put(prefix2);
                         }
                       }
                       w.write(digits);
@@ -491,12 +563,34 @@ namespace bwf
     return w;
   }
 
+  /** Format @a f as the shortest decimal string that converts back to the same value.
+   *
+   * If supported by the standard library this uses @c std::to_chars which has a Ryu style
+   * implementation. Otherwise 17 significant digits are used, which is sufficient to round trip
+   * but not shortest.
+   */
+  BufferWriter &
+  Format_Float_Shortest(BufferWriter &w, Spec const &spec, double f, char neg)
+  {
+    char buff[32];
+#if __cpp_lib_to_chars >= 201611L
+    size_t n = std::to_chars(buff, buff + sizeof(buff), f).ptr - buff;
+#else
+    size_t n = snprintf(buff, sizeof(buff), "%.17g", f);
+#endif
+    std::string_view digits{buff, n};
+    int width = static_cast<int>(spec._min) - static_cast<int>(n) - (neg ? 1 : 0);
+    Write_Aligned(w, [&]() { w.write(digits); }, spec._align, width, spec._fill, neg);
+    return w;
+  }
+
   /// Format for floating point values. Seperates floating point into a whole
   /// number and a fraction. The fraction is converted into an unsigned integer
   /// based on the specified precision, spec._prec. ie. 3.1415 with precision two
   /// is seperated into two unsigned integers 3 and 14. The different pieces are
   /// assembled and placed into the BufferWriter. The default is two decimal
-  /// places. ie. X.XX. The value is always written in base 10.
+  /// places. ie. X.XX. The value is always written in base 10. For the type 'r'
+  /// the value is written as the shortest string that reads back as the same value.
   ///
   /// format: whole.fraction
   ///     or: left.right
@@ -508,6 +602,19 @@ namespace bwf
     static const std::string_view zero_bwf{"0"};
     static const std::string_view subnormal_bwf{"subnormal"};
     static const std::string_view unknown_bwf{"unknown float"};
+    // Values at or above this are not representable as a whole number part.
+    static constexpr double WHOLE_LIMIT = 18446744073709551616.0; // 2^64
+
+    char neg = 0;
+    if (negative_p) {
+      neg = '-';
+    } else if (spec._sign != '-') {
+      neg = spec._sign;
+    }
+
+    if ('r' == spec._type && std::isfinite(f)) {
+      return Format_Float_Shortest(w, spec, f, neg);
+    }
 
     // Handle floating values that are not normal
     if (!std::isnormal(f)) {
@@ -533,45 +640,36 @@ namespace bwf
       return w;
     }
 
+    if (f >= WHOLE_LIMIT) {
+      return Format_Float_Shortest(w, spec, f, neg);
+    }
+
     uint64_t whole_part = static_cast<uint64_t>(f);
     if (whole_part == f || spec._prec == 0) { // integral
       return Format_Integer(w, spec, whole_part, negative_p);
     }
 
     static constexpr char dec = '.';
-    double frac;
-    size_t l = 0;
-    size_t r = 0;
-    char whole[std::numeric_limits<double>::digits10 + 1];
-    char fraction[std::numeric_limits<double>::digits10 + 1];
-    char neg               = 0;
+    char whole[std::numeric_limits<uint64_t>::digits10 + 1];
+    char fraction[std::numeric_limits<uint64_t>::digits10 + 1];
     int width              = static_cast<int>(spec._min);                          // amount left to fill.
     unsigned int precision = (spec._prec == Spec::DEFAULT._prec) ? 2 : spec._prec; // default precision 2
-
-    frac = f - whole_part; // split the number
-
-    if (negative_p) {
-      neg = '-';
-    } else if (spec._sign != '-') {
-      neg = spec._sign;
-    }
-
-    // Shift the floating point based on the precision. Used to convert
-    //  trailing fraction into an integer value.
-    uint64_t shift;
-    if (precision < POWERS_OF_TEN.size()) {
-      shift = POWERS_OF_TEN[precision];
-    } else { // not precomputed.
-      shift = POWERS_OF_TEN.back();
-      for (precision -= (POWERS_OF_TEN.size() - 1); precision > 0; --precision) {
-        shift *= 10;
-      }
+    // Digits past the last power of ten are always zero.
+    unsigned int frac_precision = std::min<unsigned int>(precision, POWERS_OF_TEN.size() - 1);
+
+    // Shift the fraction based on the precision to convert it to an integer value.
+    uint64_t shift     = POWERS_OF_TEN[frac_precision];
+    uint64_t frac_part = static_cast<uint64_t>((f - whole_part) * shift + 0.5 /* rounding */);
+    if (frac_part >= shift) { // rounded up to the next whole number.
+      frac_part -= shift;
+      ++whole_part;
     }
 
-    uint64_t frac_part = static_cast<uint64_t>(frac * shift + 0.5 /* rounding */);
-
-    l = bwf::To_Radix<10>(whole_part, whole, sizeof(whole), bwf::LOWER_DIGITS);
-    r = bwf::To_Radix<10>(frac_part, fraction, sizeof(fraction), bwf::LOWER_DIGITS);
+    size_t l = bwf::To_Decimal(whole_part, whole, sizeof(whole));
+    size_t r = bwf::To_Decimal(frac_part, fraction, sizeof(fraction));
+    // Leading zeros of the fraction are not generated by the integer conversion.
+    size_t lead_zeros  = frac_precision - r;
+    size_t trail_zeros = precision - frac_precision;
 
     // Clip fill width
     if (neg) {
@@ -579,7 +677,7 @@ namespace bwf
     }
     width -= static_cast<int>(l);
     --width; // '.'
-    width -= static_cast<int>(r);
+    width -= static_cast<int>(precision);
 
     std::string_view whole_digits{whole + sizeof(whole) - l, l};
     std::string_view frac_digits{fraction + sizeof(fraction) - r, r};
@@ -587,8 +685,14 @@ namespace bwf
     Write_Aligned(w,
                   [&]() {
                     w.write(whole_digits);
-                    w.write(dec);
+                    w.put(dec);
+                    for (auto n = lead_zeros; n > 0; --n) {
+                      w.put('0');
+                    }
                     w.write(frac_digits);
+                    for (auto n = trail_zeros; n > 0; --n) {
+                      w.put('0');
+                    }
                   },
                   spec._align, width, spec._fill, neg);
 
@@ -600,15 +704,52 @@ namespace bwf
    * @param w Output buffer.
    * @param view Input data.
    * @param digits Digit array for hexadecimal digits.
+   *
+   * For the standard digit arrays the conversion is done in blocks, 16 bytes at a time with SSE2
+   * if available and otherwise one byte at a time via lookup table.
    */
   void
   Format_As_Hex(BufferWriter &w, std::string_view view, const char *digits)
   {
     const char *ptr = view.data();
-    for (auto n = view.size(); n > 0; --n) {
-      char c = *ptr++;
-      w.write(digits[(c >> 4) & 0xF]);
-      w.write(digits[c & 0xf]);
+    auto n          = view.size();
+    if (digits == LOWER_DIGITS || digits == UPPER_DIGITS) {
+      static constexpr size_t BLOCK = 16;
+      char buff[BLOCK * 2];
+#if defined(__SSE2__)
+      // Convert each nibble to '0' + nibble, then add the offset for values past 9 to get to 'a'.
+      auto const mask  = _mm_set1_epi8(0xF);
+      auto const nine  = _mm_set1_epi8(9);
+      auto const zero  = _mm_set1_epi8('0');
+      auto const alpha = _mm_set1_epi8(digits[10] - '0' - 10);
+      auto to_hex      = [&](__m128i v) { return _mm_add_epi8(_mm_add_epi8(v, zero), _mm_and_si128(_mm_cmpgt_epi8(v, nine), alpha)); };
+      for (; n >= BLOCK; n -= BLOCK, ptr += BLOCK) {
+        auto data = _mm_loadu_si128(reinterpret_cast<__m128i const *>(ptr));
+        auto hi   = to_hex(_mm_and_si128(_mm_srli_epi16(data, 4), mask));
+        auto lo   = to_hex(_mm_and_si128(data, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(buff), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(buff + BLOCK), _mm_unpackhi_epi8(hi, lo));
+        w.write(std::string_view{buff, sizeof(buff)});
+      }
+#endif
+      auto const &pairs = digits == LOWER_DIGITS ? LOWER_HEX_PAIRS : UPPER_HEX_PAIRS;
+      while (n > 0) {
+        auto k = std::min(n, BLOCK);
+        for (size_t i = 0; i < k; ++i) {
+          auto c          = static_cast<uint8_t>(ptr[i]) * 2;
+          buff[2 * i]     = pairs._data[c];
+          buff[2 * i + 1] = pairs._data[c + 1];
+        }
+        w.write(std::string_view{buff, k * 2});
+        n -= k;
+        ptr += k;
+      }
+    } else {
+      for (; n > 0; --n) {
+        char c = *ptr++;
+        w.put(digits[(c >> 4) & 0xF]);
+        w.put(digits[c & 0xf]);
+      }
     }
   }
 
@@ -643,6 +784,107 @@ namespace bwf
     }
   }
 
+  void
+  CompactFormat::Item::pack(Spec const &spec, std::string_view text)
+  {
+    if (spec._min >= MAX_UNLIMITED || spec._prec > std::numeric_limits<int8_t>::max() ||
+        spec._idx > std::numeric_limits<int8_t>::max() || spec._name.size() > MAX_TEXT || spec._ext.size() > MAX_TEXT ||
+        (spec._max != std::numeric_limits<unsigned>::max() && spec._max >= MAX_UNLIMITED)) {
+      throw std::length_error("Format specifier value too large for compact format");
+    }
+    _fill  = spec._fill;
+    _sign  = spec._sign;
+    _type  = spec._type;
+    _flags = static_cast<uint8_t>(spec._align) | (spec._radix_lead_p ? RADIX_LEAD : 0);
+    _min   = spec._min;
+    _max   = spec._max == std::numeric_limits<unsigned>::max() ? MAX_UNLIMITED : spec._max;
+    _prec  = spec._prec;
+    _idx   = spec._idx;
+    // Literals are stored in the extension, move that to the name slot so the name is not lost.
+    auto name = spec._type == Spec::LITERAL_TYPE ? spec._ext : spec._name;
+    _name     = name.data() - text.data();
+    _name_len = name.size();
+    _ext      = spec._type == Spec::LITERAL_TYPE ? 0 : spec._ext.data() - text.data();
+    _ext_len  = spec._type == Spec::LITERAL_TYPE ? 0 : spec._ext.size();
+  }
+
+  Spec
+  CompactFormat::Item::unpack(char const *text) const
+  {
+    Spec zret;
+    zret._fill         = _fill;
+    zret._sign         = _sign;
+    zret._type         = _type;
+    zret._align        = static_cast<Spec::Align>(_flags & ALIGN_MASK);
+    zret._radix_lead_p = _flags & RADIX_LEAD;
+    zret._min          = _min;
+    zret._max          = _max == MAX_UNLIMITED ? std::numeric_limits<unsigned>::max() : _max;
+    zret._prec         = _prec;
+    zret._idx          = _idx;
+    if (_type == Spec::LITERAL_TYPE) {
+      zret._ext = std::string_view{text + _name, _name_len};
+    } else {
+      zret._name = std::string_view{text + _name, _name_len};
+      zret._ext  = std::string_view{text + _ext, _ext_len};
+    }
+    return zret;
+  }
+
+  void
+  CompactFormat::assign(MemSpan<char> storage, TextView fmt)
+  {
+    if (fmt.size() > storage.size()) {
+      throw std::length_error("Format string too large for compact format storage");
+    }
+    memcpy(storage.data(), fmt.data(), fmt.size());
+    _size  = fmt.size();
+    _count = 0;
+
+    // Parse the copy so the views in the specifiers are in to the storage.
+    std::string_view text{storage.data(), fmt.size()};
+    auto offset    = std::min(storage.size(), items_offset(_size));
+    auto items     = reinterpret_cast<Item *>(storage.data() + offset);
+    size_t n_items = (storage.size() - offset) / sizeof(Item); // only complete items.
+    auto ex{Format::bind(text)};
+    auto add = [&](Spec const &spec) -> void {
+      if (_count >= n_items) {
+        throw std::length_error("Format string too large for compact format storage");
+      }
+      items[_count++].pack(spec, text);
+    };
+
+    Spec lit_spec;
+    lit_spec._type = Spec::LITERAL_TYPE;
+    while (ex) {
+      std::string_view literal_v;
+      Spec spec;
+      bool spec_p = ex(literal_v, spec);
+
+      while (literal_v.size()) {
+        lit_spec._ext = literal_v.substr(0, Item::MAX_TEXT);
+        literal_v.remove_prefix(lit_spec._ext.size());
+        add(lit_spec);
+      }
+      if (spec_p) {
+        add(spec);
+      }
+    }
+  }
+
+  bool
+  CompactFormat::Extractor::operator()(std::string_view &literal_v, Spec &spec)
+  {
+    literal_v = {};
+    if (_idx < _count && _items[_idx]._type == Spec::LITERAL_TYPE) {
+      literal_v = _items[_idx++].unpack(_text)._ext;
+    }
+    if (_idx < _count && _items[_idx]._type != Spec::LITERAL_TYPE) {
+      spec = _items[_idx++].unpack(_text);
+      return true;
+    }
+    return false;
+  }
+
   NameBinding::~NameBinding() {}
 } // namespace bwf
 
@@ -679,8 +921,8 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, bwf::HexDump const &hex)
 
   int width = int(spec._min) - hex._view.size() * 2; // amount left to fill.
   if (spec._radix_lead_p) {
-    w.write('0');
-    w.write(fmt_type);
+    w.put('0');
+    w.put(fmt_type);
     width -= 2;
   }
   bwf::Write_Aligned(w, [&w, &hex, digits]() { bwf::Format_As_Hex(w, hex._view, digits); }, spec._align, width, spec._fill, 0);
@@ -697,10 +939,10 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, MemSpan<void> const &span)
     bool space_p = false;
     while (view) {
       if (space_p)
-        w.write(' ');
+        w.put(' ');
       space_p = true;
       if (spec._radix_lead_p) {
-        w.write('0').write(digits[33]);
+        w.put('0').put(digits[33]);
       }
       bwf::Format_As_Hex(w, view.prefix(block), digits);
       view.remove_prefix(block);
@@ -870,7 +1112,7 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, bwf::Errno const &e)
     w.write(short_name(e._e));
     w.write(strerror(e._e));
     if (spec._type != 's' && spec._type != 'S') {
-      w.write(' ');
+      w.put(' ');
       w.print(number_fmt, e._e);
     }
   }
@@ -879,39 +1121,154 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, bwf::Errno const &e)
 
 bwf::Date::Date(std::string_view fmt) : _epoch(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())), _fmt(fmt) {}
 
+namespace
+{
+/** Per thread cache of rendered dates.
+ *
+ * Time stamps are usually printed many times per second with the same format, and so the text
+ * changes at most once a second. Each entry caches the broken down time for the current minute
+ * and the text for the current second. When the second changes, if the only difference in the
+ * output is in two digit seconds fields (e.g. "%S" or "%T") those digits are updated in place,
+ * otherwise the text is rendered again from the cached broken down time. The time is converted
+ * only when the minute changes.
+ */
+struct DateCache {
+  static constexpr size_t N_ENTRIES = 4;    ///< Number of cached formats.
+  static constexpr size_t MAX_PATCH = 4;    ///< Maximum number of seconds fields to update in place.
+  static constexpr size_t INIT_TEXT = 256;     ///< Initial rendered text size.
+  static constexpr size_t MAX_TEXT  = 1 << 16; ///< Maximum rendered text size.
+  static constexpr time_t INVALID   = std::numeric_limits<time_t>::min(); ///< Invalid time.
+
+  struct Entry {
+    std::string _fmt;                  ///< Format string.
+    bool _local_p = false;             ///< Local time instead of GMT.
+    long _tz      = 0;                 ///< Time zone offset, for local time.
+    time_t _minute = INVALID;          ///< Start of the minute for @a _tm.
+    time_t _second = INVALID;          ///< Epoch time for @a _text.
+    struct tm _tm;                     ///< Broken down time for @a _minute.
+    std::string _text;                 ///< Rendered text.
+    std::array<size_t, MAX_PATCH> _patch; ///< Offsets of the seconds fields in @a _text.
+    size_t _n_patch = 0;               ///< Number of seconds fields.
+    bool _patch_p   = false;           ///< Seconds can be updated in place.
+  };
+
+  /** Render @a epoch with @a fmt.
+   *
+   * @param fmt Format string, which must be null terminated.
+   * @param local_p Use local time.
+   * @param epoch Time to render.
+   * @return The rendered text, valid until the next call.
+   */
+  std::string_view render(std::string_view fmt, bool local_p, time_t epoch);
+
+  /// Render the current broken down time in @a e to @a text.
+  static void strftime(Entry &e, std::string &text);
+
+  std::array<Entry, N_ENTRIES> _entries; ///< Cached formats.
+  unsigned _next = 0;                    ///< Next entry to replace.
+  std::string _last;                     ///< Text for the end of the minute.
+};
+
+thread_local DateCache Date_Cache;
+
+void
+DateCache::strftime(Entry &e, std::string &text)
+{
+  // @c strftime returns 0 if the text doesn't fit, which is the same as for empty text, so the
+  // buffer is grown up to the limit before the text is taken as empty.
+  size_t size = std::max(text.capacity(), INIT_TEXT);
+  size_t n;
+  text.resize(size);
+  while (0 == (n = ::strftime(text.data(), size, e._fmt.c_str(), &e._tm)) && !e._fmt.empty() && size < MAX_TEXT) {
+    size *= 2;
+    text.resize(size);
+  }
+  text.resize(n);
+}
+
+std::string_view
+DateCache::render(std::string_view fmt, bool local_p, time_t epoch)
+{
+  long tz  = local_p ? ::timezone : 0;
+  Entry *e = nullptr;
+  for (auto &entry : _entries) {
+    if (entry._local_p == local_p && entry._tz == tz && entry._fmt == fmt) {
+      e = &entry;
+      break;
+    }
+  }
+  if (nullptr == e) {
+    e           = &_entries[_next++ % N_ENTRIES];
+    e->_fmt     = fmt;
+    e->_local_p = local_p;
+    e->_tz      = tz;
+    e->_minute  = INVALID;
+  }
+
+  time_t minute = epoch - (epoch % 60 + 60) % 60;
+  if (e->_minute != minute) {
+    if (local_p) {
+      localtime_r(&minute, &e->_tm);
+    } else {
+      gmtime_r(&minute, &e->_tm);
+    }
+    e->_minute = minute;
+    e->_second = INVALID;
+    // Render at the start and end of the minute - if these differ only in a seconds field, that
+    // can be updated in place for the other seconds.
+    e->_tm.tm_sec = 59;
+    strftime(*e, _last);
+    std::string_view last{_last};
+    e->_tm.tm_sec = 0;
+    strftime(*e, e->_text);
+    e->_second  = minute;
+    e->_n_patch = 0;
+    e->_patch_p = e->_text.size() == last.size();
+    for (size_t i = 0; e->_patch_p && i < last.size(); ++i) {
+      if (e->_text[i] != last[i]) {
+        if (e->_n_patch < MAX_PATCH && i + 1 < last.size() && e->_text.compare(i, 2, "00") == 0 && last.substr(i, 2) == "59") {
+          e->_patch[e->_n_patch++] = i++;
+        } else {
+          e->_patch_p = false;
+        }
+      }
+    }
+  }
+
+  if (e->_second != epoch) {
+    int sec = epoch - minute;
+    if (e->_patch_p) {
+      for (size_t i = 0; i < e->_n_patch; ++i) {
+        e->_text[e->_patch[i]]     = '0' + sec / 10;
+        e->_text[e->_patch[i] + 1] = '0' + sec % 10;
+      }
+    } else {
+      e->_tm.tm_sec = sec;
+      strftime(*e, e->_text);
+    }
+    e->_second = epoch;
+  }
+  return e->_text;
+}
+
+} // namespace
+
 BufferWriter &
 bwformat(BufferWriter &w, bwf::Spec const &spec, bwf::Date const &date)
 {
   if (spec.has_numeric_type()) {
     bwformat(w, spec, date._epoch);
   } else {
-    struct tm t;
-    auto r = w.remaining();
-    size_t n{0};
     // Verify @a fmt is null terminated, even outside the bounds of the view.
     if (date._fmt.data()[date._fmt.size() - 1] != 0 && date._fmt.data()[date._fmt.size()] != 0) {
       throw(std::invalid_argument{"BWF Date String is not null terminated."});
     }
-    // Get the time, GMT or local if specified.
-    if (spec._ext == "local"sv) {
-      localtime_r(&date._epoch, &t);
-    } else {
-      gmtime_r(&date._epoch, &t);
-    }
-    // Try a direct write, faster if it works.
-    if (r > 0) {
-      n = strftime(w.aux_data(), r, date._fmt.data(), &t);
-    }
-    if (n > 0) {
-      w.commit(n);
-    } else {
-      // Direct write didn't work. Unfortunately need to write to a temporary
-      // buffer or the sizing isn't correct if @a w is clipped because @c
-      // strftime returns 0 if the buffer isn't large enough.
-      char buff[256]; // hope for the best - no real way to resize appropriately on failure.
-      n = strftime(buff, sizeof(buff), date._fmt.data(), &t);
-      w.write(buff, n);
+    auto fmt = date._fmt;
+    if (fmt.size() && fmt.back() == 0) {
+      fmt.remove_suffix(1);
     }
+    // Get the time, GMT or local if specified.
+    w.write(Date_Cache.render(fmt, spec._ext == "local"sv, date._epoch));
   }
   return w;
 }
@@ -974,7 +1331,7 @@ bwformat(BufferWriter &w, bwf::Spec const &spec, IpAddr const &addr)
   if (family_p) {
     local_spec._min = 0;
     if (addr_p) {
-      w.write(' ');
+      w.put(' ');
     }
     if (spec.has_numeric_type()) {
       bwformat(w, local_spec, static_cast<uintmax_t>(addr.family()));
@@ -1011,7 +1368,7 @@ bwformat(swoc::BufferWriter &w, swoc::bwf::Spec const &spec, error_code const &e
   } else {
     w.write(ec.message());
     if (spec._type != 's' && spec._type != 'S') {
-      w.write(' ');
+      w.put(' ');
       w.print(number_fmt, ec.value());
     }
   }
@@ -18,6 +18,9 @@
   the License.
  */
 
+#include <array>
+#include <cstring>
+
 #include "swoc/swoc_ip.h"
 #include "swoc/bwf_ip.h"
 
@@ -42,6 +45,110 @@ family_name(sa_family_t family)
   }
 }
 
+/// Decimal text for an octet.
+struct OctetText {
+  char _text[3]; ///< Digits, left justified.
+  uint8_t _size; ///< Number of digits.
+};
+
+/// Text for every octet value, for formatting IPv4 addresses without division.
+constexpr std::array<OctetText, 256> Octet_Text = [] {
+  std::array<OctetText, 256> zret{};
+  for (unsigned i = 0; i < zret.size(); ++i) {
+    auto &t = zret[i];
+    if (i >= 100) {
+      t._text[t._size++] = '0' + i / 100;
+    }
+    if (i >= 10) {
+      t._text[t._size++] = '0' + i / 10 % 10;
+    }
+    t._text[t._size++] = '0' + i % 10;
+  }
+  return zret;
+}();
+
+/** Check if @a spec formats address elements the same as plain numbers.
+ *
+ * @param spec Format specifier.
+ * @param types The element types which are the same as the default.
+ * @return @c true if the address can be formatted without a per element specifier.
+ *
+ * An extension with '=' sets a fill for the elements and so needs the general formatting.
+ */
+bool
+is_plain_spec(swoc::bwf::Spec const &spec, std::string_view types)
+{
+  auto ext = spec._ext;
+  return !(ext.size() && (ext[0] == '=' || (ext.size() > 1 && ext[1] == '='))) && !spec._radix_lead_p &&
+         spec._sign != swoc::bwf::Spec::SIGN_ALWAYS && (spec._type == swoc::bwf::Spec::DEFAULT_TYPE || types.find(spec._type) != types.npos);
+}
+
+/// Write an IPv4 address in @a host order to @a w.
+void
+write_ip4(swoc::BufferWriter &w, in_addr_t host)
+{
+  char buff[16];
+  char *spot = buff;
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    auto const &t = Octet_Text[host >> shift & 0xFF];
+    memcpy(spot, t._text, sizeof(t._text));
+    spot += t._size;
+    *spot++ = '.';
+  }
+  w.write(std::string_view(buff, spot - buff - 1));
+}
+
+/** Write an IPv6 address to @a w.
+ *
+ * @param w Output.
+ * @param addr Address, in network order.
+ * @param digits Hexadecimal digits to use.
+ *
+ * The longest run of at least two zero quads is compressed, the first if there is more than one.
+ */
+void
+write_ip6(swoc::BufferWriter &w, in6_addr const &addr, char const *digits)
+{
+  unsigned quad[8];
+  int lower = -1; // first quad in the compressed run.
+  int upper = -1; // last quad in the compressed run.
+  int best  = 1;  // size of the compressed run, it must be longer than this.
+  int run   = 0;  // size of the current zero run.
+  for (int i = 0; i < 8; ++i) {
+    quad[i] = addr.s6_addr[2 * i] << 8 | addr.s6_addr[2 * i + 1];
+    run     = quad[i] ? 0 : run + 1;
+    if (run > best) {
+      best  = run;
+      lower = i - run + 1;
+      upper = i;
+    }
+  }
+
+  char buff[40];
+  char *spot = buff;
+  for (int i = 0; i < 8; ++i) {
+    if (lower <= i && i <= upper) {
+      if (i == 0) {
+        *spot++ = ':';
+      }
+      if (i == upper) {
+        *spot++ = ':';
+      }
+    } else {
+      unsigned q = quad[i];
+      int n      = 1 + (q >= 0x10) + (q >= 0x100) + (q >= 0x1000);
+      for (int k = n - 1; k >= 0; --k, q >>= 4) {
+        spot[k] = digits[q & 0xF];
+      }
+      spot += n;
+      if (i != 7) {
+        *spot++ = ':';
+      }
+    }
+  }
+  w.write(std::string_view(buff, spot - buff));
+}
+
 } // namespace
 
 namespace swoc
@@ -52,6 +159,11 @@ BufferWriter &
 bwformat(BufferWriter &w, Spec const &spec, IP4Addr const& addr)
 {
   in_addr_t host = addr.host_order();
+  if (is_plain_spec(spec, "d"_sv)) {
+    write_ip4(w, host);
+    return w;
+  }
+
   Spec local_spec{spec}; // Format for address elements.
   bool align_p = false;
 
@@ -73,11 +185,11 @@ bwformat(BufferWriter &w, Spec const &spec, IP4Addr const& addr)
   }
 
   bwformat(w, local_spec, static_cast<uint8_t>(host >> 24 & 0xFF));
-  w.write('.');
+  w.put('.');
   bwformat(w, local_spec, static_cast<uint8_t>(host >> 16 & 0xFF));
-  w.write('.');
+  w.put('.');
   bwformat(w, local_spec, static_cast<uint8_t>(host >> 8 & 0xFF));
-  w.write('.');
+  w.put('.');
   bwformat(w, local_spec, static_cast<uint8_t>(host & 0xFF));
   return w;
 }
@@ -86,6 +198,11 @@ BufferWriter &
 bwformat(BufferWriter &w, Spec const &spec, in6_addr const &addr)
 {
   using QUAD = uint16_t const;
+  if (is_plain_spec(spec, "xX"_sv)) {
+    write_ip6(w, addr, spec._type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef");
+    return w;
+  }
+
   Spec local_spec{spec}; // Format for address elements.
   uint8_t const *ptr   = addr.s6_addr;
   uint8_t const *limit = ptr + sizeof(addr.s6_addr);
@@ -134,16 +251,16 @@ bwformat(BufferWriter &w, Spec const &spec, in6_addr const &addr)
   for (; ptr < limit; ptr += 2) {
     if (reinterpret_cast<uint8_t const *>(lower) <= ptr && ptr <= reinterpret_cast<uint8_t const *>(upper)) {
       if (ptr == addr.s6_addr) {
-        w.write(':'); // only if this is the first quad.
+        w.put(':'); // only if this is the first quad.
       }
       if (ptr == reinterpret_cast<uint8_t const *>(upper)) {
-        w.write(':');
+        w.put(':');
       }
     } else {
       uint16_t f = (ptr[0] << 8) + ptr[1];
       bwformat(w, local_spec, f);
       if (ptr != limit - 2) {
-        w.write(':');
+        w.put(':');
       }
     }
   }
@@ -193,7 +310,7 @@ bwformat(BufferWriter &w, Spec const &spec, IPAddr const &addr)
   if (family_p) {
     local_spec._min = 0;
     if (addr_p) {
-      w.write(' ');
+      w.put(' ');
     }
     if (spec.has_numeric_type()) {
       bwformat(w, local_spec, static_cast<uintmax_t>(addr.family()));
@@ -257,7 +374,7 @@ bwformat(BufferWriter &w, Spec const &spec, sockaddr const *addr)
       break;
     case AF_INET6:
       if (port_p) {
-        w.write('[');
+        w.put('[');
         bracket_p = true; // take a note - put in the trailing bracket.
       }
       bwformat(w, spec, reinterpret_cast<sockaddr_in6 const *>(addr)->sin6_addr);
@@ -267,9 +384,9 @@ bwformat(BufferWriter &w, Spec const &spec, sockaddr const *addr)
       break;
     }
     if (bracket_p)
-      w.write(']');
+      w.put(']');
     if (port_p)
-      w.write(':');
+      w.put(':');
   }
   if (port_p) {
     if (local_numeric_fill_p) {
@@ -284,7 +401,7 @@ bwformat(BufferWriter &w, Spec const &spec, sockaddr const *addr)
   if (family_p) {
     local_spec._min = 0;
     if (addr_p || port_p)
-      w.write(' ');
+      w.put(' ');
     if (spec.has_numeric_type()) {
       bwformat(w, local_spec, static_cast<uintmax_t>(addr->sa_family));
     } else {
@@ -20,8 +20,19 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define SWOC_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
 #include "swoc/swoc_file.h"
 #include "swoc/bwf_base.h"
+#include "swoc/MemArena.h"
 
 using namespace swoc::literals;
 
@@ -123,11 +134,22 @@ namespace file
       if (0 != ::fstat(fd, &info)) {
         ec = std::error_code(errno, std::system_category());
       } else {
-        int n = info.st_size;
+        size_t n = info.st_size;
         zret.resize(n);
-        auto read_len = ::read(fd, const_cast<char *>(zret.data()), n);
-        if (read_len < n) {
-          ec = std::error_code(errno, std::system_category());
+        // Reads can be short, particularly for large files, so loop until done.
+        size_t read_len = 0;
+        while (read_len < n) {
+          auto r = ::read(fd, zret.data() + read_len, n - read_len);
+          if (r > 0) {
+            read_len += r;
+          } else if (r == 0) { // file shrank.
+            zret.resize(read_len);
+            break;
+          } else if (errno != EINTR) {
+            ec = std::error_code(errno, std::system_category());
+            zret.resize(read_len);
+            break;
+          }
         }
       }
       ::close(fd);
@@ -135,6 +157,598 @@ namespace file
     return zret;
   }
 
+  std::error_code
+  mapped_file::advise(int advice) const
+  {
+    if (_size && 0 != ::madvise(const_cast<char *>(_data), _size, advice)) {
+      return std::error_code(errno, std::system_category());
+    }
+    return {};
+  }
+
+  mapped_file &
+  mapped_file::clear()
+  {
+    if (_data) {
+      ::munmap(const_cast<char *>(_data), _size);
+      _data = nullptr;
+      _size = 0;
+    }
+    return *this;
+  }
+
+  mapped_file
+  load_mapped(const path &p, std::error_code &ec, int advice)
+  {
+    mapped_file zret;
+    int fd(::open(p.c_str(), O_RDONLY));
+    ec.clear();
+    if (fd < 0) {
+      ec = std::error_code(errno, std::system_category());
+    } else {
+      struct stat info;
+      if (0 != ::fstat(fd, &info)) {
+        ec = std::error_code(errno, std::system_category());
+      } else if (info.st_size > 0) { // mapping an empty file is an error, but it's not an error here.
+        size_t n = info.st_size;
+        void *mem = ::mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem == MAP_FAILED) {
+          ec = std::error_code(errno, std::system_category());
+        } else {
+          zret._data = static_cast<char const *>(mem);
+          zret._size = n;
+          zret.advise(advice); // only a hint, failure is harmless.
+        }
+      }
+      ::close(fd); // the mapping remains valid.
+    }
+    return zret;
+  }
+
+  line_reader::line_reader(size_t chunk_size) : _buff(new char[std::max<size_t>(chunk_size, 1)]), _capacity(std::max<size_t>(chunk_size, 1))
+  {
+  }
+
+  std::error_code
+  line_reader::open(path const &p)
+  {
+    this->close();
+    _fd = ::open(p.c_str(), O_RDONLY);
+    if (_fd < 0) {
+      _eof_p = true;
+      _ec    = std::error_code(errno, std::system_category());
+    } else {
+      ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    return _ec;
+  }
+
+  line_reader &
+  line_reader::close()
+  {
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+    _avail.clear();
+    _offset = 0;
+    _eof_p  = false;
+    _ec.clear();
+    return *this;
+  }
+
+  void
+  line_reader::fill()
+  {
+    size_t keep = _avail.size();
+    if (keep == _capacity) { // a single line fills the buffer, it must be enlarged.
+      std::unique_ptr<char[]> buff(new char[_capacity * 2]);
+      memcpy(buff.get(), _avail.data(), keep);
+      _buff = std::move(buff);
+      _capacity *= 2;
+    } else if (keep) {
+      memmove(_buff.get(), _avail.data(), keep);
+    }
+    _avail.assign(_buff.get(), keep);
+
+    while (true) {
+      auto r = ::pread(_fd, _buff.get() + keep, _capacity - keep, _offset);
+      if (r > 0) {
+        _offset += r;
+        _avail.assign(_buff.get(), keep + r);
+        break;
+      } else if (r == 0) {
+        _eof_p = true;
+        break;
+      } else if (errno != EINTR) {
+        _ec    = std::error_code(errno, std::system_category());
+        _eof_p = true;
+        break;
+      }
+    }
+  }
+
+  bool
+  line_reader::next(TextView &line, char delimiter)
+  {
+    while (true) {
+      if (auto n = _avail.find(delimiter); n != TextView::npos) {
+        line = _avail.prefix(n);
+        _avail.remove_prefix(n + 1);
+        return true;
+      }
+      if (_eof_p || _fd < 0) {
+        if (_avail.empty() || _ec) {
+          return false;
+        }
+        line = _avail; // last line, not terminated.
+        _avail.clear();
+        return true;
+      }
+      this->fill();
+    }
+  }
+
+  /* ------------------------------------------------------------------- */
+
+  namespace
+  {
+    // Operation identifiers, in the low bits of the request address in the completion tag.
+    enum : uint64_t { OP_OPEN = 0, OP_READ = 1, OP_CLOSE = 2, OP_MASK = 7 };
+
+    /// Largest single read, which is the limit for a @c read on Linux.
+    constexpr size_t MAX_READ = 0x7FFFF000;
+  } // namespace
+
+  struct async_loader::Request {
+    Request(path &&p, callback_type &&cb) : _path(std::move(p)), _cb(std::move(cb)) {}
+
+    path _path;                  ///< File to load.
+    callback_type _cb;           ///< Completion callback.
+    TextView _content;           ///< Contents.
+    std::error_code _ec;         ///< Error, if any.
+    int _fd           = -1;      ///< File descriptor, while open.
+    unsigned _pending = 0;       ///< Operations not yet complete.
+    bool _sized_p     = false;   ///< The size has been found and the buffer allocated.
+    bool _eof_p       = false;   ///< A read found the end of the file.
+    char *_buffer     = nullptr; ///< Content buffer.
+    size_t _size      = 0;       ///< Size of the file when opened.
+    size_t _read      = 0;       ///< Bytes read.
+    Request *_next = nullptr; ///< List link.
+    Request *_prev = nullptr; ///< List link.
+  };
+
+  auto
+  async_loader::Linkage::next_ptr(Request *req) -> Request *&
+  {
+    return req->_next;
+  }
+
+  auto
+  async_loader::Linkage::prev_ptr(Request *req) -> Request *&
+  {
+    return req->_prev;
+  }
+
+#if SWOC_HAVE_IO_URING
+  /// A minimal @c io_uring, without SQ polling.
+  struct async_loader::Ring {
+    int _fd             = -1;         ///< Ring file descriptor.
+    void *_sq_ptr       = MAP_FAILED; ///< Submission ring mapping.
+    size_t _sq_size     = 0;          ///< Size of @a _sq_ptr.
+    void *_cq_ptr       = MAP_FAILED; ///< Completion ring mapping, if separate.
+    size_t _cq_size     = 0;          ///< Size of @a _cq_ptr.
+    io_uring_sqe *_sqes = nullptr;    ///< Submission entries.
+    size_t _sqes_size   = 0;          ///< Size of @a _sqes.
+
+    unsigned *_sq_tail  = nullptr;    ///< Submission ring tail.
+    unsigned *_sq_head  = nullptr;    ///< Submission ring head.
+    unsigned *_sq_array = nullptr;    ///< Submission index array.
+    unsigned _sq_mask   = 0;          ///< Submission ring mask.
+    unsigned *_cq_head  = nullptr;    ///< Completion ring head.
+    unsigned *_cq_tail  = nullptr;    ///< Completion ring tail.
+    io_uring_cqe *_cqes = nullptr;    ///< Completion entries.
+    unsigned _cq_mask   = 0;          ///< Completion ring mask.
+    unsigned _to_submit = 0;          ///< Entries added since the last submit.
+
+    ~Ring();
+
+    /// @return A ring with at least @a entries, or @c nullptr if @c io_uring or a required operation is not available.
+    static std::unique_ptr<Ring> make(unsigned entries);
+
+    /// @return A cleared submission entry for @a op with @a tag.
+    io_uring_sqe *sqe(uint8_t op, uint64_t tag);
+
+    /// Submit new entries and wait for @a min_complete completions.
+    int enter(unsigned min_complete);
+
+    /// Invoke @a f on the tag and result of each completion.
+    template <typename F> void reap(F &&f);
+  };
+
+  async_loader::Ring::~Ring()
+  {
+    if (_sqes) {
+      ::munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ptr != MAP_FAILED) {
+      ::munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+      ::munmap(_sq_ptr, _sq_size);
+    }
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  auto
+  async_loader::Ring::make(unsigned entries) -> std::unique_ptr<Ring>
+  {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = ::syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<Ring> ring{new Ring};
+    ring->_fd = fd;
+
+    // Check the operations are supported, which requires kernel 5.6 or later.
+    static constexpr unsigned N_PROBE_OPS = 256;
+    std::unique_ptr<char[]> probe_buff{new char[sizeof(io_uring_probe) + N_PROBE_OPS * sizeof(io_uring_probe_op)]()};
+    auto probe = reinterpret_cast<io_uring_probe *>(probe_buff.get());
+    if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, N_PROBE_OPS) < 0) {
+      return nullptr;
+    }
+    for (unsigned op : {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE}) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+        return nullptr;
+      }
+    }
+
+    ring->_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      ring->_sq_size = std::max(ring->_sq_size, cq_size);
+    }
+    ring->_sq_ptr = ::mmap(nullptr, ring->_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->_sq_ptr == MAP_FAILED) {
+      return nullptr;
+    }
+    char *cq = static_cast<char *>(ring->_sq_ptr);
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+      ring->_cq_size = cq_size;
+      ring->_cq_ptr  = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (ring->_cq_ptr == MAP_FAILED) {
+        return nullptr;
+      }
+      cq = static_cast<char *>(ring->_cq_ptr);
+    }
+    ring->_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes       = ::mmap(nullptr, ring->_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return nullptr;
+    }
+    ring->_sqes = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq          = static_cast<char *>(ring->_sq_ptr);
+    ring->_sq_head    = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    ring->_sq_tail    = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    ring->_sq_array   = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    ring->_sq_mask    = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    ring->_cq_head    = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    ring->_cq_tail    = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    ring->_cqes       = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    ring->_cq_mask    = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    return ring;
+  }
+
+  io_uring_sqe *
+  async_loader::Ring::sqe(uint8_t op, uint64_t tag)
+  {
+    // The caller limits the operations in flight to the ring size, so there is always room. The
+    // kernel reads the entry only on submit, so it can be filled after the tail is updated.
+    unsigned tail      = *_sq_tail;
+    unsigned idx       = tail & _sq_mask;
+    io_uring_sqe *zret = &_sqes[idx];
+    memset(zret, 0, sizeof(*zret));
+    zret->opcode    = op;
+    zret->user_data = tag;
+    _sq_array[idx]  = idx;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++_to_submit;
+    return zret;
+  }
+
+  int
+  async_loader::Ring::enter(unsigned min_complete)
+  {
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    int zret;
+    while ((zret = ::syscall(__NR_io_uring_enter, _fd, _to_submit, min_complete, flags, nullptr, 0)) < 0 && errno == EINTR) {
+    }
+    if (zret > 0) {
+      _to_submit -= std::min<unsigned>(zret, _to_submit);
+    }
+    return zret;
+  }
+
+  template <typename F>
+  void
+  async_loader::Ring::reap(F &&f)
+  {
+    unsigned head = *_cq_head;
+    unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      auto const &cqe = _cqes[head & _cq_mask];
+      f(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+  }
+#else
+  struct async_loader::Ring {
+    static std::unique_ptr<Ring>
+    make(unsigned)
+    {
+      return nullptr;
+    }
+  };
+#endif
+
+  async_loader::async_loader(MemArena &arena, unsigned depth) : _arena(arena), _depth(std::max(depth, 2U))
+  {
+    if (depth > 0) {
+      _ring = Ring::make(_depth);
+    }
+  }
+
+  async_loader::~async_loader()
+  {
+    while (auto req = _queued.take_head()) {
+      delete req;
+    }
+    // The kernel may still be writing to the contents, so the active loads must finish.
+    while (!_active.empty()) {
+#if SWOC_HAVE_IO_URING
+      ++_n_enter;
+      _ring->enter(_in_flight);
+      _ring->reap([this](uint64_t tag, int result) { this->complete(tag, result); });
+#endif
+    }
+    while (auto req = _done.take_head()) {
+      delete req;
+    }
+  }
+
+  async_loader &
+  async_loader::load(path p, callback_type &&cb)
+  {
+    _queued.append(new Request(std::move(p), std::move(cb)));
+    return *this;
+  }
+
+  int
+  async_loader::fd() const
+  {
+#if SWOC_HAVE_IO_URING
+    if (_ring) {
+      return _ring->_fd;
+    }
+#endif
+    return -1;
+  }
+
+  bool
+  async_loader::is_async() const
+  {
+    return _ring != nullptr;
+  }
+
+  size_t
+  async_loader::enter_count() const
+  {
+    return _n_enter;
+  }
+
+  void
+  async_loader::start()
+  {
+#if SWOC_HAVE_IO_URING
+    // A request has at most a read and a close in flight, so leave room for that for every request.
+    while (!_queued.empty() && 2 * (_active.count() + 1) <= _depth) {
+      auto req         = _queued.take_head();
+      auto open        = _ring->sqe(IORING_OP_OPENAT, reinterpret_cast<uint64_t>(req) | OP_OPEN);
+      open->fd         = AT_FDCWD;
+      open->addr       = reinterpret_cast<uint64_t>(req->_path.c_str());
+      open->open_flags = O_RDONLY | O_CLOEXEC;
+      req->_pending    = 1;
+      _in_flight      += 1;
+      _active.append(req);
+    }
+#endif
+  }
+
+  void
+  async_loader::complete(uint64_t tag, int result)
+  {
+    auto req = reinterpret_cast<Request *>(tag & ~OP_MASK);
+    --_in_flight;
+    --req->_pending;
+    // A close linked to a failed read is cancelled, and is not an error of its own.
+    if (result < 0 && result != -ECANCELED && !req->_ec) {
+      req->_ec = std::error_code(-result, std::system_category());
+    }
+    switch (tag & OP_MASK) {
+    case OP_OPEN:
+      if (result >= 0) {
+        req->_fd = result;
+      }
+      break;
+    case OP_READ:
+      if (result > 0) {
+        req->_read += result;
+      } else if (result == 0) { // file shrank.
+        req->_eof_p = true;
+      }
+      break;
+    case OP_CLOSE:
+      // The descriptor is released even if the close fails, but not if it was cancelled.
+      if (result != -ECANCELED) {
+        req->_fd = -1;
+      }
+      break;
+    }
+    if (req->_pending == 0) {
+      this->advance(req);
+    }
+  }
+
+  void
+  async_loader::advance(Request *req)
+  {
+#if SWOC_HAVE_IO_URING
+    if (req->_fd >= 0) {
+      auto tag = reinterpret_cast<uint64_t>(req);
+      if (!req->_sized_p) {
+        // The size is from the opened file, as the path may have been replaced since. This is
+        // cheaper done directly than as another round trip through the ring.
+        req->_sized_p = true;
+        struct stat info;
+        if (0 != ::fstat(req->_fd, &info)) {
+          req->_ec = std::error_code(errno, std::system_category());
+        } else if ((req->_size = info.st_size) > 0) {
+          req->_buffer = _arena.alloc(req->_size, 1).rebind<char>().data();
+        }
+      }
+      // The read and close are linked. A read that is short or fails cancels the close, and then
+      // the read continues at the new offset, or the file is closed here if the read is done.
+      if (!req->_ec && !req->_eof_p && req->_read < req->_size) {
+        auto read   = _ring->sqe(IORING_OP_READ, tag | OP_READ);
+        read->fd    = req->_fd;
+        read->addr  = reinterpret_cast<uint64_t>(req->_buffer + req->_read);
+        read->len   = std::min(req->_size - req->_read, MAX_READ);
+        read->off   = req->_read;
+        read->flags = IOSQE_IO_LINK;
+        auto close  = _ring->sqe(IORING_OP_CLOSE, tag | OP_CLOSE);
+        close->fd   = req->_fd;
+        req->_pending += 2;
+        _in_flight    += 2;
+        return;
+      }
+    }
+    req->_content.assign(req->_buffer, req->_ec ? 0 : req->_read);
+#endif
+    if (req->_fd >= 0) {
+      ::close(req->_fd);
+      req->_fd = -1;
+    }
+    _active.erase(req);
+    _done.append(req);
+  }
+
+  void
+  async_loader::load_sync(Request *req)
+  {
+    int fd = ::open(req->_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      req->_ec = std::error_code(errno, std::system_category());
+      return;
+    }
+    struct stat info;
+    if (0 != ::fstat(fd, &info)) {
+      req->_ec = std::error_code(errno, std::system_category());
+    } else if (size_t n = info.st_size; n > 0) {
+      auto span       = _arena.alloc(n, 1).rebind<char>();
+      size_t read_len = 0;
+      while (read_len < n) {
+        auto r = ::read(fd, span.data() + read_len, n - read_len);
+        if (r > 0) {
+          read_len += r;
+        } else if (r == 0) { // file shrank.
+          break;
+        } else if (errno != EINTR) {
+          req->_ec = std::error_code(errno, std::system_category());
+          break;
+        }
+      }
+      req->_content.assign(span.data(), req->_ec ? 0 : read_len);
+    }
+    ::close(fd);
+  }
+
+  void
+  async_loader::deliver()
+  {
+    while (auto req = _done.take_head()) {
+      std::unique_ptr<Request> guard{req};
+      req->_cb(req->_path, req->_content, req->_ec);
+    }
+  }
+
+  size_t
+  async_loader::submit()
+  {
+#if SWOC_HAVE_IO_URING
+    if (_ring) {
+      this->start();
+      if (_ring->_to_submit) {
+        ++_n_enter;
+        _ring->enter(0);
+      }
+    }
+#endif
+    return _queued.count() + _active.count();
+  }
+
+  size_t
+  async_loader::poll()
+  {
+    if (_ring) {
+#if SWOC_HAVE_IO_URING
+      // Reap first so that follow on operations and new loads go in the same submission.
+      _ring->reap([this](uint64_t tag, int result) { this->complete(tag, result); });
+      this->start();
+      if (_ring->_to_submit) {
+        ++_n_enter;
+        _ring->enter(0);
+      }
+#endif
+    } else {
+      while (auto req = _queued.take_head()) {
+        this->load_sync(req);
+        _done.append(req);
+      }
+    }
+    this->deliver();
+    return _queued.count() + _active.count();
+  }
+
+  async_loader &
+  async_loader::wait()
+  {
+    // Callbacks may queue more loads, so check again after delivering.
+    while (!_queued.empty() || !_active.empty() || !_done.empty()) {
+      if (_ring) {
+#if SWOC_HAVE_IO_URING
+        this->start();
+        if (_in_flight) {
+          ++_n_enter;
+          _ring->enter(_in_flight);
+          _ring->reap([this](uint64_t tag, int result) { this->complete(tag, result); });
+        }
+#endif
+      } else {
+        while (auto req = _queued.take_head()) {
+          this->load_sync(req);
+          _done.append(req);
+        }
+      }
+      this->deliver();
+    }
+    return *this;
+  }
+
 } // namespace file
 
 BufferWriter &
@@ -22,6 +22,10 @@
 #include "swoc/swoc_ip.h"
 #include "swoc/swoc_meta.h"
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 using swoc::TextView;
 using swoc::svtoi;
 using swoc::svtou;
@@ -50,6 +54,181 @@ Set_Sockaddr_Len(T *addr)
   Set_Sockaddr_Len_Case(addr, swoc::meta::CaseArg);
 }
 
+/** Classify the characters of an address.
+ *
+ * @tparam N Maximum number of characters, a multiple of 16.
+ * @param s Address text.
+ * @param n Number of characters in @a s, no more than @a N.
+ * @param sep Separator character.
+ * @param hex_p Accept hexadecimal digits if @c true, only decimal digits if @c false.
+ * @return Bit mask of separators, bit mask of separators and digits.
+ *
+ * Bit @c k in each mask corresponds to the character at index @c k.
+ */
+template <size_t N>
+std::pair<uint64_t, uint64_t>
+Classify_Address(char const *s, size_t n, char sep, bool hex_p)
+{
+  static_assert(N % 16 == 0 && N <= 64);
+  alignas(16) char buff[N] = {}; // Zero is neither a digit nor a separator.
+  memcpy(buff, s, n);
+  uint64_t seps  = 0;
+  uint64_t valid = 0;
+#if defined(__SSE2__)
+  auto const v_sep   = _mm_set1_epi8(sep);
+  auto const v_zero  = _mm_set1_epi8('0');
+  auto const v_nine  = _mm_set1_epi8(9);
+  auto const v_case  = _mm_set1_epi8(0x20);
+  auto const v_alpha = _mm_set1_epi8('a');
+  auto const v_five  = _mm_set1_epi8(5);
+  for (size_t i = 0; i < N; i += 16) {
+    auto v    = _mm_load_si128(reinterpret_cast<__m128i const *>(buff + i));
+    auto is_s = _mm_cmpeq_epi8(v, v_sep);
+    // Unsigned range checks - a byte is in [0, k] if it is unchanged by min with k.
+    auto d    = _mm_sub_epi8(v, v_zero);
+    auto ok   = _mm_or_si128(is_s, _mm_cmpeq_epi8(_mm_min_epu8(d, v_nine), d));
+    if (hex_p) {
+      auto x = _mm_sub_epi8(_mm_or_si128(v, v_case), v_alpha);
+      ok     = _mm_or_si128(ok, _mm_cmpeq_epi8(_mm_min_epu8(x, v_five), x));
+    }
+    seps  |= uint64_t(uint16_t(_mm_movemask_epi8(is_s))) << i;
+    valid |= uint64_t(uint16_t(_mm_movemask_epi8(ok))) << i;
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char c = buff[i];
+    if (c == static_cast<unsigned char>(sep)) {
+      seps  |= uint64_t(1) << i;
+      valid |= uint64_t(1) << i;
+    } else if ((c - '0') < 10u || (hex_p && ((c | 0x20) - 'a') < 6u)) {
+      valid |= uint64_t(1) << i;
+    }
+  }
+#endif
+  return {seps, valid};
+}
+
+/** Fast parse of a canonical dotted quad.
+ *
+ * @param text Address text.
+ * @param octets [out] Octets, in text order.
+ * @return @c true if @a text was parsed, @c false if it must be parsed by the general loader.
+ *
+ * Only exactly four octets of one to three digits are handled. This never fails an address the
+ * general loader would accept, it declines anything unusual so that the results are identical.
+ */
+bool
+Load_IP4_Fast(TextView text, uint8_t (&octets)[4])
+{
+  auto n = text.size();
+  if (n < 7 || n > 15) {
+    return false;
+  }
+  auto [dots, valid] = Classify_Address<16>(text.data(), n, '.', false);
+  uint64_t all       = (uint64_t(1) << n) - 1;
+  if (valid != all || __builtin_popcountll(dots) != 3) {
+    return false;
+  }
+  char const *s     = text.data();
+  unsigned start    = 0;
+  for (unsigned k = 0; k < 4; ++k) {
+    unsigned end = k < 3 ? __builtin_ctzll(dots) : n;
+    dots &= dots - 1;
+    unsigned x = 0;
+    switch (end - start) {
+    case 3:
+      x = (s[start] - '0') * 100 + (s[start + 1] - '0') * 10 + (s[start + 2] - '0');
+      if (x > 255) {
+        return false;
+      }
+      break;
+    case 2:
+      x = (s[start] - '0') * 10 + (s[start + 1] - '0');
+      break;
+    case 1:
+      x = s[start] - '0';
+      break;
+    default:
+      return false;
+    }
+    octets[k] = x;
+    start     = end + 1;
+  }
+  return true;
+}
+
+/** Fast parse of a canonical IPv6 address.
+ *
+ * @param text Address text.
+ * @param quads [out] Quads, in text order.
+ * @return @c true if @a text was parsed, @c false if it must be parsed by the general loader.
+ *
+ * Only colon separated quads of one to four hexadecimal digits with at most one "::" are handled,
+ * without brackets. As with @c Load_IP4_Fast anything unusual is declined rather than failed.
+ */
+bool
+Load_IP6_Fast(TextView text, uint16_t (&quads)[8])
+{
+  auto n = text.size();
+  if (n < 3 || n > 39) {
+    return false;
+  }
+  auto [colons, valid] = Classify_Address<48>(text.data(), n, ':', true);
+  if (valid != (uint64_t(1) << n) - 1) {
+    return false;
+  }
+
+  char const *s = text.data();
+  unsigned pos  = 0;
+  unsigned k    = 0;  // # of quads.
+  int empty_idx = -1; // Position of "::", in quads.
+  if (colons & 1) {
+    if ((colons & 0x6) != 0x2 || n == 3) { // Require exactly "::" followed by a quad, not "::1".
+      return false;
+    }
+    empty_idx = 0;
+    pos       = 2;
+  }
+  while (pos < n) {
+    uint64_t rest = colons >> pos;
+    unsigned len  = rest ? __builtin_ctzll(rest) : n - pos;
+    if (len == 0) { // Second colon of "::".
+      if (empty_idx >= 0) {
+        return false;
+      }
+      empty_idx = k;
+      ++pos;
+      continue;
+    }
+    if (len > 4 || k >= 8) {
+      return false;
+    }
+    unsigned x = 0;
+    for (unsigned i = pos, limit = pos + len; i < limit; ++i) {
+      unsigned char c = s[i];
+      x               = (x << 4) + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    quads[k++] = x;
+    pos += len;
+    if (pos < n && ++pos == n) { // Trailing single colon.
+      return false;
+    }
+  }
+
+  if (empty_idx < 0) {
+    return k == 8;
+  }
+  if (k > 7) {
+    return false;
+  }
+  // Shift the quads after "::" to the end and zero fill.
+  unsigned delta = 8 - k;
+  for (int i = 7; i >= empty_idx; --i) {
+    quads[i] = i >= int(empty_idx + delta) ? quads[i - delta] : 0;
+  }
+  return true;
+}
+
 } // namespace
 
 namespace swoc {
@@ -271,6 +450,14 @@ IP4Addr::load(std::string_view const&text) {
   TextView src{text};
   int n = SIZE; /// # of octets
 
+  if (uint8_t octets[SIZE]; Load_IP4_Fast(src, octets)) {
+    auto octet = reinterpret_cast<uint8_t *>(&_addr);
+    for (auto x : octets) {
+      octet[--n] = x;
+    }
+    return true;
+  }
+
   if (src.empty() || ('[' == *src && ((++src).empty() || src.back() != ']'))) {
     return false;
   }
@@ -300,6 +487,13 @@ IP6Addr::load(std::string_view const&str) {
   int empty_idx = -1;
   auto quad = _addr._quad.data();
 
+  if (uint16_t quads[N_QUADS]; Load_IP6_Fast(src, quads)) {
+    for (auto x : quads) {
+      quad[QUAD_IDX[n++]] = x;
+    }
+    return true;
+  }
+
   if (src && '[' == *src) {
     ++src;
     if (src.empty() || src.back() != ']') {
@@ -389,7 +583,7 @@ void IP6Addr::reorder(raw_type&dst, in6_addr const&src) {
 bool
 IPAddr::load(const std::string_view&text) {
   TextView src{text};
-  src.ltrim_if(&isspace);
+  src.ltrim(TextView::WHITESPACE);
 
   if (TextView::npos != src.prefix(5).find_first_of('.')) {
     _family = AF_INET;
@@ -214,7 +214,7 @@ TEST_CASE("MemArena example", "[libswoc][MemArena][example]")
   arena.clear();
 
   using Map = swoc::IntrusiveHashMap<Thing::Linkage>;
-  Map *ihm  = arena.make<Map>();
+  Map *ihm  = arena.make_managed<Map>(); // the map has a bucket vector that must be destroyed.
 
   {
     std::string key_1{"Key One"};
@@ -0,0 +1,149 @@
+/** @file
+
+    AtomTable unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "swoc/AtomTable.h"
+#include "swoc/bwf_base.h"
+#include "catch.hpp"
+
+using swoc::Atom;
+using swoc::AtomTable;
+using namespace std::literals;
+
+TEST_CASE("AtomTable", "[libswoc][AtomTable]")
+{
+  AtomTable table;
+
+  Atom nil;
+  REQUIRE_FALSE(nil);
+  REQUIRE(nil.view().empty());
+  REQUIRE(nil.c_str()[0] == '\0');
+  REQUIRE(nil.folded() == nil);
+
+  auto host = table.intern("Host");
+  REQUIRE(host);
+  REQUIRE(host.view() == "Host");
+  REQUIRE(host.size() == 4);
+  REQUIRE(host.c_str()[4] == '\0');
+  // The folded form is also interned.
+  REQUIRE(table.count() == 2);
+
+  std::string text{"Host"};
+  REQUIRE(table.intern(text) == host);
+  REQUIRE(table.intern(text).c_str() != text.c_str());
+  REQUIRE(table.count() == 2);
+
+  auto lower = table.intern("host");
+  REQUIRE(lower != host);
+  REQUIRE(host.folded() == lower);
+  REQUIRE(lower.folded() == lower);
+  REQUIRE(host.equal_nocase(lower));
+  REQUIRE(host.hash() == lower.hash());
+  REQUIRE(host.hash() == AtomTable::hash_of("HOST"));
+  REQUIRE(table.count() == 2);
+
+  auto upper = table.intern("HOST");
+  REQUIRE(upper.equal_nocase(host));
+  REQUIRE(upper.folded() == lower);
+  REQUIRE(table.count() == 3);
+
+  auto other = table.intern("Hosts");
+  REQUIRE_FALSE(other.equal_nocase(host));
+  REQUIRE(table.intern("") == table.intern(""sv));
+  REQUIRE(table.intern("").view().empty());
+
+  REQUIRE(table.find("HOST") == upper);
+  REQUIRE_FALSE(table.find("HoSt"));
+  auto n = table.count();
+  REQUIRE_FALSE(table.find("Missing"));
+  REQUIRE(table.count() == n);
+
+  // Atoms work as keys in standard containers, either exact or ignoring case.
+  std::unordered_set<Atom> exact{host, lower, upper, host};
+  REQUIRE(exact.size() == 3);
+  std::unordered_set<Atom, Atom::Hash, Atom::EqualNoCase> nocase{host, lower, upper, other};
+  REQUIRE(nocase.size() == 2);
+
+  // Many atoms, to expand the index.
+  std::vector<Atom> atoms;
+  std::string name;
+  for (unsigned i = 0; i < 2000; ++i) {
+    atoms.push_back(table.intern(swoc::bwprint(name, "Name-{}", i)));
+  }
+  bool match_p = true;
+  for (unsigned i = 0; i < 2000; ++i) {
+    match_p = match_p && table.intern(swoc::bwprint(name, "Name-{}", i)) == atoms[i] &&
+              table.intern(swoc::bwprint(name, "name-{}", i)) == atoms[i].folded();
+  }
+  REQUIRE(match_p);
+  REQUIRE(table.find("Host") == host);
+
+  auto generation = table.generation();
+  table.clear();
+  REQUIRE(table.generation() == generation + 1);
+  REQUIRE(table.count() == 0);
+  REQUIRE_FALSE(table.find("Host"));
+  auto next = table.intern("Host");
+  REQUIRE(next.view() == "Host");
+  REQUIRE(table.count() == 2);
+}
+
+TEST_CASE("AtomTable shared", "[libswoc][AtomTable]")
+{
+  static constexpr unsigned N_THREADS = 4;
+  static constexpr unsigned N_NAMES   = 500;
+
+  AtomTable table{AtomTable::SHARED};
+  std::vector<std::string> names(N_NAMES);
+  for (unsigned i = 0; i < N_NAMES; ++i) {
+    swoc::bwprint(names[i], "X-Header-{}", i);
+  }
+
+  // Every thread interns every name, in different orders, and must get the same atoms.
+  std::vector<std::vector<Atom>> results(N_THREADS, std::vector<Atom>(names.size()));
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < N_THREADS; ++t) {
+    threads.emplace_back([&, t]() {
+      for (unsigned round = 0; round < 3; ++round) {
+        for (unsigned k = 0; k < names.size(); ++k) {
+          auto idx        = (k * 7 + t * 131) % names.size();
+          results[t][idx] = table.intern(names[idx]);
+          table.find(names[(idx + 1) % names.size()]);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bool match_p = true;
+  for (unsigned idx = 0; idx < names.size(); ++idx) {
+    for (unsigned t = 0; t < N_THREADS; ++t) {
+      match_p = match_p && results[t][idx] == results[0][idx] && results[t][idx].view() == names[idx];
+    }
+  }
+  REQUIRE(match_p);
+  REQUIRE(table.count() == 2 * names.size());
+}
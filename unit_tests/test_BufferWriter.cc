@@ -18,10 +18,15 @@
     limitations under the License.
  */
 
+#include <cstdio>
 #include <cstring>
+#include <sstream>
+#include <unistd.h>
 #include "swoc/MemArena.h"
 #include "swoc/BufferWriter.h"
 #include "swoc/ArenaWriter.h"
+#include "swoc/FdWriter.h"
+#include "swoc/bwf_base.h"
 #include "catch.hpp"
 
 namespace
@@ -386,6 +391,163 @@ TEST_CASE("ArenaWriter print", "[BW][ArenaWriter]")
   REQUIRE(valid_p == true);
 }
 
+TEST_CASE("SegmentedArenaWriter", "[BW][ArenaWriter]")
+{
+  swoc::MemArena arena{256};
+  swoc::SegmentedArenaWriter aw{arena, 64};
+  REQUIRE(aw.extent() == 0);
+  REQUIRE(aw.segments().count() == 0);
+  REQUIRE(aw.view().empty());
+
+  std::string text;
+  std::array<char, 85> buffer;
+  swoc::TextView view{buffer.data(), buffer.size()};
+  for (char c = 'a'; c <= 'z'; ++c) {
+    memset(buffer.data(), c, buffer.size());
+    aw.write(view.substr(0, 40));
+    aw.print("{}{:>6}", view.substr(40), c);
+    text.append(buffer.data(), buffer.size());
+    text.append(5, ' ');
+    text += c;
+  }
+  REQUIRE(aw.extent() == text.size());
+  REQUIRE_FALSE(aw.error());
+
+  // Segments were not copied on growth.
+  auto segments = aw.segments();
+  REQUIRE(segments.count() > 1);
+  std::string gathered;
+  for (auto const &seg : segments) {
+    gathered.append(static_cast<char const *>(seg.iov_base), seg.iov_len);
+  }
+  REQUIRE(gathered == text);
+
+  // Discard and copy across segments.
+  auto first = segments[0].iov_len;
+  aw.copy(first - 2, first + 10, 4);
+  text.replace(first - 2, 4, text.substr(first + 10, 4));
+  aw.discard(text.size() - first - 5);
+  text.resize(first + 5);
+  aw.write("tail");
+  text += "tail";
+  REQUIRE(aw.extent() == text.size());
+  std::ostringstream out;
+  out << aw;
+  REQUIRE(out.str() == text);
+
+  // Flattening.
+  REQUIRE(aw.view() == text);
+  REQUIRE(aw.segments().count() == 1);
+  aw.write('!');
+  text += '!';
+  REQUIRE(aw.segments().count() == 2);
+  REQUIRE(aw.view() == text);
+}
+
+TEST_CASE("FdWriter", "[BW][FdWriter]")
+{
+  // Read back everything written to @a file.
+  auto contents = [](FILE *file) {
+    std::string zret;
+    char buff[256];
+    ::lseek(fileno(file), 0, SEEK_SET);
+    for (ssize_t n; (n = ::read(fileno(file), buff, sizeof(buff))) > 0;) {
+      zret.append(buff, n);
+    }
+    return zret;
+  };
+
+  std::string big(300, 'x'); // Larger than the buffer.
+  std::string tmp;
+  for (bool async_p : {false, true}) {
+    FILE *file = tmpfile();
+    REQUIRE(file != nullptr);
+    std::string text;
+    {
+      swoc::FdWriter w{fileno(file), swoc::FdWriter::MIN_BUFFER_SIZE, async_p};
+      REQUIRE(w.extent() == 0);
+      for (unsigned i = 0; i < 200; ++i) {
+        w.print("{:>20}|{}|", i * 7919, swoc::TextView{big}.prefix(size_t(i % 5)));
+        text += swoc::bwprint(tmp, "{:>20}|{}|", i * 7919, swoc::TextView{big}.prefix(size_t(i % 5)));
+        if (i % 16 == 0) {
+          w.reference(big);
+          text += big;
+        }
+      }
+      REQUIRE(w.extent() == text.size());
+      w.print("{}", big); // single argument larger than the buffer.
+      text += big;
+      w.write('@');
+      w.write("end"); // left for the destructor to flush.
+      text += "@end";
+      REQUIRE(w.extent() == text.size());
+
+      // Discard and copy are limited to the current buffer.
+      w.discard(2);
+      text.resize(text.size() - 2);
+      w.write("nd");
+      text += "nd";
+      w.copy(w.extent() - 1, w.extent() - 2, 1);
+      text.back() = 'n';
+      REQUIRE_FALSE(w.error());
+      REQUIRE(w.error_code() == 0);
+    }
+    REQUIRE(contents(file) == text);
+    fclose(file);
+  }
+
+  // Each flush writes all output so far.
+  FILE *file = tmpfile();
+  REQUIRE(file != nullptr);
+  {
+    swoc::FdWriter w{fileno(file), 128, true};
+    w.write("alpha");
+    w.reference("beta");
+    w.write("gamma");
+    w.flush();
+    REQUIRE(contents(file) == "alphabetagamma");
+  }
+  fclose(file);
+
+  // Write failures are reported.
+  swoc::FdWriter bad{-1, 64};
+  bad.write("lost");
+  bad.flush();
+  REQUIRE(bad.error());
+  REQUIRE(bad.error_code() == EBADF);
+}
+
+TEST_CASE("BufferWriter put", "[BW]")
+{
+  // Direct writes to a fixed buffer, then overflow via the virtual write.
+  LBW<4> bw;
+  swoc::BufferWriter &w = bw;
+  w.put('a').put('b').write(std::string_view("cd"));
+  REQUIRE(bw.view() == "abcd");
+  REQUIRE_FALSE(bw.error());
+  w.put('e').write(std::string_view("fg"));
+  REQUIRE(bw.error());
+  REQUIRE(bw.extent() == 7);
+  REQUIRE(bw.view() == "abcd");
+  bw.restrict(2).clear();
+  w.put('x').put('y').put('z');
+  REQUIRE(bw.view() == "xy");
+  REQUIRE(bw.extent() == 3);
+
+  // Growth happens in the virtual write.
+  swoc::MemArena arena{256};
+  swoc::ArenaWriter aw{arena};
+  swoc::BufferWriter &aww = aw;
+  std::string text;
+  for (int i = 0; i < 1000; ++i) {
+    char c = 'a' + i % 26;
+    aww.put(c);
+    text += c;
+  }
+  REQUIRE(aw.extent() == text.size());
+  REQUIRE(aw.view() == text);
+}
+
 #if 0
 // Need Endpoint or some other IP address parsing support to load the test values.
 TEST_CASE("BufferWriter IP", "[libswoc][ip][bwf]") {
@@ -18,8 +18,13 @@
     limitations under the License.
 */
 
+#include <algorithm>
+#include <cstdio>
 #include <memory>
+#include <thread>
+
 #include "swoc/Errata.h"
+#include "swoc/AsyncErrataSink.h"
 #include "catch.hpp"
 
 using swoc::Errata;
@@ -81,6 +86,304 @@ TEST_CASE("Errata copy", "[libswoc][Errata]")
   REQUIRE(match_p);
 };
 
+TEST_CASE("Errata inline", "[libswoc][Errata]")
+{
+  static int sunk = 0;
+  static std::string sunk_text;
+  Errata::register_sink([](Errata const &erratum) {
+    if (erratum.begin()->text().substr(0, 6) == "Inline") {
+      ++sunk;
+      sunk_text.clear();
+      for (auto const &note : erratum) {
+        sunk_text += note.text();
+        sunk_text += ';';
+      }
+    }
+  });
+
+  {
+    Errata erratum;
+    erratum.note(Severity::INFO, "Inline 1");
+    erratum.warn("Inline {}", 2);
+    REQUIRE(erratum.count() == 2);
+    REQUIRE(erratum.severity() == Severity::WARN);
+    REQUIRE_FALSE(erratum.is_ok());
+    REQUIRE(erratum.front().text() == "Inline 2");
+
+    // Move must keep the text, which is stored in the instance.
+    Errata moved{std::move(erratum)};
+    REQUIRE(erratum.count() == 0);
+    REQUIRE(erratum.is_ok());
+    REQUIRE(moved.count() == 2);
+    auto spot = moved.begin();
+    REQUIRE(spot->text() == "Inline 2");
+    REQUIRE((++spot)->text() == "Inline 1");
+    REQUIRE(sunk == 0);
+
+    // More notes than fit inline.
+    moved.error("Inline {}", 3);
+    REQUIRE(moved.count() == 3);
+    REQUIRE(moved.severity() == Severity::ERROR);
+    std::string text;
+    for (auto const &note : moved) {
+      text += note.text();
+    }
+    REQUIRE(text == "Inline 3Inline 2Inline 1");
+  }
+  REQUIRE(sunk == 1);
+  REQUIRE(sunk_text == "Inline 3;Inline 2;Inline 1;");
+
+  {
+    Errata erratum;
+    erratum.info("Inline shared");
+    Errata copy{erratum}; // Shares, so only one report.
+    REQUIRE(copy.count() == 1);
+    REQUIRE(erratum.count() == 1);
+    REQUIRE(copy.front().text() == "Inline shared");
+    REQUIRE(&copy.front() == &erratum.front());
+  }
+  REQUIRE(sunk == 2);
+
+  {
+    // Empty notes take no text space, but still only fit as many as there are inline slots.
+    Errata erratum;
+    erratum.info(""sv);
+    erratum.info(""sv);
+    erratum.info(""sv);
+    REQUIRE(erratum.count() == 3);
+    erratum.clear();
+  }
+  REQUIRE(sunk == 2);
+
+  {
+    Errata erratum;
+    erratum.info("Inline {}", std::string(200, 'x')); // Too large to be inline.
+    REQUIRE(erratum.count() == 1);
+    REQUIRE(erratum.front().text().size() == 207);
+    Errata other;
+    other.info("Inline other");
+    other = std::move(erratum); // Reports the previous content of other.
+    REQUIRE(sunk == 3);
+    REQUIRE(sunk_text == "Inline other;");
+    other.clear();
+  }
+  REQUIRE(sunk == 3);
+}
+
+namespace
+{
+int Rendered = 0;
+
+// Formatting counts renders, to check rendering is deferred.
+struct Counted {
+  int _n;
+};
+
+swoc::BufferWriter &
+bwformat(swoc::BufferWriter &w, swoc::bwf::Spec const &spec, Counted const &c)
+{
+  ++Rendered;
+  return bwformat(w, spec, c._n);
+}
+} // namespace
+
+TEST_CASE("Errata deferred", "[libswoc][Errata]")
+{
+  static swoc::bwf::Format const fmt{"Deferred {} of {} at {:x}"};
+
+  std::string host{"host.example.com"};
+  {
+    Errata erratum;
+    erratum.note_deferred(Severity::ERROR, fmt, 1, host, 0xBEEF);
+    host[0] = 'X'; // String arguments are copied.
+    REQUIRE(erratum.count() == 1);
+    REQUIRE(erratum.severity() == Severity::ERROR);
+    REQUIRE_FALSE(erratum.is_ok());
+    Errata moved{std::move(erratum)};
+    REQUIRE(moved.front().text() == "Deferred 1 of host.example.com at beef");
+  }
+
+  {
+    // Mixed with immediate annotations, and more than fit inline.
+    Errata erratum;
+    erratum.info("Immediate");
+    erratum.note_deferred(Severity::WARN, fmt, 2, "literal"sv, 16);
+    erratum.note_deferred(Severity::WARN, fmt, 3, std::string(150, 'y'), 17);
+    std::string_view long_text{"0123456789012345678901234567890123456789"};
+    erratum.note_deferred(Severity::DIAG, fmt, 4, long_text, 18);
+    REQUIRE(erratum.count() == 4);
+    std::vector<std::string> texts;
+    for (auto const &note : erratum) {
+      texts.emplace_back(note.text());
+    }
+    REQUIRE(texts.size() == 4);
+    REQUIRE(texts[0] == "Deferred 4 of 0123456789012345678901234567890123456789 at 12");
+    REQUIRE(texts[1] == "Deferred 3 of " + std::string(150, 'y') + " at 11");
+    REQUIRE(texts[2] == "Deferred 2 of literal at 10");
+    REQUIRE(texts[3] == "Immediate");
+  }
+
+  {
+    // Copies render first, so the shared data is never changed.
+    Errata erratum;
+    erratum.note_deferred(Severity::INFO, fmt, 5, "copy"sv, 19);
+    Errata copy{erratum};
+    REQUIRE(copy.front().text() == "Deferred 5 of copy at 13");
+    REQUIRE(&copy.front() == &erratum.front());
+  }
+
+  {
+    // Shared data is rendered before it is shared, so the shared data is never changed.
+    Errata erratum;
+    erratum.note_deferred(Severity::INFO, fmt, 6, "share"sv, 20);
+    erratum.error("Immediate");
+    erratum.note_deferred(Severity::INFO, fmt, 7, "share"sv, 21);
+    Errata copy{erratum};
+    REQUIRE(copy.front().text() == "Deferred 7 of share at 15");
+    REQUIRE(&copy.front() == &erratum.front());
+  }
+
+  static swoc::bwf::Format const counted_fmt{"Counted {}"};
+  for (int i = 0; i < 100; ++i) {
+    Errata erratum;
+    erratum.note_deferred(Severity::ERROR, counted_fmt, Counted{i});
+    REQUIRE_FALSE(erratum.is_ok());
+    erratum.clear(); // Handled, no need to render. Otherwise a registered sink would render it.
+  }
+  REQUIRE(Rendered == 0);
+  Errata erratum;
+  erratum.note_deferred(Severity::ERROR, counted_fmt, Counted{7});
+  erratum.note_deferred(Severity::ERROR, counted_fmt, Counted{8});
+  erratum.error("Immediate {}", 9); // Moves the deferred annotations out of line.
+  erratum.note_deferred(Severity::ERROR, counted_fmt, Counted{10});
+  REQUIRE(Rendered == 0);
+  REQUIRE(erratum.front().text() == "Counted 10");
+  REQUIRE(Rendered >= 3); // Rendering may be repeated if the arena needs another block.
+  std::string text;
+  for (auto const &note : erratum) {
+    text += note.text();
+    text += ';';
+  }
+  REQUIRE(text == "Counted 10;Immediate 9;Counted 8;Counted 7;");
+  erratum.clear();
+}
+
+TEST_CASE("Errata async sink", "[libswoc][Errata]")
+{
+  static constexpr int N_THREADS = 4;
+  static constexpr int N_ERRATA  = 500;
+
+  auto read_all = [](FILE *f) -> std::string {
+    std::string zret;
+    char buff[4096];
+    rewind(f);
+    for (size_t n; (n = fread(buff, 1, sizeof(buff), f)) > 0;) {
+      zret.append(buff, n);
+    }
+    return zret;
+  };
+
+  FILE *f = tmpfile();
+  REQUIRE(f != nullptr);
+  {
+    swoc::AsyncErrataSink sink(fileno(f), 1024, std::chrono::milliseconds{1});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < N_THREADS; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < N_ERRATA; ++i) {
+          Errata erratum;
+          erratum.error("Thread {} erratum {}", t, i);
+          sink(erratum);
+          erratum.clear();
+          if (sink.dropped() > 0) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+    sink.flush();
+    REQUIRE(sink.errors() == 0);
+    REQUIRE(sink.written() + sink.dropped() == N_THREADS * N_ERRATA);
+
+    // Records from a thread are written in order and are never split.
+    auto text = read_all(f);
+    REQUIRE(std::count(text.begin(), text.end(), '\n') == ptrdiff_t(sink.written()));
+    std::vector<int> last(N_THREADS, -1);
+    bool ordered_p = true;
+    for (swoc::TextView src{text}; src;) {
+      auto line = src.take_prefix_at('\n');
+      line.take_prefix_at(' '); // Severity.
+      REQUIRE(line.take_prefix_at(' ') == "Thread");
+      auto t = swoc::svtou(line.take_prefix_at(' '));
+      REQUIRE(line.take_prefix_at(' ') == "erratum");
+      int i = swoc::svtou(line);
+      ordered_p = ordered_p && i > last[t];
+      last[t]   = i;
+    }
+    REQUIRE(ordered_p);
+  }
+  fclose(f);
+
+  // A full ring drops, nothing is written until flushed.
+  f = tmpfile();
+  REQUIRE(f != nullptr);
+  size_t expected = 0;
+  {
+    swoc::AsyncErrataSink sink(fileno(f), 256, std::chrono::hours{1});
+    Errata erratum;
+    erratum.error("A somewhat long text to fill the ring in only a few errata");
+    for (int i = 0; i < 10; ++i) {
+      sink(erratum);
+    }
+    REQUIRE(sink.dropped() > 0);
+    auto written = 10 - sink.dropped();
+    sink.flush();
+    REQUIRE(sink.written() == written);
+    // The ring is available again.
+    sink(erratum);
+    erratum.clear();
+    REQUIRE(sink.dropped() == 10 - written);
+    expected = written + 1;
+  }
+  // Destruction writes the last one.
+  auto text = read_all(f);
+  REQUIRE(std::count(text.begin(), text.end(), '\n') == ptrdiff_t(expected));
+  fclose(f);
+
+  // Records drained often enough that none are dropped wrap the ring many times. The first half
+  // are 28 bytes with the header, which leaves exactly a header of space at the end of the ring.
+  static constexpr int N_WRAP = 400;
+  f = tmpfile();
+  REQUIRE(f != nullptr);
+  std::string expected_text;
+  {
+    swoc::AsyncErrataSink sink(fileno(f), 256, std::chrono::hours{1});
+    std::string filler(40, 'x');
+    Errata empty;
+    empty.info("");
+    size_t uniform = 24 - swoc::bwprint(text, "{}", empty).size();
+    empty.clear();
+    for (int i = 0; i < N_WRAP; ++i) {
+      Errata erratum;
+      erratum.info("{}", std::string_view{filler}.substr(0, i < N_WRAP / 2 ? uniform : (i * 7) % 41));
+      expected_text += swoc::bwprint(text, "{}", erratum);
+      sink(erratum);
+      erratum.clear();
+      if (i % 2) {
+        sink.flush();
+      }
+    }
+    sink.flush();
+    REQUIRE(sink.dropped() == 0);
+    REQUIRE(sink.written() == N_WRAP);
+  }
+  REQUIRE(read_all(f) == expected_text);
+  fclose(f);
+}
+
 TEST_CASE("Rv", "[libswoc][Errata]")
 {
   Rv<int> zret;
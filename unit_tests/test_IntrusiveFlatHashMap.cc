@@ -0,0 +1,251 @@
+/** @file
+
+    IntrusiveFlatHashMap unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <iostream>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "swoc/IntrusiveFlatHashMap.h"
+#include "swoc/IntrusiveHashMap.h"
+#include "swoc/bwf_base.h"
+#include "catch.hpp"
+
+using swoc::IntrusiveFlatHashMap;
+using swoc::IntrusiveHashMap;
+
+using namespace std::literals;
+
+namespace
+{
+struct Thing {
+  std::string _payload;
+  int _n{0};
+
+  Thing(std::string_view text, int x = 0) : _payload(text), _n(x) {}
+
+  Thing *_next{nullptr};
+  Thing *_prev{nullptr};
+};
+
+// Same descriptor as for IntrusiveHashMap, to check compatibility.
+struct ThingMapDescriptor {
+  static Thing *&
+  next_ptr(Thing *thing)
+  {
+    return thing->_next;
+  }
+  static Thing *&
+  prev_ptr(Thing *thing)
+  {
+    return thing->_prev;
+  }
+  static std::string_view
+  key_of(Thing *thing)
+  {
+    return thing->_payload;
+  }
+  static uint64_t
+  hash_of(std::string_view s)
+  {
+    return std::hash<std::string_view>{}(s);
+  }
+  static bool
+  equal(std::string_view const &lhs, std::string_view const &rhs)
+  {
+    return lhs == rhs;
+  }
+};
+
+// A deliberately weak hash, to check collision handling.
+struct IntDescriptor {
+  static unsigned
+  key_of(Thing const *thing)
+  {
+    return thing->_n;
+  }
+  static unsigned
+  hash_of(unsigned n)
+  {
+    return n & 0x3;
+  }
+  static bool
+  equal(unsigned lhs, unsigned rhs)
+  {
+    return lhs == rhs;
+  }
+};
+
+using Map  = IntrusiveFlatHashMap<ThingMapDescriptor>;
+using Weak = IntrusiveFlatHashMap<IntDescriptor>;
+
+} // namespace
+
+TEST_CASE("IntrusiveFlatHashMap", "[libswoc][IntrusiveFlatHashMap]")
+{
+  Map map;
+  REQUIRE(map.count() == 0);
+  REQUIRE(map.capacity() == 0);
+  REQUIRE(map.begin() == map.end());
+  REQUIRE(map.find("bob"sv) == map.end());
+
+  REQUIRE(map.insert(new Thing("bob")));
+  REQUIRE(map.count() == 1);
+  REQUIRE(map.insert(new Thing("dave")));
+  REQUIRE(map.insert(new Thing("persia")));
+  REQUIRE(map.count() == 3);
+  Thing dup{"dave"};
+  REQUIRE_FALSE(map.insert(&dup));
+  REQUIRE(map.count() == 3);
+  REQUIRE(map.find(&dup) == map.end());
+  REQUIRE(map.contains("persia"));
+  map.apply([](Thing *thing) { delete thing; });
+  map.clear();
+  REQUIRE(map.count() == 0);
+  REQUIRE(map.begin() == map.end());
+
+  std::vector<bool> marks(1000, false);
+  for (int i = 0; i < 1000; ++i) {
+    std::string name;
+    swoc::bwprint(name, "{} squared is {}", i, i * i);
+    map.insert(new Thing(name, i));
+    REQUIRE(map.count() == size_t(i + 1));
+    REQUIRE(map.find(name) != map.end());
+  }
+  REQUIRE(map.capacity() >= 1000);
+  for (auto &thing : map) {
+    REQUIRE(false == marks[thing._n]);
+    marks[thing._n] = true;
+  }
+  REQUIRE(std::count(marks.begin(), marks.end(), true) == 1000);
+
+  // Remove the odd ones.
+  for (auto spot = map.begin(); spot != map.end();) {
+    if (spot->_n & 1) {
+      Thing *thing = spot;
+      spot         = map.erase(spot);
+      delete thing;
+    } else {
+      ++spot;
+    }
+  }
+  REQUIRE(map.count() == 500);
+  bool miss_p = false;
+  for (int i = 0; i < 1000; ++i) {
+    std::string name;
+    swoc::bwprint(name, "{} squared is {}", i, i * i);
+    auto spot = map.find(name);
+    if ((i & 1) != (spot == map.end())) {
+      miss_p = true;
+    }
+  }
+  REQUIRE_FALSE(miss_p);
+
+  Map::const_iterator cspot = map.find("0 squared is 0"sv);
+  REQUIRE(cspot != map.end());
+  Thing *zero = const_cast<Thing *>(&*cspot);
+  REQUIRE(map.erase(zero));
+  REQUIRE(map.count() == 499);
+  delete zero;
+
+  Map other{std::move(map)};
+  REQUIRE(other.count() == 499);
+  other.apply([](Thing *thing) { delete thing; });
+}
+
+TEST_CASE("IntrusiveFlatHashMap collisions", "[libswoc][IntrusiveFlatHashMap]")
+{
+  std::vector<Thing> things;
+  things.reserve(2000);
+  for (int i = 0; i < 2000; ++i) {
+    things.emplace_back("", i);
+  }
+
+  Weak map{100};
+  auto cap = map.capacity();
+  REQUIRE(cap >= 100);
+  for (int i = 0; i < 100; ++i) {
+    map.insert(&things[i]);
+  }
+  REQUIRE(map.capacity() == cap); // reserved enough.
+
+  // Churn - many inserts and erases to generate tombstones, which must not break lookup.
+  for (int round = 0; round < 19; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      map.erase(&things[round * 100 + i]);
+      map.insert(&things[(round + 1) * 100 + i]);
+    }
+    REQUIRE(map.count() == 100);
+    REQUIRE(map.capacity() == cap); // tombstones cleaned without growth.
+  }
+  bool miss_p = false;
+  for (unsigned i = 0; i < 2000; ++i) {
+    if ((i < 1900) == map.contains(i)) {
+      miss_p = true;
+    }
+  }
+  REQUIRE_FALSE(miss_p);
+}
+
+// Benchmark against IntrusiveHashMap - hidden, run explicitly with "[benchmark]".
+TEST_CASE("IntrusiveFlatHashMap benchmark", "[.][benchmark][IntrusiveFlatHashMap]")
+{
+  static constexpr int N = 1'000'000;
+  using Clock            = std::chrono::high_resolution_clock;
+
+  std::vector<Thing> things;
+  std::vector<std::string> keys;
+  things.reserve(N);
+  keys.reserve(N);
+  std::minstd_rand randu;
+  for (int i = 0; i < N; ++i) {
+    std::string name;
+    swoc::bwprint(name, "host-{:x}.example.com", randu());
+    keys.push_back(name);
+    things.emplace_back(name, i);
+  }
+  // Lookup order unrelated to insert order.
+  std::vector<std::string_view> probes{keys.begin(), keys.end()};
+  std::shuffle(probes.begin(), probes.end(), randu);
+
+  auto run = [&](auto &map, char const *name) {
+    auto t0 = Clock::now();
+    for (auto &thing : things) {
+      map.insert(&thing);
+    }
+    auto t1     = Clock::now();
+    size_t hits = 0;
+    for (auto key : probes) {
+      hits += map.find(key) != map.end();
+    }
+    auto t2 = Clock::now();
+    std::cout << name << ": insert " << std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / N << " ns/op, find "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / N << " ns/op" << std::endl;
+    return hits;
+  };
+
+  IntrusiveHashMap<ThingMapDescriptor> chained;
+  Map flat;
+  auto chained_hits = run(chained, "IntrusiveHashMap");
+  auto flat_hits    = run(flat, "IntrusiveFlatHashMap");
+  REQUIRE(chained_hits == flat_hits);
+}
@@ -23,6 +23,7 @@
 #include <string>
 #include <bitset>
 #include <random>
+#include <vector>
 
 #include "swoc/IntrusiveHashMap.h"
 #include "swoc/bwf_base.h"
@@ -234,3 +235,76 @@ TEST_CASE("IntrusiveHashMapManyStrings", "[IntrusiveHashMap]")
   }
   REQUIRE(miss_p == false);
 };
+
+TEST_CASE("IntrusiveHashMap incremental expansion", "[libswoc][IntrusiveHashMap]")
+{
+  constexpr int N = 5000;
+  std::vector<std::string> names;
+  names.reserve(N);
+  for (int i = 0; i < N; ++i) {
+    swoc::bwprint(names.emplace_back(), "name-{}", i % (N / 2)); // every name twice.
+  }
+
+  Map map;
+  map.set_incremental_expansion(true);
+  REQUIRE(map.is_incremental_expansion());
+  bool expanded_p = false;
+  bool miss_p     = false;
+  bool count_p    = false;
+  for (int i = 0; i < N; ++i) {
+    map.insert(new Thing(names[i], i));
+    if (map.is_expanding()) {
+      expanded_p = true;
+      // Every element so far must be findable, and duplicates adjacent.
+      for (int j = 0; j <= i; j += 97) {
+        auto r = map.equal_range(names[j]);
+        if (std::distance(r.begin(), r.end()) != ((j % (N / 2)) + N / 2 <= i ? 2 : 1)) {
+          miss_p = true;
+        }
+      }
+      if (size_t(std::distance(map.begin(), map.end())) != map.count()) {
+        count_p = true;
+      }
+    }
+  }
+  REQUIRE(expanded_p);
+  REQUIRE_FALSE(miss_p);
+  REQUIRE_FALSE(count_p);
+  REQUIRE(map.count() == N);
+
+  // Erase while expanding.
+  map.expand();
+  REQUIRE(map.is_expanding());
+  auto nb = map.bucket_count();
+  for (int i = 0; i < N / 2; i += 3) {
+    for (auto spot = map.find(names[i]); spot != map.end() && spot->_payload == names[i];) {
+      Thing *thing = spot;
+      spot         = map.erase(spot);
+      delete thing;
+    }
+  }
+  size_t n = 0;
+  for (int i = 0; i < N / 2; ++i) {
+    auto r = map.equal_range(names[i]);
+    if (std::distance(r.begin(), r.end()) != (i % 3 ? 2 : 0)) {
+      miss_p = true;
+    }
+    n += std::distance(r.begin(), r.end());
+  }
+  REQUIRE_FALSE(miss_p);
+  REQUIRE(n == map.count());
+
+  while (map.expand_step())
+    ;
+  REQUIRE_FALSE(map.is_expanding());
+  REQUIRE(map.bucket_count() == nb);
+  REQUIRE(size_t(std::distance(map.begin(), map.end())) == map.count());
+  for (int i = 0; i < N / 2; ++i) {
+    if (map.find(names[i]) == map.end() ? i % 3 : !(i % 3)) {
+      miss_p = true;
+    }
+  }
+  REQUIRE_FALSE(miss_p);
+
+  map.apply([](Thing *thing) { delete thing; });
+}
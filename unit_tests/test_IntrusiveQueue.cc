@@ -0,0 +1,196 @@
+/** @file
+
+    Intrusive queue unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <thread>
+#include <vector>
+
+#include "swoc/IntrusiveQueue.h"
+#include "catch.hpp"
+
+using swoc::IntrusiveMPSCQueue;
+using swoc::IntrusiveSPSCRing;
+
+namespace
+{
+struct Thing {
+  Thing(unsigned src, unsigned id) : _src(src), _id(id) {}
+
+  unsigned _src;
+  unsigned _id;
+  Thing *_next{nullptr};
+  Thing *_prev{nullptr};
+
+  using Linkage = swoc::IntrusiveLinkage<Thing>;
+};
+
+using Queue = IntrusiveMPSCQueue<Thing::Linkage>;
+using Ring  = IntrusiveSPSCRing<Thing::Linkage>;
+
+std::vector<unsigned>
+ids(Queue::list_type const &list)
+{
+  std::vector<unsigned> zret;
+  for (auto const &thing : list) {
+    zret.push_back(thing._id);
+  }
+  return zret;
+}
+
+} // namespace
+
+TEST_CASE("IntrusiveMPSCQueue", "[libswoc][IntrusiveQueue]")
+{
+  std::vector<Thing> things;
+  for (unsigned i = 0; i < 10; ++i) {
+    things.emplace_back(0, i);
+  }
+
+  Queue q;
+  REQUIRE(q.empty());
+  REQUIRE(q.pop() == nullptr);
+  REQUIRE(q.pop_all().empty());
+
+  for (unsigned i = 0; i < 4; ++i) {
+    q.push(&things[i]);
+  }
+  REQUIRE_FALSE(q.empty());
+  REQUIRE(q.pop() == &things[0]);
+  // Items pushed after a pop are after those already taken.
+  q.push(&things[4]);
+  q.push(&things[5]);
+  REQUIRE(q.pop() == &things[1]);
+  auto list = q.pop_all();
+  REQUIRE(ids(list) == std::vector<unsigned>{2, 3, 4, 5});
+  REQUIRE(list.count() == 4);
+  REQUIRE(q.empty());
+
+  // Items can be pushed again after removal.
+  while (auto thing = list.take_head()) {
+    q.push(thing);
+  }
+  q.push(&things[9]);
+  REQUIRE(ids(q.pop_all()) == std::vector<unsigned>{2, 3, 4, 5, 9});
+  REQUIRE(q.pop() == nullptr);
+}
+
+TEST_CASE("IntrusiveMPSCQueue threads", "[libswoc][IntrusiveQueue]")
+{
+  static constexpr unsigned N_THREADS = 4;
+  static constexpr unsigned N_ITEMS   = 20000;
+
+  std::vector<std::vector<Thing>> things(N_THREADS);
+  for (unsigned src = 0; src < N_THREADS; ++src) {
+    for (unsigned i = 0; i < N_ITEMS; ++i) {
+      things[src].emplace_back(src, i);
+    }
+  }
+
+  Queue q;
+  std::vector<std::thread> producers;
+  for (unsigned src = 0; src < N_THREADS; ++src) {
+    producers.emplace_back([&, src]() {
+      for (auto &thing : things[src]) {
+        q.push(&thing);
+      }
+    });
+  }
+
+  // Items from each producer must be received in order, alternating single pops and batches.
+  std::vector<unsigned> next(N_THREADS, 0);
+  unsigned received = 0;
+  bool ordered_p    = true;
+  auto check        = [&](Thing *thing) {
+    ordered_p = ordered_p && thing->_id == next[thing->_src];
+    ++next[thing->_src];
+    ++received;
+  };
+  while (received < N_THREADS * N_ITEMS) {
+    if (auto thing = q.pop(); thing) {
+      check(thing);
+    }
+    for (auto &thing : q.pop_all()) {
+      check(&thing);
+    }
+  }
+  for (auto &t : producers) {
+    t.join();
+  }
+  REQUIRE(ordered_p);
+  REQUIRE(q.empty());
+}
+
+TEST_CASE("IntrusiveSPSCRing", "[libswoc][IntrusiveQueue]")
+{
+  std::vector<Thing> things;
+  for (unsigned i = 0; i < 10; ++i) {
+    things.emplace_back(0, i);
+  }
+
+  Ring ring{3};
+  REQUIRE(ring.capacity() == 4);
+  REQUIRE(ring.empty());
+  REQUIRE(ring.pop() == nullptr);
+
+  for (unsigned i = 0; i < 4; ++i) {
+    REQUIRE(ring.push(&things[i]));
+  }
+  REQUIRE_FALSE(ring.push(&things[4]));
+  REQUIRE(ring.pop() == &things[0]);
+  REQUIRE(ring.push(&things[4]));
+  REQUIRE(ring.pop() == &things[1]);
+  // Wrap around the end of the ring.
+  REQUIRE(ring.push(&things[5]));
+  REQUIRE(ids(ring.pop_all()) == std::vector<unsigned>{2, 3, 4, 5});
+  REQUIRE(ring.empty());
+  REQUIRE(ring.pop_all().empty());
+}
+
+TEST_CASE("IntrusiveSPSCRing threads", "[libswoc][IntrusiveQueue]")
+{
+  static constexpr unsigned N_ITEMS = 100000;
+
+  std::vector<Thing> things;
+  for (unsigned i = 0; i < N_ITEMS; ++i) {
+    things.emplace_back(0, i);
+  }
+
+  Ring ring{64};
+  std::thread producer([&]() {
+    for (auto &thing : things) {
+      while (!ring.push(&thing)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  unsigned next  = 0;
+  bool ordered_p = true;
+  while (next < N_ITEMS) {
+    if (auto thing = ring.pop(); thing) {
+      ordered_p = ordered_p && thing->_id == next++;
+    }
+    for (auto &thing : ring.pop_all()) {
+      ordered_p = ordered_p && thing._id == next++;
+    }
+  }
+  producer.join();
+  REQUIRE(ordered_p);
+  REQUIRE(ring.empty());
+}
@@ -0,0 +1,292 @@
+/** @file
+
+    IntrusiveRBMap unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "swoc/IntrusiveRBMap.h"
+#include "swoc/MemArena.h"
+#include "catch.hpp"
+
+using swoc::IntrusiveRBMap;
+using swoc::MemArena;
+
+namespace
+{
+struct Thing : public swoc::RBMapNode {
+  explicit Thing(int key, int id = 0) : _key(key), _id(id) {}
+
+  /// Access the subtree size for checking.
+  static size_t
+  subtree_size(swoc::detail::RBNode const *n)
+  {
+    return size_of(n);
+  }
+
+  int _key;
+  int _id;
+};
+
+struct ThingDescriptor {
+  static int
+  key_of(Thing *thing)
+  {
+    return thing->_key;
+  }
+  static bool
+  less(int lhs, int rhs)
+  {
+    return lhs < rhs;
+  }
+};
+
+using Map = IntrusiveRBMap<ThingDescriptor>;
+
+// Access the tree to check the invariants.
+struct Checker : public Map {
+  using Node = swoc::detail::RBNode;
+
+  // @return Black height of @a n, or -1 if an invariant is violated.
+  static int
+  check(Node const *n, size_t &count)
+  {
+    if (nullptr == n) {
+      count = 0;
+      return 0;
+    }
+    if (n->_color == Node::Color::RED &&
+        ((n->_left && n->_left->_color == Node::Color::RED) || (n->_right && n->_right->_color == Node::Color::RED))) {
+      return -1;
+    }
+    if ((n->_left && n->_left->_parent != n) || (n->_right && n->_right->_parent != n)) {
+      return -1;
+    }
+    size_t lc, rc;
+    int lh = check(n->_left, lc);
+    int rh = check(n->_right, rc);
+    count  = lc + rc + 1;
+    if (lh < 0 || lh != rh || count != Thing::subtree_size(n)) {
+      return -1;
+    }
+    return lh + (n->_color == Node::Color::BLACK);
+  }
+
+  static bool
+  valid(Map const &map)
+  {
+    Node const *root = map.*(&Checker::_root);
+    if (root && (root->_parent || root->_color != Node::Color::BLACK)) {
+      return false;
+    }
+    size_t count;
+    if (check(root, count) < 0) {
+      return false;
+    }
+    // The list must be in order and match the tree count.
+    size_t n = 0;
+    for (auto spot = map.begin(); spot != map.end(); ++spot, ++n) {
+      auto next = std::next(spot);
+      if (next != map.end() && next->_key < spot->_key) {
+        return false;
+      }
+    }
+    return n == count && n == map.count();
+  }
+};
+
+bool
+valid(Map const &map)
+{
+  return Checker::valid(map);
+}
+
+std::vector<int>
+keys(Map const &map)
+{
+  std::vector<int> zret;
+  for (auto const &thing : map) {
+    zret.push_back(thing._key);
+  }
+  return zret;
+}
+
+} // namespace
+
+TEST_CASE("IntrusiveRBMap", "[libswoc][IntrusiveRBMap]")
+{
+  MemArena arena;
+  Map map;
+
+  REQUIRE(map.empty());
+  REQUIRE(map.begin() == map.end());
+  REQUIRE(map.find(1) == map.end());
+
+  for (int k : {50, 20, 80, 10, 30, 70, 90, 30, 60}) {
+    map.insert(arena.make<Thing>(k, map.count()));
+    REQUIRE(valid(map));
+  }
+  REQUIRE(map.count() == 9);
+  REQUIRE(keys(map) == std::vector<int>{10, 20, 30, 30, 50, 60, 70, 80, 90});
+
+  // Equal keys keep insertion order.
+  auto [first, limit] = map.equal_range(30);
+  REQUIRE(std::distance(first, limit) == 2);
+  REQUIRE(first->_id == 4);
+  REQUIRE(std::next(first)->_id == 7);
+  REQUIRE(map.find(30) == first);
+  REQUIRE(map.find(35) == map.end());
+
+  REQUIRE(map.lower_bound(31)->_key == 50);
+  REQUIRE(map.upper_bound(30)->_key == 50);
+  REQUIRE(map.lower_bound(10)->_key == 10);
+  REQUIRE(map.upper_bound(90) == map.end());
+  REQUIRE(map.lower_bound(0) == map.begin());
+
+  // Decrement from the end.
+  auto last = map.end();
+  --last;
+  REQUIRE(last->_key == 90);
+
+  // Range erase.
+  auto spot = map.erase(map.lower_bound(30), map.lower_bound(70));
+  REQUIRE(spot->_key == 70);
+  REQUIRE(keys(map) == std::vector<int>{10, 20, 70, 80, 90});
+  REQUIRE(valid(map));
+
+  spot = map.erase(map.find(10));
+  REQUIRE(spot == map.begin());
+  REQUIRE(spot->_key == 20);
+  map.erase(&*map.find(90));
+  REQUIRE(keys(map) == std::vector<int>{20, 70, 80});
+  REQUIRE(valid(map));
+
+  map.clear();
+  REQUIRE(map.empty());
+  REQUIRE(map.count() == 0);
+}
+
+TEST_CASE("IntrusiveRBMap bulk", "[libswoc][IntrusiveRBMap]")
+{
+  MemArena arena;
+  std::vector<Thing *> things;
+  for (int k = 0; k < 1000; ++k) {
+    things.push_back(arena.make<Thing>(k * 2));
+  }
+
+  Map map;
+  for (size_t n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+    map.build_from_sorted(things.begin(), things.begin() + n);
+    REQUIRE(map.count() == n);
+    REQUIRE(valid(map));
+  }
+  REQUIRE(map.find(1000)->_key == 1000);
+
+  // Out of order input is still handled.
+  std::vector<Thing *> shuffled{things.begin(), things.begin() + 100};
+  std::shuffle(shuffled.begin(), shuffled.end(), std::minstd_rand(7));
+  map.build_from_sorted(shuffled.begin(), shuffled.end());
+  REQUIRE(map.count() == 100);
+  REQUIRE(valid(map));
+  REQUIRE(map.begin()->_key == 0);
+
+  // Split and join at every position of a smaller map.
+  for (int key = -1; key <= 40; ++key) {
+    map.build_from_sorted(things.begin(), things.begin() + 20);
+    auto upper = map.split(key);
+    REQUIRE(valid(map));
+    REQUIRE(valid(upper));
+    REQUIRE(map.count() + upper.count() == 20);
+    if (!map.empty()) {
+      REQUIRE((--map.end())->_key < key);
+    }
+    if (!upper.empty()) {
+      REQUIRE(upper.begin()->_key >= key);
+    }
+    map.join(upper);
+    REQUIRE(upper.empty());
+    REQUIRE(map.count() == 20);
+    REQUIRE(valid(map));
+  }
+
+  // Split a large map in pieces and join them back.
+  map.build_from_sorted(things.begin(), things.end());
+  std::vector<Map> pieces;
+  for (int key : {1800, 1000, 998, 500, 2}) {
+    pieces.emplace_back(map.split(key));
+    REQUIRE(valid(map));
+    REQUIRE(valid(pieces.back()));
+  }
+  REQUIRE(map.count() == 1);
+  for (auto piece = pieces.rbegin(); piece != pieces.rend(); ++piece) {
+    map.join(*piece);
+    REQUIRE(valid(map));
+  }
+  REQUIRE(map.count() == 1000);
+
+  // Joining overlapping keys merges.
+  Map other;
+  other.build_from_sorted(things.begin() + 500, things.end());
+  map.build_from_sorted(things.begin(), things.begin() + 500);
+  auto extra = arena.make<Thing>(3);
+  other.insert(extra);
+  map.join(other);
+  REQUIRE(map.count() == 1001);
+  REQUIRE(valid(map));
+  REQUIRE(std::next(map.iterator_for(extra))->_key == 4);
+}
+
+TEST_CASE("IntrusiveRBMap random", "[libswoc][IntrusiveRBMap]")
+{
+  MemArena arena;
+  Map map;
+  std::multimap<int, Thing *> ref;
+  std::minstd_rand rng(17);
+  std::uniform_int_distribution<int> key_gen(0, 500);
+
+  for (int i = 0; i < 4000; ++i) {
+    int key = key_gen(rng);
+    if (rng() % 3 && !ref.empty()) {
+      auto spot = ref.lower_bound(key);
+      if (spot == ref.end()) {
+        spot = ref.begin();
+      }
+      map.erase(spot->second);
+      ref.erase(spot);
+    } else {
+      auto thing = arena.make<Thing>(key);
+      map.insert(thing);
+      ref.emplace(key, thing);
+    }
+    if (i % 97 == 0) {
+      auto upper = map.split(key);
+      map.join(upper);
+      REQUIRE(valid(map));
+    }
+  }
+  REQUIRE(valid(map));
+  REQUIRE(map.count() == ref.size());
+  auto spot = map.begin();
+  for (auto const &[key, thing] : ref) {
+    REQUIRE(spot->_key == key);
+    ++spot;
+  }
+}
@@ -0,0 +1,171 @@
+/** @file
+
+    IntrusiveShardedHashMap unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "swoc/IntrusiveShardedHashMap.h"
+#include "swoc/bwf_base.h"
+#include "catch.hpp"
+
+using swoc::IntrusiveShardedHashMap;
+
+using namespace std::literals;
+
+namespace
+{
+struct Thing {
+  std::string _payload;
+  int _n{0};
+
+  Thing(std::string_view text, int x = 0) : _payload(text), _n(x) {}
+
+  Thing *_next{nullptr};
+  Thing *_prev{nullptr};
+};
+
+struct ThingMapDescriptor {
+  static Thing *&
+  next_ptr(Thing *thing)
+  {
+    return thing->_next;
+  }
+  static Thing *&
+  prev_ptr(Thing *thing)
+  {
+    return thing->_prev;
+  }
+  static std::string_view
+  key_of(Thing *thing)
+  {
+    return thing->_payload;
+  }
+  static uint64_t
+  hash_of(std::string_view s)
+  {
+    return std::hash<std::string_view>{}(s);
+  }
+  static bool
+  equal(std::string_view const &lhs, std::string_view const &rhs)
+  {
+    return lhs == rhs;
+  }
+};
+
+using Map = IntrusiveShardedHashMap<ThingMapDescriptor, 8>;
+
+} // namespace
+
+TEST_CASE("IntrusiveShardedHashMap", "[libswoc][IntrusiveShardedHashMap]")
+{
+  REQUIRE(Map::shard_index(0) == 0);
+  REQUIRE(Map::shard_index(~uint64_t(0)) == 7);
+  REQUIRE(Map::shard_index(uint64_t(1) << 61) == 1);
+  REQUIRE(IntrusiveShardedHashMap<ThingMapDescriptor, 1>::shard_index(~uint64_t(0)) == 0);
+
+  Map map;
+  REQUIRE(map.count() == 0);
+  REQUIRE_FALSE(map.contains("bob"));
+
+  map.insert(new Thing("bob", 1));
+  map.insert(new Thing("dave", 2));
+  map.insert(new Thing("persia", 3));
+  REQUIRE(map.count() == 3);
+  int n = 0;
+  REQUIRE(map.find("dave", [&](Thing &thing) { n = thing._n; }));
+  REQUIRE(n == 2);
+  REQUIRE_FALSE(map.find("sam", [&](Thing &thing) { n = thing._n; }));
+  REQUIRE(n == 2);
+
+  Thing *thing = map.erase("dave"sv);
+  REQUIRE(thing != nullptr);
+  REQUIRE(thing->_n == 2);
+  REQUIRE(map.count() == 2);
+  REQUIRE(map.erase("dave"sv) == nullptr);
+  REQUIRE_FALSE(map.erase(thing));
+  delete thing;
+
+  map.apply([](Thing *thing) { delete thing; });
+  map.clear();
+  REQUIRE(map.count() == 0);
+}
+
+TEST_CASE("IntrusiveShardedHashMap threads", "[libswoc][IntrusiveShardedHashMap]")
+{
+  static constexpr int N_STABLE  = 1000;
+  static constexpr int N_CHURN   = 500;
+  static constexpr int N_READERS = 4;
+
+  std::vector<Thing> stable;
+  std::vector<Thing> churn;
+  stable.reserve(N_STABLE);
+  churn.reserve(N_CHURN);
+  for (int i = 0; i < N_STABLE; ++i) {
+    std::string name;
+    swoc::bwprint(name, "stable-{}", i);
+    stable.emplace_back(name, i);
+  }
+  for (int i = 0; i < N_CHURN; ++i) {
+    std::string name;
+    swoc::bwprint(name, "churn-{}", i);
+    churn.emplace_back(name, i);
+  }
+
+  Map map;
+  for (auto &thing : stable) {
+    map.insert(&thing);
+  }
+
+  // Readers must always find the stable elements while another thread is inserting and erasing.
+  std::atomic<bool> done{false};
+  std::atomic<int> misses{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < N_READERS; ++t) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        for (auto &thing : stable) {
+          int n = -1;
+          if (!map.find(thing._payload, [&](Thing &found) { n = found._n; }) || n != thing._n) {
+            ++misses;
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 20; ++round) {
+    for (auto &thing : churn) {
+      map.insert(&thing);
+    }
+    for (auto &thing : churn) {
+      map.erase(&thing);
+    }
+  }
+  done = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  REQUIRE(misses == 0);
+  REQUIRE(map.count() == N_STABLE);
+}
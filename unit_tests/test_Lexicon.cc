@@ -18,6 +18,9 @@
     limitations under the License.
 */
 
+#include <thread>
+#include <atomic>
+
 #include "swoc/Lexicon.h"
 #include "catch.hpp"
 
@@ -185,3 +188,204 @@ TEST_CASE("Lexicon Constructor 2", "[libts][Lexicon]")
   REQUIRE(v5["q"] == INVALID);
   REQUIRE(v5[C] == "Invalid");
 }
+
+TEST_CASE("Lexicon Compiled", "[libts][Lexicon]")
+{
+  static constexpr int N = 500;
+  std::vector<std::string> names;
+  for (int i = 0; i < N; ++i) {
+    names.push_back("Name-" + std::to_string(i));
+  }
+
+  using IntLexicon = swoc::Lexicon<int>;
+  IntLexicon lex{{-1, "Invalid"}};
+  REQUIRE(lex.is_compiled());
+  REQUIRE(lex["invalid"] == -1);
+  REQUIRE(lex[-1] == "Invalid");
+
+  lex.set_default(-1).set_default("unknown");
+  for (int i = 0; i < N; ++i) {
+    lex.define(i, names[i]);
+  }
+  REQUIRE_FALSE(lex.is_compiled()); // define discards the compiled tables.
+  REQUIRE(lex["NAME-17"] == 17);
+  lex.compile();
+  REQUIRE(lex.is_compiled());
+
+  bool miss_p = false;
+  for (int i = 0; i < N; ++i) {
+    std::string upper{names[i]};
+    for (auto &c : upper) {
+      c = toupper(c);
+    }
+    if (lex[names[i]] != i || lex[upper] != i || lex[i] != names[i]) {
+      miss_p = true;
+    }
+  }
+  REQUIRE_FALSE(miss_p);
+  REQUIRE(lex["Name-"] == -1);
+  REQUIRE(lex["Name-5000"] == -1);
+  REQUIRE(lex["Name-1x"] == -1);
+  REQUIRE(lex[N] == "unknown");
+  REQUIRE(lex[-2] == "unknown");
+
+  // Sparse values, which use the hash table for value lookup.
+  IntLexicon sparse{{{1, {"one", "uno"}}, {1000, {"thousand"}}, {1'000'000, {"million"}}}, 0, "none"};
+  REQUIRE(sparse.is_compiled());
+  REQUIRE(sparse["UNO"] == 1);
+  REQUIRE(sparse["Million"] == 1'000'000);
+  REQUIRE(sparse["billion"] == 0);
+  REQUIRE(sparse[1000] == "thousand");
+  REQUIRE(sparse[1] == "one");
+  REQUIRE(sparse[2] == "none");
+}
+
+TEST_CASE("Lexicon Snapshot", "[libts][Lexicon]")
+{
+  using IntLexicon = swoc::Lexicon<int>;
+  IntLexicon lex{{{1, {"one", "uno"}}, {2, {"two"}}, {40, {"forty"}}}, -1, "none"};
+  REQUIRE(lex.snapshot() == nullptr);
+
+  auto snap = lex.freeze();
+  REQUIRE(snap != nullptr);
+  REQUIRE(lex.snapshot() == snap);
+  REQUIRE(snap->count() == 3);
+  REQUIRE((*snap)["UNO"] == 1);
+  REQUIRE((*snap)["Forty"] == 40);
+  REQUIRE((*snap)["three"] == -1);
+  REQUIRE((*snap)[2] == "two");
+  REQUIRE((*snap)[3] == "none");
+
+  // Changes publish a new snapshot, old snapshots are unchanged.
+  lex.define(3, "three");
+  auto snap2 = lex.snapshot();
+  REQUIRE(snap2 != snap);
+  REQUIRE((*snap2)["three"] == 3);
+  REQUIRE((*snap2)[3] == "three");
+  REQUIRE((*snap)["three"] == -1);
+  lex.set_default(-2);
+  REQUIRE((*lex.snapshot())["four"] == -2);
+  REQUIRE((*snap2)["four"] == -1);
+
+  // Sparse values.
+  lex.define(1'000'000, "million");
+  auto snap3 = lex.snapshot();
+  REQUIRE((*snap3)[1'000'000] == "million");
+  REQUIRE((*snap3)[40] == "forty");
+  REQUIRE((*snap3)[41] == "none");
+
+  IntLexicon empty;
+  auto nil = empty.freeze();
+  REQUIRE(nil->count() == 0);
+  REQUIRE_THROWS_AS((*nil)["one"], std::domain_error);
+
+  // Readers use snapshots while a writer adds names.
+  static constexpr int N = 200;
+  std::atomic<bool> done{false};
+  std::atomic<int> misses{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        auto s = lex.snapshot();
+        if ((*s)["uno"] != 1 || (*s)[40] != "forty") {
+          ++misses;
+        }
+        for (int i = 100; i < 100 + N; ++i) {
+          auto name = (*s)[i];
+          if (name != "none" && (*s)[name] != i) {
+            ++misses;
+          }
+        }
+      }
+    });
+  }
+  for (int i = 100; i < 100 + N; ++i) {
+    lex.define(i, "value-" + std::to_string(i));
+  }
+  done = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+  REQUIRE(misses == 0);
+  REQUIRE(lex.snapshot()->count() == 5 + N);
+}
+
+TEST_CASE("Lexicon Matcher", "[libts][Lexicon]")
+{
+  using IntLexicon = swoc::Lexicon<int>;
+  IntLexicon lex{{{1, {"Content-Length", "CL"}}, {2, {"Content-Type"}}, {3, {"Con"}}, {4, {"Host"}}, {5, {"Connection"}}},
+                 -1};
+  auto m = lex.matcher();
+  REQUIRE(m.count() == 6);
+
+  // Longest prefix.
+  auto match = m.prefix("content-length: 42");
+  REQUIRE(match);
+  REQUIRE(match._value == 1);
+  REQUIRE(match._size == 14);
+  match = m.prefix("CONTENT-TYPE");
+  REQUIRE(match._value == 2);
+  REQUIRE(match._size == 12);
+  match = m.prefix("Content-Encoding");
+  REQUIRE(match._value == 3);
+  REQUIRE(match._size == 3);
+  match = m.prefix("Connections");
+  REQUIRE(match._value == 5);
+  REQUIRE(match._size == 10);
+  match = m.prefix("cl");
+  REQUIRE(match._value == 1);
+  REQUIRE(match._size == 2);
+  REQUIRE_FALSE(m.prefix("Co"));
+  REQUIRE(m.prefix("Co")._size == 0);
+  REQUIRE_FALSE(m.prefix("Accept"));
+  REQUIRE_FALSE(m.prefix(""));
+
+  // Whole tokens.
+  static constexpr swoc::CharSet DELIMITERS{": \t"};
+  match = m.token("Host: example.com", DELIMITERS);
+  REQUIRE(match);
+  REQUIRE(match._value == 4);
+  REQUIRE(match._size == 4);
+  match = m.token("con", DELIMITERS);
+  REQUIRE(match._value == 3);
+  REQUIRE(match._size == 3);
+  match = m.token("Content: x", DELIMITERS);
+  REQUIRE_FALSE(match);
+  REQUIRE(match._size == 7);
+  match = m.token("Content-Lengthy: 42", DELIMITERS);
+  REQUIRE_FALSE(match);
+  REQUIRE(match._size == 15);
+  match = m.token("X-Unknown-Header", DELIMITERS);
+  REQUIRE_FALSE(match);
+  REQUIRE(match._size == 16);
+  match = m.token(": value", DELIMITERS);
+  REQUIRE_FALSE(match);
+  REQUIRE(match._size == 0);
+
+  // The matcher is a copy.
+  lex.define(6, "Accept");
+  REQUIRE_FALSE(m.prefix("Accept"));
+  REQUIRE(lex.matcher().prefix("ACCEPT")._value == 6);
+
+  IntLexicon empty;
+  REQUIRE_FALSE(empty.matcher().prefix("anything"));
+  REQUIRE_FALSE(IntLexicon::Matcher{}.token("anything", DELIMITERS));
+
+  // Agreement with lookup, for many names with shared prefixes.
+  static constexpr int N = 1000;
+  IntLexicon big;
+  big.set_default(-1);
+  for (int i = 0; i < N; ++i) {
+    big.define(i, "Name-" + std::to_string(i * 7));
+  }
+  auto bm      = big.matcher();
+  bool match_p = true;
+  std::string text;
+  for (int i = 0; i < N * 7 + 10; ++i) {
+    text     = "NAME-" + std::to_string(i);
+    auto hit = bm.token(text, DELIMITERS);
+    match_p  = match_p && (hit ? hit._value : -1) == big[text] && hit._size == text.size();
+  }
+  REQUIRE(match_p);
+}
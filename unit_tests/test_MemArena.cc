@@ -20,8 +20,17 @@
 
 #include <string_view>
 #include <random>
+#include <thread>
+#include <vector>
+#include <memory_resource>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include "swoc/MemArena.h"
+#include "swoc/OffsetPtr.h"
+#include "swoc/swoc_file.h"
 #include "swoc/TextView.h"
+#include "swoc/bwf_base.h"
 #include "catch.hpp"
 
 using swoc::MemSpan;
@@ -389,3 +398,487 @@ TEST_CASE("FixedArena", "[libswoc][FixedArena]") {
   three = fa.make();
   REQUIRE(two == three);
 };
+
+TEST_CASE("MemArena block cache", "[libswoc][MemArena][BlockCache]")
+{
+  auto &cache = MemArena::BlockCache::local();
+  cache.flush();
+  REQUIRE(cache.count() == 0);
+
+  void const *addr = nullptr;
+  {
+    MemArena arena;
+    arena.use_block_cache();
+    arena.alloc(100);
+    addr = arena.begin()->data();
+    arena.clear();
+    REQUIRE(cache.count() == 1);
+    REQUIRE(arena.reserved_size() == 0);
+    arena.alloc(100);
+    REQUIRE(cache.count() == 0);
+    REQUIRE(arena.begin()->data() == addr); // same block, from the cache.
+    arena.alloc(3 * 4096); // force a multi-page block.
+  }
+  REQUIRE(cache.count() == 2);
+
+  // A different arena on the same thread shares the cache.
+  MemArena arena;
+  arena.use_block_cache();
+  arena.alloc(100);
+  REQUIRE(arena.begin()->data() == addr);
+  REQUIRE(cache.count() == 1);
+
+  // Release on a different thread - goes to the return list, not the other thread's cache.
+  std::thread([&]() -> void {
+    arena.clear();
+    REQUIRE(MemArena::BlockCache::local().count() == 0);
+  }).join();
+  REQUIRE(cache.count() == 1); // not drained yet.
+  arena.alloc(4096 * 6); // miss, which drains the returns.
+  REQUIRE(cache.count() == 2);
+  arena.clear(100);
+  REQUIRE(cache.count() == 3);
+  arena.alloc(100);
+  REQUIRE(cache.count() == 2);
+  REQUIRE(arena.begin()->data() == addr);
+
+  // Large blocks are not cached.
+  arena.clear(100);
+  REQUIRE(cache.count() == 3);
+  arena.alloc(4096 * (MemArena::BlockCache::N_BUCKETS + 1));
+  arena.clear(100);
+  REQUIRE(cache.count() == 3);
+  cache.flush();
+  REQUIRE(cache.count() == 0);
+
+  // Blocks outstanding after the thread that made them is gone.
+  MemArena orphan;
+  std::thread([&]() -> void {
+    orphan.use_block_cache();
+    orphan.alloc(1000);
+    orphan.alloc(10000);
+  }).join();
+  REQUIRE(orphan.reserved_size() >= 11000);
+  orphan.clear(); // last references, the detached cache gets destroyed.
+  REQUIRE(cache.count() == 0);
+}
+
+TEST_CASE("MemArena mapped source", "[libswoc][MemArena][MappedSource]")
+{
+  using Source = MemArena::MappedSource;
+  REQUIRE(Source::node_count() >= 1);
+  REQUIRE(Source::current_node() < int(Source::node_count()));
+
+  for (auto placement : {Source::DEFAULT, Source::LOCAL, Source::NODE, Source::INTERLEAVE}) {
+    Source source{placement, Source::NORMAL, 0};
+    MemArena arena{&source};
+    arena.alloc(100);
+    auto span = arena.alloc(20000);
+    memset(span.data(), 0xa5, span.size());
+    REQUIRE(arena.contains(span.data()));
+    REQUIRE(arena.reserved_size() >= 20100);
+    for (auto const &block : arena) {
+      REQUIRE(reinterpret_cast<uintptr_t>(&block) % 4096 == 0);
+    }
+    arena.freeze();
+    arena.alloc(50);
+    arena.thaw();
+  }
+
+  // Large blocks are aligned to huge pages and exactly fill them with the hinted size.
+  for (auto pages : {Source::TRANSPARENT, Source::EXPLICIT}) {
+    Source source{Source::LOCAL, pages};
+    MemArena arena{&source, Source::block_hint(2 * Source::HUGE_PAGE_SIZE)};
+    auto span = arena.alloc(Source::HUGE_PAGE_SIZE);
+    memset(span.data(), 0x5a, span.size());
+    auto const &block = *arena.begin();
+    REQUIRE(reinterpret_cast<uintptr_t>(&block) % Source::HUGE_PAGE_SIZE == 0);
+    REQUIRE(arena.reserved_size() + sizeof(MemArena::Block) <= 2 * Source::HUGE_PAGE_SIZE);
+    REQUIRE(arena.reserved_size() + sizeof(MemArena::Block) > 2 * Source::HUGE_PAGE_SIZE - 4096);
+    arena.alloc(100); // small block in the same arena.
+  }
+}
+
+TEST_CASE("OffsetPtr", "[libswoc][OffsetPtr]")
+{
+  struct Node {
+    swoc::OffsetPtr<Node> _next;
+    int _value = 0;
+  };
+
+  swoc::OffsetPtr<Node> nil;
+  REQUIRE_FALSE(nil);
+  REQUIRE(nil.get() == nullptr);
+
+  Node nodes[3];
+  for (int i = 0; i < 3; ++i) {
+    nodes[i]._value = i;
+    nodes[i]._next  = &nodes[(i + 1) % 3];
+  }
+  REQUIRE(nodes[0]._next->_value == 1);
+  REQUIRE((*nodes[2]._next)._value == 0);
+
+  // Pointing at the containing object, which is at the same address.
+  nodes[1]._next = &nodes[1];
+  REQUIRE(nodes[1]._next.get() == &nodes[1]);
+  REQUIRE(nodes[1]._next);
+
+  // Copies point at the same target from a different location.
+  swoc::OffsetPtr<Node> copy{nodes[0]._next};
+  REQUIRE(copy.get() == &nodes[1]);
+  copy = nodes[2]._next;
+  REQUIRE(copy.get() == &nodes[0]);
+  copy = nullptr;
+  REQUIRE_FALSE(copy);
+
+  // Moving the memory of both the pointer and target keeps the link.
+  Node moved[2];
+  nodes[2]._next = &nodes[1];
+  std::memcpy(static_cast<void *>(moved), static_cast<void *>(nodes + 1), sizeof(moved));
+  REQUIRE(moved[1]._next.get() == &moved[0]);
+}
+
+TEST_CASE("MemArena image", "[libswoc][MemArena][Image]")
+{
+  struct Node {
+    swoc::OffsetPtr<Node> _next;
+    swoc::OffsetPtr<char> _name;
+    Node *_raw = nullptr;
+    unsigned _id;
+  };
+  struct Root {
+    swoc::OffsetPtr<Node> _head;
+    Node *_raw_head = nullptr;
+    unsigned _count = 0;
+  };
+  static constexpr unsigned N = 5000;
+
+  MemArena::RegionSource source{1 << 26};
+  REQUIRE(source.capacity() >= (1 << 26));
+  REQUIRE(source.used() == 0);
+  MemArena arena{&source};
+  auto root = arena.make<Root>();
+  Node *prev = nullptr;
+  for (unsigned i = 0; i < N; ++i) {
+    auto node = arena.make<Node>();
+    node->_id = i;
+    auto name = arena.alloc(16).rebind<char>();
+    snprintf(name.data(), name.size(), "node %u", i);
+    node->_name = name.data();
+    if (prev) {
+      prev->_next = node;
+      prev->_raw  = node;
+    } else {
+      root->_head     = node;
+      root->_raw_head = node;
+    }
+    prev = node;
+    ++root->_count;
+  }
+  REQUIRE(std::distance(arena.begin(), arena.end()) > 1);
+  REQUIRE(source.contains(root));
+  REQUIRE(source.used() > 0);
+
+  char name[] = "/tmp/swoc_arena_image.XXXXXX";
+  int fd      = ::mkstemp(name);
+  REQUIRE(fd >= 0);
+  ::close(fd);
+  swoc::file::path path{name};
+  std::error_code ec;
+
+  // Only a frozen generation can be written.
+  MemArena::Image::write(path, arena, source, root, ec);
+  REQUIRE(ec.value() == EINVAL);
+  arena.freeze();
+  // Allocations after the freeze are not in the image.
+  arena.make<Node>()->_id = N;
+  int outside = 0;
+  MemArena::Image::write(path, arena, source, &outside, ec);
+  REQUIRE(ec.value() == EINVAL);
+  MemArena other;
+  other.alloc(10);
+  other.freeze();
+  MemArena::Image::write(path, other, source, nullptr, ec);
+  REQUIRE(ec.value() == EINVAL);
+
+  MemArena::Image::write(path, arena, source, root, ec);
+  REQUIRE_FALSE(ec);
+
+  auto check = [&](Root const *r, bool raw_p) -> bool {
+    std::string text;
+    unsigned n = 0;
+    for (Node const *node = raw_p ? r->_raw_head : r->_head.get(); node; node = raw_p ? node->_raw : node->_next.get(), ++n) {
+      if (node->_id != n || TextView{node->_name.get(), strlen(node->_name.get())} != swoc::bwprint(text, "node {}", n)) {
+        return false;
+      }
+    }
+    return n == r->_count && n == N;
+  };
+
+  {
+    auto image = MemArena::Image::load(path, ec);
+    REQUIRE_FALSE(ec);
+    REQUIRE_FALSE(image.empty());
+    REQUIRE(image.size() <= source.used());
+    auto r = image.root<Root const>();
+    REQUIRE(r != nullptr);
+    REQUIRE(static_cast<void const *>(r) != root);
+    REQUIRE(check(r, false));
+    // Moving keeps the mapping.
+    auto moved = std::move(image);
+    REQUIRE(image.empty());
+    REQUIRE(check(moved.root<Root const>(), false));
+  }
+
+  {
+    // Raw pointers can be fixed up in a writable image.
+    auto image = MemArena::Image::load(path, ec, true);
+    REQUIRE_FALSE(ec);
+    auto r       = image.root<Root>();
+    r->_raw_head = image.relocate(r->_raw_head);
+    for (Node *node = r->_raw_head; node; node = node->_raw) {
+      node->_raw = image.relocate(node->_raw);
+    }
+    REQUIRE(check(r, true));
+    REQUIRE(image.relocate(&outside) == &outside);
+    REQUIRE(image.relocate(static_cast<Node *>(nullptr)) == nullptr);
+  }
+  // Those changes were private.
+  REQUIRE(MemArena::Image::load(path, ec).root<Root const>()->_raw_head == root->_raw_head);
+
+  // Invalid files.
+  fd = ::open(name, O_WRONLY | O_TRUNC);
+  REQUIRE(::write(fd, "not an image", 12) == 12);
+  ::close(fd);
+  REQUIRE(MemArena::Image::load(path, ec).empty());
+  REQUIRE(ec.value() == EINVAL);
+  ::unlink(name);
+  REQUIRE(MemArena::Image::load(path, ec).empty());
+  REQUIRE(ec.value() == ENOENT);
+}
+
+namespace
+{
+/// Upstream resource that tracks outstanding memory.
+struct CountingResource : public std::pmr::memory_resource {
+  size_t _count = 0; ///< Outstanding allocations.
+  size_t _bytes = 0; ///< Outstanding bytes.
+
+  void *
+  do_allocate(size_t n, size_t align) override
+  {
+    ++_count;
+    _bytes += n;
+    return std::pmr::new_delete_resource()->allocate(n, align);
+  }
+
+  void
+  do_deallocate(void *ptr, size_t n, size_t align) override
+  {
+    --_count;
+    _bytes -= n;
+    std::pmr::new_delete_resource()->deallocate(ptr, n, align);
+  }
+
+  bool
+  do_is_equal(std::pmr::memory_resource const &that) const noexcept override
+  {
+    return this == &that;
+  }
+};
+} // namespace
+
+TEST_CASE("MemArena upstream", "[libswoc][MemArena][pmr]")
+{
+  CountingResource upstream;
+  {
+    MemArena arena{&upstream};
+    REQUIRE(arena.upstream() == &upstream);
+    arena.alloc(100);
+    REQUIRE(upstream._count == 1);
+    REQUIRE(upstream._bytes >= arena.reserved_size());
+    arena.alloc(8000);
+    REQUIRE(upstream._count == 2);
+    arena.freeze();
+    arena.alloc(100);
+    REQUIRE(upstream._count == 3);
+    arena.thaw();
+    REQUIRE(upstream._count == 1);
+
+    MemArena other{std::move(arena)};
+    REQUIRE(other.upstream() == &upstream);
+    other.alloc(10000);
+    REQUIRE(upstream._count == 2);
+
+    FixedArena<std::pair<int, int>> fa{other};
+    fa.make(1, 2);
+    REQUIRE(upstream._count == 2);
+  }
+  REQUIRE(upstream._count == 0);
+  REQUIRE(upstream._bytes == 0);
+}
+
+TEST_CASE("MemArena memory resource", "[libswoc][MemArena][pmr]")
+{
+  MemArena arena;
+  arena.alloc(3); // throw off alignment.
+  auto span = arena.alloc(64, 64);
+  REQUIRE(span.size() == 64);
+  REQUIRE(reinterpret_cast<uintptr_t>(span.data()) % 64 == 0);
+  REQUIRE(arena.alloc(7, 1).size() == 7);
+  span = arena.alloc(16, 16);
+  REQUIRE(reinterpret_cast<uintptr_t>(span.data()) % 16 == 0);
+
+  std::pmr::vector<int> v{&arena};
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(i);
+  }
+  REQUIRE(arena.contains(v.data()));
+  REQUIRE(v[999] == 999);
+
+  std::pmr::memory_resource *mr = &arena;
+  REQUIRE(mr->is_equal(arena));
+  MemArena other;
+  REQUIRE_FALSE(mr->is_equal(other));
+}
+
+namespace
+{
+// Record destruction order.
+struct Tracked {
+  explicit Tracked(std::vector<int> &log, int id) : _log(log), _id(id) {}
+  ~Tracked() { _log.push_back(_id); }
+  std::vector<int> &_log;
+  int _id;
+};
+} // namespace
+
+TEST_CASE("MemArena managed instances", "[libswoc][MemArena][managed]")
+{
+  std::vector<int> log;
+  {
+    MemArena arena;
+    for (int i = 0; i < 40; ++i) { // enough for more than one finalizer chunk.
+      auto t = arena.make_managed<Tracked>(log, i);
+      REQUIRE(arena.contains(t));
+    }
+    auto size = arena.size();
+    arena.make_managed<int>(3); // trivially destructible, nothing recorded.
+    REQUIRE(arena.size() == size + sizeof(int));
+    REQUIRE(log.empty());
+  }
+  REQUIRE(log.size() == 40);
+  for (int i = 0; i < 40; ++i) {
+    REQUIRE(log[i] == 39 - i); // reverse order.
+  }
+
+  // Generations.
+  log.clear();
+  MemArena arena;
+  arena.make_managed<Tracked>(log, 1);
+  arena.make_managed<std::string>(200, 'x'); // owns heap memory, checked by ASAN.
+  arena.freeze();
+  arena.make_managed<Tracked>(log, 2);
+  arena.discard();
+  REQUIRE(log == std::vector<int>{2});
+  arena.make_managed<Tracked>(log, 3);
+  arena.thaw();
+  REQUIRE(log == std::vector<int>{2, 1});
+  arena.make_managed<Tracked>(log, 4);
+  arena.freeze();
+  arena.make_managed<Tracked>(log, 5);
+  arena.clear();
+  REQUIRE(log == std::vector<int>{2, 1, 5, 4, 3});
+
+  // Moving transfers responsibility.
+  log.clear();
+  {
+    MemArena a1;
+    a1.make_managed<Tracked>(log, 6);
+    MemArena a2{std::move(a1)};
+    a1.clear();
+    REQUIRE(log.empty());
+    MemArena a3;
+    a3.make_managed<Tracked>(log, 7);
+    a3 = std::move(a2);
+    REQUIRE(log == std::vector<int>{7});
+  }
+  REQUIRE(log == std::vector<int>{7, 6});
+
+  // Managed instances in a self contained arena.
+  log.clear();
+  auto self = MemArena::construct_self_contained();
+  self->make_managed<Tracked>(log, 8);
+  self->~MemArena();
+  REQUIRE(log == std::vector<int>{8});
+}
+
+TEST_CASE("MemArena statistics", "[libswoc][MemArena][stats]")
+{
+  static MemArena::Tag tag{"test.stats"};
+  static MemArena::Tag other{"test.other"};
+
+  MemArena arena{512};
+  {
+    MemArena::Tag::Scope scope{tag};
+    arena.alloc(100);
+    {
+      MemArena::Tag::Scope inner{other};
+      arena.alloc(10);
+    }
+    arena.alloc(50, 64);
+  }
+  arena.alloc(200);
+  auto reserved = arena.reserved_size();
+  arena.alloc(2 * reserved); // doesn't fit, makes a block.
+  arena.alloc(arena.remaining()); // fills the block.
+
+  auto const &stats = arena.stats();
+  if constexpr (MemArena::STATS_P) {
+    REQUIRE(stats._n_blocks == 2);
+    REQUIRE(stats._block_size == arena.reserved_size());
+    REQUIRE(stats._n_allocs == 6);
+    REQUIRE(stats._alloc_size == arena.allocated_size());
+    REQUIRE(stats._n_misses == 1);
+    REQUIRE(stats._wasted == 0);
+    REQUIRE(stats._peak_allocated == arena.allocated_size());
+    REQUIRE(stats._peak_reserved == arena.reserved_size());
+    REQUIRE(tag.count() == 2);
+    REQUIRE(tag.size() >= 150);
+    REQUIRE(other.count() == 1);
+    REQUIRE(other.size() == 10);
+  } else {
+    REQUIRE(stats._n_blocks == 0);
+    REQUIRE(stats._n_allocs == 0);
+    REQUIRE(tag.count() == 0);
+  }
+  REQUIRE(MemArena::Tag::current() == nullptr);
+
+  // Peaks hold after the memory is released.
+  auto peak = stats._peak_reserved;
+  arena.clear();
+  REQUIRE(stats._peak_reserved == peak);
+
+  // Space left in a block when it becomes full is wasted.
+  MemArena small{256};
+  small.alloc(0);
+  auto n = small.remaining();
+  small.alloc(n - MemArena::Block::MIN_FREE_SPACE + 1);
+  REQUIRE(small.stats()._wasted == (MemArena::STATS_P ? MemArena::Block::MIN_FREE_SPACE - 1 : 0));
+
+  // Both tags are in the registry.
+  std::vector<std::string_view> names;
+  for (auto const &t : MemArena::Tag::registry()) {
+    names.push_back(t.name());
+  }
+  REQUIRE(std::find(names.begin(), names.end(), "test.stats") != names.end());
+  REQUIRE(std::find(names.begin(), names.end(), "test.other") != names.end());
+
+  swoc::LocalBufferWriter<1024> w;
+  w.print("{}", stats);
+  REQUIRE(TextView(w.view()).starts_with("blocks "));
+  w.clear().print("{}", other);
+  REQUIRE(w.view() == (MemArena::STATS_P ? "test.other: allocs 1 (10 bytes)" : "test.other: allocs 0 (0 bytes)"));
+  w.clear().print("{}", MemArena::Tag::registry());
+  REQUIRE(w.view().find("test.stats: allocs") != std::string_view::npos);
+}
@@ -0,0 +1,157 @@
+/** @file
+
+    RecordTokenizer unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "swoc/RecordTokenizer.h"
+#include "catch.hpp"
+
+using swoc::TextView;
+using swoc::RecordTokenizer;
+
+namespace
+{
+using Records = std::vector<std::vector<std::string>>;
+
+Records
+tokenize(RecordTokenizer &&tokens)
+{
+  Records records;
+  std::vector<TextView> fields;
+  while (tokens.next(fields)) {
+    records.emplace_back(fields.begin(), fields.end());
+  }
+  return records;
+}
+
+// Reference split for text without quotes.
+Records
+reference(TextView text, char delimiter)
+{
+  Records records;
+  while (text) {
+    auto line = text.take_prefix_at('\n');
+    if (line.ends_with("\r")) {
+      line.remove_suffix(1);
+    }
+    if (line.empty()) {
+      continue;
+    }
+    auto &record = records.emplace_back();
+    for (auto n = line.find(delimiter); n != TextView::npos; n = line.find(delimiter)) {
+      record.emplace_back(line.prefix(n));
+      line.remove_prefix(n + 1);
+    }
+    record.emplace_back(line);
+  }
+  return records;
+}
+
+} // namespace
+
+TEST_CASE("RecordTokenizer", "[libswoc][RecordTokenizer]")
+{
+  REQUIRE(tokenize(RecordTokenizer{""}).empty());
+  REQUIRE(tokenize(RecordTokenizer{"\n\n"}).empty());
+
+  REQUIRE(tokenize(RecordTokenizer{"a,b,c\n1,2,3\n"}) == Records{{"a", "b", "c"}, {"1", "2", "3"}});
+  // No trailing newline, empty fields.
+  REQUIRE(tokenize(RecordTokenizer{"a,,c\n,2,"}) == Records{{"a", "", "c"}, {"", "2", ""}});
+  // CRLF and blank lines.
+  REQUIRE(tokenize(RecordTokenizer{"a,b\r\n\r\n\n1,2\r\n"}) == Records{{"a", "b"}, {"1", "2"}});
+  // Tab separated, no quoting.
+  REQUIRE(tokenize(RecordTokenizer{"a\t\"b\nc\t1\n", '\t', 0}) == Records{{"a", "\"b"}, {"c", "1"}});
+
+  // Quoted delimiters and newlines.
+  REQUIRE(tokenize(RecordTokenizer{R"(a,"b,c",d)"}) == Records{{"a", "b,c", "d"}});
+  REQUIRE(tokenize(RecordTokenizer{"\"a\nb\",c\nd\n"}) == Records{{"a\nb", "c"}, {"d"}});
+  REQUIRE(tokenize(RecordTokenizer{R"("say ""hi""",x)"}) == Records{{R"(say ""hi"")", "x"}});
+
+  // Quoted field that crosses block boundaries.
+  std::string long_field(150, 'x');
+  long_field[60]  = ',';
+  long_field[70]  = '\n';
+  long_field[130] = ',';
+  std::string text = "start,\"" + long_field + "\",end\nnext\n";
+  REQUIRE(tokenize(RecordTokenizer{text}) == Records{{"start", long_field, "end"}, {"next"}});
+
+  // Line numbers.
+  RecordTokenizer lines{"a\n\nb,\"x\ny\"\nc\n"};
+  std::vector<TextView> fields;
+  REQUIRE(lines.next(fields));
+  REQUIRE(lines.line() == 1);
+  REQUIRE(lines.next(fields));
+  REQUIRE(lines.line() == 3);
+  REQUIRE(fields[1] == "x\ny");
+  REQUIRE(lines.next(fields));
+  REQUIRE(lines.line() == 5);
+  REQUIRE(fields[0] == "c");
+  REQUIRE_FALSE(lines.next(fields));
+  // Quoted newlines in a field that spans blocks.
+  RecordTokenizer long_lines{text};
+  REQUIRE(long_lines.next(fields));
+  REQUIRE(long_lines.line() == 1);
+  REQUIRE(long_lines.next(fields));
+  REQUIRE(long_lines.line() == 3);
+  REQUIRE(fields[0] == "next");
+
+  // Fields are views of the text.
+  TextView src{"alpha,beta\n"};
+  RecordTokenizer views{src};
+  REQUIRE(views.next(fields));
+  REQUIRE(fields[1].data() == src.data() + 6);
+}
+
+TEST_CASE("RecordTokenizer projection", "[libswoc][RecordTokenizer]")
+{
+  TextView text{"a,b,c,d\n1,2,3\n\"x,y\",z,\"p\nq\",w\nlast"};
+  REQUIRE(tokenize(std::move(RecordTokenizer{text}.project({0, 2}))) ==
+          Records{{"a", "c"}, {"1", "3"}, {"x,y", "p\nq"}, {"last"}});
+  REQUIRE(tokenize(std::move(RecordTokenizer{text}.project({1}))) == Records{{"b"}, {"2"}, {"z"}, {}});
+  // Skip the rest of a record containing a quoted newline.
+  REQUIRE(tokenize(std::move(RecordTokenizer{text}.project({0}))) == Records{{"a"}, {"1"}, {"x,y"}, {"last"}});
+  // Empty projection is all columns.
+  REQUIRE(tokenize(std::move(RecordTokenizer{text}.project({1}).project({}))).size() == 4);
+}
+
+TEST_CASE("RecordTokenizer random", "[libswoc][RecordTokenizer]")
+{
+  static constexpr char ALPHABET[] = "abc,,\t\n\r";
+  std::minstd_rand rng(13);
+  std::uniform_int_distribution<unsigned> pick(0, sizeof(ALPHABET) - 2);
+  for (int trial = 0; trial < 200; ++trial) {
+    std::string text;
+    std::uniform_int_distribution<size_t> length(0, 400);
+    for (auto n = length(rng); n > 0; --n) {
+      char c = ALPHABET[pick(rng)];
+      // Keep the carriage returns in valid places so the reference split matches.
+      if (c == '\r') {
+        text += "\r\n";
+      } else {
+        text += c;
+      }
+    }
+    for (char delimiter : {',', '\t'}) {
+      REQUIRE(tokenize(RecordTokenizer{text, delimiter, 0}) == reference(text, delimiter));
+    }
+  }
+}
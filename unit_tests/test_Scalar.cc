@@ -18,7 +18,11 @@
     limitations under the License.
 */
 
+#include <thread>
+#include <vector>
+
 #include "swoc/Scalar.h"
+#include "swoc/ShardedScalar.h"
 #include "swoc/bwf_base.h"
 #include "catch.hpp"
 
@@ -259,3 +263,60 @@ TEST_CASE("Scalar Formatting", "[libswoc][Scalar][bwf]")
   w.clear().print("y is {}", y);
   REQUIRE(w.view() == "y is 12000");
 }
+
+TEST_CASE("Scalar Sharded", "[libswoc][Scalar][sharded]")
+{
+  using KBytes = swoc::Scalar<1024, long int, KBytes_tag>;
+
+  swoc::ShardedScalar<KBytes> total;
+  REQUIRE(total.fold().count() == 0);
+  total.inc();
+  total += KBytes(3);
+  total.inc(4);
+  REQUIRE(total.fold() == KBytes(8));
+  REQUIRE(total.fold().value() == 8 * 1024);
+  KBytes x = total;
+  REQUIRE(x.count() == 8);
+  total.dec(2);
+  total -= KBytes(1);
+  REQUIRE(total.fold().count() == 5);
+
+  swoc::LocalBufferWriter<128> w;
+  w.print("total is {}", total);
+  REQUIRE(w.view() == "total is 5120 bytes");
+
+  REQUIRE(total.reset().count() == 5);
+  REQUIRE(total.fold().count() == 0);
+
+  // Threads changing the value at the same time, as a counter and as a gauge.
+  static constexpr int N_THREADS = 8;
+  static constexpr int N_OPS     = 10000;
+  swoc::ShardedScalar<KBytes, 4> gauge;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < N_THREADS; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < N_OPS; ++i) {
+        total.inc(2);
+        gauge.inc(3);
+        gauge.dec(2);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(total.fold().count() == 2 * N_THREADS * N_OPS);
+  REQUIRE(gauge.fold().count() == N_THREADS * N_OPS);
+
+  // Counts are kept after a thread exits, and the next thread with that index continues them.
+  threads.clear();
+  for (int t = 0; t < N_THREADS; ++t) {
+    std::thread([&]() { gauge.inc(5); }).join();
+  }
+  REQUIRE(gauge.fold().count() == N_THREADS * N_OPS + 5 * N_THREADS);
+  REQUIRE(gauge.reset().count() == N_THREADS * N_OPS + 5 * N_THREADS);
+  gauge.dec(3);
+  REQUIRE(gauge.fold().count() == -3);
+  REQUIRE(gauge.reset().count() == -3);
+  REQUIRE(gauge.fold().count() == 0);
+}
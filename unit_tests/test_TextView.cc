@@ -22,10 +22,13 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <random>
 
 #include "swoc/TextView.h"
+#include "swoc/MemSpan.h"
 #include "catch.hpp"
 
+using swoc::CharSet;
 using swoc::TextView;
 using namespace std::literals;
 using namespace swoc::literals;
@@ -104,6 +107,72 @@ TEST_CASE("TextView Find", "[libswoc][TextView]")
   REQUIRE(addr.rfind('.') == 10);
 }
 
+TEST_CASE("TextView CharSet", "[libswoc][TextView]")
+{
+  static constexpr CharSet SEP{",;"};
+  static_assert(SEP.contains(';') && !SEP.contains('.'));
+  static_assert(SEP.count() == 2);
+  REQUIRE(CharSet{"aabbcca"}.count() == 3);
+
+  TextView line{"alpha,beta;;gamma,delta"};
+  REQUIRE(line.prefix_at(SEP) == "alpha");
+  REQUIRE(line.suffix_at(SEP) == "delta");
+  REQUIRE(line.take_prefix_at(SEP) == "alpha");
+  REQUIRE(line.split_prefix_at(SEP) == "beta");
+  REQUIRE(line.split_prefix_at(SEP).empty());
+  REQUIRE(line.take_suffix_at(SEP) == "delta");
+  REQUIRE(line == "gamma");
+  REQUIRE(line.split_prefix_at(SEP).empty());
+  REQUIRE(line == "gamma");
+
+  TextView padded{" \t\r\n  value with  spaces \n\v\f "};
+  REQUIRE(TextView{padded}.trim(TextView::WHITESPACE) == "value with  spaces");
+  REQUIRE(TextView{padded}.ltrim(TextView::WHITESPACE) == "value with  spaces \n\v\f ");
+  REQUIRE(TextView{padded}.rtrim(TextView::WHITESPACE) == " \t\r\n  value with  spaces");
+  REQUIRE(TextView{"   "}.trim(TextView::WHITESPACE).empty());
+
+  // Check the kernels against @c std::string_view for a variety of set sizes and view lengths, to
+  // exercise the vector blocks, the tails and the scalar fallback for large sets.
+  std::minstd_rand randu(7);
+  std::string text;
+  for (std::string_view chars : {";"sv, " \t\n"sv, "0123456789abcdef"sv, "0123456789abcdefghij"sv, "\x80\xff"sv}) {
+    CharSet set{chars};
+    bool ok_p = true;
+    for (size_t n = 0; n < 200; ++n) {
+      text.resize(n);
+      for (auto &c : text) {
+        // Mostly non-members, with members scattered at a variable density.
+        c = (randu() % (n / 8 + 2)) ? char('G' + randu() % 20) : chars[randu() % chars.size()];
+      }
+      TextView tv{text};
+      std::string_view sv{text};
+      ok_p = ok_p && tv.find_first_of(set) == sv.find_first_of(chars);
+      ok_p = ok_p && tv.find_first_not_of(set) == sv.find_first_not_of(chars);
+      ok_p = ok_p && tv.find_last_of(set) == sv.find_last_of(chars);
+      ok_p = ok_p && tv.find_last_not_of(set) == sv.find_last_not_of(chars);
+      std::string solid(n, chars[0]);
+      TextView stv{solid};
+      ok_p = ok_p && stv.find_first_not_of(set) == TextView::npos && stv.find_last_not_of(set) == TextView::npos;
+      ok_p = ok_p && TextView{solid}.trim(set).empty();
+    }
+    REQUIRE(ok_p);
+  }
+
+  // Case insensitive comparison, across the vector block boundary.
+  TextView upper{"HTTP/1.1 200 OK CONTENT-LENGTH: 1024"};
+  TextView lower{"http/1.1 200 ok content-length: 1024"};
+  REQUIRE(strcasecmp(upper, lower) == 0);
+  REQUIRE(upper.starts_with_nocase("http/1.1 200 ok content"));
+  REQUIRE(upper.ends_with_nocase("content-length: 1024"));
+  REQUIRE_FALSE(upper.starts_with_nocase("http/1.1 200 ok content-type"));
+  REQUIRE_FALSE(upper.ends_with_nocase("Content-Type: 1024"));
+  REQUIRE(strcasecmp(upper, "http/1.1 200 ok content-length: 1025"_tv) < 0);
+  REQUIRE(strcasecmp(upper, "http/1.1 200 ok content-length: 1023"_tv) > 0);
+  REQUIRE(strcasecmp("[Z]"_tv, "[z]"_tv) == 0);
+  REQUIRE(strcasecmp("@"_tv, "`"_tv) != 0); // bytes adjacent to the letter ranges are not folded.
+  REQUIRE(strcasecmp("0123456789abcdef[ABC"_tv, "0123456789ABCDEF{abc"_tv) < 0);
+}
+
 TEST_CASE("TextView Affixes", "[libswoc][TextView]")
 {
   TextView s; // scratch.
@@ -377,6 +446,81 @@ TEST_CASE("TextView Conversions", "[libswoc][TextView]")
   x = n3;
   REQUIRE(25 == swoc::svto_radix<8>(x));
   REQUIRE(x.size() == 0);
+
+  // Decimal conversion of every length, with the digit run ended by the characters adjacent to the
+  // digits, to check the block conversion and its boundaries.
+  std::string digits{"98765432109876543210"};
+  bool ok_p = true;
+  for (size_t n = 1; n <= 19; ++n) {
+    for (std::string_view tail : {""sv, "/"sv, ":"sv, " 12345678"sv, "0123456789"sv}) {
+      std::string text = digits.substr(digits.size() - n) + std::string(tail);
+      x                = text;
+      auto value       = swoc::svto_radix<10>(x);
+      auto expected    = strtoull(text.c_str(), nullptr, 10);
+      if (tail.size() && isdigit(tail[0])) {
+        continue; // not a separate run.
+      }
+      ok_p = ok_p && value == expected && x.size() == tail.size();
+    }
+  }
+  REQUIRE(ok_p);
+
+  x = "18446744073709551615"_tv;
+  REQUIRE(std::numeric_limits<uintmax_t>::max() == swoc::svto_radix<10>(x));
+  REQUIRE(x.empty());
+  x = "18446744073709551616"_tv;
+  REQUIRE(std::numeric_limits<uintmax_t>::max() == swoc::svto_radix<10>(x));
+  REQUIRE(x == "6");
+  x = "99999999999999999999999"_tv;
+  REQUIRE(std::numeric_limits<uintmax_t>::max() == swoc::svto_radix<10>(x));
+  REQUIRE(x == "9999");
+  x = "0000000000000000000000000042"_tv;
+  REQUIRE(42 == swoc::svto_radix<10>(x));
+  REQUIRE(x.empty());
+  REQUIRE(8675309 == svtoi("  8675309 is a number"_tv, &x));
+  REQUIRE(x == "8675309");
+  x.clear();
+  REQUIRE(0 == svtoi("Content-Length: 8675309"_tv, &x));
+  REQUIRE(x.empty());
+  REQUIRE(std::numeric_limits<uintmax_t>::max() == svtou("ffffffffffffffffff", &x, 16));
+  REQUIRE(x.size() == 16);
+}
+
+TEST_CASE("TextView Conversion List", "[libswoc][TextView]")
+{
+  intmax_t values[8];
+  swoc::MemSpan<intmax_t> span{values, 8};
+
+  TextView text{"80, 443,8080 , -1,0x10"};
+  REQUIRE(5 == svtoi_list(text, span));
+  REQUIRE(text.empty());
+  REQUIRE(values[0] == 80);
+  REQUIRE(values[1] == 443);
+  REQUIRE(values[2] == 8080);
+  REQUIRE(values[3] == -1);
+  REQUIRE(values[4] == 16);
+
+  // Stop at an invalid element, leaving it in the source view.
+  text = "1;2;three;4";
+  REQUIRE(2 == svtoi_list(text, span, CharSet{";"}));
+  REQUIRE(text == "three;4");
+  text = "1,2 3,4";
+  REQUIRE(1 == svtoi_list(text, span));
+  REQUIRE(text == "2 3,4");
+
+  // White space as the delimiter.
+  text = "10 20  30\t40";
+  REQUIRE(4 == svtoi_list(text, span, TextView::WHITESPACE));
+  REQUIRE(values[3] == 40);
+  REQUIRE(text.empty());
+
+  // Stop when the output is full.
+  text = "1,2,3,4,5,6,7,8,9,10";
+  REQUIRE(8 == svtoi_list(text, span));
+  REQUIRE(text == "9,10");
+  REQUIRE(2 == svtoi_list(text, span));
+  REQUIRE(values[1] == 10);
+  REQUIRE(text.empty());
 }
 
 TEST_CASE("TransformView", "[libswoc][TransformView]")
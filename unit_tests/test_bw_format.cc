@@ -18,8 +18,11 @@
     limitations under the License.
  */
 
+#include <charconv>
 #include <chrono>
+#include <cinttypes>
 #include <iostream>
+#include <random>
 #include <variant>
 
 #include <netinet/in.h>
@@ -145,6 +148,178 @@ TEST_CASE("bwprint basics", "[bwprint]")
   REQUIRE(bw.view() == " Some text");
 }
 
+namespace
+{
+struct StaticText {
+  static constexpr std::string_view
+  text()
+  {
+    return "Arg {1:>4} and {0:#x} {{}}";
+  }
+};
+} // namespace
+
+TEST_CASE("bwprint static format", "[bwprint][static]")
+{
+  using Fmt = swoc::bwf::StaticFormat<StaticText>;
+  using swoc::bwf::Spec;
+  // Parsing is done at compile time.
+  static_assert(Fmt::N_ITEMS == 6);
+  static_assert(Fmt::N_ARGS == 2);
+  static_assert(Fmt::ITEMS[0]._type == Spec::LITERAL_TYPE && Fmt::ITEMS[0]._ext == "Arg ");
+  static_assert(Fmt::ITEMS[1]._idx == 1 && Fmt::ITEMS[1]._min == 4 && Fmt::ITEMS[1]._align == Spec::Align::RIGHT);
+  static_assert(Fmt::ITEMS[3]._idx == 0 && Fmt::ITEMS[3]._type == 'x' && Fmt::ITEMS[3]._radix_lead_p);
+  static_assert(Fmt::ITEMS[5]._type == Spec::LITERAL_TYPE && Fmt::ITEMS[4]._ext == " {" && Fmt::ITEMS[5]._ext == "}");
+
+  swoc::LocalBufferWriter<256> bw;
+  bw.print(Fmt{}, 255, "one");
+  REQUIRE(bw.view() == "Arg  one and 0xff {}");
+
+  // Must be identical to run time parsing.
+  auto check = [&](auto fmt, auto &&... args) {
+    swoc::LocalBufferWriter<256> rw;
+    rw.print(fmt.TEXT, args...);
+    return bw.clear().print(fmt, args...).view() == rw.view();
+  };
+  REQUIRE(check(SWOC_BWF_FORMAT("Some text")));
+  REQUIRE(check(SWOC_BWF_FORMAT("left >{0:<9}< right >{0:>9}< center >{0:^9}<"), 956));
+  REQUIRE(check(SWOC_BWF_FORMAT("center |{:%3A^10}| {:.^11}"), "text", "text"));
+  REQUIRE(check(SWOC_BWF_FORMAT("Format |{:>#010x}| |{:<#010x}| |{:#010x}|"), -956, -956, -956));
+  REQUIRE(check(SWOC_BWF_FORMAT("Arg {{{0}}} Arg {} {1} {} {0} and {{stuff}}"), 5, 6));
+  REQUIRE(check(SWOC_BWF_FORMAT("Arg {} Arg {{{{}}}} {} {1} {0}"), 9, 10));
+  REQUIRE(check(SWOC_BWF_FORMAT("{:.3} {:+} {:,2} {:08.2}"), 3.14159, 42, "clipped", 2.5));
+  REQUIRE(check(SWOC_BWF_FORMAT("{:s} {:S} {:d}"), true, false, true));
+
+  // Names are resolved at run time.
+  bw.clear().print(SWOC_BWF_FORMAT("{leif} {}"), 1);
+  REQUIRE(bw.view() == "{~leif~} 1");
+
+  // Output that doesn't fit.
+  swoc::LocalBufferWriter<10> small;
+  small.print(SWOC_BWF_FORMAT("{} is more than ten"), "This");
+  REQUIRE(small.view() == "This is mo");
+  REQUIRE(small.error());
+
+  std::string s;
+  bwprint(s, SWOC_BWF_FORMAT("{} and {}"), "this is a long string to force resizing", 47);
+  REQUIRE(s == "this is a long string to force resizing and 47");
+}
+
+TEST_CASE("bwprint compact format", "[bwprint][compact]")
+{
+  static_assert(sizeof(swoc::bwf::LocalFormat<>) == 128);
+  static_assert(sizeof(swoc::bwf::CompactFormat::Item) == 16);
+  using Fmt = swoc::bwf::LocalFormat<256>;
+  static_assert(std::is_trivially_copyable_v<Fmt>);
+
+  swoc::bwf::LocalFormat<> small{"Small {} format {:x}"};
+  REQUIRE(small.size() == 20 + 4 * sizeof(swoc::bwf::CompactFormat::Item));
+
+  std::string text{"left >{0:<9}< right >{0:>9}< center >{0:^9}<"};
+  Fmt fmt{text};
+  text.assign(text.size(), 'x'); // format must not depend on the original string.
+  REQUIRE(fmt.count() == 7);
+
+  swoc::LocalBufferWriter<256> bw;
+  bw.print(fmt, 956);
+  REQUIRE(bw.view() == "left >956      < right >      956< center >   956   <");
+  bw.clear().print(small, 1, 255);
+  REQUIRE(bw.view() == "Small 1 format ff");
+
+  // Copies are independent of the source.
+  Fmt other{"nothing"};
+  other = fmt;
+  fmt   = Fmt{"{} {{}} {:#x,6} {:.2:ext} {name}"};
+  bw.clear().print(other, 956);
+  REQUIRE(bw.view() == "left >956      < right >      956< center >   956   <");
+  bw.clear().print(fmt, "one", 0xdeadbeef, 2.25);
+  REQUIRE(bw.view() == "one {} 0xdead 2.25 {~name~}");
+
+  std::vector<swoc::bwf::Spec> specs;
+  std::string literals;
+  for (auto ex{fmt.bind()}; ex;) {
+    std::string_view lit;
+    swoc::bwf::Spec spec;
+    if (ex(lit, spec)) {
+      specs.push_back(spec);
+    }
+    literals += lit;
+  }
+  REQUIRE(literals == " {}   ");
+  REQUIRE(specs.size() == 4);
+  REQUIRE(specs[0]._ext.empty());
+  REQUIRE(specs[1]._max == 6);
+  REQUIRE(specs[1]._radix_lead_p);
+  REQUIRE(specs[1]._type == 'x');
+  REQUIRE(specs[2]._prec == 2);
+  REQUIRE(specs[2]._ext == "ext");
+  REQUIRE(specs[3]._name == "name");
+  REQUIRE(specs[3]._idx == -1);
+
+  // Long literals are split.
+  std::string long_text(300, '.');
+  swoc::bwf::LocalFormat<512> long_fmt{long_text + "{}"};
+  REQUIRE(long_fmt.count() == 3);
+  swoc::LocalBufferWriter<512> lw;
+  lw.print(long_fmt, 1);
+  REQUIRE(lw.view() == long_text + "1");
+
+  REQUIRE_THROWS_AS(swoc::bwf::LocalFormat<32>("{} {} {}"), std::length_error);
+  REQUIRE_THROWS_AS(Fmt("{:100000}"), std::length_error);
+  REQUIRE_NOTHROW(swoc::bwf::LocalFormat<8 + 5 * sizeof(swoc::bwf::CompactFormat::Item)>("{} {} {}"));
+}
+
+TEST_CASE("bwprint bound names", "[bwprint][names]")
+{
+  using swoc::BufferWriter;
+  using swoc::bwf::Spec;
+  swoc::LocalBufferWriter<256> bw;
+
+  // External names.
+  unsigned count = 0;
+  swoc::bwf::ExternalNames names;
+  names.assign("count", [&](BufferWriter &w, Spec const &spec) -> BufferWriter & { return bwformat(w, spec, ++count); });
+  names.assign("host", [](BufferWriter &w, Spec const &spec) -> BufferWriter & { return bwformat(w, spec, "example.com"sv); });
+  swoc::bwf::BoundFormat<swoc::bwf::ExternalGeneratorSignature> fmt{"{host:>12} {count} {} {count:x} {missing}", names};
+  bw.print(fmt, "arg");
+  REQUIRE(bw.view() == " example.com 1 arg 2 {~missing~}");
+
+  // Same as the unbound output.
+  count = 0;
+  bw.clear().print_nfv(names.bind(), swoc::bwf::Format::bind("{host:>12} {count} {} {count:x} {missing}"),
+                       swoc::bwf::ArgTuple{std::make_tuple("arg")});
+  REQUIRE(bw.view() == " example.com 1 arg 2 {~missing~}");
+
+  // Changes to a found name are used, names added later are not.
+  names.assign("host", [](BufferWriter &w, Spec const &spec) -> BufferWriter & { return bwformat(w, spec, "other.com"sv); });
+  names.assign("missing", [](BufferWriter &w, Spec const &spec) -> BufferWriter & { return w.write("found"); });
+  bw.clear().print(fmt, 1);
+  REQUIRE(bw.view() == "   other.com 3 1 4 {~missing~}");
+
+  // Context names.
+  struct Context {
+    std::string_view _path;
+    int _status;
+  };
+  using Names = swoc::bwf::ContextNames<Context const>;
+  Names ctx_names;
+  ctx_names.assign("path", [](BufferWriter &w, Spec const &spec, Context const &ctx) -> BufferWriter & {
+    return bwformat(w, spec, ctx._path);
+  });
+  ctx_names.assign("status", [](BufferWriter &w, Spec const &spec, Context const &ctx) -> BufferWriter & {
+    return bwformat(w, spec, ctx._status);
+  });
+  ctx_names.assign("version", [](BufferWriter &w, Spec const &spec) -> BufferWriter & { return w.write("1.1"); });
+  swoc::bwf::BoundFormat<BufferWriter &(BufferWriter &, Spec const &, Context const &)> ctx_fmt{
+    "GET {path} HTTP/{version} {status} {:>4}", ctx_names};
+  Context ctx{"/index.html", 200};
+  bw.clear().print_nfv(ctx_fmt.bind_names(ctx), ctx_fmt.bind(), swoc::bwf::ArgTuple{std::make_tuple(56)});
+  REQUIRE(bw.view() == "GET /index.html HTTP/1.1 200   56");
+  Context ctx2{"/", 404};
+  bw.clear().print_nfv(ctx_fmt.bind_names(ctx2), ctx_fmt.bind());
+  REQUIRE(bw.view() == "GET / HTTP/1.1 404 {BAD_ARG_INDEX:0 of 0}");
+}
+
 TEST_CASE("BWFormat numerics", "[bwprint][bwformat]")
 {
   swoc::LocalBufferWriter<256> bw;
@@ -314,6 +489,23 @@ TEST_CASE("bwstring", "[bwprint][bwstring]")
 
 TEST_CASE("BWFormat integral", "[bwprint][bwformat]")
 {
+  {
+    // Check the decimal conversion at every digit count boundary.
+    swoc::LocalBufferWriter<32> w;
+    bool ok_p = true;
+    for (uint64_t p = 1, k = 0; k < 20; ++k, p *= 10) {
+      for (uint64_t n : {p - 1, p, p + 1, p * 2 + 7}) {
+        if (w.clear().print("{}", n).view() != std::to_string(n)) {
+          ok_p = false;
+        }
+      }
+    }
+    REQUIRE(ok_p);
+    REQUIRE(w.clear().print("{}", std::numeric_limits<uint64_t>::max()).view() == "18446744073709551615");
+    REQUIRE(w.clear().print("{}", std::numeric_limits<int64_t>::min()).view() == "-9223372036854775808");
+    REQUIRE(w.clear().print("{}", 0).view() == "0");
+  }
+
   swoc::LocalBufferWriter<256> bw;
   swoc::bwf::Spec spec;
   uint32_t num = 30;
@@ -489,6 +681,23 @@ TEST_CASE("BWFormat floating", "[bwprint][bwformat]")
   REQUIRE(bw.view() == "1.4444444");
   bw.clear();
 
+  // Leading zeros in the fraction, and rounding in to the whole part.
+  bw.print("{} {:.3} {} {:.1}", 1.05, 2.0004, 0.999, 9.96);
+  REQUIRE(bw.view() == "1.05 2.000 1.00 10.0");
+  bw.clear().print("{:.22}", 0.5);
+  REQUIRE(bw.view() == "0.5000000000000000000000");
+  bw.clear().print("{:>8}|{:<8}|{:=+8}", 0.25, -0.25, 0.25);
+  REQUIRE(bw.view() == "    0.25|-0.25   |+   0.25");
+
+  // Shortest round trip.
+  bw.clear().print("{:r} {:r} {:r} {:r} {:r}", 0.1, 1.0 / 3, -2.5, 1e300, 5e-324);
+  REQUIRE(bw.view() == "0.1 0.3333333333333333 -2.5 1e+300 5e-324");
+  bw.clear().print("{:>6r}|{:r}", 1.5, 42);
+  REQUIRE(bw.view() == "   1.5|42");
+  bw.clear().print("{}", 1e20); // too large for the whole part.
+  REQUIRE(bw.view() == "1e+20");
+  bw.clear();
+
   // Edge
   bw.print("{}", (1.0 / 0.0));
   REQUIRE(bw.view() == "Inf");
@@ -539,6 +748,43 @@ TEST_CASE("bwstring std formats", "[libswoc][bwprint]")
   w.clear().print("{} is {::local}", t, swoc::bwf::Date(t, "%a, %d %b %Y at %H.%M.%S"));
   REQUIRE(w.view() == "1528484137 is Fri, 08 Jun 2018 at 12.55.37");
 
+  {
+    // Cached rendering must match direct rendering across second and minute boundaries.
+    std::array<char const *, 6> formats{"%Y %b %d %H:%M:%S", "%s", "%T %c", "%H:%M", "%S-%S", "%j %Ss"};
+    bool ok_p = true;
+    char buff[256];
+    swoc::LocalBufferWriter<256> dw;
+    for (auto fmt : formats) {
+      for (time_t e = t - 70; e < t + 130; e += (e % 7) + 1) {
+        for (bool local_p : {false, true}) {
+          struct tm tm;
+          local_p ? localtime_r(&e, &tm) : gmtime_r(&e, &tm);
+          std::string_view expected{buff, strftime(buff, sizeof(buff), fmt, &tm)};
+          dw.clear().print(local_p ? "{::local}"sv : "{}"sv, swoc::bwf::Date(e, fmt));
+          if (dw.view() != expected) {
+            ok_p = false;
+          }
+        }
+      }
+    }
+    REQUIRE(ok_p);
+
+    // Text longer than the initial cache buffer.
+    std::string long_fmt;
+    for (int i = 0; i < 60; ++i) {
+      long_fmt += "%T ";
+    }
+    swoc::LocalBufferWriter<1024> lw;
+    for (time_t e : {t, t + 1, t + 61}) {
+      struct tm tm;
+      gmtime_r(&e, &tm);
+      std::string_view expected{buff, strftime(buff, sizeof(buff), "%T ", &tm)};
+      lw.clear().print("{}", swoc::bwf::Date(e, long_fmt.c_str()));
+      REQUIRE(lw.size() == 60 * expected.size());
+      REQUIRE(lw.view().substr(lw.size() - expected.size()) == expected);
+    }
+  }
+
   unsigned v = htonl(0xdeadbeef);
   w.clear().print("{}", swoc::bwf::As_Hex(v));
   REQUIRE(w.view() == "deadbeef");
@@ -550,6 +796,21 @@ TEST_CASE("bwstring std formats", "[libswoc][bwprint]")
   REQUIRE(w.view() == "0XDEADBEEF");
   w.clear().print("{} bytes {} digits {}", sizeof(double), std::numeric_limits<double>::digits10, swoc::bwf::As_Hex(2.718281828));
   REQUIRE(w.view() == "8 bytes 15 digits 9b91048b0abf0540");
+  {
+    // Long enough to use the block conversion, with a partial block.
+    char bytes[37];
+    std::string lower, upper;
+    for (unsigned i = 0; i < sizeof(bytes); ++i) {
+      bytes[i] = static_cast<char>(i * 7 + 0x9b);
+      lower += "0123456789abcdef"[(bytes[i] >> 4) & 0xF];
+      lower += "0123456789abcdef"[bytes[i] & 0xF];
+      upper += "0123456789ABCDEF"[(bytes[i] >> 4) & 0xF];
+      upper += "0123456789ABCDEF"[bytes[i] & 0xF];
+    }
+    swoc::LocalBufferWriter<128> hw;
+    REQUIRE(hw.print("{:x}", std::string_view{bytes, sizeof(bytes)}).view() == lower);
+    REQUIRE(hw.clear().print("{:X}", swoc::bwf::As_Hex(bytes)).view() == upper);
+  }
 
 #if 0
   INK_MD5 md5;
@@ -670,3 +931,47 @@ TEST_CASE("bwperf", "[bwprint][performance]")
             << std::chrono::duration_cast<std::chrono::milliseconds>(delta).count() << "ms" << std::endl;
 }
 #endif
+
+// Benchmark numeric formatting - hidden, run explicitly with "[benchmark]".
+TEST_CASE("BWFormat numeric benchmark", "[.][benchmark][bwformat]")
+{
+  static constexpr int N = 1'000'000;
+  using Clock            = std::chrono::high_resolution_clock;
+
+  std::minstd_rand randu;
+  std::vector<uint64_t> ints;
+  std::vector<double> floats;
+  ints.reserve(N);
+  floats.reserve(N);
+  for (int i = 0; i < N; ++i) {
+    // Spread the values over the digit counts.
+    ints.push_back((uint64_t(randu()) << 32 | randu()) >> (randu() % 64));
+    floats.push_back(double(randu()) / (randu() | 1));
+  }
+
+  char buff[64];
+  swoc::FixedBufferWriter bw{buff, sizeof(buff)};
+  size_t total = 0; // keep the output live.
+  auto run     = [&](char const *name, auto &&f) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < N; ++i) {
+      total += f(i);
+    }
+    auto t1 = Clock::now();
+    std::cout << name << ": " << std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / N << " ns/op" << std::endl;
+  };
+
+  run("bwformat integer", [&](int i) { return bw.clear().print("{}", ints[i]).size(); });
+  run("snprintf integer", [&](int i) { return snprintf(buff, sizeof(buff), "%" PRIu64, ints[i]); });
+  run("to_chars integer", [&](int i) { return std::to_chars(buff, buff + sizeof(buff), ints[i]).ptr - buff; });
+  run("bwformat hex", [&](int i) { return bw.clear().print("{:x}", ints[i]).size(); });
+  run("snprintf hex", [&](int i) { return snprintf(buff, sizeof(buff), "%" PRIx64, ints[i]); });
+  run("bwformat float", [&](int i) { return bw.clear().print("{:.3}", floats[i]).size(); });
+  run("snprintf float", [&](int i) { return snprintf(buff, sizeof(buff), "%.3f", floats[i]); });
+  run("to_chars float", [&](int i) {
+    return std::to_chars(buff, buff + sizeof(buff), floats[i], std::chars_format::fixed, 3).ptr - buff;
+  });
+  run("bwformat shortest", [&](int i) { return bw.clear().print("{:r}", floats[i]).size(); });
+  run("to_chars shortest", [&](int i) { return std::to_chars(buff, buff + sizeof(buff), floats[i]).ptr - buff; });
+  REQUIRE(total > 0);
+}
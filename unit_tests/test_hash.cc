@@ -0,0 +1,123 @@
+/** @file
+
+    Hash function unit tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one or more contributor license
+    agreements.  See the NOTICE file distributed with this work for additional information regarding
+    copyright ownership.  The ASF licenses this file to you under the Apache License, Version 2.0
+    (the "License"); you may not use this file except in compliance with the License.  You may
+    obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software distributed under the
+    License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+    express or implied. See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+
+#include "swoc/ext/HashFNV.h"
+#include "catch.hpp"
+
+using swoc::Hash64Wy;
+using swoc::Hash64WyNoCase;
+using namespace std::literals;
+
+TEST_CASE("Hash FNV", "[libswoc][hash]")
+{
+  // Published test vectors.
+  REQUIRE(swoc::Hash32FNV1a().hash_immediate(""sv) == 0x811c9dc5u);
+  REQUIRE(swoc::Hash32FNV1a().hash_immediate("a"sv) == 0xe40c292cu);
+  REQUIRE(swoc::Hash64FNV1a().hash_immediate("a"sv) == 0xaf63dc4c8601ec8cull);
+  REQUIRE(swoc::Hash64FNV1a().hash_immediate("foobar"sv) == 0x85944171f73967e8ull);
+}
+
+TEST_CASE("Hash Wy", "[libswoc][hash]")
+{
+  std::string text;
+  for (int i = 0; i < 100; ++i) {
+    text += char('!' + i % 90);
+  }
+
+  // Seed makes a difference, and the same seed is the same hash.
+  REQUIRE(Hash64Wy(1).hash_immediate(text) != Hash64Wy(2).hash_immediate(text));
+  REQUIRE(Hash64Wy(1).hash_immediate(text) == Hash64Wy(1).hash_immediate(text));
+  REQUIRE(Hash64Wy().hash_immediate(text) == Hash64Wy(Hash64Wy::process_seed()).hash_immediate(text));
+
+  // Incremental update is the same as a single update, for all lengths and split points.
+  bool split_p = true;
+  for (size_t n = 0; n <= text.size(); ++n) {
+    std::string_view data{text.data(), n};
+    auto h = Hash64Wy(7).hash_immediate(data);
+    for (size_t k = 0; k <= n; k += 3) {
+      Hash64Wy hash(7);
+      hash.update(data.substr(0, k)).update(data.substr(k));
+      split_p = split_p && hash.final().get() == h;
+    }
+    split_p = split_p && Hash64Wy(7).hash_immediate(swoc::transform_view_of(data)) == h;
+  }
+  REQUIRE(split_p);
+
+  // Zero padding doesn't collide.
+  REQUIRE(Hash64Wy(7).hash_immediate("ab"sv) != Hash64Wy(7).hash_immediate("ab\0"sv));
+  REQUIRE(Hash64Wy(7).hash_immediate(""sv) != Hash64Wy(7).hash_immediate("\0"sv));
+
+  Hash64Wy hash(9);
+  auto h = hash.hash_immediate(text);
+  REQUIRE(hash.clear().hash_immediate(text) == h);
+
+  // No collisions on short, similar keys.
+  std::unordered_set<uint64_t> hashes;
+  for (int i = 0; i < 100000; ++i) {
+    hashes.insert(Hash64Wy(3).hash_immediate(std::to_string(i)));
+  }
+  REQUIRE(hashes.size() == 100000);
+}
+
+TEST_CASE("Hash Wy case", "[libswoc][hash]")
+{
+  // Case folding matches toupper for every byte value.
+  std::string text;
+  for (int c = 0; c < 256; ++c) {
+    text += char(c);
+  }
+  std::string upper;
+  for (unsigned char c : text) {
+    upper += char(toupper(c));
+  }
+  REQUIRE(Hash64WyNoCase(5).hash_immediate(text) == Hash64Wy(5).hash_immediate(upper));
+  REQUIRE(Hash64WyNoCase(5).hash_immediate(text) == Hash64WyNoCase(5).hash_immediate(upper));
+  REQUIRE(Hash64WyNoCase(5).hash_immediate(swoc::transform_view_of(std::string_view(text))) == Hash64Wy(5).hash_immediate(upper));
+  REQUIRE(Hash64WyNoCase(5).hash_immediate("Content-Length"sv) == Hash64WyNoCase(5).hash_immediate("CONTENT-length"sv));
+  REQUIRE(Hash64Wy(5).hash_immediate("Content-Length"sv) != Hash64Wy(5).hash_immediate("CONTENT-length"sv));
+}
+
+TEST_CASE("Hash benchmark", "[.][benchmark][hash]")
+{
+  static constexpr int N = 1000000;
+  std::string_view keys[] = {"GET"sv, "Content-Length"sv, "X-Forwarded-For-Original-Client-Address"sv,
+                             "application/x-www-form-urlencoded; charset=utf-8 with a longer tail for good measure"sv};
+  for (auto key : keys) {
+    uint64_t sink = 0;
+    auto t0       = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; ++i) {
+      sink += swoc::Hash32FNV1a().hash_immediate(swoc::transform_view_of(&toupper, key));
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; ++i) {
+      sink += Hash64WyNoCase().hash_immediate(key);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << key.size() << " bytes: FNV-1a toupper " << std::chrono::duration<double, std::nano>(t1 - t0).count() / N
+              << "ns, Wy no case " << std::chrono::duration<double, std::nano>(t2 - t1).count() / N << "ns (" << (sink & 1) << ")"
+              << std::endl;
+  }
+}
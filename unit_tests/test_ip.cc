@@ -9,11 +9,22 @@
 #include "catch.hpp"
 
 #include <set>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include <swoc/TextView.h>
 #include <swoc/swoc_ip.h>
 #include <swoc/bwf_ip.h>
 #include <swoc/swoc_file.h>
+#include <swoc/IPPrefixMap.h>
+#include <swoc/IntrusiveHashMap.h>
 
 using namespace std::literals;
 using namespace swoc::literals;
@@ -77,6 +88,26 @@ TEST_CASE("ink_inet", "[libswoc][ip]") {
   REQUIRE(a6_3 < a6_2);
   REQUIRE(a6_2 > a6_3);
 
+  // Carry and borrow between the words.
+  IP6Addr a6_4{"2001:db8::ffff:ffff:ffff:ffff"};
+  IP6Addr a6_5{"2001:db8:0:1::"};
+  REQUIRE(a6_4 < a6_5);
+  REQUIRE(a6_4 <= a6_5);
+  REQUIRE_FALSE(a6_5 <= a6_4);
+  ++a6_4;
+  REQUIRE(a6_4 == a6_5);
+  --a6_4;
+  REQUIRE(a6_4 == IP6Addr{"2001:db8::ffff:ffff:ffff:ffff"});
+  auto a6_max = IP6Addr::MAX;
+  ++a6_max;
+  REQUIRE(a6_max == IP6Addr::MIN);
+  --a6_max;
+  REQUIRE(a6_max == IP6Addr::MAX);
+  in6_addr a6_raw = a6_5.network_order();
+  REQUIRE(a6_raw.s6_addr[0] == 0x20);
+  REQUIRE(a6_raw.s6_addr[7] == 0x01);
+  REQUIRE(IP6Addr{a6_raw} == a6_5);
+
   // Little bit of IP4 address arithmetic / comparison testing.
   IP4Addr a4_null;
   IP4Addr a4_1{"172.28.56.33"};
@@ -137,6 +168,300 @@ TEST_CASE("ink_inet", "[libswoc][ip]") {
   REQUIRE(r4.load("2.2.2.2-fe80:20c::29ff:feae:5587::1c33") == false);
 };
 
+namespace {
+// The general loaders, used as the reference for the fast path parsers.
+bool ref_ip4_load(TextView src, in_addr_t & addr) {
+  int n = IP4Addr::SIZE;
+  if (src.empty() || ('[' == *src && ((++src).empty() || src.back() != ']'))) {
+    return false;
+  }
+  auto octet = reinterpret_cast<uint8_t *>(&addr);
+  while (n > 0 && !src.empty()) {
+    TextView token{src.take_prefix_at('.')};
+    auto x = swoc::svto_radix<10>(token);
+    if (token.empty() && 0 <= x && x <= std::numeric_limits<uint8_t>::max()) {
+      octet[--n] = x;
+    } else {
+      break;
+    }
+  }
+  return n == 0 && src.empty();
+}
+
+bool ref_ip6_load(TextView src, std::array<uint16_t, IP6Addr::N_QUADS> & quad) {
+  int n = 0;
+  int empty_idx = -1;
+  static constexpr int N = IP6Addr::N_QUADS;
+
+  if (src && '[' == *src) {
+    ++src;
+    if (src.empty() || src.back() != ']') {
+      return false;
+    }
+    src.remove_suffix(1);
+  }
+  if (src.size() < 2) {
+    return false;
+  }
+  if (src[0] == ':') {
+    if (src[1] != ':') {
+      return false;
+    }
+    if (src.size() == 2) {
+      quad.fill(0);
+      return true;
+    } else if (src.size() == 3 && src[2] == '1') {
+      quad.fill(0);
+      quad[7] = 1;
+      return true;
+    }
+    empty_idx = n;
+    src.remove_prefix(2);
+  }
+  while (n < N && !src.empty()) {
+    TextView token{src.take_prefix_at(':')};
+    if (token.empty()) {
+      if (empty_idx >= 0) {
+        return false;
+      }
+      empty_idx = n;
+    } else {
+      TextView r;
+      auto x = swoc::svtoi(token, &r, 16);
+      if (r.size() == token.size()) {
+        quad[n++] = x;
+      } else {
+        break;
+      }
+    }
+  }
+  if (empty_idx >= 0) {
+    if (n >= N) {
+      return false;
+    }
+    auto nil_idx = N - (n - empty_idx);
+    auto delta = N - n;
+    for (int k = N - 1; k >= empty_idx; --k) {
+      quad[k] = (k >= nil_idx ? quad[k - delta] : 0);
+    }
+    n = N;
+  }
+  return n == N && src.empty();
+}
+
+// Generate address-like text - mostly valid addresses, mutated with characters that stress the parsers.
+std::string fuzz_address(std::minstd_rand & randu) {
+  static constexpr TextView JUNK{"0123456789abcdefABCDEFgG:.[] +-\t"};
+  std::string s;
+  auto pick = [&](unsigned n) { return randu() % n; };
+  switch (pick(4)) {
+    case 0: // IPv4
+      for (int i = 0 ; i < 4 ; ++i) {
+        if (i) s += '.';
+        s += std::to_string(pick(5) ? pick(256) : pick(1000));
+      }
+      break;
+    case 1: // IPv6, possibly compressed.
+    case 2: {
+      std::array<unsigned, 8> q;
+      for (auto & x : q) {
+        x = pick(3) ? pick(0x10000) >> (4 * pick(4)) : 0;
+      }
+      int gap = pick(3) ? int(pick(8)) : -1;
+      int gap_n = gap >= 0 ? 1 + pick(8 - gap) : 0;
+      for (int i = 0 ; i < 8 ; ++i) {
+        if (i == gap) {
+          s += "::";
+          i += gap_n - 1;
+          continue;
+        }
+        if (i && s.back() != ':') s += ':';
+        char buff[8];
+        snprintf(buff, sizeof(buff), pick(2) ? "%x" : "%X", q[i]);
+        s += buff;
+      }
+      break;
+    }
+    default:
+      for (unsigned i = 0, n = pick(42) ; i < n ; ++i) {
+        s += JUNK[pick(JUNK.size())];
+      }
+  }
+  // Mutate.
+  for (unsigned i = 0, n = pick(3) ? 0 : 1 + pick(3) ; i < n ; ++i) {
+    char c = JUNK[pick(JUNK.size())];
+    unsigned idx = s.empty() ? 0 : pick(s.size());
+    switch (pick(3)) {
+      case 0: s.insert(s.begin() + idx, c); break;
+      case 1: if (!s.empty()) s.erase(idx, 1); break;
+      default: if (!s.empty()) s[idx] = c; break;
+    }
+  }
+  return s;
+}
+} // namespace
+
+TEST_CASE("IP Parse Equivalence", "[libswoc][ip]") {
+  std::vector<std::string> texts {
+      "", "[", "[]", ":", "::", ":::", "::1", "::a", "[::1]", "1:", "1::", "1:::2", "1.2.3.4", "1.2.3.4.", "....", "1..2.3",
+      "[1.2.3.4]", "01.002.255.0", "256.1.1.1", "1.2.3", "1.2.3.4.5", "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8:", "1:2:3:4:5:6:7::",
+      "::2:3:4:5:6:7:8", "1::2:3:4:5:6:7:8", "12345::", "+1::", "1: 2::", "fFfF::AbCd"
+  };
+  std::minstd_rand randu;
+  for (int i = 0 ; i < 200000 ; ++i) {
+    texts.push_back(fuzz_address(randu));
+  }
+
+  std::vector<std::string> mismatch;
+  unsigned n_valid = 0;
+  for (auto const& text : texts) {
+    in_addr_t ref4 = 0;
+    IP4Addr addr4;
+    bool ref4_p = ref_ip4_load(text, ref4);
+    if (addr4.load(text) != ref4_p || (ref4_p && addr4.host_order() != ref4)) {
+      mismatch.push_back("IPv4 "s + text);
+    }
+
+    std::array<uint16_t, IP6Addr::N_QUADS> ref6;
+    IP6Addr addr6;
+    bool ref6_p = ref_ip6_load(text, ref6);
+    bool match_p = addr6.load(text) == ref6_p;
+    if (match_p && ref6_p) {
+      auto na = addr6.network_order();
+      for (unsigned k = 0 ; k < ref6.size() ; ++k) {
+        match_p = match_p && na.s6_addr[2 * k] == (ref6[k] >> 8) && na.s6_addr[2 * k + 1] == (ref6[k] & 0xFF);
+      }
+    }
+    if (!match_p) {
+      mismatch.push_back("IPv6 "s + text);
+    }
+    n_valid += ref4_p || ref6_p;
+  }
+  REQUIRE(mismatch.empty());
+  REQUIRE(n_valid > texts.size() / 4); // Make sure the valid paths are exercised.
+}
+
+TEST_CASE("IPKey", "[libswoc][ip]") {
+  using swoc::IPAddr;
+  using swoc::IPKey;
+
+  IPEndpoint ep4{"172.17.99.231:80"};
+  IPKey k4{ep4};
+  REQUIRE(k4.is_valid());
+  REQUIRE(k4.family() == AF_INET);
+  REQUIRE(k4.host_order_port() == 80);
+  REQUIRE(k4.addr() == IPAddr{"172.17.99.231"});
+  REQUIRE(k4 == IPKey(IPAddr{"172.17.99.231"}, htons(80)));
+  REQUIRE(k4 != IPKey(IPAddr{"172.17.99.231"}, htons(81)));
+  // IPv4 and the mapped IPv6 address are different keys.
+  REQUIRE(k4 != IPKey(IPAddr{"::ffff:172.17.99.231"}, htons(80)));
+
+  IPEndpoint out;
+  k4.fill(&out.sa);
+  REQUIRE(IPKey(out) == k4);
+  swoc::LocalBufferWriter<64> w;
+  REQUIRE(w.print("{}", k4).view() == "172.17.99.231:80");
+
+  // Parts of the IPv6 socket address that are not the address or port don't matter.
+  IPEndpoint ep6{"[1337:0:0:ded:BEEF:0:0:956]:443"};
+  IPKey k6{ep6};
+  ep6.sa6.sin6_flowinfo = 17;
+  ep6.sa6.sin6_scope_id = 3;
+  REQUIRE(IPKey(ep6) == k6);
+  REQUIRE(k6.family() == AF_INET6);
+  REQUIRE(k6.host_order_port() == 443);
+  REQUIRE(k6.addr() == IPAddr{"1337:0:0:ded:BEEF:0:0:956"});
+  w.clear();
+  REQUIRE(w.print("{}", k6).view() == "[1337::ded:beef:0:0:956]:443");
+
+  REQUIRE_FALSE(IPKey{}.is_valid());
+  REQUIRE(IPKey{IPEndpoint{}} == IPKey{});
+  REQUIRE(IPKey{IPAddr{}, htons(80)} == IPKey{});
+  sockaddr_un sun;
+  sun.sun_family = AF_UNIX;
+  IPKey k{k6};
+  REQUIRE(k.assign(reinterpret_cast<sockaddr *>(&sun)) == IPKey{});
+  REQUIRE(k.family() == AF_UNSPEC);
+  REQUIRE(k.port() == 0);
+  REQUIRE(k.assign(nullptr) == IPKey{});
+
+  // Hashes of similar keys should all be distinct.
+  std::unordered_set<uint64_t> hashes;
+  std::unordered_set<IPKey> keys;
+  size_t n = 0;
+  for (unsigned i = 0; i < 64; ++i) {
+    for (in_port_t port = 1024; port < 1024 + 64; ++port, n += 2) {
+      IPKey a{IPAddr{htonl(0x0A000000 + i)}, htons(port)};
+      IPKey b{IPAddr{"2001:db8::"}, htons(port)};
+      // Vary the IPv6 address in the low bits.
+      sockaddr_in6 sin6;
+      b.fill(reinterpret_cast<sockaddr *>(&sin6));
+      sin6.sin6_addr.s6_addr[15] = i;
+      b.assign(reinterpret_cast<sockaddr *>(&sin6));
+      hashes.insert(a.hash());
+      hashes.insert(b.hash());
+      keys.insert(a);
+      keys.insert(b);
+    }
+  }
+  REQUIRE(keys.size() == n);
+  REQUIRE(hashes.size() == n);
+
+  // As a hash map key.
+  struct Connection {
+    IPKey _key;
+    Connection *_next{nullptr};
+    Connection *_prev{nullptr};
+
+    struct Descriptor : public IPKey::HashDescriptor, public swoc::IntrusiveLinkage<Connection> {
+      static IPKey const &
+      key_of(Connection *c) {
+        return c->_key;
+      }
+    };
+  };
+  Connection c4{k4}, c6{k6};
+  swoc::IntrusiveHashMap<Connection::Descriptor> map;
+  map.insert(&c4);
+  map.insert(&c6);
+  REQUIRE(map.find(IPKey{ep4}) != map.end());
+  REQUIRE(&*map.find(IPKey{ep4}) == &c4);
+  REQUIRE(&*map.find(k6) == &c6);
+  REQUIRE(map.find(IPKey(IPAddr{"172.17.99.231"}, htons(81))) == map.end());
+}
+
+// Parser throughput - hidden, run explicitly with "[benchmark]".
+TEST_CASE("IP Parse benchmark", "[.][benchmark][ip]") {
+  static constexpr int N = 1'000'000;
+  using Clock = std::chrono::high_resolution_clock;
+  std::minstd_rand randu;
+  std::vector<std::string> ip4, ip6;
+  for (int i = 0 ; i < N ; ++i) {
+    swoc::LocalBufferWriter<64> w;
+    w.print("{}", IP4Addr(in_addr_t(randu())));
+    ip4.emplace_back(w.view());
+    w.clear();
+    in6_addr a6;
+    for (unsigned k = 0 ; k < sizeof(a6.s6_addr) ; k += 2) { // Some zero quads, for "::".
+      a6.s6_addr[k] = a6.s6_addr[k + 1] = (randu() % 4) ? randu() : 0;
+    }
+    w.print("{}", IP6Addr(a6));
+    ip6.emplace_back(w.view());
+  }
+
+  auto run = [&](char const * name, auto && f) {
+    auto t0 = Clock::now();
+    unsigned n = f();
+    auto t1 = Clock::now();
+    std::cout << name << ": " << std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / N << " ns/addr" << std::endl;
+    REQUIRE(n == N);
+  };
+  run("IP4Addr::load", [&]() { unsigned n = 0; IP4Addr a; for (auto & s : ip4) n += a.load(s); return n; });
+  run("IPv4 reference", [&]() { unsigned n = 0; in_addr_t a; for (auto & s : ip4) n += ref_ip4_load(s, a); return n; });
+  run("IP6Addr::load", [&]() { unsigned n = 0; IP6Addr a; for (auto & s : ip6) n += a.load(s); return n; });
+  run("IPv6 reference", [&]() { unsigned n = 0; std::array<uint16_t, 8> a; for (auto & s : ip6) n += ref_ip6_load(s, a); return n; });
+}
+
 TEST_CASE("IP Formatting", "[libswoc][ip][bwformat]") {
   IPEndpoint ep;
   std::string_view addr_1{"[ffee::24c3:3349:3cee:143]:8080"};
@@ -314,6 +639,61 @@ Property *PropertyGroup::operator[](std::string_view const&name) {
   return std::get<1>(_properties.back()).get();
 }
 
+TEST_CASE("IP Formatting equivalence", "[libswoc][ip][bwformat]") {
+  // The plain formats must match the system formatting, which is also RFC 5952 compressed.
+  std::minstd_rand randu(29);
+  swoc::LocalBufferWriter<64> w;
+  char ref[INET6_ADDRSTRLEN];
+  bool ip4_p = true;
+  bool ip6_p = true;
+  bool upper_p = true;
+  for (unsigned i = 0; i < 20000; ++i) {
+    in_addr a4;
+    a4.s_addr = randu() ^ (randu() << 16);
+    if (i % 3 == 0) {
+      a4.s_addr &= htonl(0xFF00FF00); // zero octets.
+    }
+    w.clear().print("{}", IP4Addr{a4.s_addr});
+    ip4_p = ip4_p && w.view() == inet_ntop(AF_INET, &a4, ref, sizeof(ref));
+
+    // Zero runs in every position, but not the IPv4 embedded forms that are formatted differently.
+    in6_addr a6;
+    for (unsigned k = 0; k < 8; ++k) {
+      uint16_t q = (randu() % 2) ? 0 : (randu() % 3 == 0 ? randu() % 16 : randu());
+      a6.s6_addr[2 * k]     = q >> 8;
+      a6.s6_addr[2 * k + 1] = q & 0xFF;
+    }
+    if (i % 7 == 0) {
+      a6.s6_addr[0] = 0x20;
+    }
+    bool embedded_p = true;
+    for (unsigned k = 0; k < 10; ++k) {
+      embedded_p = embedded_p && a6.s6_addr[k] == 0;
+    }
+    if (!embedded_p) {
+      w.clear().print("{}", IP6Addr{a6});
+      ip6_p = ip6_p && w.view() == inet_ntop(AF_INET6, &a6, ref, sizeof(ref));
+      w.clear().print("{:X}", IP6Addr{a6});
+      std::string upper{ref};
+      for (auto &c : upper) {
+        c = toupper(c);
+      }
+      upper_p = upper_p && w.view() == upper;
+    }
+  }
+  REQUIRE(ip4_p);
+  REQUIRE(ip6_p);
+  REQUIRE(upper_p);
+
+  // Formats that need the general formatting.
+  w.clear().print("{:x}", IP4Addr{"172.17.99.231"});
+  REQUIRE(w.view() == "ac.11.63.e7");
+  w.clear().print("{:#x}", IP6Addr{"1337::ded:beef"});
+  REQUIRE(w.view() == "0x1337::0xded:0xbeef");
+  w.clear().print("{:d}", IP6Addr{"1337::ded:beef"});
+  REQUIRE(w.view() == "4919::3565:48879");
+}
+
 TEST_CASE("IP Space Int", "[libswoc][ip][ipspace]") {
   using int_space = swoc::IPSpace<unsigned>;
   int_space space;
@@ -385,6 +765,734 @@ TEST_CASE("IP Space Int", "[libswoc][ip][ipspace]") {
   REQUIRE(space.count() == 4);
 }
 
+TEST_CASE("IP Space Frozen", "[libswoc][ip][ipspace]") {
+  using int_space = swoc::IPSpace<unsigned>;
+  int_space space;
+
+  auto empty = space.freeze();
+  REQUIRE(empty.count() == 0);
+  REQUIRE(empty.find(IP4Addr{"172.16.0.1"}) == nullptr);
+
+  auto addr = [](unsigned h) { return IP4Addr{htonl(0x0A000000 + h)}; };
+  std::minstd_rand randu;
+  std::uniform_int_distribution<unsigned> base_gen{0, 0xFFFF};
+  std::uniform_int_distribution<unsigned> size_gen{0, 64};
+  for (unsigned i = 0; i < 2000; ++i) {
+    auto min = base_gen(randu);
+    space.mark({addr(min), addr(min + size_gen(randu))}, i % 7);
+  }
+  space.blend(IP6Range{IP6Addr{"1337::ded:beef"}, IP6Addr{"1337::ded:ffff"}}, 9u, [](unsigned &lhs, unsigned rhs) {
+    lhs = rhs;
+    return true;
+  });
+
+  auto frozen = space.freeze();
+  REQUIRE(frozen.count() == space.count());
+  bool mismatch_p = false;
+  for (unsigned h = 0; h < 0x10100; ++h) {
+    auto a = addr(h);
+    auto expected = space.find(a);
+    auto found = frozen.find(a);
+    if ((expected == nullptr) != (found == nullptr) || (found && *found != *expected)) {
+      mismatch_p = true;
+    }
+  }
+  REQUIRE_FALSE(mismatch_p);
+  REQUIRE(frozen.find(addr(0x20000)) == nullptr);
+  REQUIRE(frozen.find(IP4Addr{"9.255.255.255"}) == nullptr);
+
+  auto payload = frozen.find(IP6Addr{"1337::ded:cafe"});
+  REQUIRE(payload != nullptr);
+  REQUIRE(*payload == 9);
+  REQUIRE(frozen.find(IP6Addr{"1337::dee:0"}) == nullptr);
+
+  // Batch lookups, with a partial final group.
+  std::vector<IP4Addr> addrs;
+  for (unsigned h = 0; h < 0x10100; h += 13) {
+    addrs.push_back(addr(h));
+  }
+  std::vector<unsigned *> results(addrs.size());
+  std::vector<unsigned const *> frozen_results(addrs.size());
+  space.find(swoc::MemSpan<IP4Addr const>{addrs.data(), addrs.size()}, swoc::MemSpan<unsigned *>{results.data(), results.size()});
+  frozen.find(swoc::MemSpan<IP4Addr const>{addrs.data(), addrs.size()},
+              swoc::MemSpan<unsigned const *>{frozen_results.data(), frozen_results.size()});
+  mismatch_p = false;
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    if (results[i] != space.find(addrs[i]) || frozen_results[i] != frozen.find(addrs[i])) {
+      mismatch_p = true;
+    }
+  }
+  REQUIRE_FALSE(mismatch_p);
+  REQUIRE(std::count(results.begin(), results.end(), nullptr) < results.size());
+
+  IP6Addr a6[3] = {IP6Addr{"1337::ded:beef"}, IP6Addr{"1337::ded:beee"}, IP6Addr{"1337::ded:ffff"}};
+  unsigned const *r6[3];
+  frozen.find(swoc::MemSpan<IP6Addr const>{a6, 3}, swoc::MemSpan<unsigned const *>{r6, 3});
+  REQUIRE(r6[0] != nullptr);
+  REQUIRE(r6[1] == nullptr);
+  REQUIRE(r6[2] != nullptr);
+
+  // Frozen is independent of the source space.
+  space.clear();
+  REQUIRE(frozen.find(IP6Addr{"1337::ded:cafe"}) != nullptr);
+}
+
+TEST_CASE("IP Space Frozen image", "[libswoc][ip][ipspace]") {
+  using int_space = swoc::IPSpace<unsigned>;
+  int_space space;
+
+  auto addr = [](unsigned h) { return IP4Addr{htonl(0x0A000000 + h)}; };
+  std::minstd_rand randu;
+  std::uniform_int_distribution<unsigned> base_gen{0, 0xFFFF};
+  std::uniform_int_distribution<unsigned> size_gen{0, 64};
+  for (unsigned i = 0; i < 1000; ++i) {
+    auto min = base_gen(randu);
+    space.mark({addr(min), addr(min + size_gen(randu))}, i % 7);
+  }
+  space.blend(IP6Range{IP6Addr{"1337::ded:beef"}, IP6Addr{"1337::ded:ffff"}}, 9u, [](unsigned &lhs, unsigned rhs) {
+    lhs = rhs;
+    return true;
+  });
+  auto frozen = space.freeze();
+
+  std::vector<char> buff(frozen.image_size() + 100);
+  REQUIRE(frozen.write_image(swoc::MemSpan<char>{buff.data(), frozen.image_size() - 1}).empty());
+  auto image = frozen.write_image(swoc::MemSpan<char>{buff.data(), buff.size()});
+  REQUIRE(image.size() == frozen.image_size());
+
+  // Write the image to a file and use it from a memory map.
+  char name[] = "/tmp/swoc_ip_image.XXXXXX";
+  int fd      = ::mkstemp(name);
+  REQUIRE(fd >= 0);
+  REQUIRE(::write(fd, image.data(), image.size()) == ssize_t(image.size()));
+  ::close(fd);
+  std::error_code ec;
+  auto mapped = swoc::file::load_mapped(swoc::file::path{name}, ec, MADV_RANDOM);
+  ::unlink(name);
+  REQUIRE_FALSE(ec);
+  auto view = mapped.view();
+
+  int_space::Frozen loaded;
+  REQUIRE(loaded.attach(swoc::MemSpan<char const>{view.data(), view.size()}));
+  REQUIRE(loaded.count() == frozen.count());
+  bool mismatch_p = false;
+  for (unsigned h = 0; h < 0x10100; ++h) {
+    auto expected = frozen.find(addr(h));
+    auto found    = loaded.find(addr(h));
+    if ((expected == nullptr) != (found == nullptr) || (found && *found != *expected)) {
+      mismatch_p = true;
+    }
+  }
+  REQUIRE_FALSE(mismatch_p);
+  auto payload = loaded.find(IP6Addr{"1337::ded:cafe"});
+  REQUIRE(payload != nullptr);
+  REQUIRE(*payload == 9);
+  REQUIRE(loaded.find(IP6Addr{"1337::dee:0"}) == nullptr);
+
+  // Copies share the image.
+  auto copy = loaded;
+  REQUIRE(copy.find(IP6Addr{"1337::ded:cafe"}) == payload);
+  REQUIRE(loaded.image_size() == view.size());
+
+  // Images that are damaged or for other types are rejected and leave the space unchanged.
+  std::vector<char> bad{image.data(), image.data() + image.size()};
+  swoc::MemSpan<char const> bad_span{bad.data(), bad.size()};
+  int_space::Frozen other;
+  REQUIRE_FALSE(other.attach(bad_span.prefix(bad.size() - 1)));
+  REQUIRE_FALSE(other.attach(bad_span.prefix(10)));
+  REQUIRE(swoc::IPSpace<uint64_t>::Frozen{}.attach(bad_span) == false);
+  bad[0] = 'X';
+  REQUIRE_FALSE(copy.attach(bad_span));
+  REQUIRE(copy.find(IP6Addr{"1337::ded:cafe"}) == payload);
+  bad[0] = image.data()[0];
+  REQUIRE(other.attach(bad_span));
+  REQUIRE(*other.find(IP6Addr{"1337::ded:cafe"}) == 9);
+
+  // An empty space has a valid image.
+  int_space::Frozen empty;
+  std::vector<char> empty_buff(empty.image_size());
+  REQUIRE_FALSE(empty.write_image(swoc::MemSpan<char>{empty_buff.data(), empty_buff.size()}).empty());
+  REQUIRE(other.attach(swoc::MemSpan<char const>{empty_buff.data(), empty_buff.size()}));
+  REQUIRE(other.count() == 0);
+  REQUIRE(other.find(addr(1)) == nullptr);
+}
+
+TEST_CASE("IP Space Arena", "[libswoc][ip][ipspace]") {
+  using int_space = swoc::IPSpace<unsigned>;
+  swoc::MemArena arena;
+  int_space space{arena};
+
+  auto addr = [](unsigned h) { return IP4Addr{htonl(0x0A000000 + h)}; };
+  for (unsigned i = 0; i < 100; ++i) {
+    space.mark({addr(i * 16), addr(i * 16 + 7)}, i);
+  }
+  REQUIRE(space.count() == 100);
+  REQUIRE(arena.size() > 0);
+  auto size = arena.size();
+  auto payload = space.find(addr(35));
+  REQUIRE(payload != nullptr);
+  REQUIRE(*payload == 2);
+
+  // Nodes from clearing are re-used, the external arena does not grow.
+  space.clear();
+  REQUIRE(space.count() == 0);
+  REQUIRE(space.find(addr(35)) == nullptr);
+  for (unsigned i = 0; i < 100; ++i) {
+    space.mark({addr(i * 16 + 8), addr(i * 16 + 15)}, i);
+  }
+  REQUIRE(space.count() == 100);
+  REQUIRE(arena.size() == size);
+  payload = space.find(addr(45));
+  REQUIRE(payload != nullptr);
+  REQUIRE(*payload == 2);
+}
+
+namespace {
+// Expose the tree for validation.
+struct CheckedSpace : public swoc::DiscreteSpace<unsigned, unsigned> {
+  using super_type = swoc::DiscreteSpace<unsigned, unsigned>;
+  using super_type::super_type;
+
+  /// @return The black height, or -1 if the tree is not a valid red black tree.
+  int black_height() const { return this->check(_root, 0, ~0U); }
+
+  int check(Node *n, unsigned lo, unsigned hi) const {
+    if (n == nullptr) {
+      return 1;
+    }
+    auto l = static_cast<Node *>(n->_left);
+    auto r = static_cast<Node *>(n->_right);
+    if (n->min() < lo || n->max() > hi || (l && l->_parent != n) || (r && r->_parent != n)) {
+      return -1;
+    }
+    if (n->_color == Node::Color::RED &&
+        ((l && l->_color == Node::Color::RED) || (r && r->_color == Node::Color::RED))) {
+      return -1;
+    }
+    int lh = l ? this->check(l, lo, n->min() - 1) : 1;
+    int rh = r ? this->check(r, n->max() + 1, hi) : 1;
+    if (lh < 0 || lh != rh) {
+      return -1;
+    }
+    return lh + (n->_color == Node::Color::BLACK);
+  }
+};
+} // namespace
+
+TEST_CASE("DiscreteSpace load", "[libswoc][ip][ipspace]") {
+  using Range = swoc::DiscreteRange<unsigned>;
+  using Item  = std::tuple<Range, unsigned>;
+
+  for (unsigned n : {0U, 1U, 2U, 3U, 7U, 8U, 100U, 1000U}) {
+    std::vector<Item> items;
+    for (unsigned i = 0; i < n; ++i) {
+      items.emplace_back(Range{i * 10, i * 10 + 4}, i);
+    }
+    CheckedSpace space;
+    space.load(items.begin(), items.end());
+    REQUIRE(space.count() == n);
+    REQUIRE(space.black_height() > 0);
+    bool miss_p = false;
+    for (unsigned i = 0; i < n; ++i) {
+      auto p = space.find(i * 10 + 2);
+      if (p == nullptr || *p != i || space.find(i * 10 + 7) != nullptr) {
+        miss_p = true;
+      }
+    }
+    REQUIRE_FALSE(miss_p);
+    // The result must remain a valid tree under further changes.
+    for (unsigned i = 0; i < n; i += 3) {
+      space.mark({i * 10 + 5, i * 10 + 6}, i);
+    }
+    REQUIRE(space.black_height() > 0);
+  }
+
+  // Unsorted, adjacent with the same payload, and overlapping.
+  std::vector<Item> items{{Range{30, 39}, 2}, {Range{0, 9}, 1}, {Range{10, 19}, 1}, {Range{20, 29}, 2}, {Range{25, 34}, 3}};
+  CheckedSpace space;
+  space.load(items.begin(), items.end());
+  REQUIRE(space.count() == 4);
+  REQUIRE(*space.find(15) == 1);
+  REQUIRE(*space.find(22) == 2);
+  REQUIRE(*space.find(27) == 3);
+  REQUIRE(*space.find(30) == 2); // later minimum has priority.
+  REQUIRE(*space.find(37) == 2);
+  REQUIRE(space.black_height() > 0);
+
+  // Loading in to a non-empty space merges.
+  std::vector<Item> more{{Range{5, 12}, 4}, {Range{100, 110}, 5}};
+  space.load(more.begin(), more.end());
+  REQUIRE(space.count() == 7);
+  REQUIRE(*space.find(4) == 1);
+  REQUIRE(*space.find(8) == 4);
+  REQUIRE(*space.find(13) == 1);
+  REQUIRE(*space.find(105) == 5);
+  REQUIRE(space.black_height() > 0);
+}
+
+TEST_CASE("DiscreteSpace merge", "[libswoc][ip][ipspace]") {
+  using Range = swoc::DiscreteRange<unsigned>;
+  using Space = swoc::DiscreteSpace<unsigned, unsigned>;
+  using Item  = std::tuple<Range, unsigned>;
+  static constexpr unsigned MAX = std::numeric_limits<unsigned>::max();
+  static constexpr unsigned N   = 3000; // Values past this are all the same.
+
+  // Payloads are combined as digits, 0 for missing.
+  auto digits = [](unsigned const *lhs, unsigned const *rhs) { return (lhs ? *lhs * 10 : 0) + (rhs ? *rhs : 0); };
+  auto join   = [&](unsigned &result, unsigned const *lhs, unsigned const *rhs) {
+    result = digits(lhs, rhs);
+    return true;
+  };
+  auto meet = [&](unsigned &result, unsigned const *lhs, unsigned const *rhs) {
+    result = digits(lhs, rhs);
+    return lhs && rhs;
+  };
+  auto diff = [&](unsigned &result, unsigned const *lhs, unsigned const *rhs) {
+    result = digits(lhs, rhs);
+    return !rhs;
+  };
+
+  std::minstd_rand randu(19);
+  auto make = [&](Space &space, std::vector<unsigned> &model, unsigned n) {
+    model.assign(N + 1, 0);
+    for (unsigned i = 0; i < n; ++i) {
+      unsigned min = randu() % (N - 100);
+      unsigned max = min + randu() % 40;
+      space.mark({min, max}, randu() % 3 + 1);
+    }
+    space.mark({N - 50, MAX}, 1);
+    for (auto const &r : space) {
+      for (unsigned k = r.min(); k <= std::min(r.max(), N); ++k) {
+        model[k] = r.payload();
+      }
+    }
+  };
+  // Check @a space matches @a expected, with ranges coalesced.
+  auto same = [](Space const &space, std::vector<unsigned> const &expected) {
+    std::vector<unsigned> cells(N + 1, 0);
+    bool valid_p = true;
+    Space::const_iterator prev;
+    for (auto spot = space.begin(); spot != space.end(); prev = spot++) {
+      if (spot != space.begin()) {
+        valid_p = valid_p && prev->max() < spot->min() && (prev->max() + 1 < spot->min() || prev->payload() != spot->payload());
+      }
+      for (unsigned k = spot->min(); k <= std::min(spot->max(), N); ++k) {
+        cells[k] = spot->payload();
+      }
+    }
+    return valid_p && cells == expected;
+  };
+
+  Space lhs, rhs, empty;
+  std::vector<unsigned> lhs_model, rhs_model;
+  make(lhs, lhs_model, 300);
+  make(rhs, rhs_model, 200);
+  std::vector<unsigned> join_model(N + 1), meet_model(N + 1), diff_model(N + 1);
+  for (unsigned k = 0; k <= N; ++k) {
+    unsigned a = lhs_model[k], b = rhs_model[k];
+    unsigned d = digits(a ? &a : nullptr, b ? &b : nullptr);
+    join_model[k] = d;
+    meet_model[k] = a && b ? d : 0;
+    diff_model[k] = b ? 0 : d;
+  }
+
+  Space result;
+  REQUIRE(same(result.merge(lhs, rhs, join), join_model));
+  REQUIRE(same(result.merge(lhs, rhs, meet), meet_model));
+  REQUIRE(same(result.merge(lhs, rhs, diff), diff_model));
+  REQUIRE(result.merge(empty, empty, join).count() == 0);
+  REQUIRE(result.merge(lhs, empty, meet).count() == 0);
+  result.merge(lhs, empty, [](unsigned &result, unsigned const *lhs, unsigned const *) {
+    result = *lhs;
+    return true;
+  });
+  REQUIRE(same(result, lhs_model));
+
+  // Large spaces are split across threads, which must give the same result.
+  std::vector<Item> items;
+  for (unsigned i = 0; i < 50000; ++i) {
+    items.emplace_back(Range{i * 100, static_cast<unsigned>(i * 100 + randu() % 90)}, randu() % 3 + 1);
+  }
+  Space big_lhs, big_rhs;
+  big_lhs.load(items.begin(), items.end());
+  for (auto &[range, payload] : items) {
+    range.assign(range.min() + 50, range.max() + 50);
+  }
+  big_rhs.load(items.begin(), items.end());
+  Space single, multiple;
+  single.merge(big_lhs, big_rhs, join, 1);
+  multiple.merge(big_lhs, big_rhs, join, 4);
+  REQUIRE(single.count() > 100000);
+  REQUIRE(single.count() == multiple.count());
+  bool match_p = true;
+  auto spot    = multiple.begin();
+  for (auto const &r : single) {
+    match_p = match_p && r.min() == spot->min() && r.max() == spot->max() && r.payload() == spot->payload();
+    ++spot;
+  }
+  REQUIRE(match_p);
+}
+
+TEST_CASE("DiscreteSpace interned", "[libswoc][ip][ipspace]") {
+  struct Info {
+    unsigned _asn = 0;
+    char _country[3] = {0, 0, 0};
+    unsigned _flags = 0;
+
+    bool
+    operator==(Info const &that) const {
+      return _asn == that._asn && 0 == memcmp(_country, that._country, sizeof(_country)) && _flags == that._flags;
+    }
+  };
+  struct InfoHash {
+    size_t
+    operator()(Info const &info) const {
+      return std::hash<unsigned>{}(info._asn) ^ (std::hash<unsigned>{}(info._flags) << 1);
+    }
+  };
+  using Space = swoc::InternedDiscreteSpace<IP4Addr, Info, uint16_t, InfoHash>;
+  static constexpr Info US_1{1, "US", 0}, US_2{2, "US", 0}, DE_3{3, "DE", 1};
+
+  Space space;
+  REQUIRE(space.payload_count() == 1);
+  REQUIRE(space.count() == 0);
+  for (unsigned i = 0; i < 3000; ++i) {
+    auto base = IP4Addr{htonl(0x0A000000 + i * 256)};
+    space.mark({base, IP4Addr{htonl(0x0A000000 + i * 256 + 255)}}, i % 3 == 0 ? US_1 : i % 3 == 1 ? US_2 : DE_3);
+  }
+  REQUIRE(space.count() == 3000);
+  REQUIRE(space.payload_count() == 4);
+  REQUIRE(*space.find(IP4Addr{"10.0.0.7"}) == US_1);
+  REQUIRE(*space.find(IP4Addr{"10.0.1.7"}) == US_2);
+  REQUIRE(*space.find(IP4Addr{"10.0.2.7"}) == DE_3);
+  REQUIRE(space.find(IP4Addr{"11.0.0.0"}) == nullptr);
+  REQUIRE(space.intern(US_2) == 2); // in order of first use.
+  REQUIRE(space.payload_count() == 4);
+
+  // Identical payloads coalesce, including with the following range.
+  space.mark({IP4Addr{"10.0.0.0"}, IP4Addr{"10.0.11.255"}}, US_1);
+  REQUIRE(space.count() == 3000 - 12);
+  REQUIRE(space.payload_count() == 4);
+
+  // Blending makes new payloads as needed.
+  space.blend(IP4Range{"10.0.0.0/16"}, 4U, [](Info &info, unsigned flags) {
+    info._flags |= flags;
+    return true;
+  });
+  REQUIRE(space.payload_count() == 8); // including the blended default payload.
+  REQUIRE(space.find(IP4Addr{"10.0.0.7"})->_flags == 4);
+  REQUIRE(space.find(IP4Addr{"10.0.14.7"})->_flags == 5);
+  REQUIRE(space.find(IP4Addr{"10.1.0.7"})->_flags == 0);
+  auto spot = space.space().begin();
+  REQUIRE(space.payload_at(spot->payload())._flags == 4);
+
+  space.clear();
+  REQUIRE(space.count() == 0);
+  REQUIRE(space.payload_count() == 1);
+}
+
+TEST_CASE("DiscreteSpace persistent", "[libswoc][ip][ipspace]") {
+  using Range = swoc::DiscreteRange<unsigned>;
+  using Space = swoc::PersistentDiscreteSpace<unsigned, unsigned>;
+  static constexpr unsigned MAX = std::numeric_limits<unsigned>::max();
+  auto blender = [](unsigned &lhs, unsigned const &rhs) {
+    lhs ^= rhs;
+    return lhs != 0;
+  };
+  // Reference model, a payload per value with 0 for no payload. The last element stands for all of
+  // the values from there to @c MAX, as ranges never start in that part.
+  static constexpr unsigned N = 1100;
+  using Model                 = std::vector<unsigned>;
+  auto model_apply = [](Model &model, Range const &r, auto &&f) {
+    for (unsigned k = r.min(); k <= std::min(r.max(), N); ++k) {
+      f(model[k]);
+    }
+  };
+  // Check @a v has the same content as @a model, with ranges in order and coalesced.
+  auto same = [](Space::Version const &v, Model const &model) {
+    Model cells(N + 1, 0);
+    bool valid_p = true;
+    size_t n     = 0;
+    Range prev;
+    unsigned prev_payload = 0;
+    v.apply([&](Range const &r, unsigned p) {
+      if (n++ > 0) {
+        valid_p = valid_p && prev.max() < r.min() && (prev.max() + 1 < r.min() || prev_payload != p);
+      }
+      valid_p = valid_p && !r.is_empty() && (r.max() < N || r.max() == MAX);
+      for (unsigned k = r.min(); k <= std::min(r.max(), N); ++k) {
+        cells[k] = p;
+      }
+      prev         = r;
+      prev_payload = p;
+    });
+    return valid_p && n == v.count() && cells == model;
+  };
+
+  Space space;
+  REQUIRE(space.count() == 0);
+  REQUIRE(space.find(1) == nullptr);
+
+  // Random changes must match the model.
+  Model model(N + 1, 0);
+  std::minstd_rand randu(17);
+  bool match_p = true;
+  std::vector<std::pair<Space::Version, Model>> history;
+  for (unsigned i = 0; i < 2000; ++i) {
+    unsigned min     = randu() % 1000;
+    unsigned max     = min + randu() % 50;
+    unsigned payload = randu() % 4 + 1;
+    if (i % 97 == 0) { // exercise the metric limits.
+      max = MAX;
+    } else if (i % 89 == 0) {
+      min = 0;
+    }
+    Range range{min, max};
+    switch (randu() % 4) {
+    case 0:
+      space.mark(range, payload);
+      model_apply(model, range, [=](unsigned &p) { p = payload; });
+      break;
+    case 1:
+      space.fill(range, payload);
+      model_apply(model, range, [=](unsigned &p) { p = p ? p : payload; });
+      break;
+    case 2:
+      space.blend(range, payload, blender);
+      model_apply(model, range, [=](unsigned &p) { p ^= payload; });
+      break;
+    case 3:
+      space.erase(range);
+      model_apply(model, range, [](unsigned &p) { p = 0; });
+      break;
+    }
+    match_p = match_p && same(space.snapshot(), model);
+    if (i % 200 == 0) {
+      history.emplace_back(space.snapshot(), model);
+    }
+  }
+  REQUIRE(match_p);
+  REQUIRE(space.count() > 10);
+
+  // Old versions are unchanged.
+  bool history_p = true;
+  for (auto const &[v, m] : history) {
+    history_p = history_p && same(v, m);
+  }
+  REQUIRE(history_p);
+
+  // Changes can be combined and published at once.
+  auto v = space.snapshot().erase({0, MAX}).mark({10, 19}, 1).mark({20, 29}, 1).fill({0, 100}, 2);
+  REQUIRE(space.snapshot().count() == space.count());
+  REQUIRE(v.count() == 3);
+  space.publish(v);
+  REQUIRE(space.count() == 3);
+  REQUIRE(*space.find(15) == 1);
+  REQUIRE(*space.find(25) == 1);
+  REQUIRE(*space.find(30) == 2);
+  REQUIRE(space.find(101) == nullptr);
+  space.clear();
+  REQUIRE(space.count() == 0);
+  REQUIRE(v.count() == 3);
+
+  // Readers use versions while the space changes.
+  space.mark({0, 999}, 1);
+  std::atomic<bool> done_p{false};
+  std::atomic<unsigned> misses{0};
+  std::thread reader([&]() {
+    while (!done_p) {
+      auto snap = space.snapshot();
+      for (unsigned k = 0; k < 1000; k += 10) {
+        if (snap.find(k) == nullptr) {
+          ++misses;
+        }
+      }
+    }
+  });
+  for (unsigned i = 0; i < 2000; ++i) {
+    unsigned min = randu() % 1000;
+    space.mark({min, std::min(999U, min + 10)}, i % 5 + 1);
+  }
+  done_p = true;
+  reader.join();
+  REQUIRE(misses == 0);
+
+  swoc::PersistentDiscreteSpace<IP4Addr, unsigned> acl;
+  acl.mark(IP4Range{"10.0.0.0/8"}, 1).mark(IP4Range{"10.1.0.0/16"}, 2).mark(IP4Range{"255.0.0.0/8"}, 3);
+  auto acl_v = acl.snapshot();
+  acl.erase(IP4Range{"10.1.0.0/16"});
+  REQUIRE(*acl_v.find(IP4Addr{"10.1.2.3"}) == 2);
+  REQUIRE(acl.find(IP4Addr{"10.1.2.3"}) == nullptr);
+  REQUIRE(*acl.find(IP4Addr{"10.2.2.3"}) == 1);
+  REQUIRE(*acl.find(IP4Addr{"255.255.255.255"}) == 3);
+  REQUIRE(acl.count() == 3);
+}
+
+TEST_CASE("IP Space parallel load", "[libswoc][ip][ipspace]") {
+  using Space = swoc::IPSpace<unsigned>;
+  std::string text;
+  swoc::LocalBufferWriter<128> w;
+  std::minstd_rand randu(13);
+  // Mostly disjoint ranges in random order, with some overlaps, IPv6 ranges, and junk lines.
+  for (unsigned i = 0; i < 5000; ++i) {
+    unsigned base = (randu() % 20000) * 256;
+    unsigned size = (randu() % 4 == 0) ? 1000 : 200;
+    w.clear().print("{}-{},{}\n", swoc::IP4Addr(htonl(0x0A000000 + base)), swoc::IP4Addr(htonl(0x0A000000 + base + size)), i % 7);
+    text += w.view();
+    if (i % 100 == 0) {
+      w.clear().print("2001:db8::{:x}:0-2001:db8::{:x}:ffff,{}\n# comment\n", i, i, i % 5);
+      text += w.view();
+    }
+  }
+
+  auto parse = [](TextView line, swoc::IPRange &range, unsigned &payload) -> bool {
+    auto token = line.take_prefix_at(',');
+    if (!range.load(token)) {
+      return false;
+    }
+    payload = swoc::svtou(line);
+    return true;
+  };
+
+  // Reference, marked a line at a time in text order.
+  Space ref;
+  for (TextView src{text}; src;) {
+    swoc::IPRange range;
+    unsigned payload;
+    if (parse(src.take_prefix_at('\n'), range, payload)) {
+      if (range.is(AF_INET)) {
+        ref.mark(range, payload);
+      } else { // No IPv6 mark, but blending by assignment is equivalent.
+        ref.blend(range, payload, [](unsigned &lhs, unsigned rhs) { lhs = rhs; return true; });
+      }
+    }
+  }
+  REQUIRE(ref.count() > 4000);
+
+  for (unsigned n_threads : {1U, 2U, 3U, 8U, 0U}) {
+    Space space;
+    space.parallel_load(text, parse, n_threads);
+    REQUIRE(space.count() == ref.count());
+    bool match_p = true;
+    auto spot    = space.begin();
+    for (auto const &r : ref) {
+      match_p = match_p && spot != space.end() && r.min() == spot->min() && r.max() == spot->max() && r.payload() == spot->payload();
+      ++spot;
+    }
+    REQUIRE(match_p);
+  }
+
+  // Same minimum, the later line has priority.
+  Space space;
+  space.parallel_load("10.1.0.0-10.1.0.255,1\n10.1.0.0-10.1.0.255,2\n10.1.0.0-10.1.0.255,3\n", parse, 3);
+  REQUIRE(space.count() == 1);
+  REQUIRE(*space.find(swoc::IP4Addr{"10.1.0.7"}) == 3);
+  // Overlaps are resolved by text order, not by minimum.
+  space.clear();
+  space.parallel_load("10.2.0.0-10.2.0.99,1\n10.2.0.50-10.2.0.59,2\n10.2.0.0-10.2.0.255,3\n10.2.0.40-10.2.0.49,4\n10.3.0.0,5\n", parse, 2);
+  REQUIRE(space.count() == 4);
+  REQUIRE(*space.find(swoc::IP4Addr{"10.2.0.55"}) == 3);
+  REQUIRE(*space.find(swoc::IP4Addr{"10.2.0.45"}) == 4);
+  REQUIRE(*space.find(swoc::IP4Addr{"10.3.0.0"}) == 5);
+  space.clear();
+  space.parallel_load("10.1.0.0-10.1.0.255,1\n10.1.0.0-10.1.0.255,2\n10.1.0.0-10.1.0.255,3\n", parse, 3);
+  space.parallel_load("2001:db8::1-2001:db8::ff,4", parse);
+  REQUIRE(space.count() == 2);
+  REQUIRE(space.freeze().find(swoc::IP6Addr{"2001:db8::10"}) != nullptr);
+  REQUIRE(*space.freeze().find(swoc::IP6Addr{"2001:db8::10"}) == 4);
+  space.parallel_load("", parse);
+  REQUIRE(space.count() == 2);
+}
+
+TEST_CASE("IP Prefix Map", "[libswoc][ip][ipprefix]") {
+  using swoc::IpNet;
+  using swoc::IPAddr;
+  using swoc::IPMask;
+  using Map = swoc::IPPrefixMap<unsigned>;
+
+  auto net4 = [](char const *text, unsigned width) { return IpNet{IPAddr{IP4Addr{text}}, IPMask(width, AF_INET)}; };
+  auto net6 = [](char const *text, unsigned width) { return IpNet{IPAddr{IP6Addr{text}}, IPMask(width, AF_INET6)}; };
+
+  Map map;
+  REQUIRE(map.compile().find(IP4Addr{"10.1.2.3"}) == nullptr);
+
+  REQUIRE(map.insert(net4("10.0.0.0", 8), 1));
+  REQUIRE(map.insert(net4("10.1.0.0", 16), 2));
+  REQUIRE(map.insert(net4("10.1.2.0", 24), 3));
+  REQUIRE(map.insert(net4("10.1.2.128", 25), 4));
+  REQUIRE(map.insert(net4("10.1.2.3", 32), 5));
+  REQUIRE_FALSE(map.insert(net4("10.1.0.0", 16), 6)); // replace.
+  REQUIRE(map.insert(net6("2001:db8::", 32), 7));
+  REQUIRE(map.insert(net6("2001:db8:1::", 48), 8));
+  REQUIRE(map.insert(net6("2001:db8:1::1", 128), 9));
+  REQUIRE(map.count() == 8);
+
+  auto compiled = map.compile();
+  REQUIRE(compiled.count() == 8);
+  for (auto &&[text, expected] : std::initializer_list<std::tuple<char const *, unsigned>>{
+         {"10.200.0.1", 1}, {"10.1.200.1", 6}, {"10.1.2.4", 3}, {"10.1.2.200", 4}, {"10.1.2.3", 5}, {"11.0.0.0", 0}}) {
+    IP4Addr addr{text};
+    auto p = map.find(addr);
+    auto cp = compiled.find(addr);
+    REQUIRE((p ? *p : 0) == expected);
+    REQUIRE((cp ? *cp : 0) == expected);
+  }
+  for (auto &&[text, expected] : std::initializer_list<std::tuple<char const *, unsigned>>{
+         {"2001:db8:2::1", 7}, {"2001:db8:1::2", 8}, {"2001:db8:1::1", 9}, {"2001:db9::", 0}}) {
+    IP6Addr addr{text};
+    auto p = map.find(addr);
+    auto cp = compiled.find(addr);
+    REQUIRE((p ? *p : 0) == expected);
+    REQUIRE((cp ? *cp : 0) == expected);
+  }
+
+  REQUIRE(map.erase(net4("10.1.2.0", 24)));
+  REQUIRE_FALSE(map.erase(net4("10.1.2.0", 24)));
+  REQUIRE(*map.find(IP4Addr{"10.1.2.4"}) == 6);
+  REQUIRE(*compiled.find(IP4Addr{"10.1.2.4"}) == 3); // compiled is independent.
+
+  // Random prefixes, checked against a linear scan.
+  map.clear();
+  REQUIRE(map.count() == 0);
+  std::minstd_rand randu;
+  std::vector<std::tuple<uint32_t, unsigned, unsigned>> nets;
+  for (unsigned i = 0; i < 2000; ++i) {
+    unsigned width = randu() % 33;
+    uint32_t addr  = (0x0A000000 | (randu() & 0x00FFFFFF)) & (width ? ~uint32_t(0) << (32 - width) : 0);
+    if (map.insert(IpNet{IPAddr{IP4Addr{htonl(addr)}}, IPMask(width, AF_INET)}, i)) {
+      nets.emplace_back(addr, width, i);
+    } else {
+      for (auto &[a, w, p] : nets) {
+        if (a == addr && w == width) {
+          p = i;
+        }
+      }
+    }
+  }
+  compiled = map.compile();
+  bool mismatch_p = false;
+  for (unsigned i = 0; i < 20000; ++i) {
+    uint32_t h = (i & 1) ? (0x0A000000 | (randu() & 0x00FFFFFF)) : uint32_t(randu());
+    unsigned best_width = 0;
+    unsigned const *best = nullptr;
+    for (auto &[a, w, p] : nets) {
+      uint32_t mask = w ? ~uint32_t(0) << (32 - w) : 0;
+      if ((h & mask) == a && (best == nullptr || w > best_width)) {
+        best       = &p;
+        best_width = w;
+      }
+    }
+    IP4Addr addr{htonl(h)};
+    auto p  = map.find(addr);
+    auto cp = compiled.find(addr);
+    if ((best == nullptr) != (p == nullptr) || (best && *best != *p) || (best == nullptr) != (cp == nullptr) ||
+        (best && *best != *cp)) {
+      mismatch_p = true;
+    }
+  }
+  REQUIRE_FALSE(mismatch_p);
+}
+
 #if 1
 TEST_CASE("IP Space YNETDB", "[libswoc][ipspace][ynetdb]") {
   std::set<std::string_view> Locations;
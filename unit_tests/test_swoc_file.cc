@@ -18,9 +18,13 @@
     limitations under the License.
 */
 
+#include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
+#include <vector>
 
 #include "swoc/swoc_file.h"
+#include "swoc/MemArena.h"
 #include "catch.hpp"
 
 using swoc::file::path;
@@ -67,3 +71,165 @@ TEST_CASE("swoc_file_io", "[libts][swoc_file_io]")
   REQUIRE(ec.value() == 2);
   REQUIRE(swoc::file::is_readable(file) == false);
 }
+
+TEST_CASE("swoc_file_mapped", "[libts][swoc_file_io]")
+{
+  path file("unit_tests/test_swoc_file.cc");
+  std::error_code ec;
+  std::string content = swoc::file::load(file, ec);
+  REQUIRE(ec.value() == 0);
+
+  auto mapped = swoc::file::load_mapped(file, ec);
+  REQUIRE(ec.value() == 0);
+  REQUIRE(mapped.size() == content.size());
+  REQUIRE(mapped.view() == content);
+  swoc::TextView text = mapped;
+  REQUIRE(text.take_prefix_at('\n') == "/** @file");
+  REQUIRE(mapped.advise(MADV_WILLNEED).value() == 0);
+
+  // Ownership moves with the instance.
+  auto data = mapped.data();
+  swoc::file::mapped_file other{std::move(mapped)};
+  REQUIRE(mapped.empty());
+  REQUIRE(mapped.data() == nullptr);
+  REQUIRE(other.data() == data);
+  mapped = std::move(other);
+  REQUIRE(other.empty());
+  REQUIRE(mapped.data() == data);
+  mapped.clear();
+  REQUIRE(mapped.empty());
+
+  // An empty file is not an error.
+  char tmpl[] = "/tmp/swoc_file_mapped_XXXXXX";
+  int fd      = mkstemp(tmpl);
+  REQUIRE(fd >= 0);
+  auto empty = swoc::file::load_mapped(path(tmpl), ec);
+  REQUIRE(ec.value() == 0);
+  REQUIRE(empty.empty());
+  ::close(fd);
+  ::unlink(tmpl);
+
+  mapped = swoc::file::load_mapped(path("../unit-tests/no_such_file.txt"), ec);
+  REQUIRE(ec.value() == 2);
+  REQUIRE(mapped.empty());
+}
+
+TEST_CASE("swoc_file_lines", "[libts][swoc_file_io]")
+{
+  // Lines of varied length, including empty lines and lines longer than the buffer.
+  std::string content;
+  std::vector<std::string> lines;
+  for (unsigned i = 0; i < 500; ++i) {
+    lines.emplace_back((i * 7) % 53, char('a' + i % 26));
+    content += lines.back();
+    content += '\n';
+  }
+  lines.emplace_back("last line without a newline");
+  content += lines.back();
+
+  char tmpl[] = "/tmp/swoc_file_lines_XXXXXX";
+  int fd      = mkstemp(tmpl);
+  REQUIRE(fd >= 0);
+  REQUIRE(::write(fd, content.data(), content.size()) == ssize_t(content.size()));
+  ::close(fd);
+
+  for (size_t chunk : {size_t(16), size_t(100), swoc::file::line_reader::DEFAULT_CHUNK_SIZE}) {
+    swoc::file::line_reader reader{chunk};
+    REQUIRE(reader.open(path(tmpl)).value() == 0);
+    swoc::TextView line;
+    size_t n     = 0;
+    bool match_p = true;
+    while (reader.next(line)) {
+      match_p = match_p && n < lines.size() && line == lines[n];
+      ++n;
+    }
+    REQUIRE(match_p);
+    REQUIRE(n == lines.size());
+    REQUIRE(reader.error().value() == 0);
+    REQUIRE(reader.capacity() >= chunk);
+    REQUIRE(reader.capacity() < std::max<size_t>(chunk, 53) * 2);
+  }
+
+  // Reopen and use a different delimiter.
+  swoc::file::line_reader reader{32};
+  REQUIRE(reader.open(path(tmpl)).value() == 0);
+  swoc::TextView line;
+  REQUIRE(reader.next(line, 'b'));
+  REQUIRE(line == "\n"); // first line is empty, second is all 'b'.
+  REQUIRE(reader.next(line, 'b'));
+  REQUIRE(line.empty());
+  ::unlink(tmpl);
+
+  REQUIRE(reader.open(path("../unit-tests/no_such_file.txt")).value() == 2);
+  REQUIRE_FALSE(reader.next(line));
+}
+
+TEST_CASE("swoc_file_async", "[libts][swoc_file_io]")
+{
+  // A directory of small fragments.
+  char tmpl[] = "/tmp/swoc_file_async_XXXXXX";
+  REQUIRE(mkdtemp(tmpl) != nullptr);
+  path dir{tmpl};
+  std::vector<std::string> contents;
+  std::vector<path> paths;
+  for (unsigned i = 0; i < 40; ++i) {
+    contents.emplace_back(i * 37, char('a' + i % 26));
+    paths.push_back(dir / std::string_view(std::to_string(i)));
+    int fd = ::open(paths.back().c_str(), O_WRONLY | O_CREAT, 0600);
+    REQUIRE(fd >= 0);
+    REQUIRE(::write(fd, contents.back().data(), contents.back().size()) == ssize_t(contents.back().size()));
+    ::close(fd);
+  }
+
+  for (unsigned depth : {swoc::file::async_loader::DEFAULT_DEPTH, 8U, 0U}) {
+    swoc::MemArena arena;
+    swoc::file::async_loader loader{arena, depth};
+    REQUIRE((depth == 0 || loader.is_async() == (loader.fd() >= 0)));
+    std::vector<std::string> loaded(paths.size() + 2);
+    std::vector<int> errors(paths.size() + 2, -1);
+    for (unsigned i = 0; i < paths.size(); ++i) {
+      loader.load(paths[i], [&, i](path const &p, swoc::TextView content, std::error_code ec) {
+        loaded[i] = content;
+        errors[i] = ec.value();
+      });
+    }
+    loader.load(dir / "no_such_file", [&](path const &, swoc::TextView content, std::error_code ec) {
+      errors[paths.size()] = ec.value();
+      loaded[paths.size()] = content;
+    });
+    loader.load(dir, [&](path const &, swoc::TextView, std::error_code ec) { errors[paths.size() + 1] = ec.value(); });
+    loader.wait();
+
+    bool match_p = true;
+    for (unsigned i = 0; i < paths.size(); ++i) {
+      match_p = match_p && errors[i] == 0 && loaded[i] == contents[i];
+    }
+    REQUIRE(match_p);
+    REQUIRE(errors[paths.size()] == ENOENT);
+    REQUIRE(loaded[paths.size()].empty());
+    REQUIRE(errors[paths.size() + 1] == EISDIR);
+    if (loader.is_async() && depth == swoc::file::async_loader::DEFAULT_DEPTH) {
+      // Two submissions for each batch of files that fit in the ring.
+      REQUIRE(loader.enter_count() <= 4);
+    }
+  }
+
+  // Polling, with a load queued from a callback.
+  swoc::MemArena arena;
+  swoc::file::async_loader loader{arena};
+  std::string first, second;
+  loader.load(paths[3], [&](path const &, swoc::TextView content, std::error_code) {
+    first = content;
+    loader.load(paths[4], [&](path const &, swoc::TextView content, std::error_code) { second = content; });
+  });
+  REQUIRE(loader.submit() == 1);
+  while (loader.poll() > 0 || second.empty()) {
+  }
+  REQUIRE(first == contents[3]);
+  REQUIRE(second == contents[4]);
+
+  for (auto const &p : paths) {
+    ::unlink(p.c_str());
+  }
+  ::rmdir(tmpl);
+}